@@ -64,6 +64,7 @@
 #endif
 
 #include "ApplMain.h"
+#include "app_timer_wheel.h"
 
 #if (defined(CPU_QN908X) || defined(CPU_JN518X))
 #include "controller_interface.h"
@@ -152,6 +153,124 @@
 #define mAppTaskWaitTime_c (osaWaitForever_c)
 #endif
 
+/*
+ * Maximum number of messages handled by App_Thread on each wake up, taken in turn
+ * from the Host and the callback queues. The thread signals itself again if
+ * messages are left, so that other tasks get to run.
+ **/
+#ifndef gAppThreadMsgBudget_c
+#define gAppThreadMsgBudget_c (8U)
+#endif
+
+#if (gAppThreadMsgBudget_c == 0U)
+#error "gAppThreadMsgBudget_c must be at least 1"
+#endif
+
+/*
+ * Optional time limit (microseconds) of a wake up of App_Thread. No new message is
+ * taken once it is exceeded. 0 means no limit.
+ **/
+#ifndef gAppThreadTimeBudgetUs_c
+#define gAppThreadTimeBudgetUs_c (0U)
+#endif
+
+/*
+ * Number of scan report messages kept allocated and reused by App_ScanningCallback.
+ * Reports with more than gAppScanReportPoolDataSize_c bytes of data, or received
+ * while all the pooled messages are in use, are allocated as usual. 0 disables the pool.
+ **/
+#ifndef gAppScanReportPoolSize_c
+#define gAppScanReportPoolSize_c (0U)
+#endif
+
+#ifndef gAppScanReportPoolDataSize_c
+#define gAppScanReportPoolDataSize_c (gcGapMaxAdvertisingDataLength_c)
+#endif
+
+#if (gAppScanReportPoolSize_c > 0U)
+/* Size of a pooled scan report message */
+#define mAppScanReportSize_c (sizeof(uint32_t) + sizeof(gapScanningEvent_t) + gAppScanReportPoolDataSize_c)
+#endif
+
+/* The upper bits of the message type tell where a Host message was allocated */
+#define mAppMsgTypeMask_c    (0x00FFFFFFU)
+/* Slab size class + 1 */
+#define mAppMsgSlabMask_c    (0x0F000000U)
+#define mAppMsgSlabShift_c   (24U)
+/* Pooled scan report message */
+#define mAppMsgPooled_c      (0x80000000U)
+
+/* List element placed by MSG_Alloc() before a message */
+#define mAppMsgListElement_m(pMsg)   ((listElementHandle_t)(void*)(pMsg) - 1)
+
+/*
+ * Set gAppHostMsgLanes_d to queue the Host messages in three lanes: control and
+ * security events, connection data (GATT and L2CAP data), and scanning events.
+ * App_Thread takes up to the lane weight of messages from each lane in turn,
+ * higher priority lanes first, or always the highest priority lane with messages
+ * if gAppHostMsgStrictPriority_d is set. Messages keep their order within a lane only,
+ * so the disconnection of a peer is queued in the data lane, after its data.
+ **/
+#ifndef gAppHostMsgLanes_d
+#define gAppHostMsgLanes_d (0)
+#endif
+
+#ifndef gAppHostMsgStrictPriority_d
+#define gAppHostMsgStrictPriority_d (0)
+#endif
+
+#ifndef gAppControlLaneWeight_c
+#define gAppControlLaneWeight_c (8U)
+#endif
+
+#ifndef gAppDataLaneWeight_c
+#define gAppDataLaneWeight_c (4U)
+#endif
+
+#ifndef gAppScanLaneWeight_c
+#define gAppScanLaneWeight_c (1U)
+#endif
+
+#if gAppHostMsgLanes_d && !gAppHostMsgStrictPriority_d && \
+    ((gAppControlLaneWeight_c == 0U) || (gAppDataLaneWeight_c == 0U) || (gAppScanLaneWeight_c == 0U))
+#error "The lane weights must be at least 1"
+#endif
+
+#if gAppNotifRing_d
+#if ((gAppNotifRingSize_c & (gAppNotifRingSize_c - 1U)) != 0U) || (gAppNotifRingSize_c < 8U)
+#error "gAppNotifRingSize_c must be a power of 2"
+#endif
+
+/* Each value is stored after a header of handle and length, rounded up to 4 bytes */
+#define mAppNotifHeaderSize_c       (4U)
+#define mAppNotifRecordSize_m(len)  (((uint32_t)(len) + mAppNotifHeaderSize_c + 3U) & ~3U)
+/* Set in the length of an indication */
+#define mAppNotifIndication_c       (0x8000U)
+/* Handle of the filler record skipping the end of the ring */
+#define mAppNotifPadHandle_c        (0x0000U)
+#endif
+
+#if gAppScanCache_d
+#if ((gAppScanCacheSize_c & (gAppScanCacheSize_c - 1U)) != 0U) || (gAppScanCacheSize_c == 0U)
+#error "gAppScanCacheSize_c must be a power of 2"
+#endif
+
+/* Number of cache slots searched for a device, starting with its hash */
+#if (gAppScanCacheSize_c < 8U)
+#define mAppScanCacheProbes_c   (gAppScanCacheSize_c)
+#else
+#define mAppScanCacheProbes_c   (8U)
+#endif
+
+/* The RSSI average is kept in 1/16 dBm and moves by 1/8 of the difference */
+#define mAppScanCacheRssiScale_c    (16)
+#define mAppScanCacheRssiWeight_c   (8)
+
+/* FNV-1a hash */
+#define mAppScanCacheHashInit_c     (0x811C9DC5U)
+#define mAppScanCacheHashPrime_c    (0x01000193U)
+#endif
+
 #if defined (MULTICORE_APPLICATION_CORE) && (MULTICORE_APPLICATION_CORE)
 #define MULTICORE_STATIC
 #else
@@ -181,6 +300,8 @@ typedef enum {
     gAppL2caLeDataMsg_c,
     gAppL2caLeControlMsg_c,
     gAppSecLibMultiplyMsg_c,
+    gAppGattServerWriteBatchMsg_c,
+    gAppNotifRingDrainMsg_c,
 }appHostMsgType_t;
 
 /* Host to Application Connection Message */
@@ -219,6 +340,22 @@ typedef struct l2caLeCbDataMsg_tag{
     uint8_t     aPacket[1];
 }l2caLeCbDataMsg_t;
 
+/* Host to Application batched writes without response */
+typedef struct gattServerWriteBatchMsg_tag{
+    deviceId_t  deviceId;
+    uint16_t    handle;
+    uint16_t    writeCount;
+    uint16_t    dataLength;
+    uint16_t    aLengths[gAppWriteBatchMaxWrites_c];
+    uint8_t     aData[1];
+}gattServerWriteBatchMsg_t;
+
+/* Marks the place of the values of a notification ring in the Host to App queue */
+typedef struct notifRingDrainMsg_tag{
+    deviceId_t  deviceId;
+    uint32_t    head;       /* Ring position after the last value stored for this marker */
+}notifRingDrainMsg_t;
+
 /* SecLib to Application Data Message */
 typedef struct secLibMsgData_tag{
     computeDhKeyParam_t *pData;
@@ -237,6 +374,8 @@ typedef struct appMsgFromHost_tag{
         l2caLeCbDataMsg_t       l2caLeCbDataMsg;
         l2capControlMessage_t   l2caLeCbControlMsg;
         secLibMsgData_t         secLibMsgData;
+        gattServerWriteBatchMsg_t gattServerWriteBatchMsg;
+        notifRingDrainMsg_t     notifRingDrainMsg;
     } msgData;
 }appMsgFromHost_t;
 
@@ -244,6 +383,82 @@ typedef struct appMsgCallback_tag{
     appCallbackHandler_t   handler;
     appCallbackParam_t     param;
 }appMsgCallback_t;
+
+#if gAppMsgSlab_d
+/* Host to Application message slab size class */
+typedef struct appMsgSlabClass_tag{
+    anchor_t    freeList;
+    uint16_t    blockSize;
+    uint16_t    blocks;
+    uint16_t    inUse;
+    uint16_t    maxInUse;
+}appMsgSlabClass_t;
+#endif
+
+#if gAppHostMsgLanes_d
+/* Host to Application message lanes, highest priority first */
+typedef enum {
+    mAppControlLane_c = 0U,
+    mAppDataLane_c,
+    mAppScanLane_c,
+    mAppLaneCount_c
+}appHostMsgLane_t;
+#endif
+
+#if gAppNotifRing_d
+/* Notification ring of a connection. Single producer (Host task), single consumer (App task) */
+typedef struct appNotifRing_tag{
+    volatile uint32_t   head;       /* Written by the Host task */
+    volatile uint32_t   tail;       /* Written by the App task */
+    appMsgFromHost_t*   pMarker;    /* Drain marker new values are added to, NULL once
+                                       another message is queued after it */
+    appNotifRingStats_t stats;
+    struct {
+        uint16_t    handle;
+        uint32_t    overflows;
+    } aHandles[gAppNotifRingHandles_c];
+    uint32_t            aData[gAppNotifRingSize_c / sizeof(uint32_t)];
+}appNotifRing_t;
+#endif
+
+#if gAppScanCache_d
+/* Advertising report cache slot */
+typedef struct appScanCacheEntry_tag{
+    bleDeviceAddress_t  aAddress;
+    bleAddressType_t    addressType;
+    uint8_t             sid;
+    bool_t              scanResponse;
+    bool_t              inUse;
+    bool_t              restart;        /* Counters restart with the next report */
+    int8_t              rssiMin;
+    int8_t              rssiMax;
+    int16_t             rssiAverage;    /* 1/16 dBm */
+    uint16_t            dataLength;
+    uint32_t            dataHash;
+    uint32_t            reports;
+    uint32_t            lastForward;    /* milliseconds */
+    uint32_t            lastSeen;       /* milliseconds */
+}appScanCacheEntry_t;
+#endif
+
+#if gAppHostMsgCoalesce_d
+/* Kind of a state event. Zero filled, so that keys can be compared as bytes */
+typedef struct appMsgCoalesceKey_tag{
+    uint8_t             msgType;
+    uint8_t             eventType;
+    deviceId_t          deviceId;       /* gInvalidDeviceId_c for advertising reports */
+    bleAddressType_t    addressType;
+    uint8_t             sid;
+    uint16_t            variant;        /* Report type, or PHY event type */
+    bleDeviceAddress_t  aAddress;
+}appMsgCoalesceKey_t;
+
+/* State event waiting in the App queue */
+typedef struct appMsgCoalesceSlot_tag{
+    appMsgFromHost_t*   pMsg;           /* NULL if the slot is free */
+    appMsgCoalesceKey_t key;
+}appMsgCoalesceSlot_t;
+#endif
 /************************************************************************************
 *************************************************************************************
 * Private prototypes
@@ -287,6 +502,51 @@ static void App_KeyboardCallBack(uint8_t events);
 #endif
 
 static void App_HandleHostMessageInput(appMsgFromHost_t* pMsg);
+static bool_t App_ProcessHostMessage(void);
+static bool_t App_ProcessCallbackMessage(void);
+static void App_QueueHostMessage(appMsgFromHost_t* pMsgIn);
+static void App_EnqueueHostMessage(appMsgFromHost_t* pMsgIn);
+static void App_CloseHostMessageAppends(void);
+static bool_t App_HostMessagePending(void);
+static appMsgFromHost_t* App_MsgAlloc(uint32_t msgType, uint32_t msgLen);
+static void App_MsgFree(appMsgFromHost_t* pMsgIn, uint32_t msgTag);
+#if gAppMsgSlab_d
+static void App_MsgSlabInit(void);
+#endif
+
+#if gAppNotifRing_d
+static bool_t App_NotifRingWrite(deviceId_t deviceId, uint16_t handle, const uint8_t* aValue,
+                                 uint16_t valueLength, bool_t indication);
+static void App_NotifRingDrain(appMsgFromHost_t* pMarker);
+static bool_t App_NotifRingPending(void);
+#endif
+
+#if gAppWriteBatch_d
+static bool_t App_WriteBatchAppend(deviceId_t deviceId, const gattServerAttributeWrittenEvent_t* pEvent);
+static void App_WriteBatchDispatch(const gattServerWriteBatchMsg_t* pBatch);
+#endif
+
+#if (gAppDirectDispatchMask_c != 0U)
+static bool_t App_DirectDispatchEnter(void);
+static void App_DirectDispatchExit(void);
+#endif
+
+#if (gAppScanReportPoolSize_c > 0U)
+static appMsgFromHost_t* App_ScanReportAlloc(uint32_t msgLen);
+#endif
+
+#if gAppScanCache_d
+static bool_t App_ScanCacheFilter(const gapScanningEvent_t* pScanningEvent);
+static appScanCacheEntry_t* App_ScanCacheLookup(const appScanCacheEntry_t* pKey, bool_t insert);
+static uint32_t App_ScanCacheHash(uint32_t hash, const uint8_t* pData, uint32_t length);
+#endif
+
+#if gAppHostMsgCoalesce_d
+static bool_t App_CoalesceKey(uint32_t msgType, deviceId_t deviceId, const void* pEvent,
+                              appMsgCoalesceKey_t* pKey);
+static void App_CoalesceQueue(const appMsgCoalesceKey_t* pKey, appMsgFromHost_t* pMsgIn);
+static void App_CoalesceClose(deviceId_t deviceId);
+#endif
 
 #ifdef CPU_QN908X
 #if (defined(BOARD_XTAL1_CLK_HZ) && (BOARD_XTAL1_CLK_HZ != CLK_XTAL_32KHZ))
@@ -410,6 +670,77 @@ anchor_t mHostAppInputQueue;
 anchor_t mAppCbInputQueue;
 #endif
 
+#if (gAppScanReportPoolSize_c > 0U)
+/* Pooled scan report messages not in use */
+static anchor_t mAppScanReportFreeList;
+/* Number of pooled scan report messages allocated so far */
+static uint32_t mAppScanReportCount = 0U;
+#endif
+
+#if gAppNotifRing_d
+static appNotifRing_t maAppNotifRings[gAppMaxConnections_c];
+#endif
+
+#if gAppWriteBatch_d
+/* Batch still in the Application Task queue that writes can be appended to */
+static appMsgFromHost_t* mpAppWriteBatch = NULL;
+static appGattServerWriteBatchCallback_t pfGattServerWriteBatchCallback = NULL;
+#endif
+
+#if (gAppDirectDispatchMask_c != 0U)
+/* Application handlers running in the Host task */
+static uint8_t mAppDirectDispatchDepth = 0U;
+/* App_Thread is taking messages out of its queues or running their handlers */
+static volatile bool_t mAppThreadBusy = FALSE;
+#endif
+
+#if gAppMsgSlab_d
+/* Size classes of the Host to Application messages, smallest first */
+static appMsgSlabClass_t maAppMsgSlab[gAppMsgSlabClassCount_c];
+/* Messages allocated with MSG_Alloc, because too big or because their classes were empty */
+static uint32_t mAppMsgSlabFallbacks = 0U;
+#endif
+
+#if gAppHostMsgLanes_d
+/* The control lane is the Host to App queue */
+static anchor_t mHostAppDataQueue;
+static anchor_t mHostAppScanQueue;
+
+static anchor_t* const maHostAppLanes[mAppLaneCount_c] = {
+    &mHostAppInputQueue,
+    &mHostAppDataQueue,
+    &mHostAppScanQueue
+};
+
+#if !gAppHostMsgStrictPriority_d
+static const uint8_t maHostAppLaneWeights[mAppLaneCount_c] = {
+    gAppControlLaneWeight_c,
+    gAppDataLaneWeight_c,
+    gAppScanLaneWeight_c
+};
+
+/* Messages left to each lane in the current round, used by the App task only */
+static uint8_t maHostAppLaneCredits[mAppLaneCount_c];
+#endif
+#endif
+
+#if gAppScanCache_d
+/* Advertising report cache, used by the Host task only */
+static appScanCacheEntry_t mAppScanCache[gAppScanCacheSize_c];
+static appScanCacheStats_t mAppScanCacheStats;
+#endif
+
+#if gAppHostMsgCoalesce_d
+/* State events that can still be replaced */
+static appMsgCoalesceSlot_t maAppCoalesceSlots[gAppHostMsgCoalesceSlots_c];
+static appHostMsgCoalesceStats_t mAppCoalesceStats;
+#endif
+
+#if gAppThreadStats_d
+/* Written by App_Thread only */
+static appThreadStats_t mAppThreadStats;
+#endif
+
 static gapGenericCallback_t pfGenericCallback = NULL;
 static gapAdvertisingCallback_t pfAdvCallback = NULL;
 static gapScanningCallback_t pfScanCallback = NULL;
@@ -508,6 +839,10 @@ void main_task(uint32_t param)
         NV_Init();
 #endif
         TMR_Init();
+#if gAppTimerWheel_d
+        /* All the delayed application callbacks share one low power timer */
+        (void)App_TimerWheelInit();
+#endif
 
         /* Cryptographic and RNG hardware initialization */
   #if defined(MULTICORE_CONNECTIVITY_CORE) && (MULTICORE_CONNECTIVITY_CORE)
@@ -616,9 +951,22 @@ void main_task(uint32_t param)
         /* Prepare application input queue.*/
         MSG_InitQueue(&mHostAppInputQueue);
 
+#if gAppHostMsgLanes_d
+        MSG_InitQueue(&mHostAppDataQueue);
+        MSG_InitQueue(&mHostAppScanQueue);
+#endif
+
         /* Prepare callback input queue.*/
         MSG_InitQueue(&mAppCbInputQueue);
 
+#if (gAppScanReportPoolSize_c > 0U)
+        MSG_InitQueue(&mAppScanReportFreeList);
+#endif
+
+#if gAppMsgSlab_d
+        App_MsgSlabInit();
+#endif
+
         App_NvmInit();
 
 #if defined (gMWS_UseCoexistence_d) && (gMWS_UseCoexistence_d)
@@ -664,12 +1012,17 @@ void main_task(uint32_t param)
 *         include timers, messages and any other user defined events.
 * \param[in]  argument
 *
-* \remarks  For bare-metal, process only one type of message at a time,
+* \remarks  At most gAppThreadMsgBudget_c messages are processed on each run,
 *           to allow other higher priority task to run.
 *
 ********************************************************************************** */
 void App_Thread (uint32_t param)
 {
+    uint32_t budget;
+    bool_t   pending;
+#if (gAppThreadTimeBudgetUs_c > 0U)
+    uint64_t startTime;
+#endif
 #if !defined(gHybridApp_d) || (!gHybridApp_d)
     osaEventFlags_t event = 0U;
 
@@ -679,47 +1032,74 @@ void App_Thread (uint32_t param)
 #else
     {
 #endif /* gHybridApp_d */
-        /* Check for existing messages in queue */
-        if (MSG_Pending(&mHostAppInputQueue))
+#if (gAppThreadTimeBudgetUs_c > 0U)
+        startTime = TMR_GetTimestamp();
+#endif
+        budget = gAppThreadMsgBudget_c;
+
+#if (gAppDirectDispatchMask_c != 0U)
+        /* Set before any message leaves its queue, so a direct handler never overtakes it
+           nor runs at the same time as the handlers of the Application Task */
+        mAppThreadBusy = TRUE;
+#endif
+
+        /* Take the messages in turn from both queues until they are empty or the budget is spent */
+        pending = TRUE;
+        while (pending && (budget > 0U))
         {
-            /* Pointer for storing the messages from host. */
-            appMsgFromHost_t *pMsgIn = MSG_DeQueue(&mHostAppInputQueue);
+            pending = FALSE;
 
-            if (pMsgIn != NULL)
+            if (App_ProcessHostMessage())
             {
-                /* Process it */
-                App_HandleHostMessageInput(pMsgIn);
-
-                /* Messages must always be freed. */
-                (void)MSG_Free(pMsgIn);
+                pending = TRUE;
+                budget--;
             }
-        }
 
-        /* Check for existing messages in queue */
-        if (MSG_Pending(&mAppCbInputQueue))
-        {
-            /* Pointer for storing the callback messages. */
-            appMsgCallback_t *pMsgIn = MSG_DeQueue(&mAppCbInputQueue);
+            if ((budget > 0U) && App_ProcessCallbackMessage())
+            {
+                pending = TRUE;
+                budget--;
+            }
 
-            if (pMsgIn != NULL)
+#if (gAppThreadTimeBudgetUs_c > 0U)
+            if ((TMR_GetTimestamp() - startTime) >= (uint64_t)gAppThreadTimeBudgetUs_c)
             {
-                /* Execute callback handler */
-                if (pMsgIn->handler != NULL)
+#if gAppThreadStats_d
+                if (pending && (budget > 0U))
                 {
-                    pMsgIn->handler(pMsgIn->param);
+                    mAppThreadStats.timeStops++;
                 }
-
-                /* Messages must always be freed. */
-                (void)MSG_Free(pMsgIn);
+#endif
+                break;
             }
+#endif
         }
+
+#if (gAppDirectDispatchMask_c != 0U)
+        mAppThreadBusy = FALSE;
+#endif
+
+#if gAppThreadStats_d
+        OSA_InterruptDisable();
+        mAppThreadStats.wakeups++;
+        mAppThreadStats.messages += gAppThreadMsgBudget_c - budget;
+        if (budget == 0U)
+        {
+            mAppThreadStats.budgetStops++;
+        }
+        OSA_InterruptEnable();
+#endif
+
 #if !defined(gHybridApp_d) || (!gHybridApp_d)
         /* Signal the App_Thread again if there are more messages pending */
-        event = MSG_Pending(&mHostAppInputQueue) ? gAppEvtMsgFromHostStack_c : 0U;
+        event = App_HostMessagePending() ? gAppEvtMsgFromHostStack_c : 0U;
         event |= MSG_Pending(&mAppCbInputQueue) ? gAppEvtAppCallback_c : 0U;
 
         if (event != 0U)
         {
+#if gAppThreadStats_d
+            mAppThreadStats.resignals++;
+#endif
             (void)OSA_EventSet(mAppEvent, gAppEvtAppCallback_c);
         }
 
@@ -732,1252 +1112,2519 @@ void App_Thread (uint32_t param)
     }
 }
 
-/*
-* board_specific_action_on_idle is declared weak.
-* Its actual implementation is expected in borad.c
-*/
-WEAK void board_specific_action_on_idle(void)
-{
-}
-
-#ifdef CPU_QN908X
-#if (defined(BOARD_XTAL1_CLK_HZ) && (BOARD_XTAL1_CLK_HZ != CLK_XTAL_32KHZ))
-#if (defined(CFG_CALIBRATION_ON_IDLE_TASK) && (CFG_CALIBRATION_ON_IDLE_TASK > 0))
-static void App_Rco32KCalibrate(void)
-{
-    if(gRco32kCalibrationRequest)
-    {
-        /* perform RCO32K calibration */
-        RCO32K_Calibrate();
-        /* clear the calibration request flag */
-        gRco32kCalibrationRequest = FALSE;
-    }
-}
-#endif /* CFG_CALIBRATION_ON_IDLE_TASK */
-#endif /* BOARD_XTAL1_CLK_HZ != CLK_XTAL_32KHZ */
-#endif /* CPU_QN908X */
-
-#ifndef DUAL_MODE_APP
-#if (IdleTaskAct_c & IdleTask_LowPower_c )
 /*! *********************************************************************************
-* \brief The idle task is created when applications enable the usage of the Framework
-*        Low-Power module
+* \brief  Handles the oldest message received from the Host, if any.
 *
-* \param[in] none
+* \return  TRUE if a message was handled.
 *
-* \return  none
 ********************************************************************************** */
-static void App_Idle(void)
+static bool_t App_ProcessHostMessage(void)
 {
-#if defined(cPWR_UsePowerDownMode) && (cPWR_UsePowerDownMode)
-
-    OSA_InterruptDisable();
-
-#if USE_RTOS == 0
-    if(!OSA_TaskShouldYield())
+    /* Pointer for storing the messages from host. */
+    appMsgFromHost_t *pMsgIn;
+    uint32_t msgTag;
+#if gAppHostMsgCoalesce_d
+    uint32_t i;
 #endif
-    {
-        int ret = PWR_CheckIfDeviceCanGoToSleepExt();
 
-        if( ret == kPmPowerDown0 || ret == kPmPowerDown1)
-        {
-            /* Enter Low Power */
-            (void)PWR_EnterLowPower();
-
-#if gFSCI_IncludeLpmCommands_c
-            /* Send Wake Up indication to FSCI */
-            FSCI_SendWakeUpIndication();
+#if gAppHostMsgLanes_d
+    uint32_t lane;
+#if !gAppHostMsgStrictPriority_d
+    uint32_t round;
 #endif
 
-#if gKBD_KeysCount_c > 0
-#if !defined(CPU_JN518X)   // ON QN9090, PWR will directly notify the GPIO module for the source of IO wakeup
-            /* Woke up on Keyboard Press */
-            if(PWRLib_MCU_WakeupReason.Bits.FromKeyBoard != 0U)
+    pMsgIn = NULL;
+
+#if gAppHostMsgStrictPriority_d
+    for (lane = mAppControlLane_c; (lane < mAppLaneCount_c) && (pMsgIn == NULL); lane++)
+    {
+        pMsgIn = MSG_DeQueue(maHostAppLanes[lane]);
+    }
+#else
+    /* A new round starts when the lanes with messages have used their credits */
+    for (round = 0U; (round < 2U) && (pMsgIn == NULL); round++)
+    {
+        for (lane = mAppControlLane_c; (lane < mAppLaneCount_c) && (pMsgIn == NULL); lane++)
+        {
+            if ((maHostAppLaneCredits[lane] > 0U) && MSG_Pending(maHostAppLanes[lane]))
             {
-  #if defined(cPWR_EnableDeepSleepMode_8) && (cPWR_EnableDeepSleepMode_8)
-                /* Skip over the key scan timer to improve low power consumption. */
-                BleApp_HandleKeys(gKBD_EventPressPB1_c);
-  #else
-                KBD_SwitchPressedOnWakeUp();
-  #endif
+                pMsgIn = MSG_DeQueue(maHostAppLanes[lane]);
+                maHostAppLaneCredits[lane]--;
             }
-#endif  /*  !defined(CPU_JN518X) */
-#endif  /* gKBD_KeysCount_c */
         }
-        else if ( (ret == kPmSleep) || ( ret < 0) )
+
+        if (pMsgIn == NULL)
         {
-            /* Enter MCU Sleep */
-            PWR_EnterSleep();
+            FLib_MemCpy(maHostAppLaneCredits, maHostAppLaneWeights, sizeof(maHostAppLaneCredits));
         }
     }
-    OSA_InterruptEnable();
+#endif /* gAppHostMsgStrictPriority_d */
 
 #else
+    /* Check for existing messages in queue */
+    if (!MSG_Pending(&mHostAppInputQueue))
+    {
+        return FALSE;
+    }
 
-    /* check if any Radio calibration is needed, it requires asking for a dry run BLE sleep */
-    if(XCVR_GetRecalDuration())
+    pMsgIn = MSG_DeQueue(&mHostAppInputQueue);
+#endif /* gAppHostMsgLanes_d */
+
+    if (pMsgIn == NULL)
     {
-        BLE_get_sleep_mode();
+        return FALSE;
     }
-#endif /* cPWR_UsePowerDownMode */
-}
-#endif /*  (IdleTaskAct_c & IdleTask_LowPower_c) */
-#endif /* DUAL_MODE_APP */
 
-#if (gMaxBondedDevices_c > 0) && (gAppUseBonding_d)
+#if gAppWriteBatch_d
+    /* No write can be appended once the batch is out of the queue */
+    OSA_InterruptDisable();
+    if (mpAppWriteBatch == pMsgIn)
+    {
+        mpAppWriteBatch = NULL;
+    }
+    OSA_InterruptEnable();
+#endif
+
+#if gAppHostMsgCoalesce_d
+    /* The event is about to be read, it can no longer be replaced */
+    OSA_InterruptDisable();
+    for (i = 0U; i < gAppHostMsgCoalesceSlots_c; i++)
+    {
+        if (maAppCoalesceSlots[i].pMsg == pMsgIn)
+        {
+            maAppCoalesceSlots[i].pMsg = NULL;
+        }
+    }
+    OSA_InterruptEnable();
+#endif
+
+    msgTag = pMsgIn->msgType & ~mAppMsgTypeMask_c;
+    pMsgIn->msgType &= mAppMsgTypeMask_c;
+
+    /* Process it */
+    App_HandleHostMessageInput(pMsgIn);
+
+    /* Messages must always be freed. */
+    App_MsgFree(pMsgIn, msgTag);
+
+    return TRUE;
+}
 
 /*! *********************************************************************************
-* \brief Save Bonding Entries in NVM if updated
+* \brief  Puts a message from the Host in its queue and signals the App_Thread.
 *
-* \param[in] fullEntries  set in case all entries need to be saved
+* \param[in]  pMsgIn  Message from the Host
 *
-* \return  none
 ********************************************************************************** */
-static void AppSaveBondingInfo(bool_t fullEntries)
+static void App_QueueHostMessage(appMsgFromHost_t* pMsgIn)
 {
+    OSA_InterruptDisable();
+    App_EnqueueHostMessage(pMsgIn);
+    OSA_InterruptEnable();
 
-    #define PDM_UPDATE_RECORD_TIME_US 8000
+    (void)OSA_EventSet(mAppEvent, gAppEvtMsgFromHostStack_c);
+}
 
-    uint16_t i;
-    PDM_teStatus  pdmSt;
-    OSA_MutexLock(bondingMutex, osaWaitForever_c);
+/*! *********************************************************************************
+* \brief  Puts a message from the Host in its queue.
+*
+* \param[in]  pMsgIn  Message from the Host
+*
+* \pre Called with interrupts disabled. The App_Thread must be signaled afterwards.
+*
+********************************************************************************** */
+static void App_EnqueueHostMessage(appMsgFromHost_t* pMsgIn)
+{
+#if gAppHostMsgLanes_d
+    appHostMsgLane_t lane;
 
-    for (i=0; i<gMaxBondedDevices_c; i++)
+    switch (pMsgIn->msgType & mAppMsgTypeMask_c)
     {
-        if (bondEntries[i].nbRamWrite > 0)
-        {
-            if(fullEntries==FALSE)
-            {
-                 uint32_t nextBleEventValue = BLE_TimeBeforeNextBleEvent();
+        case (uint32_t)gAppGapScanMsg_c:
+            lane = mAppScanLane_c;
+            break;
 
-                /* Avoid to block the LL during PDM save record
-                 * PDM_eSaveRecordData could take up to 8ms to save a 1 page record so we need to
-                 * make sure that no LL event is scheduled during a call to SaveRecordData
-                 */
-                if (nextBleEventValue < PDM_UPDATE_RECORD_TIME_US)
-                {
-                    break;
-                }
+        case (uint32_t)gAppGattServerMsg_c:
+        case (uint32_t)gAppGattServerWriteBatchMsg_c:
+        case (uint32_t)gAppGattClientNotificationMsg_c:
+        case (uint32_t)gAppGattClientIndicationMsg_c:
+        case (uint32_t)gAppL2caLeDataMsg_c:
+        case (uint32_t)gAppNotifRingDrainMsg_c:
+            lane = mAppDataLane_c;
+            break;
 
-                APP_DBG_LOG("nextBleEventValue = %d",nextBleEventValue);
-            }
-            APP_DBG_LOG("entry (%d) will be saved in PDM nbRamWrite = %d",i,bondEntries[i].nbRamWrite);
-            bondEntries[i].nbRamWrite = 0;
-            pdmSt = PDM_eSaveRecordData(bondEntries[i].pdmId,
-                                                  &bondEntries[i],
-                                                  sizeof(bleBondDeviceEntry));
-            NOT_USED(pdmSt);
-            assert(pdmSt == PDM_E_STATUS_OK);
-            if(fullEntries==FALSE)
-            {
-                break;
-            }
-        }
-    }
-    OSA_MutexUnlock(bondingMutex);
+        case (uint32_t)gAppGapConnectionMsg_c:
+            /* The application gets the data of the peer before its disconnection */
+            lane = (pMsgIn->msgData.connMsg.connEvent.eventType == gConnEvtDisconnected_c) ?
+                   mAppDataLane_c : mAppControlLane_c;
+            break;
 
-}
-#endif
-#if (IdleTaskAct_c != 0)
-/*
- * Treatment to be executed in Idle
- * - With an RTOS whether from the vApplicationIdleHook function or from a
- * dedicated task.
- * - in Bare metal mode  from the OSA Idle Task
- */
-static void AppIdleCommon(void)
-{
-#if (gMaxBondedDevices_c > 0) && (gAppUseBonding_d)
-    AppSaveBondingInfo(FALSE);
+        default:
+            /* Generic, connection, advertising, procedure, L2CAP control and security events */
+            lane = mAppControlLane_c;
+            break;
+    }
 #endif
-    /* do ADC measurements before going to low power */
-#if gAdcUsed_d
-    BOARD_ADCMeasure();
+
+#if gAppNotifRing_d
+    /* A ring marker leaves the other markers open */
+    if ((pMsgIn->msgType & mAppMsgTypeMask_c) != (uint32_t)gAppNotifRingDrainMsg_c)
 #endif
+    {
+        App_CloseHostMessageAppends();
+    }
 
-#if   (IdleTaskAct_c & IdleTask_BoardSpecific_c )
-    board_specific_action_on_idle();
+#if gAppWriteBatch_d
+    /* A batch is open until another event is queued after it */
+    mpAppWriteBatch = ((pMsgIn->msgType & mAppMsgTypeMask_c) == (uint32_t)gAppGattServerWriteBatchMsg_c) ?
+                      pMsgIn : NULL;
 #endif
 
-#if (IdleTaskAct_c & IdleTask_DualMode_c )
-        dm_switch_IdleTask();
-#elif (IdleTaskAct_c & IdleTask_LowPower_c )
-    App_Idle();
+#if gAppHostMsgLanes_d
+    (void)MSG_Queue(maHostAppLanes[lane], pMsgIn);
+#else
+    (void)MSG_Queue(&mHostAppInputQueue, pMsgIn);
 #endif
 }
 
-#if (mAppIdleHook_c)
 /*! *********************************************************************************
-* \brief Is linked by the application in order to hook the idle task
+* \brief  Stops appending to the messages already queued, because a newer event is
+*         queued: the write batch and the notification ring markers.
 *
-* \param[in] none
+* \pre Called with interrupts disabled.
 *
-* \return  none
 ********************************************************************************** */
-
-void vApplicationIdleHook(void)
+static void App_CloseHostMessageAppends(void)
 {
-#ifdef CPU_QN908X
-#if (defined(BOARD_XTAL1_CLK_HZ) && (BOARD_XTAL1_CLK_HZ != CLK_XTAL_32KHZ))
-#if (defined(CFG_CALIBRATION_ON_IDLE_TASK) && (CFG_CALIBRATION_ON_IDLE_TASK > 0))
-    App_Rco32KCalibrate();
-#endif /* CFG_CALIBRATION_ON_IDLE_TASK */
-#endif /* BOARD_XTAL1_CLK_HZ != CLK_XTAL_32KHZ */
-#endif /* CPU_QN908X */
+#if gAppNotifRing_d
+    uint32_t i;
+#endif
 
-    LpIoSet(1, 1);
-    AppIdleCommon();
-    LpIoSet(1, 0);
-}
+#if gAppWriteBatch_d
+    mpAppWriteBatch = NULL;
+#endif
 
-#else /* mAppIdleHook_c */
-static void App_Idle_Task(osaTaskParam_t argument)
-{
-    for (;;)
+#if gAppNotifRing_d
+    /* Values stored from now on must be given after this event: they need a new marker */
+    for (i = 0U; i < gAppMaxConnections_c; i++)
     {
-#ifdef CPU_QN908X
-#if (defined(BOARD_XTAL1_CLK_HZ) && (BOARD_XTAL1_CLK_HZ != CLK_XTAL_32KHZ))
-#if (defined(CFG_CALIBRATION_ON_IDLE_TASK) && (CFG_CALIBRATION_ON_IDLE_TASK > 0))
-        App_Rco32KCalibrate();
-#endif /* CFG_CALIBRATION_ON_IDLE_TASK */
-#endif /* BOARD_XTAL1_CLK_HZ != CLK_XTAL_32KHZ */
-#endif /* CPU_QN908X */
-        AppIdleCommon();
-
-        /* For BareMetal break the while(1) after 1 run */
-        if (gUseRtos_c == 0U)
-        {
-            break;
-        }
+        maAppNotifRings[i].pMarker = NULL;
     }
+#endif
 }
 
 /*! *********************************************************************************
-* \brief Initializes task
-*
-* \param[in]  none
+* \brief  Tells if messages from the Host are waiting for the App_Thread.
 *
-* \return  osaStatus_Error or osaStatus_Success.
+* \return  TRUE if a queue holds messages.
 *
 ********************************************************************************** */
-#ifndef DUAL_MODE_APP
-static osaStatus_t AppIdle_TaskInit(void)
+static bool_t App_HostMessagePending(void)
+{
+    bool_t pending;
+
+#if gAppHostMsgLanes_d
+    pending = (MSG_Pending(&mHostAppInputQueue) || MSG_Pending(&mHostAppDataQueue) ||
+               MSG_Pending(&mHostAppScanQueue));
 #else
-osaStatus_t AppIdle_TaskInit(void)
+    pending = MSG_Pending(&mHostAppInputQueue);
+#endif
+
+#if gAppNotifRing_d
+    pending = pending || App_NotifRingPending();
 #endif
+
+    return pending;
+}
+
+/*! *********************************************************************************
+* \brief  Allocates a message for the App_Thread.
+*
+* \param[in]  msgType  Type of the message
+* \param[in]  msgLen   Size of the message
+*
+* \return  Pointer to the message, with its type set, or NULL.
+*
+* \remarks With gAppMsgSlab_d, the message is taken from the smallest size class
+*          it fits in that has a free block, else from the MemManager.
+*
+********************************************************************************** */
+static appMsgFromHost_t* App_MsgAlloc(uint32_t msgType, uint32_t msgLen)
 {
-    osaStatus_t st;
-    do {
-        if(NULL != mAppIdleTaskId)
+    appMsgFromHost_t *pMsgIn = NULL;
+#if gAppMsgSlab_d
+    appMsgSlabClass_t *pClass;
+    uint32_t i;
+
+    for (i = 0U; (i < gAppMsgSlabClassCount_c) && (pMsgIn == NULL); i++)
+    {
+        pClass = &maAppMsgSlab[i];
+
+        if (msgLen <= pClass->blockSize)
         {
-            st = osaStatus_Error;
-            break;
+            pMsgIn = MSG_DeQueue(&pClass->freeList);
         }
 
-    /* Task creation */
-        mAppIdleTaskId = OSA_TaskCreate(OSA_TASK(App_Idle_Task), NULL);
+        if (pMsgIn != NULL)
+        {
+            msgType |= (i + 1U) << mAppMsgSlabShift_c;
 
-        if( NULL == mAppIdleTaskId )
+            OSA_InterruptDisable();
+            pClass->inUse++;
+            if (pClass->inUse > pClass->maxInUse)
+            {
+                pClass->maxInUse = pClass->inUse;
+            }
+            OSA_InterruptEnable();
+        }
+    }
+
+    if (pMsgIn == NULL)
+    {
+        pMsgIn = MSG_Alloc(msgLen);
+
+        if (pMsgIn != NULL)
         {
-            panic(0,0,0,0);
-            st = osaStatus_Error;
-            break;
+            OSA_InterruptDisable();
+            mAppMsgSlabFallbacks++;
+            OSA_InterruptEnable();
         }
-        st = osaStatus_Success;
-    } while (0);
-    return st;
-}
-#endif /* mAppIdleHook_c */
-#endif /*IdleTaskAct_c != 0 */
+    }
+#else
+    pMsgIn = MSG_Alloc(msgLen);
+#endif /* gAppMsgSlab_d */
+
+    if (pMsgIn != NULL)
+    {
+        pMsgIn->msgType = msgType;
+    }
 
+    return pMsgIn;
+}
 
 /*! *********************************************************************************
-* \brief  Application wrapper function for Gap_Connect.
+* \brief  Frees a message handled by the App_Thread.
 *
-* \param[in] pParameters  Connection Request parameters
-* \param[in] connCallback Callback used to receive connection events.
-*
-* \return  gBleSuccess_c or error.
+* \param[in]  pMsgIn  Message
+* \param[in]  msgTag  Upper bits of the message type, set when it was allocated
 *
 ********************************************************************************** */
-bleResult_t App_Connect(
-    gapConnectionRequestParameters_t*   pParameters,
-    gapConnectionCallback_t             connCallback
-)
+static void App_MsgFree(appMsgFromHost_t* pMsgIn, uint32_t msgTag)
 {
-    pfConnCallback = connCallback;
+#if gAppMsgSlab_d
+    appMsgSlabClass_t *pClass;
+    uint32_t sizeClass = (msgTag & mAppMsgSlabMask_c) >> mAppMsgSlabShift_c;
 
-    return Gap_Connect(pParameters, App_ConnectionCallback);
+    if (sizeClass != 0U)
+    {
+        pClass = &maAppMsgSlab[sizeClass - 1U];
+
+        OSA_InterruptDisable();
+        pClass->inUse--;
+        OSA_InterruptEnable();
+
+        (void)MSG_Queue(&pClass->freeList, pMsgIn);
+        return;
+    }
+#endif
+
+#if (gAppScanReportPoolSize_c > 0U)
+    if ((msgTag & mAppMsgPooled_c) != 0U)
+    {
+        /* Keep the message for the next scan report */
+        (void)MSG_Queue(&mAppScanReportFreeList, pMsgIn);
+        return;
+    }
+#endif
+
+    (void)MSG_Free(pMsgIn);
 }
 
+#if gAppMsgSlab_d
 /*! *********************************************************************************
-* \brief  Application wrapper function for Gap_StartAdvertising.
-*
-* \param[in] advertisingCallback   Callback used by the application to receive advertising events.
-*                                  Can be NULL.
-* \param[in] connectionCallback    Callback used by the application to receive connection events.
-*                                  Can be NULL.
+* \brief  Allocates the blocks of the Host to Application message size classes.
 *
-* \return  gBleSuccess_c or error.
+* \remarks The blocks are taken from the MemManager once and are never freed.
 *
 ********************************************************************************** */
-bleResult_t App_StartAdvertising(
-    gapAdvertisingCallback_t    advertisingCallback,
-    gapConnectionCallback_t     connectionCallback
-)
+static void App_MsgSlabInit(void)
 {
-    pfAdvCallback = advertisingCallback;
-    pfConnCallback = connectionCallback;
+    static const uint16_t aPayloads[gAppMsgSlabClassCount_c] = {
+        gAppMsgSlabPayload0_c, gAppMsgSlabPayload1_c, gAppMsgSlabPayload2_c
+    };
+    static const uint16_t aBlocks[gAppMsgSlabClassCount_c] = {
+        gAppMsgSlabBlocks0_c, gAppMsgSlabBlocks1_c, gAppMsgSlabBlocks2_c
+    };
+    appMsgSlabClass_t *pClass;
+    void *pBlock;
+    uint32_t i;
+    uint32_t j;
+
+    for (i = 0U; i < gAppMsgSlabClassCount_c; i++)
+    {
+        pClass = &maAppMsgSlab[i];
+        MSG_InitQueue(&pClass->freeList);
+        pClass->blockSize = (uint16_t)(sizeof(appMsgFromHost_t) + aPayloads[i]);
 
-    return Gap_StartAdvertising(App_AdvertisingCallback, App_ConnectionCallback);
+        for (j = 0U; j < aBlocks[i]; j++)
+        {
+            pBlock = MSG_Alloc(pClass->blockSize);
+
+            if (pBlock == NULL)
+            {
+                break;
+            }
+
+            (void)MSG_Queue(&pClass->freeList, pBlock);
+            pClass->blocks++;
+        }
+    }
 }
 
 /*! *********************************************************************************
-* \brief  Application wrapper function for Gap_StartExtAdvertising.
-*
-* \param[in] advertisingCallback   Callback used by the application to receive advertising events.
-*                                  Can be NULL.
-* \param[in] connectionCallback    Callback used by the application to receive connection events.
-*                                  Can be NULL.
-* \param[in] handle                The ID of the advertising set
-* \param[in] duration              The duration of the advertising
-* \param[in] maxExtAdvEvents       The maximum number of advertising events
+* \brief  Returns the counters of the Host to Application message size classes.
 *
-* \return  gBleSuccess_c or error.
+* \param[out] aClasses    Counters of each size class, smallest first
+* \param[out] pFallbacks  Messages allocated from the MemManager
 *
 ********************************************************************************** */
-bleResult_t App_StartExtAdvertising(
-    gapAdvertisingCallback_t    advertisingCallback,
-    gapConnectionCallback_t     connectionCallback,
-    uint8_t                     handle,
-    uint16_t                    duration,
-    uint8_t                     maxExtAdvEvents
+void App_MsgSlabGetStats
+(
+    appMsgSlabStats_t   aClasses[gAppMsgSlabClassCount_c],
+    uint32_t*           pFallbacks
 )
 {
-    pfAdvCallback = advertisingCallback;
-    pfConnCallback = connectionCallback;
+    uint32_t i;
 
-    return Gap_StartExtAdvertising(App_AdvertisingCallback, App_ConnectionCallback, handle, duration, maxExtAdvEvents);
+    OSA_InterruptDisable();
+    for (i = 0U; i < gAppMsgSlabClassCount_c; i++)
+    {
+        aClasses[i].blockSize = maAppMsgSlab[i].blockSize;
+        aClasses[i].blocks = maAppMsgSlab[i].blocks;
+        aClasses[i].inUse = maAppMsgSlab[i].inUse;
+        aClasses[i].maxInUse = maAppMsgSlab[i].maxInUse;
+    }
+    *pFallbacks = mAppMsgSlabFallbacks;
+    OSA_InterruptEnable();
 }
+#endif /* gAppMsgSlab_d */
 
+#if (gAppDirectDispatchMask_c != 0U)
 /*! *********************************************************************************
-* \brief  Application wrapper function for Gap_StartScanning.
-*
-* \param[in] pScanningParameters    The scanning parameters; may be NULL.
-* \param[in] scanningCallback       The scanning callback.
-* \param[in] enableFilterDuplicates Enable duplicate advertising reports filtering
-* \param[in] duration               Scan duration
-* \param[in] period                 Scan period
+* \brief  Tells if a Host event can be given to its application handler directly.
 *
-* \return    gBleSuccess_c or error.
+* \return  TRUE if the handler can be called. App_DirectDispatchExit() must be
+*          called when it returns.
 *
 ********************************************************************************** */
-bleResult_t App_StartScanning(
-    gapScanningParameters_t*    pScanningParameters,
-    gapScanningCallback_t       scanningCallback,
-    gapFilterDuplicates_t       enableFilterDuplicates,
-    uint16_t                    duration,
-    uint16_t                    period
-)
+static bool_t App_DirectDispatchEnter(void)
 {
-    pfScanCallback = scanningCallback;
+    /* Keep the order of the events, do not nest handlers calling back into the Host, and
+       do not run alongside the Application Task, its Host messages or its callbacks */
+    if ((mAppDirectDispatchDepth != 0U) || mAppThreadBusy || App_HostMessagePending() ||
+        MSG_Pending(&mAppCbInputQueue))
+    {
+        return FALSE;
+    }
 
-    return Gap_StartScanning(pScanningParameters, App_ScanningCallback,  enableFilterDuplicates, duration, period);
+    /* The handlers need the stack reserved in the Host task, which the Host itself may
+       have used if its callback came deeper than planned */
+    if (Ble_HostTaskStackFree() < (uint32_t)gHost_TaskDirectDispatchStack_c)
+    {
+        return FALSE;
+    }
+
+    mAppDirectDispatchDepth++;
+    return TRUE;
 }
 
 /*! *********************************************************************************
-* \brief  Application wrapper function for GattServer_RegisterCallback.
-*
-* \param[in] serverCallback Application-defined callback to be triggered by this module.
-*
-* \return    gBleSuccess_c or error.
+* \brief  Ends the direct call of an application handler.
 *
 ********************************************************************************** */
-bleResult_t App_RegisterGattServerCallback(gattServerCallback_t  serverCallback)
+static void App_DirectDispatchExit(void)
 {
-    pfGattServerCallback = serverCallback;
-
-    return GattServer_RegisterCallback(App_GattServerCallback);
+    mAppDirectDispatchDepth--;
 }
+#endif /* gAppDirectDispatchMask_c */
 
 /*! *********************************************************************************
-* \brief  Application wrapper function for App_RegisterGattClientProcedureCallback.
-*
-* \param[in] callback Application-defined callback to be triggered by this module.
+* \brief  Runs the oldest application callback, if any.
 *
-* \return    gBleSuccess_c or error.
+* \return  TRUE if a callback message was handled.
 *
 ********************************************************************************** */
-bleResult_t App_RegisterGattClientProcedureCallback(gattClientProcedureCallback_t  callback)
+static bool_t App_ProcessCallbackMessage(void)
 {
-    pfGattClientProcCallback = callback;
+    /* Pointer for storing the callback messages. */
+    appMsgCallback_t *pMsgIn;
 
-    return GattClient_RegisterProcedureCallback(App_GattClientProcedureCallback);
-}
+    /* Check for existing messages in queue */
+    if (!MSG_Pending(&mAppCbInputQueue))
+    {
+        return FALSE;
+    }
 
-/*! *********************************************************************************
-* \brief  Application wrapper function for GattClient_RegisterNotificationCallback.
-*
-* \param[in] callback   Application defined callback to be triggered by this module.
-*
-* \return  gBleSuccess_c or error.
-*
-********************************************************************************** */
-bleResult_t App_RegisterGattClientNotificationCallback(gattClientNotificationCallback_t  callback)
-{
-    pfGattClientNotifCallback = callback;
+    pMsgIn = MSG_DeQueue(&mAppCbInputQueue);
 
-    return GattClient_RegisterNotificationCallback(App_GattClientNotificationCallback);
-}
+    if (pMsgIn == NULL)
+    {
+        return FALSE;
+    }
 
-/*! *********************************************************************************
-* \brief  Application wrapper function for GattClient_RegisterIndicationCallback.
-*
-* \param[in] callback   Application defined callback to be triggered by this module.
-*
-* \return  gBleSuccess_c or error.
-*
-********************************************************************************** */
-bleResult_t App_RegisterGattClientIndicationCallback(gattClientIndicationCallback_t  callback)
-{
-    pfGattClientIndCallback = callback;
+    /* Execute callback handler */
+    if (pMsgIn->handler != NULL)
+    {
+        pMsgIn->handler(pMsgIn->param);
+    }
 
-    return GattClient_RegisterIndicationCallback(App_GattClientIndicationCallback);
+    /* Messages must always be freed. */
+    (void)MSG_Free(pMsgIn);
+
+    return TRUE;
 }
 
-/*! *********************************************************************************
-* \brief  Application wrapper function for L2ca_RegisterLeCbCallbacks.
-*
-* \param[in] pCallback     L2cap Data Callback
-* \param[in] pCtrlCallback L2cap Control Callback
-*
-* \return  gBleSuccess_c or error.
-*
-********************************************************************************** */
-bleResult_t App_RegisterLeCbCallbacks
-(
-    l2caLeCbDataCallback_t      pCallback,
-    l2caLeCbControlCallback_t   pCtrlCallback
-)
+/*
+* board_specific_action_on_idle is declared weak.
+* Its actual implementation is expected in borad.c
+*/
+WEAK void board_specific_action_on_idle(void)
 {
-    pfL2caLeCbDataCallback = pCallback;
-    pfL2caLeCbControlCallback = pCtrlCallback;
+}
 
-    return L2ca_RegisterLeCbCallbacks(App_L2caLeDataCallback, App_L2caLeControlCallback);
+#ifdef CPU_QN908X
+#if (defined(BOARD_XTAL1_CLK_HZ) && (BOARD_XTAL1_CLK_HZ != CLK_XTAL_32KHZ))
+#if (defined(CFG_CALIBRATION_ON_IDLE_TASK) && (CFG_CALIBRATION_ON_IDLE_TASK > 0))
+static void App_Rco32KCalibrate(void)
+{
+    if(gRco32kCalibrationRequest)
+    {
+        /* perform RCO32K calibration */
+        RCO32K_Calibrate();
+        /* clear the calibration request flag */
+        gRco32kCalibrationRequest = FALSE;
+    }
 }
+#endif /* CFG_CALIBRATION_ON_IDLE_TASK */
+#endif /* BOARD_XTAL1_CLK_HZ != CLK_XTAL_32KHZ */
+#endif /* CPU_QN908X */
 
+#ifndef DUAL_MODE_APP
+#if (IdleTaskAct_c & IdleTask_LowPower_c )
 /*! *********************************************************************************
-* \brief  Posts an application event containing a callback handler and parameter.
-*
-* \param[in] handler Handler function, to be executed when the event is processed.
-* \param[in] param   Parameter for the handler function.
+* \brief The idle task is created when applications enable the usage of the Framework
+*        Low-Power module
 *
-* \return  gBleSuccess_c or error.
+* \param[in] none
 *
+* \return  none
 ********************************************************************************** */
-bleResult_t App_PostCallbackMessage
-(
-    appCallbackHandler_t   handler,
-    appCallbackParam_t     param
-)
+static void App_Idle(void)
 {
-    appMsgCallback_t *pMsgIn = NULL;
+#if defined(cPWR_UsePowerDownMode) && (cPWR_UsePowerDownMode)
 
-    /* Allocate a buffer with enough space to store the packet */
-    pMsgIn = MSG_Alloc(sizeof (appMsgCallback_t));
+    OSA_InterruptDisable();
 
-    if (pMsgIn == NULL)
+#if USE_RTOS == 0
+    if(!OSA_TaskShouldYield())
+#endif
     {
-        return gBleOutOfMemory_c;
-    }
+        int ret = PWR_CheckIfDeviceCanGoToSleepExt();
 
-    pMsgIn->handler = handler;
-    pMsgIn->param = param;
+        if( ret == kPmPowerDown0 || ret == kPmPowerDown1)
+        {
+            /* Enter Low Power */
+            (void)PWR_EnterLowPower();
 
-    /* Put message in the Cb App queue */
-    (void)MSG_Queue(&mAppCbInputQueue, pMsgIn);
+#if gFSCI_IncludeLpmCommands_c
+            /* Send Wake Up indication to FSCI */
+            FSCI_SendWakeUpIndication();
+#endif
 
-    /* Signal application */
-    (void)OSA_EventSet(mAppEvent, gAppEvtAppCallback_c);
+#if gKBD_KeysCount_c > 0
+#if !defined(CPU_JN518X)   // ON QN9090, PWR will directly notify the GPIO module for the source of IO wakeup
+            /* Woke up on Keyboard Press */
+            if(PWRLib_MCU_WakeupReason.Bits.FromKeyBoard != 0U)
+            {
+  #if defined(cPWR_EnableDeepSleepMode_8) && (cPWR_EnableDeepSleepMode_8)
+                /* Skip over the key scan timer to improve low power consumption. */
+                BleApp_HandleKeys(gKBD_EventPressPB1_c);
+  #else
+                KBD_SwitchPressedOnWakeUp();
+  #endif
+            }
+#endif  /*  !defined(CPU_JN518X) */
+#endif  /* gKBD_KeysCount_c */
+        }
+        else if ( (ret == kPmSleep) || ( ret < 0) )
+        {
+            /* Enter MCU Sleep */
+            PWR_EnterSleep();
+        }
+    }
+    OSA_InterruptEnable();
 
-    return gBleSuccess_c;
+#else
+
+    /* check if any Radio calibration is needed, it requires asking for a dry run BLE sleep */
+    if(XCVR_GetRecalDuration())
+    {
+        BLE_get_sleep_mode();
+    }
+#endif /* cPWR_UsePowerDownMode */
 }
+#endif /*  (IdleTaskAct_c & IdleTask_LowPower_c) */
+#endif /* DUAL_MODE_APP */
+
+#if (gMaxBondedDevices_c > 0) && (gAppUseBonding_d)
 
 /*! *********************************************************************************
-* \brief  Initialize bonded devices list and restore bonded data from PDM
+* \brief Save Bonding Entries in NVM if updated
 *
-* \param[in] none
+* \param[in] fullEntries  set in case all entries need to be saved
 *
 * \return  none
-*
 ********************************************************************************** */
-void App_NvmInit(void)
+static void AppSaveBondingInfo(bool_t fullEntries)
 {
-#if (gMaxBondedDevices_c > 0)
-    /* Init the bonded device list */
-    uint16_t i = 0;
+
+    #define PDM_UPDATE_RECORD_TIME_US 8000
+
+    uint16_t i;
     PDM_teStatus  pdmSt;
-    uint16_t pu16DataBytesRead = 0;
-    FLib_MemSet(bondEntries, 0, sizeof(bondEntries));
-    bondingMutex = OSA_MutexCreate();
-    assert(bondingMutex != NULL);
+    OSA_MutexLock(bondingMutex, osaWaitForever_c);
+
     for (i=0; i<gMaxBondedDevices_c; i++)
     {
-        bondEntries[i].pdmId = pdmId_BondEntry0+i;
-        bondEntries[i].nbRamWrite = 0;
-        /* Try to load the data from the PDM */
-        if (PDM_bDoesDataExist(bondEntries[i].pdmId, &pu16DataBytesRead))
+        if (bondEntries[i].nbRamWrite > 0)
         {
-            APP_DBG_LOG("Record = 0x%x loaded", bondEntries[i].pdmId);
-            pdmSt = PDM_eReadDataFromRecord(bondEntries[i].pdmId, &bondEntries[i],
-                                                         sizeof(bleBondDeviceEntry),
-                                                         &pu16DataBytesRead);
+            if(fullEntries==FALSE)
+            {
+                 uint32_t nextBleEventValue = BLE_TimeBeforeNextBleEvent();
+
+                /* Avoid to block the LL during PDM save record
+                 * PDM_eSaveRecordData could take up to 8ms to save a 1 page record so we need to
+                 * make sure that no LL event is scheduled during a call to SaveRecordData
+                 */
+                if (nextBleEventValue < PDM_UPDATE_RECORD_TIME_US)
+                {
+                    break;
+                }
+
+                APP_DBG_LOG("nextBleEventValue = %d",nextBleEventValue);
+            }
+            APP_DBG_LOG("entry (%d) will be saved in PDM nbRamWrite = %d",i,bondEntries[i].nbRamWrite);
+            bondEntries[i].nbRamWrite = 0;
+            pdmSt = PDM_eSaveRecordData(bondEntries[i].pdmId,
+                                                  &bondEntries[i],
+                                                  sizeof(bleBondDeviceEntry));
             NOT_USED(pdmSt);
             assert(pdmSt == PDM_E_STATUS_OK);
-            assert(sizeof(bleBondDeviceEntry) == pu16DataBytesRead);
+            if(fullEntries==FALSE)
+            {
+                break;
+            }
         }
     }
+    OSA_MutexUnlock(bondingMutex);
+
+}
+#endif
+#if (IdleTaskAct_c != 0)
+/*
+ * Treatment to be executed in Idle
+ * - With an RTOS whether from the vApplicationIdleHook function or from a
+ * dedicated task.
+ * - in Bare metal mode  from the OSA Idle Task
+ */
+static void AppIdleCommon(void)
+{
+#if (gMaxBondedDevices_c > 0) && (gAppUseBonding_d)
+    AppSaveBondingInfo(FALSE);
+#endif
+    /* do ADC measurements before going to low power */
+#if gAdcUsed_d
+    BOARD_ADCMeasure();
+#endif
+
+#if   (IdleTaskAct_c & IdleTask_BoardSpecific_c )
+    board_specific_action_on_idle();
+#endif
+
+#if (IdleTaskAct_c & IdleTask_DualMode_c )
+        dm_switch_IdleTask();
+#elif (IdleTaskAct_c & IdleTask_LowPower_c )
+    App_Idle();
 #endif
 }
+
+#if (mAppIdleHook_c)
 /*! *********************************************************************************
-* \brief  Performs NVM erase operation
+* \brief Is linked by the application in order to hook the idle task
 *
-* \param[in] mEntryIdx Bonded device index
+* \param[in] none
 *
 * \return  none
-*
 ********************************************************************************** */
 
-void App_NvmErase(uint8_t mEntryIdx)
+void vApplicationIdleHook(void)
 {
-#if (gMaxBondedDevices_c > 0)
-    APP_DBG_LOG("EntryIdx=%d", mEntryIdx);
-    OSA_MutexLock(bondingMutex, osaWaitForever_c);
-    if(mEntryIdx < (uint8_t)gMaxBondedDevices_c)
-    {
-        /* Check if a write is required */
-        if (!FLib_MemCmpToVal(&bondEntries[mEntryIdx].aBondingHeader, 0, sizeof(bondEntries[mEntryIdx].aBondingHeader)) ||
+#ifdef CPU_QN908X
+#if (defined(BOARD_XTAL1_CLK_HZ) && (BOARD_XTAL1_CLK_HZ != CLK_XTAL_32KHZ))
+#if (defined(CFG_CALIBRATION_ON_IDLE_TASK) && (CFG_CALIBRATION_ON_IDLE_TASK > 0))
+    App_Rco32KCalibrate();
+#endif /* CFG_CALIBRATION_ON_IDLE_TASK */
+#endif /* BOARD_XTAL1_CLK_HZ != CLK_XTAL_32KHZ */
+#endif /* CPU_QN908X */
+
+    LpIoSet(1, 1);
+    AppIdleCommon();
+    LpIoSet(1, 0);
+}
+
+#else /* mAppIdleHook_c */
+static void App_Idle_Task(osaTaskParam_t argument)
+{
+    for (;;)
+    {
+#ifdef CPU_QN908X
+#if (defined(BOARD_XTAL1_CLK_HZ) && (BOARD_XTAL1_CLK_HZ != CLK_XTAL_32KHZ))
+#if (defined(CFG_CALIBRATION_ON_IDLE_TASK) && (CFG_CALIBRATION_ON_IDLE_TASK > 0))
+        App_Rco32KCalibrate();
+#endif /* CFG_CALIBRATION_ON_IDLE_TASK */
+#endif /* BOARD_XTAL1_CLK_HZ != CLK_XTAL_32KHZ */
+#endif /* CPU_QN908X */
+        AppIdleCommon();
+
+        /* For BareMetal break the while(1) after 1 run */
+        if (gUseRtos_c == 0U)
+        {
+            break;
+        }
+    }
+}
+
+/*! *********************************************************************************
+* \brief Initializes task
+*
+* \param[in]  none
+*
+* \return  osaStatus_Error or osaStatus_Success.
+*
+********************************************************************************** */
+#ifndef DUAL_MODE_APP
+static osaStatus_t AppIdle_TaskInit(void)
+#else
+osaStatus_t AppIdle_TaskInit(void)
+#endif
+{
+    osaStatus_t st;
+    do {
+        if(NULL != mAppIdleTaskId)
+        {
+            st = osaStatus_Error;
+            break;
+        }
+
+    /* Task creation */
+        mAppIdleTaskId = OSA_TaskCreate(OSA_TASK(App_Idle_Task), NULL);
+
+        if( NULL == mAppIdleTaskId )
+        {
+            panic(0,0,0,0);
+            st = osaStatus_Error;
+            break;
+        }
+        st = osaStatus_Success;
+    } while (0);
+    return st;
+}
+#endif /* mAppIdleHook_c */
+#endif /*IdleTaskAct_c != 0 */
+
+
+/*! *********************************************************************************
+* \brief  Application wrapper function for Gap_Connect.
+*
+* \param[in] pParameters  Connection Request parameters
+* \param[in] connCallback Callback used to receive connection events.
+*
+* \return  gBleSuccess_c or error.
+*
+********************************************************************************** */
+bleResult_t App_Connect(
+    gapConnectionRequestParameters_t*   pParameters,
+    gapConnectionCallback_t             connCallback
+)
+{
+    pfConnCallback = connCallback;
+
+    return Gap_Connect(pParameters, App_ConnectionCallback);
+}
+
+/*! *********************************************************************************
+* \brief  Application wrapper function for Gap_StartAdvertising.
+*
+* \param[in] advertisingCallback   Callback used by the application to receive advertising events.
+*                                  Can be NULL.
+* \param[in] connectionCallback    Callback used by the application to receive connection events.
+*                                  Can be NULL.
+*
+* \return  gBleSuccess_c or error.
+*
+********************************************************************************** */
+bleResult_t App_StartAdvertising(
+    gapAdvertisingCallback_t    advertisingCallback,
+    gapConnectionCallback_t     connectionCallback
+)
+{
+    pfAdvCallback = advertisingCallback;
+    pfConnCallback = connectionCallback;
+
+    return Gap_StartAdvertising(App_AdvertisingCallback, App_ConnectionCallback);
+}
+
+/*! *********************************************************************************
+* \brief  Application wrapper function for Gap_StartExtAdvertising.
+*
+* \param[in] advertisingCallback   Callback used by the application to receive advertising events.
+*                                  Can be NULL.
+* \param[in] connectionCallback    Callback used by the application to receive connection events.
+*                                  Can be NULL.
+* \param[in] handle                The ID of the advertising set
+* \param[in] duration              The duration of the advertising
+* \param[in] maxExtAdvEvents       The maximum number of advertising events
+*
+* \return  gBleSuccess_c or error.
+*
+********************************************************************************** */
+bleResult_t App_StartExtAdvertising(
+    gapAdvertisingCallback_t    advertisingCallback,
+    gapConnectionCallback_t     connectionCallback,
+    uint8_t                     handle,
+    uint16_t                    duration,
+    uint8_t                     maxExtAdvEvents
+)
+{
+    pfAdvCallback = advertisingCallback;
+    pfConnCallback = connectionCallback;
+
+    return Gap_StartExtAdvertising(App_AdvertisingCallback, App_ConnectionCallback, handle, duration, maxExtAdvEvents);
+}
+
+/*! *********************************************************************************
+* \brief  Application wrapper function for Gap_StartScanning.
+*
+* \param[in] pScanningParameters    The scanning parameters; may be NULL.
+* \param[in] scanningCallback       The scanning callback.
+* \param[in] enableFilterDuplicates Enable duplicate advertising reports filtering
+* \param[in] duration               Scan duration
+* \param[in] period                 Scan period
+*
+* \return    gBleSuccess_c or error.
+*
+********************************************************************************** */
+bleResult_t App_StartScanning(
+    gapScanningParameters_t*    pScanningParameters,
+    gapScanningCallback_t       scanningCallback,
+    gapFilterDuplicates_t       enableFilterDuplicates,
+    uint16_t                    duration,
+    uint16_t                    period
+)
+{
+    pfScanCallback = scanningCallback;
+
+    return Gap_StartScanning(pScanningParameters, App_ScanningCallback,  enableFilterDuplicates, duration, period);
+}
+
+/*! *********************************************************************************
+* \brief  Application wrapper function for GattServer_RegisterCallback.
+*
+* \param[in] serverCallback Application-defined callback to be triggered by this module.
+*
+* \return    gBleSuccess_c or error.
+*
+********************************************************************************** */
+bleResult_t App_RegisterGattServerCallback(gattServerCallback_t  serverCallback)
+{
+    pfGattServerCallback = serverCallback;
+
+    return GattServer_RegisterCallback(App_GattServerCallback);
+}
+
+#if gAppWriteBatch_d
+/*! *********************************************************************************
+* \brief  Registers the handler of the batched writes without response.
+*
+* \param[in] callback Application-defined callback, or NULL.
+*
+* \return    gBleSuccess_c.
+*
+********************************************************************************** */
+bleResult_t App_RegisterGattServerWriteBatchCallback(appGattServerWriteBatchCallback_t callback)
+{
+    pfGattServerWriteBatchCallback = callback;
+
+    return gBleSuccess_c;
+}
+#endif /* gAppWriteBatch_d */
+
+/*! *********************************************************************************
+* \brief  Application wrapper function for App_RegisterGattClientProcedureCallback.
+*
+* \param[in] callback Application-defined callback to be triggered by this module.
+*
+* \return    gBleSuccess_c or error.
+*
+********************************************************************************** */
+bleResult_t App_RegisterGattClientProcedureCallback(gattClientProcedureCallback_t  callback)
+{
+    pfGattClientProcCallback = callback;
+
+    return GattClient_RegisterProcedureCallback(App_GattClientProcedureCallback);
+}
+
+/*! *********************************************************************************
+* \brief  Application wrapper function for GattClient_RegisterNotificationCallback.
+*
+* \param[in] callback   Application defined callback to be triggered by this module.
+*
+* \return  gBleSuccess_c or error.
+*
+********************************************************************************** */
+bleResult_t App_RegisterGattClientNotificationCallback(gattClientNotificationCallback_t  callback)
+{
+    pfGattClientNotifCallback = callback;
+
+    return GattClient_RegisterNotificationCallback(App_GattClientNotificationCallback);
+}
+
+/*! *********************************************************************************
+* \brief  Application wrapper function for GattClient_RegisterIndicationCallback.
+*
+* \param[in] callback   Application defined callback to be triggered by this module.
+*
+* \return  gBleSuccess_c or error.
+*
+********************************************************************************** */
+bleResult_t App_RegisterGattClientIndicationCallback(gattClientIndicationCallback_t  callback)
+{
+    pfGattClientIndCallback = callback;
+
+    return GattClient_RegisterIndicationCallback(App_GattClientIndicationCallback);
+}
+
+/*! *********************************************************************************
+* \brief  Application wrapper function for L2ca_RegisterLeCbCallbacks.
+*
+* \param[in] pCallback     L2cap Data Callback
+* \param[in] pCtrlCallback L2cap Control Callback
+*
+* \return  gBleSuccess_c or error.
+*
+********************************************************************************** */
+bleResult_t App_RegisterLeCbCallbacks
+(
+    l2caLeCbDataCallback_t      pCallback,
+    l2caLeCbControlCallback_t   pCtrlCallback
+)
+{
+    pfL2caLeCbDataCallback = pCallback;
+    pfL2caLeCbControlCallback = pCtrlCallback;
+
+    return L2ca_RegisterLeCbCallbacks(App_L2caLeDataCallback, App_L2caLeControlCallback);
+}
+
+/*! *********************************************************************************
+* \brief  Posts an application event containing a callback handler and parameter.
+*
+* \param[in] handler Handler function, to be executed when the event is processed.
+* \param[in] param   Parameter for the handler function.
+*
+* \return  gBleSuccess_c or error.
+*
+********************************************************************************** */
+bleResult_t App_PostCallbackMessage
+(
+    appCallbackHandler_t   handler,
+    appCallbackParam_t     param
+)
+{
+    appMsgCallback_t *pMsgIn = NULL;
+
+    /* Allocate a buffer with enough space to store the packet */
+    pMsgIn = MSG_Alloc(sizeof (appMsgCallback_t));
+
+    if (pMsgIn == NULL)
+    {
+        return gBleOutOfMemory_c;
+    }
+
+    pMsgIn->handler = handler;
+    pMsgIn->param = param;
+
+    /* Put message in the Cb App queue */
+    (void)MSG_Queue(&mAppCbInputQueue, pMsgIn);
+
+    /* Signal application */
+    (void)OSA_EventSet(mAppEvent, gAppEvtAppCallback_c);
+
+    return gBleSuccess_c;
+}
+
+/*! *********************************************************************************
+* \brief  Initialize bonded devices list and restore bonded data from PDM
+*
+* \param[in] none
+*
+* \return  none
+*
+********************************************************************************** */
+void App_NvmInit(void)
+{
+#if (gMaxBondedDevices_c > 0)
+    /* Init the bonded device list */
+    uint16_t i = 0;
+    PDM_teStatus  pdmSt;
+    uint16_t pu16DataBytesRead = 0;
+    FLib_MemSet(bondEntries, 0, sizeof(bondEntries));
+    bondingMutex = OSA_MutexCreate();
+    assert(bondingMutex != NULL);
+    for (i=0; i<gMaxBondedDevices_c; i++)
+    {
+        bondEntries[i].pdmId = pdmId_BondEntry0+i;
+        bondEntries[i].nbRamWrite = 0;
+        /* Try to load the data from the PDM */
+        if (PDM_bDoesDataExist(bondEntries[i].pdmId, &pu16DataBytesRead))
+        {
+            APP_DBG_LOG("Record = 0x%x loaded", bondEntries[i].pdmId);
+            pdmSt = PDM_eReadDataFromRecord(bondEntries[i].pdmId, &bondEntries[i],
+                                                         sizeof(bleBondDeviceEntry),
+                                                         &pu16DataBytesRead);
+            NOT_USED(pdmSt);
+            assert(pdmSt == PDM_E_STATUS_OK);
+            assert(sizeof(bleBondDeviceEntry) == pu16DataBytesRead);
+        }
+    }
+#endif
+}
+/*! *********************************************************************************
+* \brief  Performs NVM erase operation
+*
+* \param[in] mEntryIdx Bonded device index
+*
+* \return  none
+*
+********************************************************************************** */
+
+void App_NvmErase(uint8_t mEntryIdx)
+{
+#if (gMaxBondedDevices_c > 0)
+    APP_DBG_LOG("EntryIdx=%d", mEntryIdx);
+    OSA_MutexLock(bondingMutex, osaWaitForever_c);
+    if(mEntryIdx < (uint8_t)gMaxBondedDevices_c)
+    {
+        /* Check if a write is required */
+        if (!FLib_MemCmpToVal(&bondEntries[mEntryIdx].aBondingHeader, 0, sizeof(bondEntries[mEntryIdx].aBondingHeader)) ||
             !FLib_MemCmpToVal(&bondEntries[mEntryIdx].aBondingDataDynamic, 0, sizeof(bondEntries[mEntryIdx].aBondingDataDynamic)) ||
             !FLib_MemCmpToVal(&bondEntries[mEntryIdx].aBondingDataStatic, 0, sizeof(bondEntries[mEntryIdx].aBondingDataStatic)) ||
             !FLib_MemCmpToVal(&bondEntries[mEntryIdx].aBondingDataDeviceInfo, 0, sizeof(bondEntries[mEntryIdx].aBondingDataDeviceInfo)) ||
             !FLib_MemCmpToVal(&bondEntries[mEntryIdx].aBondingDataDescriptor[0], 0, sizeof(bondEntries[mEntryIdx].aBondingDataDescriptor)))
         {
-            FLib_MemSet(&bondEntries[mEntryIdx].aBondingHeader, 0, sizeof(bondEntries[mEntryIdx].aBondingHeader));
-            FLib_MemSet(&bondEntries[mEntryIdx].aBondingDataDynamic, 0, sizeof(bondEntries[mEntryIdx].aBondingDataDynamic));
-            FLib_MemSet(&bondEntries[mEntryIdx].aBondingDataStatic, 0, sizeof(bondEntries[mEntryIdx].aBondingDataStatic));
-            FLib_MemSet(&bondEntries[mEntryIdx].aBondingDataDeviceInfo, 0, sizeof(bondEntries[mEntryIdx].aBondingDataDeviceInfo));
-            FLib_MemSet(&bondEntries[mEntryIdx].aBondingDataDescriptor[0], 0, sizeof(bondEntries[mEntryIdx].aBondingDataDescriptor));
-            bondEntries[mEntryIdx].nbRamWrite++;
+            FLib_MemSet(&bondEntries[mEntryIdx].aBondingHeader, 0, sizeof(bondEntries[mEntryIdx].aBondingHeader));
+            FLib_MemSet(&bondEntries[mEntryIdx].aBondingDataDynamic, 0, sizeof(bondEntries[mEntryIdx].aBondingDataDynamic));
+            FLib_MemSet(&bondEntries[mEntryIdx].aBondingDataStatic, 0, sizeof(bondEntries[mEntryIdx].aBondingDataStatic));
+            FLib_MemSet(&bondEntries[mEntryIdx].aBondingDataDeviceInfo, 0, sizeof(bondEntries[mEntryIdx].aBondingDataDeviceInfo));
+            FLib_MemSet(&bondEntries[mEntryIdx].aBondingDataDescriptor[0], 0, sizeof(bondEntries[mEntryIdx].aBondingDataDescriptor));
+            bondEntries[mEntryIdx].nbRamWrite++;
+        }
+    }
+    OSA_MutexUnlock(bondingMutex);
+#else
+    NOT_USED(mEntryIdx);
+#endif
+    APP_DBG_LOG("==> end");
+}
+
+/*! *********************************************************************************
+* \brief  Performs NVM write operation
+*
+* \param[in] mEntryIdx            Bonded device index
+* \param[in] pBondHeader          Bond Identity Header
+* \param[in] pBondDataDynamic     Bond Data Dynamic
+* \param[in] pBondDataStatic      Bond Data Static
+* \param[in] pBondDataDeviceInfo  Bond Data Device Info
+* \param[in] pBondDataDescriptor  Bond Data Descriptor
+* \param[in] mDescriptorIndex     Descriptor Index
+*
+* \return    none
+*
+********************************************************************************** */
+void App_NvmWrite
+(
+    uint8_t  mEntryIdx,
+    void*    pBondHeader,
+    void*    pBondDataDynamic,
+    void*    pBondDataStatic,
+    void*    pBondDataDeviceInfo,
+    void*    pBondDataDescriptor,
+    uint8_t  mDescriptorIndex
+)
+{
+#if (gMaxBondedDevices_c > 0)
+    APP_DBG_LOG("EntryIdx=%d DescIdx=%d", mEntryIdx, mDescriptorIndex);
+    OSA_MutexLock(bondingMutex, osaWaitForever_c);
+    if(mEntryIdx < (uint8_t)gMaxBondedDevices_c)
+    {
+        if (pBondHeader != NULL)
+        {
+            FLib_MemCpy((void*)&bondEntries[mEntryIdx].aBondingHeader, pBondHeader, sizeof(bondEntries[mEntryIdx].aBondingHeader));
+            bondEntries[mEntryIdx].nbRamWrite++;
+            APP_DBG_LOG("pBondHeader");
+        }
+
+        if (pBondDataDynamic != NULL)
+        {
+            FLib_MemCpy((void*)&bondEntries[mEntryIdx].aBondingDataDynamic, pBondDataDynamic, sizeof(bondEntries[mEntryIdx].aBondingDataDynamic));
+            bondEntries[mEntryIdx].nbRamWrite++;
+            APP_DBG_LOG("pBondDataDynamic");
+        }
+
+        if (pBondDataStatic != NULL)
+        {
+            FLib_MemCpy((void*)&bondEntries[mEntryIdx].aBondingDataStatic, pBondDataStatic, sizeof(bondEntries[mEntryIdx].aBondingDataStatic));
+            bondEntries[mEntryIdx].nbRamWrite++;
+            APP_DBG_LOG("pBondDataStatic");
+        }
+
+        if (pBondDataDeviceInfo != NULL)
+        {
+            FLib_MemCpy((void*)&bondEntries[mEntryIdx].aBondingDataDeviceInfo, pBondDataDeviceInfo, sizeof(bondEntries[mEntryIdx].aBondingDataDeviceInfo));
+            bondEntries[mEntryIdx].nbRamWrite++;
+            APP_DBG_LOG("pBondDataDeviceInfo");
+        }
+
+        if (pBondDataDescriptor != NULL && mDescriptorIndex<gcGapMaximumSavedCccds_c)
+        {
+            FLib_MemCpy((void*)&bondEntries[mEntryIdx].aBondingDataDescriptor[mDescriptorIndex], pBondDataDescriptor, gBleBondDataDescriptorSize_c);
+            bondEntries[mEntryIdx].nbRamWrite++;
+            APP_DBG_LOG("pBondDataDescriptor");
+        }
+    }
+    OSA_MutexUnlock(bondingMutex);
+#else
+    NOT_USED(mEntryIdx);
+    NOT_USED(pBondHeader);
+    NOT_USED(pBondDataDynamic);
+    NOT_USED(pBondDataStatic);
+    NOT_USED(pBondDataDeviceInfo);
+    NOT_USED(pBondDataDescriptor);
+    NOT_USED(mDescriptorIndex);
+#endif
+    APP_DBG_LOG("==> end");
+}
+
+/*! *********************************************************************************
+* \brief  Performs NVM read operation
+*
+* \param[in] mEntryIdx            Bonded device index
+* \param[in] pBondHeader          Bond Identity Header
+* \param[in] pBondDataDynamic     Bond Data Dynamic
+* \param[in] pBondDataStatic      Bond Data Static
+* \param[in] pBondDataDeviceInfo  Bond Data Device Info
+* \param[in] pBondDataDescriptor  Bond Data Descriptor
+* \param[in] mDescriptorIndex     Descriptor Index
+*
+* \return  none
+*
+********************************************************************************** */
+void App_NvmRead
+(
+    uint8_t  mEntryIdx,
+    void*    pBondHeader,
+    void*    pBondDataDynamic,
+    void*    pBondDataStatic,
+    void*    pBondDataDeviceInfo,
+    void*    pBondDataDescriptor,
+    uint8_t  mDescriptorIndex
+)
+{
+#if (gMaxBondedDevices_c > 0)
+    APP_DBG_LOG("EntryIdx=%d DescIdx=%d", mEntryIdx, mDescriptorIndex);
+    OSA_MutexLock(bondingMutex, osaWaitForever_c);
+    if(mEntryIdx < (uint8_t)gMaxBondedDevices_c)
+    {
+        if (pBondHeader != NULL)
+        {
+            FLib_MemCpy(pBondHeader, (void*)&bondEntries[mEntryIdx].aBondingHeader, sizeof(bondEntries[mEntryIdx].aBondingHeader));
+        }
+
+        if (pBondDataDynamic != NULL)
+        {
+            FLib_MemCpy(pBondDataDynamic, (void*)&bondEntries[mEntryIdx].aBondingDataDynamic, sizeof(bondEntries[mEntryIdx].aBondingDataDynamic));
+        }
+
+        if (pBondDataStatic != NULL)
+        {
+            FLib_MemCpy(pBondDataStatic, (void*)&bondEntries[mEntryIdx].aBondingDataStatic, sizeof(bondEntries[mEntryIdx].aBondingDataStatic));
+
+        }
+
+        if (pBondDataDeviceInfo != NULL)
+        {
+            FLib_MemCpy(pBondDataDeviceInfo, (void*)&bondEntries[mEntryIdx].aBondingDataDeviceInfo, sizeof(bondEntries[mEntryIdx].aBondingDataDeviceInfo));
+
+        }
+
+        if (pBondDataDescriptor != NULL && mDescriptorIndex<gcGapMaximumSavedCccds_c)
+        {
+            FLib_MemCpy(pBondDataDescriptor, (void*)&bondEntries[mEntryIdx].aBondingDataDescriptor[mDescriptorIndex], gBleBondDataDescriptorSize_c);
+        }
+    }
+    OSA_MutexUnlock(bondingMutex);
+#else
+    NOT_USED(mEntryIdx);
+    NOT_USED(pBondHeader);
+    NOT_USED(pBondDataDynamic);
+    NOT_USED(pBondDataStatic);
+    NOT_USED(pBondDataDeviceInfo);
+    NOT_USED(pBondDataDescriptor);
+    NOT_USED(mDescriptorIndex);
+#endif
+    APP_DBG_LOG("==> end");
+}
+
+#ifdef PDM_EXT_FLASH
+extern uint8_t EEPROM_isBusy();
+#endif
+/*! *********************************************************************************
+* \brief  Performs all actions needed to processed before reset or low power with RAM off
+*         Mainly store data cached in RAM to reflect updates in NVM
+*         Otherwise updates done in RAM will be lost on Reset or RAM Off
+* \param[in] None
+*
+* \return  none
+*
+********************************************************************************** */
+
+void SafeActions_on_RamOff(void)
+{
+    APP_DBG_LOG("");
+#if (gMaxBondedDevices_c > 0) && (gAppUseBonding_d)
+    /* Ensure that any ongoing write transaction started from the Idle Task  is complete by taking the mutex */
+    OSA_MutexLock(bondingMutex, osaWaitForever_c);
+    /* mask interrupts only after completion : prevent further scheduling before ResetMCU */
+    OSA_InterruptDisable();
+    /* Release the Mutex now so that the MutexTake in AppSaveBondingInfo does not return an error : interrupt are masked anyway */
+    OSA_MutexUnlock(bondingMutex);
+
+    AppSaveBondingInfo(TRUE);
+#endif
+#ifdef PDM_EXT_FLASH
+    /* wait for EEPROM transactions ended */
+    while(EEPROM_isBusy()) {}
+#endif
+}
+
+
+
+#if !defined(MULTICORE_CONNECTIVITY_CORE) || (!MULTICORE_CONNECTIVITY_CORE)
+
+/*! *********************************************************************************
+* \brief Sends the GAP Generic Event triggered by the Host Stack to the application
+*
+* \param[in] pGenericEvent Pointer to the generic event
+*
+* \return  none
+*
+********************************************************************************** */
+void App_GenericCallback (gapGenericEvent_t* pGenericEvent)
+{
+    appMsgFromHost_t *pMsgIn = NULL;
+#if gAppHostMsgCoalesce_d
+    appMsgCoalesceKey_t coalesceKey;
+    bool_t coalesce;
+#endif
+
+#if (gAppDirectDispatchMask_c & gAppDirectDispatchGeneric_c)
+    if (App_DirectDispatchEnter())
+    {
+        if (pfGenericCallback != NULL)
+        {
+            pfGenericCallback(pGenericEvent);
+        }
+        else
+        {
+            BleApp_GenericCallback(pGenericEvent);
+        }
+        App_DirectDispatchExit();
+        return;
+    }
+#endif
+
+#if gAppHostMsgCoalesce_d
+    coalesce = App_CoalesceKey((uint32_t)gAppGapGenericMsg_c, gInvalidDeviceId_c, pGenericEvent, &coalesceKey);
+#endif
+
+    pMsgIn = App_MsgAlloc((uint32_t)gAppGapGenericMsg_c, sizeof(uint32_t) + sizeof(gapGenericEvent_t));
+
+    if (pMsgIn == NULL)
+    {
+        return;
+    }
+
+    FLib_MemCpy(&pMsgIn->msgData.genericMsg, pGenericEvent, sizeof(gapGenericEvent_t));
+
+#if gAppHostMsgCoalesce_d
+    if (coalesce)
+    {
+        /* Takes the place of the queued event of the same kind, if any */
+        App_CoalesceQueue(&coalesceKey, pMsgIn);
+        return;
+    }
+#endif
+
+    /* Put message in the Host Stack to App queue and signal application */
+    App_QueueHostMessage(pMsgIn);
+}
+#endif /* MULTICORE_CONNECTIVITY_CORE */
+
+/************************************************************************************
+*************************************************************************************
+* Private functions
+*************************************************************************************
+************************************************************************************/
+
+/*****************************************************************************
+* Handles all key events for this device.
+* Interface assumptions: None
+* Return value: None
+*****************************************************************************/
+#if gKeyBoardSupported_d && (gKBD_KeysCount_c > 0) && !defined (DUAL_MODE_APP)
+static void App_KeyboardCallBack
+  (
+  uint8_t events  /*IN: Events from keyboard module  */
+  )
+{
+    BleApp_HandleKeys(events);
+}
+#endif
+
+/*****************************************************************************
+* Handles all messages received from the host task.
+* Interface assumptions: None
+* Return value: None
+*****************************************************************************/
+static void App_HandleHostMessageInput(appMsgFromHost_t* pMsg)
+{
+    switch ( pMsg->msgType )
+    {
+        case (uint32_t)gAppGapGenericMsg_c:
+        {
+            if (pfGenericCallback != NULL)
+            {
+                pfGenericCallback(&pMsg->msgData.genericMsg);
+            }
+            else
+            {
+                BleApp_GenericCallback(&pMsg->msgData.genericMsg);
+            }
+            break;
+        }
+        case (uint32_t)gAppGapAdvertisementMsg_c:
+        {
+            if (pfAdvCallback != NULL)
+            {
+                pfAdvCallback(&pMsg->msgData.advMsg);
+            }
+            break;
+        }
+        case (uint32_t)gAppGapScanMsg_c:
+        {
+            if (pfScanCallback != NULL)
+            {
+                pfScanCallback(&pMsg->msgData.scanMsg);
+            }
+            break;
+        }
+        case (uint32_t)gAppGapConnectionMsg_c:
+        {
+            if (pfConnCallback != NULL)
+            {
+                pfConnCallback(pMsg->msgData.connMsg.deviceId, &pMsg->msgData.connMsg.connEvent);
+            }
+            break;
+        }
+        case (uint32_t)gAppGattServerMsg_c:
+        {
+            if (pfGattServerCallback != NULL)
+            {
+                pfGattServerCallback(pMsg->msgData.gattServerMsg.deviceId, &pMsg->msgData.gattServerMsg.serverEvent);
+            }
+            break;
+        }
+        case (uint32_t)gAppGattClientProcedureMsg_c:
+        {
+            if (pfGattClientProcCallback != NULL)
+            {
+                pfGattClientProcCallback(
+                    pMsg->msgData.gattClientProcMsg.deviceId,
+                    pMsg->msgData.gattClientProcMsg.procedureType,
+                    pMsg->msgData.gattClientProcMsg.procedureResult,
+                    pMsg->msgData.gattClientProcMsg.error);
+            }
+            break;
+        }
+        case (uint32_t)gAppGattClientNotificationMsg_c:
+        {
+            if (pfGattClientNotifCallback != NULL)
+            {
+                pfGattClientNotifCallback(
+                    pMsg->msgData.gattClientNotifIndMsg.deviceId,
+                    pMsg->msgData.gattClientNotifIndMsg.characteristicValueHandle,
+                    pMsg->msgData.gattClientNotifIndMsg.aValue,
+                    pMsg->msgData.gattClientNotifIndMsg.valueLength);
+            }
+            break;
+        }
+        case (uint32_t)gAppGattClientIndicationMsg_c:
+        {
+            if (pfGattClientIndCallback != NULL)
+            {
+                pfGattClientIndCallback(
+                    pMsg->msgData.gattClientNotifIndMsg.deviceId,
+                    pMsg->msgData.gattClientNotifIndMsg.characteristicValueHandle,
+                    pMsg->msgData.gattClientNotifIndMsg.aValue,
+                    pMsg->msgData.gattClientNotifIndMsg.valueLength);
+            }
+            break;
+        }
+        case (uint32_t)gAppL2caLeDataMsg_c:
+        {
+            if (pfL2caLeCbDataCallback != NULL)
+            {
+                pfL2caLeCbDataCallback(
+                    pMsg->msgData.l2caLeCbDataMsg.deviceId,
+                    pMsg->msgData.l2caLeCbDataMsg.channelId,
+                    pMsg->msgData.l2caLeCbDataMsg.aPacket,
+                    pMsg->msgData.l2caLeCbDataMsg.packetLength);
+            }
+            break;
+        }
+        case (uint32_t)gAppL2caLeControlMsg_c:
+        {
+            if (pfL2caLeCbControlCallback != NULL)
+            {
+                pfL2caLeCbControlCallback(&pMsg->msgData.l2caLeCbControlMsg);
+            }
+            break;
+        }
+#if gAppWriteBatch_d
+        case (uint32_t)gAppGattServerWriteBatchMsg_c:
+        {
+            App_WriteBatchDispatch(&pMsg->msgData.gattServerWriteBatchMsg);
+            break;
+        }
+#endif
+#if gAppNotifRing_d
+        case (uint32_t)gAppNotifRingDrainMsg_c:
+        {
+            App_NotifRingDrain(pMsg);
+            break;
+        }
+#endif
+#if !(defined EC_P256_DSPEXT && (EC_P256_DSPEXT == 1)) && !(defined(FSL_FEATURE_SOC_CAU3_COUNT) && (FSL_FEATURE_SOC_CAU3_COUNT > 0))
+        case (uint32_t)gAppSecLibMultiplyMsg_c:
+        {
+            computeDhKeyParam_t *pData = pMsg->msgData.secLibMsgData.pData;
+            bool_t ready = SecLib_HandleMultiplyStep(pData);
+
+            if(ready == FALSE)
+            {
+                SecLib_ExecMultiplicationCb(pData);
+            }
+            else
+            {
+                bleResult_t status;
+
+                status = Gap_ResumeLeScStateMachine(pData);
+                if (status != gBleSuccess_c)
+                {
+                    /* Not enough memory to resume LE SC operations */
+                    panic(0, (uint32_t)Gap_ResumeLeScStateMachine, 0, 0);
+                }
+            }
+
+            break;
+        }
+#endif
+        default:
+        {
+            ; /* No action required */
+            break;
+        }
+    }
+}
+
+/*! *********************************************************************************
+* \brief Sends the GAP Connection Event triggered by the Host Stack to the application
+*
+* \param[in] peerDeviceId The id of the peer device
+* \param[in] pConnectionEvent Pointer to the connection event
+*
+* \return  none
+*
+********************************************************************************** */
+MULTICORE_STATIC void App_ConnectionCallback (deviceId_t peerDeviceId, gapConnectionEvent_t* pConnectionEvent)
+{
+#if defined(MULTICORE_APPLICATION_CORE) && (MULTICORE_APPLICATION_CORE == 1) && ((gFsciBleBBox_d == 1) || (gFsciBleTest_d == 1))
+    fsciBleGapConnectionEvtMonitor(peerDeviceId, pConnectionEvent);
+#else
+    appMsgFromHost_t *pMsgIn = NULL;
+#if gAppHostMsgCoalesce_d
+    appMsgCoalesceKey_t coalesceKey;
+    bool_t coalesce;
+#endif
+
+    uint32_t msgLen = sizeof(uint32_t) + sizeof(connectionMsg_t);
+
+#if gAppNotifRing_d
+    if ((pConnectionEvent->eventType == gConnEvtConnected_c) && (peerDeviceId < gAppMaxConnections_c))
+    {
+        /* The ring itself is emptied by the App task, with the disconnection */
+        FLib_MemSet(&maAppNotifRings[peerDeviceId].stats, 0, sizeof(appNotifRingStats_t));
+        FLib_MemSet(maAppNotifRings[peerDeviceId].aHandles, 0, sizeof(maAppNotifRings[peerDeviceId].aHandles));
+    }
+#endif
+
+#if (gAppDirectDispatchMask_c & gAppDirectDispatchConnection_c)
+    if ((pfConnCallback != NULL) && App_DirectDispatchEnter())
+    {
+        pfConnCallback(peerDeviceId, pConnectionEvent);
+        App_DirectDispatchExit();
+        return;
+    }
+#endif
+
+#if gAppHostMsgCoalesce_d
+    coalesce = App_CoalesceKey((uint32_t)gAppGapConnectionMsg_c, peerDeviceId, pConnectionEvent, &coalesceKey);
+
+    if (!coalesce)
+    {
+        /* The state events already queued for the peer must not be replaced by
+           events following this one, e.g. a disconnection */
+        App_CoalesceClose(peerDeviceId);
+    }
+#endif
+
+    if(pConnectionEvent->eventType == gConnEvtKeysReceived_c)
+    {
+        gapSmpKeys_t    *pKeys = pConnectionEvent->eventData.keysReceivedEvent.pKeys;
+
+        /* add room for pMsgIn->msgType */
+        msgLen = sizeof(uint32_t);
+        /* add room for pMsgIn->msgData.connMsg.deviceId */
+        msgLen += sizeof(uint32_t);
+        /* add room for pMsgIn->msgData.connMsg.connEvent.eventType */
+        msgLen += sizeof(uint32_t);
+        /* add room for pMsgIn->msgData.connMsg.connEvent.eventData.keysReceivedEvent.pKeys pointer */
+        msgLen += sizeof(void*);
+        /* add room for pMsgIn->msgData.connMsg.connEvent.eventData.keysReceivedEvent.pKeys data */
+        msgLen += sizeof(gapSmpKeys_t);
+        if (pKeys->aLtk != NULL)
+        {
+            /* add room for LTK and Rand data */
+            msgLen += (uint32_t)pKeys->cLtkSize + (uint32_t)pKeys->cRandSize;
+        }
+        /* add room for IRK data */
+        msgLen += (pKeys->aIrk != NULL) ? (gcSmpIrkSize_c + gcBleDeviceAddressSize_c) : 0U;
+        /*  add room for CSRK data */
+        msgLen += (pKeys->aCsrk != NULL) ? gcSmpCsrkSize_c : 0U;
+        /* add room for device address data */
+        msgLen += (pKeys->aAddress != NULL) ? (gcBleDeviceAddressSize_c) : 0U;
+    }
+
+    pMsgIn = App_MsgAlloc((uint32_t)gAppGapConnectionMsg_c, msgLen);
+
+    if (pMsgIn == NULL)
+    {
+        return;
+    }
+
+    pMsgIn->msgData.connMsg.deviceId = peerDeviceId;
+
+    if(pConnectionEvent->eventType == gConnEvtKeysReceived_c)
+    {
+        union
+        {
+            uint8_t      *pu8;
+            gapSmpKeys_t *pObject;
+        } temp; /* MISRA rule 11.3 */
+
+        gapSmpKeys_t    *pKeys = pConnectionEvent->eventData.keysReceivedEvent.pKeys;
+        uint8_t         *pCursor = (uint8_t*)&pMsgIn->msgData.connMsg.connEvent.eventData.keysReceivedEvent.pKeys;
+
+        pMsgIn->msgData.connMsg.connEvent.eventType = gConnEvtKeysReceived_c;
+        pCursor += sizeof(void*); /* skip pKeys pointer */
+
+        temp.pu8 = pCursor;
+        pMsgIn->msgData.connMsg.connEvent.eventData.keysReceivedEvent.pKeys = temp.pObject;
+
+        /* Copy SMP Keys structure */
+        FLib_MemCpy(pCursor, pConnectionEvent->eventData.keysReceivedEvent.pKeys, sizeof(gapSmpKeys_t));
+        pCursor += sizeof(gapSmpKeys_t);
+
+        if (pKeys->aLtk != NULL)
+        {
+            /* Copy LTK */
+            pMsgIn->msgData.connMsg.connEvent.eventData.keysReceivedEvent.pKeys->cLtkSize = pKeys->cLtkSize;
+            pMsgIn->msgData.connMsg.connEvent.eventData.keysReceivedEvent.pKeys->aLtk = pCursor;
+            FLib_MemCpy(pCursor, pKeys->aLtk, pKeys->cLtkSize);
+            pCursor += pKeys->cLtkSize;
+
+            /* Copy RAND */
+            pMsgIn->msgData.connMsg.connEvent.eventData.keysReceivedEvent.pKeys->cRandSize = pKeys->cRandSize;
+            pMsgIn->msgData.connMsg.connEvent.eventData.keysReceivedEvent.pKeys->aRand = pCursor;
+            FLib_MemCpy(pCursor, pKeys->aRand, pKeys->cRandSize);
+            pCursor += pKeys->cRandSize;
+        }
+
+        if (pKeys->aIrk != NULL)
+        {
+            /* Copy IRK */
+            pMsgIn->msgData.connMsg.connEvent.eventData.keysReceivedEvent.pKeys->aIrk = pCursor;
+            FLib_MemCpy(pCursor, pKeys->aIrk, gcSmpIrkSize_c);
+            pCursor += gcSmpIrkSize_c;
+
+            /* Copy Address*/
+            pMsgIn->msgData.connMsg.connEvent.eventData.keysReceivedEvent.pKeys->addressType = pKeys->addressType;
+            pMsgIn->msgData.connMsg.connEvent.eventData.keysReceivedEvent.pKeys->aAddress = pCursor;
+            FLib_MemCpy(pCursor, pKeys->aAddress, gcBleDeviceAddressSize_c);
+            pCursor += gcBleDeviceAddressSize_c;
+        }
+
+        if (pKeys->aCsrk != NULL)
+        {
+            /* Copy CSRK */
+            pMsgIn->msgData.connMsg.connEvent.eventData.keysReceivedEvent.pKeys->aCsrk = pCursor;
+            FLib_MemCpy(pCursor, pKeys->aCsrk, gcSmpCsrkSize_c);
         }
     }
-    OSA_MutexUnlock(bondingMutex);
-#else
-    NOT_USED(mEntryIdx);
+    else
+    {
+        FLib_MemCpy(&pMsgIn->msgData.connMsg.connEvent, pConnectionEvent, sizeof(gapConnectionEvent_t));
+    }
+
+#if gAppHostMsgCoalesce_d
+    if (coalesce)
+    {
+        /* Takes the place of the queued event of the same kind, if any */
+        App_CoalesceQueue(&coalesceKey, pMsgIn);
+        return;
+    }
+#endif
+
+    /* Put message in the Host Stack to App queue and signal application */
+    App_QueueHostMessage(pMsgIn);
+#endif /* (MULTICORE_APPLICATION_CORE == 1) && (gFsciBleBBox_d == 1) */
+}
+
+/*! *********************************************************************************
+* \brief Sends the GAP Advertising Event triggered by the Host Stack to the application
+*
+* \param[in] pAdvertisingEvent Pointer to the advertising event
+*
+* \return  none
+*
+********************************************************************************** */
+MULTICORE_STATIC void App_AdvertisingCallback (gapAdvertisingEvent_t* pAdvertisingEvent)
+{
+#if defined(MULTICORE_APPLICATION_CORE) && (MULTICORE_APPLICATION_CORE == 1) && ((gFsciBleBBox_d == 1) || (gFsciBleTest_d == 1))
+    fsciBleGapAdvertisingEvtMonitor(pAdvertisingEvent);
+#else
+    appMsgFromHost_t *pMsgIn = NULL;
+
+#if (gAppDirectDispatchMask_c & gAppDirectDispatchAdvertising_c)
+    if ((pfAdvCallback != NULL) && App_DirectDispatchEnter())
+    {
+        pfAdvCallback(pAdvertisingEvent);
+        App_DirectDispatchExit();
+        return;
+    }
+#endif
+
+    pMsgIn = App_MsgAlloc((uint32_t)gAppGapAdvertisementMsg_c, sizeof(uint32_t) + sizeof(gapAdvertisingEvent_t));
+
+    if (pMsgIn == NULL)
+    {
+        return;
+    }
+
+    pMsgIn->msgData.advMsg.eventType = pAdvertisingEvent->eventType;
+    pMsgIn->msgData.advMsg.eventData = pAdvertisingEvent->eventData;
+
+    /* Put message in the Host Stack to App queue and signal application */
+    App_QueueHostMessage(pMsgIn);
+#endif /* (MULTICORE_APPLICATION_CORE == 1) && (gFsciBleBBox_d == 1) */
+}
+
+/*! *********************************************************************************
+* \brief Sends the GAP Scanning Event triggered by the Host Stack to the application
+*
+* \param[in] pScanningEvent Pointer to the scanning event
+*
+* \return  none
+*
+********************************************************************************** */
+MULTICORE_STATIC void App_ScanningCallback (gapScanningEvent_t* pScanningEvent)
+{
+#if defined(MULTICORE_APPLICATION_CORE) && (MULTICORE_APPLICATION_CORE == 1) && ((gFsciBleBBox_d == 1) || (gFsciBleTest_d == 1))
+    fsciBleGapScanningEvtMonitor(pScanningEvent);
+#else
+    appMsgFromHost_t *pMsgIn = NULL;
+#if gAppHostMsgCoalesce_d
+    appMsgCoalesceKey_t coalesceKey;
+    bool_t coalesce;
+#endif
+
+    uint32_t msgLen = sizeof(uint32_t) + sizeof(gapScanningEvent_t);
+
+#if gAppScanCache_d
+    if (!App_ScanCacheFilter(pScanningEvent))
+    {
+        /* Only counted in the cache */
+        return;
+    }
+#endif
+
+#if (gAppDirectDispatchMask_c & gAppDirectDispatchScanning_c)
+    if ((pfScanCallback != NULL) && App_DirectDispatchEnter())
+    {
+        pfScanCallback(pScanningEvent);
+        App_DirectDispatchExit();
+        return;
+    }
+#endif
+
+#if gAppHostMsgCoalesce_d
+    coalesce = App_CoalesceKey((uint32_t)gAppGapScanMsg_c, gInvalidDeviceId_c, pScanningEvent, &coalesceKey);
+
+    if (!coalesce)
+    {
+        /* Reports must not be replaced by reports following a scan state change */
+        App_CoalesceClose(gInvalidDeviceId_c);
+    }
+#endif
+
+    if (pScanningEvent->eventType == gDeviceScanned_c)
+    {
+        msgLen += pScanningEvent->eventData.scannedDevice.dataLength;
+    }
+    else if (pScanningEvent->eventType == gExtDeviceScanned_c)
+    {
+        msgLen += pScanningEvent->eventData.extScannedDevice.dataLength;
+    }
+    else if (pScanningEvent->eventType == gPeriodicDeviceScanned_c)
+    {
+        msgLen += pScanningEvent->eventData.periodicScannedDevice.dataLength;
+    }
+    else
+    {
+        /* msgLen does not modify for all other event types */
+    }
+
+#if (gAppScanReportPoolSize_c > 0U)
+    pMsgIn = App_ScanReportAlloc(msgLen);
+
+    if (pMsgIn == NULL)
 #endif
-    APP_DBG_LOG("==> end");
+    {
+        pMsgIn = App_MsgAlloc((uint32_t)gAppGapScanMsg_c, msgLen);
+    }
+
+    if (pMsgIn == NULL)
+    {
+        return;
+    }
+
+    pMsgIn->msgData.scanMsg.eventType = pScanningEvent->eventType;
+
+    if (pScanningEvent->eventType == gScanCommandFailed_c)
+    {
+        pMsgIn->msgData.scanMsg.eventData.failReason = pScanningEvent->eventData.failReason;
+    }
+    else if (pScanningEvent->eventType == gDeviceScanned_c)
+    {
+        FLib_MemCpy(&pMsgIn->msgData.scanMsg.eventData.scannedDevice,
+                    &pScanningEvent->eventData.scannedDevice,
+                    sizeof(pScanningEvent->eventData.scannedDevice));
+
+        /* Copy data after the gapScanningEvent_t structure and update the data pointer*/
+        pMsgIn->msgData.scanMsg.eventData.scannedDevice.data = (uint8_t*)&pMsgIn->msgData + sizeof(gapScanningEvent_t);
+        FLib_MemCpy(pMsgIn->msgData.scanMsg.eventData.scannedDevice.data,
+                    pScanningEvent->eventData.scannedDevice.data,
+                    pScanningEvent->eventData.scannedDevice.dataLength);
+    }
+    else if (pScanningEvent->eventType == gExtDeviceScanned_c)
+    {
+        FLib_MemCpy(&pMsgIn->msgData.scanMsg.eventData.extScannedDevice,
+                    &pScanningEvent->eventData.extScannedDevice,
+                    sizeof(pScanningEvent->eventData.extScannedDevice));
+
+        /* Copy data after the gapScanningEvent_t structure and update the data pointer*/
+        pMsgIn->msgData.scanMsg.eventData.extScannedDevice.pData = (uint8_t*)&pMsgIn->msgData + sizeof(gapScanningEvent_t);
+        FLib_MemCpy(pMsgIn->msgData.scanMsg.eventData.extScannedDevice.pData,
+                    pScanningEvent->eventData.extScannedDevice.pData,
+                    pScanningEvent->eventData.extScannedDevice.dataLength);
+    }
+    else if (pScanningEvent->eventType == gPeriodicDeviceScanned_c)
+    {
+        FLib_MemCpy(&pMsgIn->msgData.scanMsg.eventData.periodicScannedDevice,
+                    &pScanningEvent->eventData.periodicScannedDevice,
+                    sizeof(pScanningEvent->eventData.periodicScannedDevice));
+
+        pMsgIn->msgData.scanMsg.eventData.periodicScannedDevice.pData = (uint8_t*)&pMsgIn->msgData + sizeof(gapScanningEvent_t);
+        FLib_MemCpy(pMsgIn->msgData.scanMsg.eventData.periodicScannedDevice.pData,
+                    pScanningEvent->eventData.periodicScannedDevice.pData,
+                    pScanningEvent->eventData.periodicScannedDevice.dataLength);
+    }
+    else if (pScanningEvent->eventType == gPeriodicAdvSyncEstablished_c)
+    {
+        FLib_MemCpy(&pMsgIn->msgData.scanMsg.eventData.syncEstb,
+                    &pScanningEvent->eventData.syncEstb,
+                    sizeof(pScanningEvent->eventData.syncEstb));
+    }
+    else if (pScanningEvent->eventType == gPeriodicAdvSyncLost_c)
+    {
+        FLib_MemCpy(&pMsgIn->msgData.scanMsg.eventData.syncLost,
+                    &pScanningEvent->eventData.syncLost,
+                    sizeof(pScanningEvent->eventData.syncLost));
+    }
+    else
+    {
+        /* no action for all other event types */
+    }
+
+#if gAppHostMsgCoalesce_d
+    if (coalesce)
+    {
+        /* Takes the place of the queued report of the same kind, if any */
+        App_CoalesceQueue(&coalesceKey, pMsgIn);
+        return;
+    }
+#endif
+
+    /* Put message in the Host Stack to App queue and signal application */
+    App_QueueHostMessage(pMsgIn);
+#endif /* (MULTICORE_APPLICATION_CORE == 1) && (gFsciBleBBox_d == 1) */
 }
 
+#if (gAppScanReportPoolSize_c > 0U)
 /*! *********************************************************************************
-* \brief  Performs NVM write operation
+* \brief Takes a pooled message for a scan report
 *
-* \param[in] mEntryIdx            Bonded device index
-* \param[in] pBondHeader          Bond Identity Header
-* \param[in] pBondDataDynamic     Bond Data Dynamic
-* \param[in] pBondDataStatic      Bond Data Static
-* \param[in] pBondDataDeviceInfo  Bond Data Device Info
-* \param[in] pBondDataDescriptor  Bond Data Descriptor
-* \param[in] mDescriptorIndex     Descriptor Index
+* \param[in] msgLen Size of the message
 *
-* \return    none
+* \return  Pointer to the message, or NULL if the report must be allocated as usual
 *
 ********************************************************************************** */
-void App_NvmWrite
-(
-    uint8_t  mEntryIdx,
-    void*    pBondHeader,
-    void*    pBondDataDynamic,
-    void*    pBondDataStatic,
-    void*    pBondDataDeviceInfo,
-    void*    pBondDataDescriptor,
-    uint8_t  mDescriptorIndex
-)
+static appMsgFromHost_t* App_ScanReportAlloc(uint32_t msgLen)
 {
-#if (gMaxBondedDevices_c > 0)
-    APP_DBG_LOG("EntryIdx=%d DescIdx=%d", mEntryIdx, mDescriptorIndex);
-    OSA_MutexLock(bondingMutex, osaWaitForever_c);
-    if(mEntryIdx < (uint8_t)gMaxBondedDevices_c)
-    {
-        if (pBondHeader != NULL)
-        {
-            FLib_MemCpy((void*)&bondEntries[mEntryIdx].aBondingHeader, pBondHeader, sizeof(bondEntries[mEntryIdx].aBondingHeader));
-            bondEntries[mEntryIdx].nbRamWrite++;
-            APP_DBG_LOG("pBondHeader");
-        }
+    appMsgFromHost_t *pMsgIn = NULL;
 
-        if (pBondDataDynamic != NULL)
-        {
-            FLib_MemCpy((void*)&bondEntries[mEntryIdx].aBondingDataDynamic, pBondDataDynamic, sizeof(bondEntries[mEntryIdx].aBondingDataDynamic));
-            bondEntries[mEntryIdx].nbRamWrite++;
-            APP_DBG_LOG("pBondDataDynamic");
-        }
+    if (msgLen <= mAppScanReportSize_c)
+    {
+        pMsgIn = MSG_DeQueue(&mAppScanReportFreeList);
 
-        if (pBondDataStatic != NULL)
+        /* The pool is filled on demand, by the Host task only */
+        if ((pMsgIn == NULL) && (mAppScanReportCount < gAppScanReportPoolSize_c))
         {
-            FLib_MemCpy((void*)&bondEntries[mEntryIdx].aBondingDataStatic, pBondDataStatic, sizeof(bondEntries[mEntryIdx].aBondingDataStatic));
-            bondEntries[mEntryIdx].nbRamWrite++;
-            APP_DBG_LOG("pBondDataStatic");
-        }
+            pMsgIn = MSG_Alloc(mAppScanReportSize_c);
 
-        if (pBondDataDeviceInfo != NULL)
-        {
-            FLib_MemCpy((void*)&bondEntries[mEntryIdx].aBondingDataDeviceInfo, pBondDataDeviceInfo, sizeof(bondEntries[mEntryIdx].aBondingDataDeviceInfo));
-            bondEntries[mEntryIdx].nbRamWrite++;
-            APP_DBG_LOG("pBondDataDeviceInfo");
+            if (pMsgIn != NULL)
+            {
+                mAppScanReportCount++;
+            }
         }
+    }
 
-        if (pBondDataDescriptor != NULL && mDescriptorIndex<gcGapMaximumSavedCccds_c)
-        {
-            FLib_MemCpy((void*)&bondEntries[mEntryIdx].aBondingDataDescriptor[mDescriptorIndex], pBondDataDescriptor, gBleBondDataDescriptorSize_c);
-            bondEntries[mEntryIdx].nbRamWrite++;
-            APP_DBG_LOG("pBondDataDescriptor");
-        }
+    if (pMsgIn != NULL)
+    {
+        pMsgIn->msgType = (uint32_t)gAppGapScanMsg_c | mAppMsgPooled_c;
     }
-    OSA_MutexUnlock(bondingMutex);
-#else
-    NOT_USED(mEntryIdx);
-    NOT_USED(pBondHeader);
-    NOT_USED(pBondDataDynamic);
-    NOT_USED(pBondDataStatic);
-    NOT_USED(pBondDataDeviceInfo);
-    NOT_USED(pBondDataDescriptor);
-    NOT_USED(mDescriptorIndex);
-#endif
-    APP_DBG_LOG("==> end");
+
+    return pMsgIn;
 }
+#endif /* gAppScanReportPoolSize_c */
 
+#if gAppScanCache_d
 /*! *********************************************************************************
-* \brief  Performs NVM read operation
+* \brief Returns the counters of the advertising report cache
 *
-* \param[in] mEntryIdx            Bonded device index
-* \param[in] pBondHeader          Bond Identity Header
-* \param[in] pBondDataDynamic     Bond Data Dynamic
-* \param[in] pBondDataStatic      Bond Data Static
-* \param[in] pBondDataDeviceInfo  Bond Data Device Info
-* \param[in] pBondDataDescriptor  Bond Data Descriptor
-* \param[in] mDescriptorIndex     Descriptor Index
+* \param[out] pStats Counters since the start of the application
 *
-* \return  none
+********************************************************************************** */
+void App_ScanCacheGetStats
+(
+    appScanCacheStats_t*    pStats
+)
+{
+    OSA_InterruptDisable();
+    *pStats = mAppScanCacheStats;
+    OSA_InterruptEnable();
+}
+
+/*! *********************************************************************************
+* \brief Returns the reports aggregated for a device by the advertising report cache
+*
+* \param[in]  addressType  Advertising address type of the device
+* \param[in]  aAddress     Advertising address of the device
+* \param[in]  sid          Advertising set id, or gAppScanCacheNoSid_c
+* \param[in]  scanResponse TRUE for the scan responses of the device
+* \param[out] pDevice      Aggregated reports
+*
+* \return  gBleSuccess_c or gBleInvalidParameter_c
 *
 ********************************************************************************** */
-void App_NvmRead
+bleResult_t App_ScanCacheGetDevice
 (
-    uint8_t  mEntryIdx,
-    void*    pBondHeader,
-    void*    pBondDataDynamic,
-    void*    pBondDataStatic,
-    void*    pBondDataDeviceInfo,
-    void*    pBondDataDescriptor,
-    uint8_t  mDescriptorIndex
+    bleAddressType_t        addressType,
+    const bleDeviceAddress_t aAddress,
+    uint8_t                 sid,
+    bool_t                  scanResponse,
+    appScanCacheDevice_t*   pDevice
 )
 {
-#if (gMaxBondedDevices_c > 0)
-    APP_DBG_LOG("EntryIdx=%d DescIdx=%d", mEntryIdx, mDescriptorIndex);
-    OSA_MutexLock(bondingMutex, osaWaitForever_c);
-    if(mEntryIdx < (uint8_t)gMaxBondedDevices_c)
+    appScanCacheEntry_t  key;
+    appScanCacheEntry_t* pEntry;
+    bleResult_t          result = gBleInvalidParameter_c;
+
+    FLib_MemCpy(key.aAddress, aAddress, sizeof(bleDeviceAddress_t));
+    key.addressType = addressType;
+    key.sid = sid;
+    key.scanResponse = scanResponse;
+
+    /* The Host task updates the cache */
+    OSA_InterruptDisable();
+    pEntry = App_ScanCacheLookup(&key, FALSE);
+
+    if (pEntry != NULL)
     {
-        if (pBondHeader != NULL)
+        pDevice->reports = pEntry->reports;
+        pDevice->rssiMin = pEntry->rssiMin;
+        pDevice->rssiMax = pEntry->rssiMax;
+        pDevice->rssiAverage = (int8_t)(pEntry->rssiAverage / mAppScanCacheRssiScale_c);
+        result = gBleSuccess_c;
+    }
+    OSA_InterruptEnable();
+
+    return result;
+}
+
+/*! *********************************************************************************
+* \brief Counts an advertising report in the cache and decides if it is given to
+*        the application
+*
+* \param[in] pScanningEvent Pointer to the scanning event
+*
+* \return  TRUE if the event must be given to the application
+*
+* \remarks Reports are given for new devices, changed data, and once per
+*          gAppScanCacheForwardInterval_c otherwise.
+*
+********************************************************************************** */
+static bool_t App_ScanCacheFilter(const gapScanningEvent_t* pScanningEvent)
+{
+    appScanCacheEntry_t  key;
+    appScanCacheEntry_t* pEntry;
+    const uint8_t*       pData;
+    uint32_t             now;
+    int8_t               rssi;
+    bool_t               forward;
+
+    FLib_MemSet(&key, 0, sizeof(key));
+
+    if (pScanningEvent->eventType == gDeviceScanned_c)
+    {
+        const gapScannedDevice_t *pDevice = &pScanningEvent->eventData.scannedDevice;
+
+        FLib_MemCpy(key.aAddress, pDevice->aAddress, sizeof(bleDeviceAddress_t));
+        key.addressType = pDevice->addressType;
+        key.sid = gAppScanCacheNoSid_c;
+        key.scanResponse = (pDevice->advEventType == gBleAdvRepScanRsp_c);
+        key.dataLength = pDevice->dataLength;
+        pData = pDevice->data;
+        rssi = pDevice->rssi;
+    }
+    else if (pScanningEvent->eventType == gExtDeviceScanned_c)
+    {
+        const gapExtScannedDevice_t *pDevice = &pScanningEvent->eventData.extScannedDevice;
+
+        FLib_MemCpy(key.aAddress, pDevice->aAddress, sizeof(bleDeviceAddress_t));
+        key.addressType = pDevice->addressType;
+        key.sid = pDevice->SID;
+        key.scanResponse = ((pDevice->advEventProperties & (uint16_t)gAdvEventScanResponse_c) != 0U);
+        key.dataLength = pDevice->dataLength;
+        pData = pDevice->pData;
+        rssi = pDevice->rssi;
+    }
+    else
+    {
+        if (pScanningEvent->eventType == gScanStateChanged_c)
         {
-            FLib_MemCpy(pBondHeader, (void*)&bondEntries[mEntryIdx].aBondingHeader, sizeof(bondEntries[mEntryIdx].aBondingHeader));
+            /* Start over with each scan */
+            FLib_MemSet(mAppScanCache, 0, sizeof(mAppScanCache));
         }
 
-        if (pBondDataDynamic != NULL)
-        {
-            FLib_MemCpy(pBondDataDynamic, (void*)&bondEntries[mEntryIdx].aBondingDataDynamic, sizeof(bondEntries[mEntryIdx].aBondingDataDynamic));
-        }
+        return TRUE;
+    }
+
+    now = (uint32_t)(TMR_GetTimestamp() / 1000U);
+    key.dataHash = App_ScanCacheHash(mAppScanCacheHashInit_c, pData, key.dataLength);
+
+    mAppScanCacheStats.received++;
+    pEntry = App_ScanCacheLookup(&key, TRUE);
+
+    if (!pEntry->inUse)
+    {
+        /* New device, or a device replacing the least recently seen one */
+        FLib_MemCpy(pEntry, &key, sizeof(appScanCacheEntry_t));
+        pEntry->inUse = TRUE;
+        pEntry->rssiAverage = (int16_t)rssi * mAppScanCacheRssiScale_c;
+        forward = TRUE;
+    }
+    else
+    {
+        forward = ((pEntry->dataHash != key.dataHash) || (pEntry->dataLength != key.dataLength) ||
+                   ((now - pEntry->lastForward) >= (uint32_t)gAppScanCacheForwardInterval_c));
+        pEntry->rssiAverage += (int16_t)(((int16_t)rssi * mAppScanCacheRssiScale_c - pEntry->rssiAverage) /
+                                         mAppScanCacheRssiWeight_c);
+    }
+
+    if ((pEntry->reports == 0U) || pEntry->restart)
+    {
+        pEntry->reports = 0U;
+        pEntry->rssiMin = rssi;
+        pEntry->rssiMax = rssi;
+        pEntry->restart = FALSE;
+    }
+
+    pEntry->reports++;
+    pEntry->rssiMin = (rssi < pEntry->rssiMin) ? rssi : pEntry->rssiMin;
+    pEntry->rssiMax = (rssi > pEntry->rssiMax) ? rssi : pEntry->rssiMax;
+    pEntry->lastSeen = now;
+
+    if (forward)
+    {
+        pEntry->dataHash = key.dataHash;
+        pEntry->dataLength = key.dataLength;
+        pEntry->lastForward = now;
+        pEntry->restart = TRUE;
+        mAppScanCacheStats.forwarded++;
+    }
+    else
+    {
+        mAppScanCacheStats.suppressed++;
+    }
+
+    return forward;
+}
+
+/*! *********************************************************************************
+* \brief Finds the cache slot of a device
+*
+* \param[in] pKey   Address, address type, SID and report kind of the device
+* \param[in] insert TRUE to return a slot for the device if it is not in the cache
+*
+* \return  Slot of the device, or NULL if not found. When inserting, the returned
+*          slot is not in use if the device is new.
+*
+* \remarks When all the searched slots are in use, the least recently seen device
+*          is replaced.
+*
+********************************************************************************** */
+static appScanCacheEntry_t* App_ScanCacheLookup(const appScanCacheEntry_t* pKey, bool_t insert)
+{
+    appScanCacheEntry_t *pEntry;
+    appScanCacheEntry_t *pOldest = NULL;
+    uint32_t index;
+    uint32_t i;
+
+    index = App_ScanCacheHash(mAppScanCacheHashInit_c, pKey->aAddress, sizeof(bleDeviceAddress_t));
+    index = App_ScanCacheHash(index, &pKey->sid, sizeof(pKey->sid));
+    index ^= ((uint32_t)pKey->addressType << 1U) | (pKey->scanResponse ? 1U : 0U);
 
-        if (pBondDataStatic != NULL)
-        {
-            FLib_MemCpy(pBondDataStatic, (void*)&bondEntries[mEntryIdx].aBondingDataStatic, sizeof(bondEntries[mEntryIdx].aBondingDataStatic));
+    for (i = 0U; i < mAppScanCacheProbes_c; i++)
+    {
+        pEntry = &mAppScanCache[(index + i) & (gAppScanCacheSize_c - 1U)];
 
+        if (!pEntry->inUse)
+        {
+            return insert ? pEntry : NULL;
         }
 
-        if (pBondDataDeviceInfo != NULL)
+        if ((pEntry->addressType == pKey->addressType) &&
+            (pEntry->sid == pKey->sid) &&
+            (pEntry->scanResponse == pKey->scanResponse) &&
+            FLib_MemCmp(pEntry->aAddress, pKey->aAddress, sizeof(bleDeviceAddress_t)))
         {
-            FLib_MemCpy(pBondDataDeviceInfo, (void*)&bondEntries[mEntryIdx].aBondingDataDeviceInfo, sizeof(bondEntries[mEntryIdx].aBondingDataDeviceInfo));
-
+            return pEntry;
         }
 
-        if (pBondDataDescriptor != NULL && mDescriptorIndex<gcGapMaximumSavedCccds_c)
+        if ((pOldest == NULL) || ((int32_t)(pEntry->lastSeen - pOldest->lastSeen) < 0))
         {
-            FLib_MemCpy(pBondDataDescriptor, (void*)&bondEntries[mEntryIdx].aBondingDataDescriptor[mDescriptorIndex], gBleBondDataDescriptorSize_c);
+            pOldest = pEntry;
         }
     }
-    OSA_MutexUnlock(bondingMutex);
-#else
-    NOT_USED(mEntryIdx);
-    NOT_USED(pBondHeader);
-    NOT_USED(pBondDataDynamic);
-    NOT_USED(pBondDataStatic);
-    NOT_USED(pBondDataDeviceInfo);
-    NOT_USED(pBondDataDescriptor);
-    NOT_USED(mDescriptorIndex);
-#endif
-    APP_DBG_LOG("==> end");
-}
-
-#ifdef PDM_EXT_FLASH
-extern uint8_t EEPROM_isBusy();
-#endif
-/*! *********************************************************************************
-* \brief  Performs all actions needed to processed before reset or low power with RAM off
-*         Mainly store data cached in RAM to reflect updates in NVM
-*         Otherwise updates done in RAM will be lost on Reset or RAM Off
-* \param[in] None
-*
-* \return  none
-*
-********************************************************************************** */
 
-void SafeActions_on_RamOff(void)
-{
-    APP_DBG_LOG("");
-#if (gMaxBondedDevices_c > 0) && (gAppUseBonding_d)
-    /* Ensure that any ongoing write transaction started from the Idle Task  is complete by taking the mutex */
-    OSA_MutexLock(bondingMutex, osaWaitForever_c);
-    /* mask interrupts only after completion : prevent further scheduling before ResetMCU */
-    OSA_InterruptDisable();
-    /* Release the Mutex now so that the MutexTake in AppSaveBondingInfo does not return an error : interrupt are masked anyway */
-    OSA_MutexUnlock(bondingMutex);
+    if (insert)
+    {
+        /* The slot is reused in place, so the probe sequences of the other devices are kept */
+        pOldest->inUse = FALSE;
+        mAppScanCacheStats.evictions++;
+        return pOldest;
+    }
 
-    AppSaveBondingInfo(TRUE);
-#endif
-#ifdef PDM_EXT_FLASH
-    /* wait for EEPROM transactions ended */
-    while(EEPROM_isBusy()) {}
-#endif
+    return NULL;
 }
 
-
-
-#if !defined(MULTICORE_CONNECTIVITY_CORE) || (!MULTICORE_CONNECTIVITY_CORE)
-
 /*! *********************************************************************************
-* \brief Sends the GAP Generic Event triggered by the Host Stack to the application
+* \brief Adds data to an FNV-1a hash
 *
-* \param[in] pGenericEvent Pointer to the generic event
+* \param[in] hash    Hash of the previous data, or mAppScanCacheHashInit_c
+* \param[in] pData   Data
+* \param[in] length  Length of the data
 *
-* \return  none
+* \return  Updated hash
 *
 ********************************************************************************** */
-void App_GenericCallback (gapGenericEvent_t* pGenericEvent)
+static uint32_t App_ScanCacheHash(uint32_t hash, const uint8_t* pData, uint32_t length)
 {
-    appMsgFromHost_t *pMsgIn = NULL;
+    uint32_t i;
 
-    pMsgIn = MSG_Alloc(sizeof(uint32_t) + sizeof(gapGenericEvent_t));
-
-    if (pMsgIn == NULL)
+    for (i = 0U; i < length; i++)
     {
-        return;
+        hash = (hash ^ pData[i]) * mAppScanCacheHashPrime_c;
     }
 
-    pMsgIn->msgType = (uint32_t)gAppGapGenericMsg_c;
-    FLib_MemCpy(&pMsgIn->msgData.genericMsg, pGenericEvent, sizeof(gapGenericEvent_t));
-
-    /* Put message in the Host Stack to App queue */
-    (void)MSG_Queue(&mHostAppInputQueue, pMsgIn);
-
-    /* Signal application */
-    (void)OSA_EventSet(mAppEvent, gAppEvtMsgFromHostStack_c);
+    return hash;
 }
-#endif /* MULTICORE_CONNECTIVITY_CORE */
+#endif /* gAppScanCache_d */
 
-/************************************************************************************
-*************************************************************************************
-* Private functions
-*************************************************************************************
-************************************************************************************/
+#if gAppThreadStats_d
+/*! *********************************************************************************
+* \brief Returns the counters of the wake ups of App_Thread
+*
+* \param[out] pStats Counters since the start of the application
+*
+********************************************************************************** */
+void App_ThreadGetStats
+(
+    appThreadStats_t*   pStats
+)
+{
+    OSA_InterruptDisable();
+    *pStats = mAppThreadStats;
+    OSA_InterruptEnable();
+}
+#endif /* gAppThreadStats_d */
 
-/*****************************************************************************
-* Handles all key events for this device.
-* Interface assumptions: None
-* Return value: None
-*****************************************************************************/
-#if gKeyBoardSupported_d && (gKBD_KeysCount_c > 0) && !defined (DUAL_MODE_APP)
-static void App_KeyboardCallBack
-  (
-  uint8_t events  /*IN: Events from keyboard module  */
-  )
+#if gAppHostMsgCoalesce_d
+/*! *********************************************************************************
+* \brief Returns the counters of the coalescing of state events
+*
+* \param[out] pStats Counters since the start of the application
+*
+********************************************************************************** */
+void App_HostMsgCoalesceGetStats
+(
+    appHostMsgCoalesceStats_t*  pStats
+)
 {
-    BleApp_HandleKeys(events);
+    OSA_InterruptDisable();
+    *pStats = mAppCoalesceStats;
+    OSA_InterruptEnable();
 }
-#endif
 
-/*****************************************************************************
-* Handles all messages received from the host task.
-* Interface assumptions: None
-* Return value: None
-*****************************************************************************/
-static void App_HandleHostMessageInput(appMsgFromHost_t* pMsg)
+/*! *********************************************************************************
+* \brief Tells if an event only matters in its newest form and builds its key
+*
+* \param[in]  msgType  Host to Application message type of the event
+* \param[in]  deviceId The id of the peer device, for connection events
+* \param[in]  pEvent   Generic, connection or scanning event
+* \param[out] pKey     Kind of the event
+*
+* \return  TRUE if a newer event of the same kind can replace this one
+*
+********************************************************************************** */
+static bool_t App_CoalesceKey
+(
+    uint32_t                msgType,
+    deviceId_t              deviceId,
+    const void*             pEvent,
+    appMsgCoalesceKey_t*    pKey
+)
 {
-    switch ( pMsg->msgType )
+    const gapGenericEvent_t *pGenericEvent;
+    const gapConnectionEvent_t *pConnectionEvent;
+    const gapScanningEvent_t *pScanningEvent;
+    bool_t coalesce = FALSE;
+
+    FLib_MemSet(pKey, 0, sizeof(appMsgCoalesceKey_t));
+    pKey->msgType = (uint8_t)msgType;
+    pKey->deviceId = deviceId;
+
+    if (msgType == (uint32_t)gAppGapGenericMsg_c)
     {
-        case (uint32_t)gAppGapGenericMsg_c:
-        {
-            if (pfGenericCallback != NULL)
-            {
-                pfGenericCallback(&pMsg->msgData.genericMsg);
-            }
-            else
-            {
-                BleApp_GenericCallback(&pMsg->msgData.genericMsg);
-            }
-            break;
-        }
-        case (uint32_t)gAppGapAdvertisementMsg_c:
-        {
-            if (pfAdvCallback != NULL)
-            {
-                pfAdvCallback(&pMsg->msgData.advMsg);
-            }
-            break;
-        }
-        case (uint32_t)gAppGapScanMsg_c:
-        {
-            if (pfScanCallback != NULL)
-            {
-                pfScanCallback(&pMsg->msgData.scanMsg);
-            }
-            break;
-        }
-        case (uint32_t)gAppGapConnectionMsg_c:
-        {
-            if (pfConnCallback != NULL)
-            {
-                pfConnCallback(pMsg->msgData.connMsg.deviceId, &pMsg->msgData.connMsg.connEvent);
-            }
-            break;
-        }
-        case (uint32_t)gAppGattServerMsg_c:
-        {
-            if (pfGattServerCallback != NULL)
-            {
-                pfGattServerCallback(pMsg->msgData.gattServerMsg.deviceId, &pMsg->msgData.gattServerMsg.serverEvent);
-            }
-            break;
-        }
-        case (uint32_t)gAppGattClientProcedureMsg_c:
-        {
-            if (pfGattClientProcCallback != NULL)
-            {
-                pfGattClientProcCallback(
-                    pMsg->msgData.gattClientProcMsg.deviceId,
-                    pMsg->msgData.gattClientProcMsg.procedureType,
-                    pMsg->msgData.gattClientProcMsg.procedureResult,
-                    pMsg->msgData.gattClientProcMsg.error);
-            }
-            break;
-        }
-        case (uint32_t)gAppGattClientNotificationMsg_c:
-        {
-            if (pfGattClientNotifCallback != NULL)
-            {
-                pfGattClientNotifCallback(
-                    pMsg->msgData.gattClientNotifIndMsg.deviceId,
-                    pMsg->msgData.gattClientNotifIndMsg.characteristicValueHandle,
-                    pMsg->msgData.gattClientNotifIndMsg.aValue,
-                    pMsg->msgData.gattClientNotifIndMsg.valueLength);
-            }
-            break;
-        }
-        case (uint32_t)gAppGattClientIndicationMsg_c:
+        pGenericEvent = (const gapGenericEvent_t*)pEvent;
+
+        if ((pGenericEvent->eventType == gLePhyEvent_c) &&
+            ((pGenericEvent->eventData.phyEvent.phyEventType == gPhyRead_c) ||
+             (pGenericEvent->eventData.phyEvent.phyEventType == gPhyUpdateComplete_c)))
         {
-            if (pfGattClientIndCallback != NULL)
-            {
-                pfGattClientIndCallback(
-                    pMsg->msgData.gattClientNotifIndMsg.deviceId,
-                    pMsg->msgData.gattClientNotifIndMsg.characteristicValueHandle,
-                    pMsg->msgData.gattClientNotifIndMsg.aValue,
-                    pMsg->msgData.gattClientNotifIndMsg.valueLength);
-            }
-            break;
+            pKey->eventType = (uint8_t)gLePhyEvent_c;
+            pKey->deviceId = pGenericEvent->eventData.phyEvent.deviceId;
+            pKey->variant = (uint16_t)pGenericEvent->eventData.phyEvent.phyEventType;
+            coalesce = TRUE;
         }
-        case (uint32_t)gAppL2caLeDataMsg_c:
+    }
+    else if (msgType == (uint32_t)gAppGapConnectionMsg_c)
+    {
+        pConnectionEvent = (const gapConnectionEvent_t*)pEvent;
+
+        switch (pConnectionEvent->eventType)
         {
-            if (pfL2caLeCbDataCallback != NULL)
-            {
-                pfL2caLeCbDataCallback(
-                    pMsg->msgData.l2caLeCbDataMsg.deviceId,
-                    pMsg->msgData.l2caLeCbDataMsg.channelId,
-                    pMsg->msgData.l2caLeCbDataMsg.aPacket,
-                    pMsg->msgData.l2caLeCbDataMsg.packetLength);
-            }
-            break;
+            case gConnEvtRssiRead_c:
+            case gConnEvtTxPowerLevelRead_c:
+            case gConnEvtParameterUpdateComplete_c:
+            case gConnEvtLeDataLengthChanged_c:
+            case gConnEvtChannelMapRead_c:
+                pKey->eventType = (uint8_t)pConnectionEvent->eventType;
+                coalesce = TRUE;
+                break;
+
+            default:
+                /* All other connection events are delivered */
+                break;
         }
-        case (uint32_t)gAppL2caLeControlMsg_c:
+    }
+    else if (msgType == (uint32_t)gAppGapScanMsg_c)
+    {
+        pScanningEvent = (const gapScanningEvent_t*)pEvent;
+
+        if (pScanningEvent->eventType == gDeviceScanned_c)
         {
-            if (pfL2caLeCbControlCallback != NULL)
-            {
-                pfL2caLeCbControlCallback(&pMsg->msgData.l2caLeCbControlMsg);
-            }
-            break;
+            pKey->eventType = (uint8_t)gDeviceScanned_c;
+            pKey->addressType = pScanningEvent->eventData.scannedDevice.addressType;
+            FLib_MemCpy(pKey->aAddress, pScanningEvent->eventData.scannedDevice.aAddress, sizeof(bleDeviceAddress_t));
+            /* Advertising data and scan response are different states */
+            pKey->variant = (uint16_t)pScanningEvent->eventData.scannedDevice.advEventType;
+            coalesce = TRUE;
         }
-#if !(defined EC_P256_DSPEXT && (EC_P256_DSPEXT == 1)) && !(defined(FSL_FEATURE_SOC_CAU3_COUNT) && (FSL_FEATURE_SOC_CAU3_COUNT > 0))
-        case (uint32_t)gAppSecLibMultiplyMsg_c:
+        else if (pScanningEvent->eventType == gExtDeviceScanned_c)
         {
-            computeDhKeyParam_t *pData = pMsg->msgData.secLibMsgData.pData;
-            bool_t ready = SecLib_HandleMultiplyStep(pData);
-
-            if(ready == FALSE)
-            {
-                SecLib_ExecMultiplicationCb(pData);
-            }
-            else
-            {
-                bleResult_t status;
-
-                status = Gap_ResumeLeScStateMachine(pData);
-                if (status != gBleSuccess_c)
-                {
-                    /* Not enough memory to resume LE SC operations */
-                    panic(0, (uint32_t)Gap_ResumeLeScStateMachine, 0, 0);
-                }
-            }
-
-            break;
+            pKey->eventType = (uint8_t)gExtDeviceScanned_c;
+            pKey->addressType = pScanningEvent->eventData.extScannedDevice.addressType;
+            FLib_MemCpy(pKey->aAddress, pScanningEvent->eventData.extScannedDevice.aAddress, sizeof(bleDeviceAddress_t));
+            pKey->sid = pScanningEvent->eventData.extScannedDevice.SID;
+            pKey->variant = pScanningEvent->eventData.extScannedDevice.advEventProperties;
+            coalesce = TRUE;
         }
-#endif
-        default:
+        else
         {
-            ; /* No action required */
-            break;
+            /* Scan state changes and periodic advertising events are delivered */
         }
     }
+    else
+    {
+        /* MISRA rule 15.7 */
+    }
+
+    return coalesce;
 }
 
 /*! *********************************************************************************
-* \brief Sends the GAP Connection Event triggered by the Host Stack to the application
+* \brief Queues a state event in the place of the queued event of the same kind, or
+*        at the end of the queue and remembers it, so that newer events of the same
+*        kind can take its place
 *
-* \param[in] peerDeviceId The id of the peer device
-* \param[in] pConnectionEvent Pointer to the connection event
+* \param[in] pKey   Kind of the event
+* \param[in] pMsgIn Message holding the event
 *
-* \return  none
+* \remarks Only the list links are changed with interrupts disabled. The replaced
+*          message is freed afterwards.
 *
 ********************************************************************************** */
-MULTICORE_STATIC void App_ConnectionCallback (deviceId_t peerDeviceId, gapConnectionEvent_t* pConnectionEvent)
+static void App_CoalesceQueue
+(
+    const appMsgCoalesceKey_t*  pKey,
+    appMsgFromHost_t*           pMsgIn
+)
 {
-#if defined(MULTICORE_APPLICATION_CORE) && (MULTICORE_APPLICATION_CORE == 1) && ((gFsciBleBBox_d == 1) || (gFsciBleTest_d == 1))
-    fsciBleGapConnectionEvtMonitor(peerDeviceId, pConnectionEvent);
-#else
-    appMsgFromHost_t *pMsgIn = NULL;
-
-    uint32_t msgLen = sizeof(uint32_t) + sizeof(connectionMsg_t);
+    appMsgCoalesceSlot_t *pSlot = NULL;
+    appMsgFromHost_t *pOldMsg = NULL;
+    uint32_t i;
 
-    if(pConnectionEvent->eventType == gConnEvtKeysReceived_c)
+    OSA_InterruptDisable();
+    for (i = 0U; i < gAppHostMsgCoalesceSlots_c; i++)
     {
-        gapSmpKeys_t    *pKeys = pConnectionEvent->eventData.keysReceivedEvent.pKeys;
-
-        /* add room for pMsgIn->msgType */
-        msgLen = sizeof(uint32_t);
-        /* add room for pMsgIn->msgData.connMsg.deviceId */
-        msgLen += sizeof(uint32_t);
-        /* add room for pMsgIn->msgData.connMsg.connEvent.eventType */
-        msgLen += sizeof(uint32_t);
-        /* add room for pMsgIn->msgData.connMsg.connEvent.eventData.keysReceivedEvent.pKeys pointer */
-        msgLen += sizeof(void*);
-        /* add room for pMsgIn->msgData.connMsg.connEvent.eventData.keysReceivedEvent.pKeys data */
-        msgLen += sizeof(gapSmpKeys_t);
-        if (pKeys->aLtk != NULL)
+        if (maAppCoalesceSlots[i].pMsg == NULL)
         {
-            /* add room for LTK and Rand data */
-            msgLen += (uint32_t)pKeys->cLtkSize + (uint32_t)pKeys->cRandSize;
+            if (pSlot == NULL)
+            {
+                pSlot = &maAppCoalesceSlots[i];
+            }
+        }
+        else if (FLib_MemCmp(&maAppCoalesceSlots[i].key, pKey, sizeof(appMsgCoalesceKey_t)))
+        {
+            pSlot = &maAppCoalesceSlots[i];
+            pOldMsg = pSlot->pMsg;
+            break;
+        }
+        else
+        {
+            /* Slot of another kind of event */
         }
-        /* add room for IRK data */
-        msgLen += (pKeys->aIrk != NULL) ? (gcSmpIrkSize_c + gcBleDeviceAddressSize_c) : 0U;
-        /*  add room for CSRK data */
-        msgLen += (pKeys->aCsrk != NULL) ? gcSmpCsrkSize_c : 0U;
-        /* add room for device address data */
-        msgLen += (pKeys->aAddress != NULL) ? (gcBleDeviceAddressSize_c) : 0U;
     }
 
-    pMsgIn = MSG_Alloc(msgLen);
-
-    if (pMsgIn == NULL)
+    if (pOldMsg != NULL)
     {
-        return;
+        /* The slot is cleared when the message leaves the queue: it is still queued */
+        (void)ListAddPrevElement(mAppMsgListElement_m(pOldMsg), mAppMsgListElement_m(pMsgIn));
+        (void)ListRemoveElement(mAppMsgListElement_m(pOldMsg));
+        pSlot->pMsg = pMsgIn;
+        mAppCoalesceStats.replaced++;
+
+        /* Counts as a newer event for the messages still open to appends */
+        App_CloseHostMessageAppends();
     }
-
-    pMsgIn->msgType = (uint32_t)gAppGapConnectionMsg_c;
-    pMsgIn->msgData.connMsg.deviceId = peerDeviceId;
-
-    if(pConnectionEvent->eventType == gConnEvtKeysReceived_c)
+    else
     {
-        union
-        {
-            uint8_t      *pu8;
-            gapSmpKeys_t *pObject;
-        } temp; /* MISRA rule 11.3 */
-
-        gapSmpKeys_t    *pKeys = pConnectionEvent->eventData.keysReceivedEvent.pKeys;
-        uint8_t         *pCursor = (uint8_t*)&pMsgIn->msgData.connMsg.connEvent.eventData.keysReceivedEvent.pKeys;
-
-        pMsgIn->msgData.connMsg.connEvent.eventType = gConnEvtKeysReceived_c;
-        pCursor += sizeof(void*); /* skip pKeys pointer */
-
-        temp.pu8 = pCursor;
-        pMsgIn->msgData.connMsg.connEvent.eventData.keysReceivedEvent.pKeys = temp.pObject;
-
-        /* Copy SMP Keys structure */
-        FLib_MemCpy(pCursor, pConnectionEvent->eventData.keysReceivedEvent.pKeys, sizeof(gapSmpKeys_t));
-        pCursor += sizeof(gapSmpKeys_t);
-
-        if (pKeys->aLtk != NULL)
+        if (pSlot != NULL)
         {
-            /* Copy LTK */
-            pMsgIn->msgData.connMsg.connEvent.eventData.keysReceivedEvent.pKeys->cLtkSize = pKeys->cLtkSize;
-            pMsgIn->msgData.connMsg.connEvent.eventData.keysReceivedEvent.pKeys->aLtk = pCursor;
-            FLib_MemCpy(pCursor, pKeys->aLtk, pKeys->cLtkSize);
-            pCursor += pKeys->cLtkSize;
-
-            /* Copy RAND */
-            pMsgIn->msgData.connMsg.connEvent.eventData.keysReceivedEvent.pKeys->cRandSize = pKeys->cRandSize;
-            pMsgIn->msgData.connMsg.connEvent.eventData.keysReceivedEvent.pKeys->aRand = pCursor;
-            FLib_MemCpy(pCursor, pKeys->aRand, pKeys->cRandSize);
-            pCursor += pKeys->cRandSize;
+            pSlot->pMsg = pMsgIn;
+            FLib_MemCpy(&pSlot->key, pKey, sizeof(appMsgCoalesceKey_t));
         }
-
-        if (pKeys->aIrk != NULL)
+        else
         {
-            /* Copy IRK */
-            pMsgIn->msgData.connMsg.connEvent.eventData.keysReceivedEvent.pKeys->aIrk = pCursor;
-            FLib_MemCpy(pCursor, pKeys->aIrk, gcSmpIrkSize_c);
-            pCursor += gcSmpIrkSize_c;
-
-            /* Copy Address*/
-            pMsgIn->msgData.connMsg.connEvent.eventData.keysReceivedEvent.pKeys->addressType = pKeys->addressType;
-            pMsgIn->msgData.connMsg.connEvent.eventData.keysReceivedEvent.pKeys->aAddress = pCursor;
-            FLib_MemCpy(pCursor, pKeys->aAddress, gcBleDeviceAddressSize_c);
-            pCursor += gcBleDeviceAddressSize_c;
+            mAppCoalesceStats.untracked++;
         }
 
-        if (pKeys->aCsrk != NULL)
-        {
-            /* Copy CSRK */
-            pMsgIn->msgData.connMsg.connEvent.eventData.keysReceivedEvent.pKeys->aCsrk = pCursor;
-            FLib_MemCpy(pCursor, pKeys->aCsrk, gcSmpCsrkSize_c);
-        }
+        App_EnqueueHostMessage(pMsgIn);
+    }
+    OSA_InterruptEnable();
+
+    if (pOldMsg != NULL)
+    {
+        App_MsgFree(pOldMsg, pOldMsg->msgType & ~mAppMsgTypeMask_c);
     }
     else
     {
-        FLib_MemCpy(&pMsgIn->msgData.connMsg.connEvent, pConnectionEvent, sizeof(gapConnectionEvent_t));
+        (void)OSA_EventSet(mAppEvent, gAppEvtMsgFromHostStack_c);
     }
-
-    /* Put message in the Host Stack to App queue */
-    (void)MSG_Queue(&mHostAppInputQueue, pMsgIn);
-
-    /* Signal application */
-    (void)OSA_EventSet(mAppEvent, gAppEvtMsgFromHostStack_c);
-#endif /* (MULTICORE_APPLICATION_CORE == 1) && (gFsciBleBBox_d == 1) */
 }
 
 /*! *********************************************************************************
-* \brief Sends the GAP Advertising Event triggered by the Host Stack to the application
-*
-* \param[in] pAdvertisingEvent Pointer to the advertising event
+* \brief Stops the replacement of the queued state events of a device
 *
-* \return  none
+* \param[in] deviceId The id of the peer device, or gInvalidDeviceId_c for the
+*                     advertising reports
 *
 ********************************************************************************** */
-MULTICORE_STATIC void App_AdvertisingCallback (gapAdvertisingEvent_t* pAdvertisingEvent)
+static void App_CoalesceClose(deviceId_t deviceId)
 {
-#if defined(MULTICORE_APPLICATION_CORE) && (MULTICORE_APPLICATION_CORE == 1) && ((gFsciBleBBox_d == 1) || (gFsciBleTest_d == 1))
-    fsciBleGapAdvertisingEvtMonitor(pAdvertisingEvent);
-#else
-    appMsgFromHost_t *pMsgIn = NULL;
-
-    pMsgIn = MSG_Alloc(sizeof(uint32_t) + sizeof(gapAdvertisingEvent_t));
+    uint32_t i;
 
-    if (pMsgIn == NULL)
+    OSA_InterruptDisable();
+    for (i = 0U; i < gAppHostMsgCoalesceSlots_c; i++)
     {
-        return;
+        if (maAppCoalesceSlots[i].key.deviceId == deviceId)
+        {
+            maAppCoalesceSlots[i].pMsg = NULL;
+        }
     }
-
-    pMsgIn->msgType = (uint32_t)gAppGapAdvertisementMsg_c;
-    pMsgIn->msgData.advMsg.eventType = pAdvertisingEvent->eventType;
-    pMsgIn->msgData.advMsg.eventData = pAdvertisingEvent->eventData;
-
-    /* Put message in the Host Stack to App queue */
-    (void)MSG_Queue(&mHostAppInputQueue, pMsgIn);
-
-    /* Signal application */
-    (void)OSA_EventSet(mAppEvent, gAppEvtMsgFromHostStack_c);
-#endif /* (MULTICORE_APPLICATION_CORE == 1) && (gFsciBleBBox_d == 1) */
+    OSA_InterruptEnable();
 }
+#endif /* gAppHostMsgCoalesce_d */
 
 /*! *********************************************************************************
-* \brief Sends the GAP Scanning Event triggered by the Host Stack to the application
+* \brief Handles the server events received from one of the peer devices
 *
-* \param[in] pScanningEvent Pointer to the scanning event
+* \param[in] peerDeviceId The id of the peer device
+* \param[in] pServerEvent The Gatt server event received
 *
 * \return  none
 *
 ********************************************************************************** */
-MULTICORE_STATIC void App_ScanningCallback (gapScanningEvent_t* pScanningEvent)
+MULTICORE_STATIC void App_GattServerCallback
+(
+    deviceId_t          peerDeviceId,
+    gattServerEvent_t*  pServerEvent
+)
 {
-#if defined(MULTICORE_APPLICATION_CORE) && (MULTICORE_APPLICATION_CORE == 1) && ((gFsciBleBBox_d == 1) || (gFsciBleTest_d == 1))
-    fsciBleGapScanningEvtMonitor(pScanningEvent);
+#if defined(MULTICORE_APPLICATION_CORE) && (MULTICORE_APPLICATION_CORE == 1) && ((gFsciBleBBox_d == 1) )
+    fsciBleGattServerEvtMonitor(peerDeviceId, pServerEvent);
 #else
     appMsgFromHost_t *pMsgIn = NULL;
+    uint32_t msgLen = sizeof(uint32_t) + sizeof(gattServerMsg_t);
 
-    uint32_t msgLen = sizeof(uint32_t) + sizeof(gapScanningEvent_t);
-
-    if (pScanningEvent->eventType == gDeviceScanned_c)
-    {
-        msgLen += pScanningEvent->eventData.scannedDevice.dataLength;
-    }
-    else if (pScanningEvent->eventType == gExtDeviceScanned_c)
+#if (gAppDirectDispatchMask_c & gAppDirectDispatchGattServer_c)
+    if ((pfGattServerCallback != NULL) && App_DirectDispatchEnter())
     {
-        msgLen += pScanningEvent->eventData.extScannedDevice.dataLength;
+        pfGattServerCallback(peerDeviceId, pServerEvent);
+        App_DirectDispatchExit();
+        return;
     }
-    else if (pScanningEvent->eventType == gPeriodicDeviceScanned_c)
+#endif
+
+#if gAppWriteBatch_d
+    if ((pServerEvent->eventType == gEvtAttributeWrittenWithoutResponse_c) &&
+        App_WriteBatchAppend(peerDeviceId, &pServerEvent->eventData.attributeWrittenEvent))
     {
-        msgLen += pScanningEvent->eventData.periodicScannedDevice.dataLength;
+        return;
     }
-    else
+#endif
+
+    if (pServerEvent->eventType == gEvtAttributeWritten_c ||
+        pServerEvent->eventType == gEvtAttributeWrittenWithoutResponse_c)
     {
-        /* msgLen does not modify for all other event types */
+        msgLen += pServerEvent->eventData.attributeWrittenEvent.cValueLength;
     }
 
-    pMsgIn = MSG_Alloc(msgLen);
+    pMsgIn = App_MsgAlloc((uint32_t)gAppGattServerMsg_c, msgLen);
 
     if (pMsgIn == NULL)
     {
         return;
     }
 
-    pMsgIn->msgType = (uint32_t)gAppGapScanMsg_c;
-    pMsgIn->msgData.scanMsg.eventType = pScanningEvent->eventType;
+    pMsgIn->msgData.gattServerMsg.deviceId = peerDeviceId;
+    FLib_MemCpy(&pMsgIn->msgData.gattServerMsg.serverEvent, pServerEvent, sizeof(gattServerEvent_t));
 
-    if (pScanningEvent->eventType == gScanCommandFailed_c)
-    {
-        pMsgIn->msgData.scanMsg.eventData.failReason = pScanningEvent->eventData.failReason;
-    }
-    else if (pScanningEvent->eventType == gDeviceScanned_c)
+    if ((pMsgIn->msgData.gattServerMsg.serverEvent.eventType == gEvtAttributeWritten_c) ||
+        (pMsgIn->msgData.gattServerMsg.serverEvent.eventType == gEvtAttributeWrittenWithoutResponse_c))
     {
-        FLib_MemCpy(&pMsgIn->msgData.scanMsg.eventData.scannedDevice,
-                    &pScanningEvent->eventData.scannedDevice,
-                    sizeof(pScanningEvent->eventData.scannedDevice));
+        /* Copy value after the gattServerEvent_t structure and update the aValue pointer*/
+        pMsgIn->msgData.gattServerMsg.serverEvent.eventData.attributeWrittenEvent.aValue =
+          (uint8_t *)&pMsgIn->msgData.gattServerMsg.serverEvent.eventData.attributeWrittenEvent.aValue + sizeof(uint8_t*);
+        FLib_MemCpy(pMsgIn->msgData.gattServerMsg.serverEvent.eventData.attributeWrittenEvent.aValue,
+                    pServerEvent->eventData.attributeWrittenEvent.aValue,
+                    pServerEvent->eventData.attributeWrittenEvent.cValueLength);
 
-        /* Copy data after the gapScanningEvent_t structure and update the data pointer*/
-        pMsgIn->msgData.scanMsg.eventData.scannedDevice.data = (uint8_t*)&pMsgIn->msgData + sizeof(gapScanningEvent_t);
-        FLib_MemCpy(pMsgIn->msgData.scanMsg.eventData.scannedDevice.data,
-                    pScanningEvent->eventData.scannedDevice.data,
-                    pScanningEvent->eventData.scannedDevice.dataLength);
     }
-    else if (pScanningEvent->eventType == gExtDeviceScanned_c)
-    {
-        FLib_MemCpy(&pMsgIn->msgData.scanMsg.eventData.extScannedDevice,
-                    &pScanningEvent->eventData.extScannedDevice,
-                    sizeof(pScanningEvent->eventData.extScannedDevice));
 
-        /* Copy data after the gapScanningEvent_t structure and update the data pointer*/
-        pMsgIn->msgData.scanMsg.eventData.extScannedDevice.pData = (uint8_t*)&pMsgIn->msgData + sizeof(gapScanningEvent_t);
-        FLib_MemCpy(pMsgIn->msgData.scanMsg.eventData.extScannedDevice.pData,
-                    pScanningEvent->eventData.extScannedDevice.pData,
-                    pScanningEvent->eventData.extScannedDevice.dataLength);
-    }
-    else if (pScanningEvent->eventType == gPeriodicDeviceScanned_c)
-    {
-        FLib_MemCpy(&pMsgIn->msgData.scanMsg.eventData.periodicScannedDevice,
-                    &pScanningEvent->eventData.periodicScannedDevice,
-                    sizeof(pScanningEvent->eventData.periodicScannedDevice));
+    /* Put message in the Host Stack to App queue and signal application */
+    App_QueueHostMessage(pMsgIn);
+#endif /* (MULTICORE_APPLICATION_CORE == 1) && (gFsciBleBBox_d == 1) */
+}
 
-        pMsgIn->msgData.scanMsg.eventData.periodicScannedDevice.pData = (uint8_t*)&pMsgIn->msgData + sizeof(gapScanningEvent_t);
-        FLib_MemCpy(pMsgIn->msgData.scanMsg.eventData.periodicScannedDevice.pData,
-                    pScanningEvent->eventData.periodicScannedDevice.pData,
-                    pScanningEvent->eventData.periodicScannedDevice.dataLength);
+#if gAppWriteBatch_d
+/*! *********************************************************************************
+* \brief Appends a write without response to the batch waiting in the App queue,
+*        or queues a new batch
+*
+* \param[in] deviceId The id of the peer device
+* \param[in] pEvent   The write
+*
+* \return  FALSE if the write must be queued on its own
+*
+********************************************************************************** */
+static bool_t App_WriteBatchAppend
+(
+    deviceId_t                                  deviceId,
+    const gattServerAttributeWrittenEvent_t*    pEvent
+)
+{
+    gattServerWriteBatchMsg_t *pBatch;
+    appMsgFromHost_t *pMsgIn;
+    bool_t appended = FALSE;
+
+    if (pEvent->cValueLength > gAppWriteBatchMaxBytes_c)
+    {
+        return FALSE;
     }
-    else if (pScanningEvent->eventType == gPeriodicAdvSyncEstablished_c)
+
+    OSA_InterruptDisable();
+    if (mpAppWriteBatch != NULL)
     {
-        FLib_MemCpy(&pMsgIn->msgData.scanMsg.eventData.syncEstb,
-                    &pScanningEvent->eventData.syncEstb,
-                    sizeof(pScanningEvent->eventData.syncEstb));
+        pBatch = &mpAppWriteBatch->msgData.gattServerWriteBatchMsg;
+
+        if ((pBatch->deviceId == deviceId) && (pBatch->handle == pEvent->handle) &&
+            (pBatch->writeCount < gAppWriteBatchMaxWrites_c) &&
+            ((pBatch->dataLength + pEvent->cValueLength) <= gAppWriteBatchMaxBytes_c))
+        {
+            FLib_MemCpy(&pBatch->aData[pBatch->dataLength], pEvent->aValue, pEvent->cValueLength);
+            pBatch->aLengths[pBatch->writeCount] = pEvent->cValueLength;
+            pBatch->dataLength += pEvent->cValueLength;
+            pBatch->writeCount++;
+            appended = TRUE;
+        }
     }
-    else if (pScanningEvent->eventType == gPeriodicAdvSyncLost_c)
+    OSA_InterruptEnable();
+
+    if (appended)
     {
-        FLib_MemCpy(&pMsgIn->msgData.scanMsg.eventData.syncLost,
-                    &pScanningEvent->eventData.syncLost,
-                    sizeof(pScanningEvent->eventData.syncLost));
+        return TRUE;
     }
-    else
+
+    pMsgIn = App_MsgAlloc((uint32_t)gAppGattServerWriteBatchMsg_c,
+                          sizeof(uint32_t) + (sizeof(gattServerWriteBatchMsg_t) - 1U) + gAppWriteBatchMaxBytes_c);
+
+    if (pMsgIn == NULL)
     {
-        /* no action for all other event types */
+        return FALSE;
     }
 
-    /* Put message in the Host Stack to App queue */
-    (void)MSG_Queue(&mHostAppInputQueue, pMsgIn);
+    pBatch = &pMsgIn->msgData.gattServerWriteBatchMsg;
+    pBatch->deviceId = deviceId;
+    pBatch->handle = pEvent->handle;
+    pBatch->writeCount = 1U;
+    pBatch->dataLength = pEvent->cValueLength;
+    pBatch->aLengths[0] = pEvent->cValueLength;
+    FLib_MemCpy(pBatch->aData, pEvent->aValue, pEvent->cValueLength);
 
-    /* Signal application */
-    (void)OSA_EventSet(mAppEvent, gAppEvtMsgFromHostStack_c);
-#endif /* (MULTICORE_APPLICATION_CORE == 1) && (gFsciBleBBox_d == 1) */
+    /* Put message in the Host Stack to App queue and signal application */
+    App_QueueHostMessage(pMsgIn);
+
+    return TRUE;
 }
 
 /*! *********************************************************************************
-* \brief Handles the server events received from one of the peer devices
+* \brief Gives the writes of a batch to the application
 *
-* \param[in] peerDeviceId The id of the peer device
-* \param[in] pServerEvent The Gatt server event received
-*
-* \return  none
+* \param[in] pBatch The batched writes without response
 *
 ********************************************************************************** */
-MULTICORE_STATIC void App_GattServerCallback
-(
-    deviceId_t          peerDeviceId,
-    gattServerEvent_t*  pServerEvent
-)
+static void App_WriteBatchDispatch(const gattServerWriteBatchMsg_t* pBatch)
 {
-#if defined(MULTICORE_APPLICATION_CORE) && (MULTICORE_APPLICATION_CORE == 1) && ((gFsciBleBBox_d == 1) )
-    fsciBleGattServerEvtMonitor(peerDeviceId, pServerEvent);
-#else
-    appMsgFromHost_t *pMsgIn = NULL;
-    uint32_t msgLen = sizeof(uint32_t) + sizeof(gattServerMsg_t);
+    gattServerEvent_t serverEvent;
+    uint32_t offset = 0U;
+    uint32_t i;
 
-    if (pServerEvent->eventType == gEvtAttributeWritten_c ||
-        pServerEvent->eventType == gEvtAttributeWrittenWithoutResponse_c)
+    if (pfGattServerWriteBatchCallback != NULL)
     {
-        msgLen += pServerEvent->eventData.attributeWrittenEvent.cValueLength;
+        pfGattServerWriteBatchCallback(pBatch->deviceId, pBatch->handle, pBatch->writeCount,
+                                       pBatch->aLengths, pBatch->aData);
     }
-
-    pMsgIn = MSG_Alloc(msgLen);
-
-    if (pMsgIn == NULL)
+    else if (pfGattServerCallback != NULL)
     {
-        return;
-    }
-
-    pMsgIn->msgType = (uint32_t)gAppGattServerMsg_c;
-    pMsgIn->msgData.gattServerMsg.deviceId = peerDeviceId;
-    FLib_MemCpy(&pMsgIn->msgData.gattServerMsg.serverEvent, pServerEvent, sizeof(gattServerEvent_t));
+        serverEvent.eventType = gEvtAttributeWrittenWithoutResponse_c;
+        serverEvent.eventData.attributeWrittenEvent.handle = pBatch->handle;
 
-    if ((pMsgIn->msgData.gattServerMsg.serverEvent.eventType == gEvtAttributeWritten_c) ||
-        (pMsgIn->msgData.gattServerMsg.serverEvent.eventType == gEvtAttributeWrittenWithoutResponse_c))
+        for (i = 0U; i < pBatch->writeCount; i++)
+        {
+            serverEvent.eventData.attributeWrittenEvent.cValueLength = pBatch->aLengths[i];
+            serverEvent.eventData.attributeWrittenEvent.aValue = (uint8_t*)&pBatch->aData[offset];
+            pfGattServerCallback(pBatch->deviceId, &serverEvent);
+            offset += pBatch->aLengths[i];
+        }
+    }
+    else
     {
-        /* Copy value after the gattServerEvent_t structure and update the aValue pointer*/
-        pMsgIn->msgData.gattServerMsg.serverEvent.eventData.attributeWrittenEvent.aValue =
-          (uint8_t *)&pMsgIn->msgData.gattServerMsg.serverEvent.eventData.attributeWrittenEvent.aValue + sizeof(uint8_t*);
-        FLib_MemCpy(pMsgIn->msgData.gattServerMsg.serverEvent.eventData.attributeWrittenEvent.aValue,
-                    pServerEvent->eventData.attributeWrittenEvent.aValue,
-                    pServerEvent->eventData.attributeWrittenEvent.cValueLength);
-
+        /* No handler */
     }
-
-    /* Put message in the Host Stack to App queue */
-    (void)MSG_Queue(&mHostAppInputQueue, pMsgIn);
-
-    /* Signal application */
-    (void)OSA_EventSet(mAppEvent, gAppEvtMsgFromHostStack_c);
-#endif /* (MULTICORE_APPLICATION_CORE == 1) && (gFsciBleBBox_d == 1) */
 }
+#endif /* gAppWriteBatch_d */
 
 /*! *********************************************************************************
 * \brief Handles a client procedure result reveived from a peer device
@@ -2002,24 +3649,29 @@ MULTICORE_STATIC void App_GattClientProcedureCallback
 #else
     appMsgFromHost_t *pMsgIn = NULL;
 
-    pMsgIn = MSG_Alloc(sizeof(uint32_t) + sizeof(gattClientProcMsg_t));
+#if (gAppDirectDispatchMask_c & gAppDirectDispatchGattClientProcedure_c)
+    if ((pfGattClientProcCallback != NULL) && App_DirectDispatchEnter())
+    {
+        pfGattClientProcCallback(deviceId, procedureType, procedureResult, error);
+        App_DirectDispatchExit();
+        return;
+    }
+#endif
+
+    pMsgIn = App_MsgAlloc((uint32_t)gAppGattClientProcedureMsg_c, sizeof(uint32_t) + sizeof(gattClientProcMsg_t));
 
     if (pMsgIn == NULL)
     {
         return;
     }
 
-    pMsgIn->msgType = (uint32_t)gAppGattClientProcedureMsg_c;
     pMsgIn->msgData.gattClientProcMsg.deviceId = deviceId;
     pMsgIn->msgData.gattClientProcMsg.procedureType = procedureType;
     pMsgIn->msgData.gattClientProcMsg.error = error;
     pMsgIn->msgData.gattClientProcMsg.procedureResult = procedureResult;
 
-    /* Put message in the Host Stack to App queue */
-    (void)MSG_Queue(&mHostAppInputQueue, pMsgIn);
-
-    /* Signal application */
-    (void)OSA_EventSet(mAppEvent, gAppEvtMsgFromHostStack_c);
+    /* Put message in the Host Stack to App queue and signal application */
+    App_QueueHostMessage(pMsgIn);
 #endif /* (MULTICORE_APPLICATION_CORE == 1) && (gFsciBleBBox_d == 1) */
 }
 
@@ -2047,15 +3699,30 @@ MULTICORE_STATIC void App_GattClientNotificationCallback
 #else
     appMsgFromHost_t *pMsgIn = NULL;
 
+#if (gAppDirectDispatchMask_c & gAppDirectDispatchGattClientNotification_c)
+    if ((pfGattClientNotifCallback != NULL) && App_DirectDispatchEnter())
+    {
+        pfGattClientNotifCallback(deviceId, characteristicValueHandle, aValue, valueLength);
+        App_DirectDispatchExit();
+        return;
+    }
+#endif
+
+#if gAppNotifRing_d
+    if (App_NotifRingWrite(deviceId, characteristicValueHandle, aValue, valueLength, FALSE))
+    {
+        return;
+    }
+#endif
+
     /* Allocate a buffer with enough space to store also the notified value*/
-    pMsgIn = MSG_Alloc(sizeof(uint32_t) + sizeof(gattClientNotifIndMsg_t) + (uint32_t)valueLength);
+    pMsgIn = App_MsgAlloc((uint32_t)gAppGattClientNotificationMsg_c, sizeof(uint32_t) + sizeof(gattClientNotifIndMsg_t) + (uint32_t)valueLength);
 
     if (pMsgIn == NULL)
     {
         return;
     }
 
-    pMsgIn->msgType = (uint32_t)gAppGattClientNotificationMsg_c;
     pMsgIn->msgData.gattClientNotifIndMsg.deviceId = deviceId;
     pMsgIn->msgData.gattClientNotifIndMsg.characteristicValueHandle = characteristicValueHandle;
     pMsgIn->msgData.gattClientNotifIndMsg.valueLength = valueLength;
@@ -2064,11 +3731,8 @@ MULTICORE_STATIC void App_GattClientNotificationCallback
     pMsgIn->msgData.gattClientNotifIndMsg.aValue = (uint8_t*)&pMsgIn->msgData + sizeof(gattClientNotifIndMsg_t);
     FLib_MemCpy(pMsgIn->msgData.gattClientNotifIndMsg.aValue, aValue, valueLength);
 
-    /* Put message in the Host Stack to App queue */
-    (void)MSG_Queue(&mHostAppInputQueue, pMsgIn);
-
-    /* Signal application */
-    (void)OSA_EventSet(mAppEvent, gAppEvtMsgFromHostStack_c);
+    /* Put message in the Host Stack to App queue and signal application */
+    App_QueueHostMessage(pMsgIn);
 #endif /* (MULTICORE_APPLICATION_CORE == 1) && (gFsciBleBBox_d == 1) */
 }
 
@@ -2096,16 +3760,31 @@ MULTICORE_STATIC void App_GattClientIndicationCallback
 #else
     appMsgFromHost_t *pMsgIn = NULL;
 
+#if (gAppDirectDispatchMask_c & gAppDirectDispatchGattClientIndication_c)
+    if ((pfGattClientIndCallback != NULL) && App_DirectDispatchEnter())
+    {
+        pfGattClientIndCallback(deviceId, characteristicValueHandle, aValue, valueLength);
+        App_DirectDispatchExit();
+        return;
+    }
+#endif
+
+#if gAppNotifRing_d
+    if (App_NotifRingWrite(deviceId, characteristicValueHandle, aValue, valueLength, TRUE))
+    {
+        return;
+    }
+#endif
+
     /* Allocate a buffer with enough space to store also the notified value*/
-    pMsgIn = MSG_Alloc(sizeof(uint32_t) + sizeof(gattClientNotifIndMsg_t)
-                        + (uint32_t)valueLength);
+    pMsgIn = App_MsgAlloc((uint32_t)gAppGattClientIndicationMsg_c, sizeof(uint32_t) + sizeof(gattClientNotifIndMsg_t)
+                          + (uint32_t)valueLength);
 
     if (pMsgIn == NULL)
     {
         return;
     }
 
-    pMsgIn->msgType = (uint32_t)gAppGattClientIndicationMsg_c;
     pMsgIn->msgData.gattClientNotifIndMsg.deviceId = deviceId;
     pMsgIn->msgData.gattClientNotifIndMsg.characteristicValueHandle = characteristicValueHandle;
     pMsgIn->msgData.gattClientNotifIndMsg.valueLength = valueLength;
@@ -2114,14 +3793,304 @@ MULTICORE_STATIC void App_GattClientIndicationCallback
     pMsgIn->msgData.gattClientNotifIndMsg.aValue = (uint8_t*)&pMsgIn->msgData + sizeof(gattClientNotifIndMsg_t);
     FLib_MemCpy(pMsgIn->msgData.gattClientNotifIndMsg.aValue, aValue, valueLength);
 
-    /* Put message in the Host Stack to App queue */
-    (void)MSG_Queue(&mHostAppInputQueue, pMsgIn);
-
-    /* Signal application */
-    (void)OSA_EventSet(mAppEvent, gAppEvtMsgFromHostStack_c);
+    /* Put message in the Host Stack to App queue and signal application */
+    App_QueueHostMessage(pMsgIn);
 #endif /* (MULTICORE_APPLICATION_CORE == 1) && (gFsciBleBBox_d == 1) */
 }
 
+#if gAppNotifRing_d
+/*! *********************************************************************************
+* \brief Returns the counters of the notification ring of a connection
+*
+* \param[in]  deviceId The id of the peer device
+* \param[out] pStats   Counters since the connection was established
+*
+* \return  gBleSuccess_c or gBleInvalidParameter_c
+*
+********************************************************************************** */
+bleResult_t App_NotifRingGetStats
+(
+    deviceId_t              deviceId,
+    appNotifRingStats_t*    pStats
+)
+{
+    if (deviceId >= gAppMaxConnections_c)
+    {
+        return gBleInvalidParameter_c;
+    }
+
+    OSA_InterruptDisable();
+    *pStats = maAppNotifRings[deviceId].stats;
+    OSA_InterruptEnable();
+
+    return gBleSuccess_c;
+}
+
+/*! *********************************************************************************
+* \brief Returns the values of an attribute dropped by the notification ring
+*
+* \param[in] deviceId The id of the peer device
+* \param[in] handle   The characteristic value handle
+*
+* \return  Number of dropped values
+*
+********************************************************************************** */
+uint32_t App_NotifRingGetHandleOverflows
+(
+    deviceId_t  deviceId,
+    uint16_t    handle
+)
+{
+    uint32_t overflows = 0U;
+    uint32_t i;
+
+    if (deviceId < gAppMaxConnections_c)
+    {
+        OSA_InterruptDisable();
+        for (i = 0U; i < gAppNotifRingHandles_c; i++)
+        {
+            if (maAppNotifRings[deviceId].aHandles[i].handle == handle)
+            {
+                overflows = maAppNotifRings[deviceId].aHandles[i].overflows;
+                break;
+            }
+        }
+        OSA_InterruptEnable();
+    }
+
+    return overflows;
+}
+
+/*! *********************************************************************************
+* \brief Stores a notified or indicated value in the ring of its connection
+*
+* \param[in] deviceId    The id of the peer device
+* \param[in] handle      The characteristic value handle
+* \param[in] aValue      The value
+* \param[in] valueLength The length of the value
+* \param[in] indication  TRUE for an indication
+*
+* \return  FALSE if the value must be queued as a message
+*
+* \remarks Called by the Host task only. When the ring is full, notifications are
+*          dropped and counted, indications are queued as messages. Values that
+*          cannot fit in the ring at all are queued as messages.
+*
+********************************************************************************** */
+static bool_t App_NotifRingWrite
+(
+    deviceId_t      deviceId,
+    uint16_t        handle,
+    const uint8_t*  aValue,
+    uint16_t        valueLength,
+    bool_t          indication
+)
+{
+    appNotifRing_t *pRing;
+    appMsgFromHost_t *pNewMarker = NULL;
+    uint8_t  *pData;
+    uint32_t head;
+    uint32_t tail;
+    uint32_t offset;
+    uint32_t pad;
+    uint32_t size = mAppNotifRecordSize_m(valueLength);
+    uint32_t i;
+    bool_t   published = FALSE;
+    bool_t   signal = FALSE;
+
+    if ((deviceId >= gAppMaxConnections_c) || (valueLength >= mAppNotifIndication_c) ||
+        (size > gAppNotifRingSize_c))
+    {
+        return FALSE;
+    }
+
+    pRing = &maAppNotifRings[deviceId];
+    pData = (uint8_t*)pRing->aData;
+    head = pRing->head;
+    tail = pRing->tail;
+    offset = head & (gAppNotifRingSize_c - 1U);
+
+    /* A value is never split at the end of the ring */
+    pad = ((offset + size) > gAppNotifRingSize_c) ? (gAppNotifRingSize_c - offset) : 0U;
+
+    OSA_InterruptDisable();
+    pRing->stats.received++;
+    OSA_InterruptEnable();
+
+    if ((pad + size) > (gAppNotifRingSize_c - (head - tail)))
+    {
+        if (indication)
+        {
+            /* Indications are never dropped: queued as a message instead */
+            return FALSE;
+        }
+
+        OSA_InterruptDisable();
+        pRing->stats.overflows++;
+        for (i = 0U; i < gAppNotifRingHandles_c; i++)
+        {
+            if ((pRing->aHandles[i].handle == handle) || (pRing->aHandles[i].handle == mAppNotifPadHandle_c))
+            {
+                pRing->aHandles[i].handle = handle;
+                pRing->aHandles[i].overflows++;
+                break;
+            }
+        }
+        OSA_InterruptEnable();
+
+        return TRUE;
+    }
+
+    if (pad != 0U)
+    {
+        Utils_PackTwoByteValue(mAppNotifPadHandle_c, &pData[offset]);
+        Utils_PackTwoByteValue((uint16_t)pad, &pData[offset + 2U]);
+        offset = 0U;
+    }
+
+    Utils_PackTwoByteValue(handle, &pData[offset]);
+    Utils_PackTwoByteValue(indication ? (valueLength | mAppNotifIndication_c) : valueLength, &pData[offset + 2U]);
+    FLib_MemCpy(&pData[offset + mAppNotifHeaderSize_c], aValue, valueLength);
+
+    /* Publish the value after it is written, with the marker that gives it to the App
+       task. A new marker is queued if another message was queued after the last one. */
+    while (!published)
+    {
+        OSA_InterruptDisable();
+        if ((pRing->pMarker == NULL) && (pNewMarker != NULL))
+        {
+            App_EnqueueHostMessage(pNewMarker);
+            pRing->pMarker = pNewMarker;
+            signal = TRUE;
+        }
+
+        if (pRing->pMarker != NULL)
+        {
+            pRing->pMarker->msgData.notifRingDrainMsg.head = head + pad + size;
+            pRing->head = head + pad + size;
+            published = TRUE;
+        }
+        OSA_InterruptEnable();
+
+        if (!published)
+        {
+            pNewMarker = App_MsgAlloc((uint32_t)gAppNotifRingDrainMsg_c, sizeof(uint32_t) + sizeof(notifRingDrainMsg_t));
+
+            if (pNewMarker == NULL)
+            {
+                return FALSE;
+            }
+
+            pNewMarker->msgData.notifRingDrainMsg.deviceId = deviceId;
+        }
+    }
+
+    if (signal)
+    {
+        (void)OSA_EventSet(mAppEvent, gAppEvtMsgFromHostStack_c);
+    }
+
+    return TRUE;
+}
+
+/*! *********************************************************************************
+* \brief Gives the values stored in the ring of a connection to the application
+*
+* \param[in] pMarker  Drain marker taken from the Host to App queue
+*
+* \remarks Called by the App task only. Only the values stored before the marker was
+*          closed are given: the others belong to a later marker.
+*
+********************************************************************************** */
+static void App_NotifRingDrain(appMsgFromHost_t* pMarker)
+{
+    appNotifRing_t *pRing;
+    const uint8_t *pRecord;
+    deviceId_t deviceId = pMarker->msgData.notifRingDrainMsg.deviceId;
+    uint32_t head;
+    uint32_t tail;
+    uint16_t handle;
+    uint16_t length;
+
+    if (deviceId >= gAppMaxConnections_c)
+    {
+        return;
+    }
+
+    pRing = &maAppNotifRings[deviceId];
+
+    OSA_InterruptDisable();
+    if (pRing->pMarker == pMarker)
+    {
+        /* The values stored from now on need a new marker */
+        pRing->pMarker = NULL;
+    }
+    head = pMarker->msgData.notifRingDrainMsg.head;
+    OSA_InterruptEnable();
+
+    tail = pRing->tail;
+
+    while (tail != head)
+    {
+        pRecord = &((const uint8_t*)pRing->aData)[tail & (gAppNotifRingSize_c - 1U)];
+        handle = Utils_ExtractTwoByteValue(&pRecord[0]);
+        length = Utils_ExtractTwoByteValue(&pRecord[2]);
+
+        if (handle == mAppNotifPadHandle_c)
+        {
+            tail += length;
+        }
+        else
+        {
+            if ((length & mAppNotifIndication_c) != 0U)
+            {
+                length &= (uint16_t)~mAppNotifIndication_c;
+
+                if (pfGattClientIndCallback != NULL)
+                {
+                    pfGattClientIndCallback(deviceId, handle, (uint8_t*)&pRecord[mAppNotifHeaderSize_c], length);
+                }
+            }
+            else if (pfGattClientNotifCallback != NULL)
+            {
+                pfGattClientNotifCallback(deviceId, handle, (uint8_t*)&pRecord[mAppNotifHeaderSize_c], length);
+            }
+            else
+            {
+                /* No handler */
+            }
+
+            tail += mAppNotifRecordSize_m(length);
+            pRing->stats.delivered++;
+        }
+
+        /* The space is given back after the handler is done with the value */
+        pRing->tail = tail;
+    }
+}
+
+/*! *********************************************************************************
+* \brief Tells if values are waiting in a notification ring
+*
+* \return  TRUE if a ring is not empty
+*
+********************************************************************************** */
+static bool_t App_NotifRingPending(void)
+{
+    uint32_t i;
+
+    for (i = 0U; i < gAppMaxConnections_c; i++)
+    {
+        if (maAppNotifRings[i].head != maAppNotifRings[i].tail)
+        {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+#endif /* gAppNotifRing_d */
+
 /*! *********************************************************************************
 * \brief L2cap data callback
 *
@@ -2146,27 +4115,32 @@ MULTICORE_STATIC void App_L2caLeDataCallback
 #else
     appMsgFromHost_t *pMsgIn = NULL;
 
+#if (gAppDirectDispatchMask_c & gAppDirectDispatchL2caLeData_c)
+    if ((pfL2caLeCbDataCallback != NULL) && App_DirectDispatchEnter())
+    {
+        pfL2caLeCbDataCallback(deviceId, channelId, pPacket, packetLength);
+        App_DirectDispatchExit();
+        return;
+    }
+#endif
+
     /* Allocate a buffer with enough space to store the packet */
-    pMsgIn = MSG_Alloc(sizeof(uint32_t) + (sizeof(l2caLeCbDataMsg_t) - 1U)
-                        + (uint32_t)packetLength);
+    pMsgIn = App_MsgAlloc((uint32_t)gAppL2caLeDataMsg_c, sizeof(uint32_t) + (sizeof(l2caLeCbDataMsg_t) - 1U)
+                          + (uint32_t)packetLength);
 
     if (pMsgIn == NULL)
     {
         return;
     }
 
-    pMsgIn->msgType = (uint32_t)gAppL2caLeDataMsg_c;
     pMsgIn->msgData.l2caLeCbDataMsg.deviceId = deviceId;
     pMsgIn->msgData.l2caLeCbDataMsg.channelId = channelId;
     pMsgIn->msgData.l2caLeCbDataMsg.packetLength = packetLength;
 
     FLib_MemCpy(pMsgIn->msgData.l2caLeCbDataMsg.aPacket, pPacket, packetLength);
 
-    /* Put message in the Host Stack to App queue */
-    (void)MSG_Queue(&mHostAppInputQueue, pMsgIn);
-
-    /* Signal application */
-    (void)OSA_EventSet(mAppEvent, gAppEvtMsgFromHostStack_c);
+    /* Put message in the Host Stack to App queue and signal application */
+    App_QueueHostMessage(pMsgIn);
 #endif /* (MULTICORE_APPLICATION_CORE == 1) && (gFsciBleBBox_d == 1) */
 }
 
@@ -2189,6 +4163,15 @@ MULTICORE_STATIC void App_L2caLeControlCallback
     appMsgFromHost_t *pMsgIn = NULL;
     uint8_t messageLength = 0U;
 
+#if (gAppDirectDispatchMask_c & gAppDirectDispatchL2caLeControl_c)
+    if ((pfL2caLeCbControlCallback != NULL) && App_DirectDispatchEnter())
+    {
+        pfL2caLeCbControlCallback(pMessage);
+        App_DirectDispatchExit();
+        return;
+    }
+#endif
+
     switch (pMessage->messageType) {
         case gL2ca_LePsmConnectRequest_c:
         {
@@ -2233,23 +4216,19 @@ MULTICORE_STATIC void App_L2caLeControlCallback
     }
 
     /* Allocate a buffer with enough space to store the biggest packet */
-    pMsgIn = MSG_Alloc(sizeof(uint32_t) + sizeof(l2capControlMessage_t));
+    pMsgIn = App_MsgAlloc((uint32_t)gAppL2caLeControlMsg_c, sizeof(uint32_t) + sizeof(l2capControlMessage_t));
 
     if (pMsgIn == NULL)
     {
           return;
     }
 
-    pMsgIn->msgType = (uint32_t)gAppL2caLeControlMsg_c;
     pMsgIn->msgData.l2caLeCbControlMsg.messageType = pMessage->messageType;
 
     FLib_MemCpy(&pMsgIn->msgData.l2caLeCbControlMsg.messageData, &pMessage->messageData, messageLength);
 
-    /* Put message in the Host Stack to App queue */
-    (void)MSG_Queue(&mHostAppInputQueue, pMsgIn);
-
-    /* Signal application */
-    (void)OSA_EventSet(mAppEvent, gAppEvtMsgFromHostStack_c);
+    /* Put message in the Host Stack to App queue and signal application */
+    App_QueueHostMessage(pMsgIn);
 #endif /* (MULTICORE_APPLICATION_CORE == 1) && (gFsciBleBBox_d == 1) */
 }
 
@@ -2270,21 +4249,17 @@ MULTICORE_STATIC void App_SecLibMultCallback
     appMsgFromHost_t *pMsgIn = NULL;
 
     /* Allocate a buffer with enough space to store also the notified value*/
-    pMsgIn = MSG_Alloc(sizeof(uint32_t) + sizeof(secLibMsgData_t));
+    pMsgIn = App_MsgAlloc((uint32_t)gAppSecLibMultiplyMsg_c, sizeof(uint32_t) + sizeof(secLibMsgData_t));
 
     if (pMsgIn == NULL)
     {
         return;
     }
 
-    pMsgIn->msgType = (uint32_t)gAppSecLibMultiplyMsg_c;
     pMsgIn->msgData.secLibMsgData.pData = pData;
 
-    /* Put message in the Host Stack to App queue */
-    (void)MSG_Queue(&mHostAppInputQueue, pMsgIn);
-
-    /* Signal application */
-    (void)OSA_EventSet(mAppEvent, gAppEvtMsgFromHostStack_c);
+    /* Put message in the Host Stack to App queue and signal application */
+    App_QueueHostMessage(pMsgIn);
 }
 #endif
 
@@ -31,6 +31,7 @@
 #include "ble_config.h"
 #include "l2ca_cb_interface.h"
 #include "ble_constants.h"
+#include "ble_host_task_config.h"
 
 #if !defined(gUseHciTransportDownward_d) || (!gUseHciTransportDownward_d)
 #include "controller_interface.h"
@@ -44,6 +45,64 @@
 typedef void* appCallbackParam_t;
 typedef void (*appCallbackHandler_t)(appCallbackParam_t param);
 
+/*! Writes without response to an attribute, delivered together.
+    The value of write i is aLengths[i] bytes long and follows the previous ones in aData. */
+typedef void (*appGattServerWriteBatchCallback_t)
+(
+    deviceId_t      deviceId,
+    uint16_t        handle,
+    uint16_t        writeCount,
+    const uint16_t* aLengths,
+    const uint8_t*  aData
+);
+
+/*! Counters of the notification ring of a connection */
+typedef struct appNotifRingStats_tag{
+    uint32_t    received;       /*!< Notifications and indications received from the Host */
+    uint32_t    delivered;      /*!< Values given to the application */
+    uint32_t    overflows;      /*!< Values dropped because the ring was full */
+} appNotifRingStats_t;
+
+/*! Counters of a size class of the Host to Application messages */
+typedef struct appMsgSlabStats_tag{
+    uint16_t    blockSize;      /*!< Largest message of the class */
+    uint16_t    blocks;         /*!< Blocks of the class */
+    uint16_t    inUse;          /*!< Blocks holding a message */
+    uint16_t    maxInUse;       /*!< High-water mark of inUse */
+} appMsgSlabStats_t;
+
+/*! Advertising report cache counters */
+typedef struct appScanCacheStats_tag{
+    uint32_t    received;       /*!< Advertising reports received from the Host */
+    uint32_t    forwarded;      /*!< Reports given to the application */
+    uint32_t    suppressed;     /*!< Reports only counted in the cache */
+    uint32_t    evictions;      /*!< Devices replaced by another one in the cache */
+} appScanCacheStats_t;
+
+/*! Counters of the coalescing of state events */
+typedef struct appHostMsgCoalesceStats_tag{
+    uint32_t    replaced;       /*!< Events that took the place of a queued event of the same kind */
+    uint32_t    untracked;      /*!< Events queued with no free slot to track them */
+} appHostMsgCoalesceStats_t;
+
+/*! Counters of the wake ups of App_Thread */
+typedef struct appThreadStats_tag{
+    uint32_t    wakeups;        /*!< Runs of the message loop */
+    uint32_t    messages;       /*!< Messages handled */
+    uint32_t    budgetStops;    /*!< Runs stopped by gAppThreadMsgBudget_c */
+    uint32_t    timeStops;      /*!< Runs stopped by gAppThreadTimeBudgetUs_c */
+    uint32_t    resignals;      /*!< Runs that left messages and signalled App_Thread again */
+} appThreadStats_t;
+
+/*! Advertising reports of a device aggregated by the cache. The counters restart
+    with the first report received after a forwarded one. */
+typedef struct appScanCacheDevice_tag{
+    uint32_t    reports;        /*!< Number of reports */
+    int8_t      rssiMin;        /*!< Lowest RSSI */
+    int8_t      rssiMax;        /*!< Highest RSSI */
+    int8_t      rssiAverage;    /*!< Exponential moving average of the RSSI, kept across forwards */
+} appScanCacheDevice_t;
+
 /*! *********************************************************************************
 *************************************************************************************
 * Public macros
@@ -120,6 +179,117 @@ typedef void (*appCallbackHandler_t)(appCallbackParam_t param);
 #define gAppIdleTaskPriority_c  (8)
 #endif
 
+/* gAppDirectDispatchMask_c and its bits are in ble_host_task_config.h, which sizes
+   the Host task stack from them */
+
+/*! Append the writes without response to an attribute to the previous one while it
+    waits in the Application Task queue, instead of queuing one message per write.
+    A batch closes when App_Thread takes it, when another Host event is queued, or when
+    it holds gAppWriteBatchMaxBytes_c bytes or gAppWriteBatchMaxWrites_c writes. */
+#ifndef gAppWriteBatch_d
+#define gAppWriteBatch_d                (0)
+#endif
+
+#ifndef gAppWriteBatchMaxBytes_c
+#define gAppWriteBatchMaxBytes_c        (244U)
+#endif
+
+#ifndef gAppWriteBatchMaxWrites_c
+#define gAppWriteBatchMaxWrites_c       (8U)
+#endif
+
+/*! Keep the values of the GATT client notifications and indications in a byte ring
+    per connection, written by the Host task and read by the Application Task, instead
+    of one message per value. A drain marker queued with the other Host messages keeps
+    the values in order with them. When the ring is full, notifications are dropped
+    and counted, and indications are queued as messages. */
+#ifndef gAppNotifRing_d
+#define gAppNotifRing_d                 (0)
+#endif
+
+/*! Size of the ring of a connection, in bytes. Must be a power of 2. Longer values
+    are queued as messages. */
+#ifndef gAppNotifRingSize_c
+#define gAppNotifRingSize_c             (512U)
+#endif
+
+/*! Number of attribute handles with their own overflow counter, per connection */
+#ifndef gAppNotifRingHandles_c
+#define gAppNotifRingHandles_c          (4U)
+#endif
+
+/*! Enable the size classes of the messages sent by the Host to the Application
+    Task. Each class holds blocks of sizeof(appMsgFromHost_t) plus its payload size,
+    allocated once at start up. Bigger messages, or messages finding their classes
+    empty, are allocated from the MemManager. */
+#ifndef gAppMsgSlab_d
+#define gAppMsgSlab_d                   (0)
+#endif
+
+#define gAppMsgSlabClassCount_c         (3U)
+
+/*! Events without data, such as connection and GATT procedure events */
+#ifndef gAppMsgSlabPayload0_c
+#define gAppMsgSlabPayload0_c           (0U)
+#endif
+#ifndef gAppMsgSlabBlocks0_c
+#define gAppMsgSlabBlocks0_c            (8U)
+#endif
+
+/*! Legacy advertising reports, default MTU notifications and short L2CAP packets */
+#ifndef gAppMsgSlabPayload1_c
+#define gAppMsgSlabPayload1_c           (32U)
+#endif
+#ifndef gAppMsgSlabBlocks1_c
+#define gAppMsgSlabBlocks1_c            (8U)
+#endif
+
+/*! Extended advertising reports and large notifications */
+#ifndef gAppMsgSlabPayload2_c
+#define gAppMsgSlabPayload2_c           (256U)
+#endif
+#ifndef gAppMsgSlabBlocks2_c
+#define gAppMsgSlabBlocks2_c            (2U)
+#endif
+
+/*! Enable the advertising report cache of App_StartScanning. Reports are given
+    to the application only for new devices, changed data, or once per
+    gAppScanCacheForwardInterval_c for each device. Other reports are only counted. */
+#ifndef gAppScanCache_d
+#define gAppScanCache_d                 (0)
+#endif
+
+/*! Number of devices in the advertising report cache. Must be a power of 2 */
+#ifndef gAppScanCacheSize_c
+#define gAppScanCacheSize_c             (32U)
+#endif
+
+/*! Advertising set id of the legacy advertising reports in the cache */
+#define gAppScanCacheNoSid_c            (0xFFU)
+
+/*! Interval between forwarded reports of an unchanged device, in milliseconds */
+#ifndef gAppScanCacheForwardInterval_c
+#define gAppScanCacheForwardInterval_c  (1000U)
+#endif
+
+/*! Enable the coalescing of state events. A RSSI, TX power, connection parameters,
+    data length, channel map or PHY event, or an advertising report, replaces the
+    event of the same kind from the same device still waiting in the App queue. */
+#ifndef gAppHostMsgCoalesce_d
+#define gAppHostMsgCoalesce_d           (0)
+#endif
+
+/*! Number of queued state events that can be replaced */
+#ifndef gAppHostMsgCoalesceSlots_c
+#define gAppHostMsgCoalesceSlots_c      (8U)
+#endif
+
+/*! Count the wake ups of App_Thread and the messages handled by each, to measure
+    the batching of gAppThreadMsgBudget_c on target */
+#ifndef gAppThreadStats_d
+#define gAppThreadStats_d               (0)
+#endif
+
 /*! *********************************************************************************
 *************************************************************************************
 * Public memory declarations
@@ -332,6 +502,138 @@ bleResult_t App_PostCallbackMessage
     appCallbackParam_t     param
 );
 
+#if gAppNotifRing_d
+/*! *********************************************************************************
+* \brief  Returns the counters of the notification ring of a connection.
+*
+* \param[in]  deviceId  The id of the peer device.
+* \param[out] pStats    Counters since the connection was established.
+*
+* \return  gBleSuccess_c or gBleInvalidParameter_c.
+*
+********************************************************************************** */
+bleResult_t App_NotifRingGetStats
+(
+    deviceId_t              deviceId,
+    appNotifRingStats_t*    pStats
+);
+
+/*! *********************************************************************************
+* \brief  Returns the values of an attribute dropped by the notification ring.
+*
+* \param[in]  deviceId  The id of the peer device.
+* \param[in]  handle    The characteristic value handle.
+*
+* \return  Number of dropped values, or 0 if the handle is not tracked.
+*
+* \remarks The first gAppNotifRingHandles_c handles with drops are tracked.
+*
+********************************************************************************** */
+uint32_t App_NotifRingGetHandleOverflows
+(
+    deviceId_t  deviceId,
+    uint16_t    handle
+);
+#endif /* gAppNotifRing_d */
+
+#if gAppMsgSlab_d
+/*! *********************************************************************************
+* \brief  Returns the counters of the Host to Application message size classes.
+*
+* \param[out] aClasses    Counters of each size class, smallest first.
+* \param[out] pFallbacks  Messages allocated from the MemManager instead.
+*
+********************************************************************************** */
+void App_MsgSlabGetStats
+(
+    appMsgSlabStats_t   aClasses[gAppMsgSlabClassCount_c],
+    uint32_t*           pFallbacks
+);
+#endif /* gAppMsgSlab_d */
+
+#if gAppScanCache_d
+/*! *********************************************************************************
+* \brief  Returns the counters of the advertising report cache.
+*
+* \param[out] pStats Counters since the start of the application.
+*
+* \remarks The suppression ratio is suppressed / received.
+*
+********************************************************************************** */
+void App_ScanCacheGetStats
+(
+    appScanCacheStats_t*    pStats
+);
+
+/*! *********************************************************************************
+* \brief  Returns the reports aggregated for a device by the advertising report cache.
+*
+* \param[in]  addressType Advertising address type of the device.
+* \param[in]  aAddress    Advertising address of the device.
+* \param[in]  sid         Advertising set id, or gAppScanCacheNoSid_c for legacy reports.
+* \param[in]  scanResponse TRUE for the scan responses of the device.
+* \param[out] pDevice     Aggregated reports.
+*
+* \return  gBleSuccess_c, or gBleInvalidParameter_c if the device is not in the cache.
+*
+********************************************************************************** */
+bleResult_t App_ScanCacheGetDevice
+(
+    bleAddressType_t        addressType,
+    const bleDeviceAddress_t aAddress,
+    uint8_t                 sid,
+    bool_t                  scanResponse,
+    appScanCacheDevice_t*   pDevice
+);
+#endif /* gAppScanCache_d */
+
+#if gAppHostMsgCoalesce_d
+/*! *********************************************************************************
+* \brief  Returns the counters of the coalescing of state events.
+*
+* \param[out] pStats Counters since the start of the application.
+*
+********************************************************************************** */
+void App_HostMsgCoalesceGetStats
+(
+    appHostMsgCoalesceStats_t*  pStats
+);
+#endif /* gAppHostMsgCoalesce_d */
+
+#if gAppThreadStats_d
+/*! *********************************************************************************
+* \brief  Returns the counters of the wake ups of App_Thread.
+*
+* \param[out] pStats Counters since the start of the application.
+*
+* \remarks The messages handled per event round trip are messages / wakeups.
+*
+********************************************************************************** */
+void App_ThreadGetStats
+(
+    appThreadStats_t*   pStats
+);
+#endif /* gAppThreadStats_d */
+
+#if gAppWriteBatch_d
+/*! *********************************************************************************
+* \brief  Registers the handler of the batched writes without response.
+*
+* \param[in] callback Application-defined callback, or NULL.
+*
+* \return  gBleSuccess_c.
+*
+* \remarks Without a handler, each write of a batch is given to the GATT Server
+*          callback as a gEvtAttributeWrittenWithoutResponse_c event, in order.
+*          The callback is executed in the context of the Application Task.
+*
+********************************************************************************** */
+bleResult_t App_RegisterGattServerWriteBatchCallback
+(
+    appGattServerWriteBatchCallback_t callback
+);
+#endif /* gAppWriteBatch_d */
+
 void App_NvmInit(void);
 
 void App_NvmErase(uint8_t mEntryIdx);
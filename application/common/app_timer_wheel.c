@@ -0,0 +1,688 @@
+/*! *********************************************************************************
+ * \addtogroup BLE
+ * @{
+ ********************************************************************************** */
+/*! *********************************************************************************
+* Copyright 2026 NXP
+* All rights reserved.
+*
+* \file
+*
+* This is the source file of the application timer wheel.
+*
+* The timers are kept on a hierarchical wheel: level 0 has one slot per tick, each
+* higher level has one slot per round of the level below. A timer is linked in the
+* slot of the lowest level that covers its delay and is moved down when its slot is
+* reached. A single low power timer is programmed for the next slot to process, so
+* the device does not wake up on the ticks in between.
+*
+* SPDX-License-Identifier: BSD-3-Clause
+********************************************************************************** */
+
+/************************************************************************************
+*************************************************************************************
+* Include
+*************************************************************************************
+************************************************************************************/
+#include "app_timer_wheel.h"
+
+#if gAppTimerWheel_d
+#include "fsl_os_abstraction.h"
+#include "TimersManager.h"
+
+/************************************************************************************
+*************************************************************************************
+* Private macros
+*************************************************************************************
+************************************************************************************/
+#define mAppTimerWheelSlotBits_c        5U
+#define mAppTimerWheelSlots_c           (1UL << mAppTimerWheelSlotBits_c)
+#define mAppTimerWheelSlotMask_c        (mAppTimerWheelSlots_c - 1U)
+
+/* Number of ticks covered by the levels below the given one */
+#define mAppTimerWheelLevelSpan(level)  (1UL << (mAppTimerWheelSlotBits_c * (level)))
+
+#if (gAppTimerWheelLevels_c == 0U) || (gAppTimerWheelLevels_c > 6U)
+#error "gAppTimerWheelLevels_c must be between 1 and 6"
+#endif
+
+#if (gAppTimerWheelTickMs_c == 0U)
+#error "gAppTimerWheelTickMs_c must not be 0"
+#endif
+
+/************************************************************************************
+*************************************************************************************
+* Private prototypes
+*************************************************************************************
+************************************************************************************/
+static uint32_t App_TimerWheelNow(void);
+static uint32_t App_TimerWheelMsToTicks(uint32_t ms);
+static void App_TimerWheelInsert(appTimerWheelEntry_t* pEntry);
+static void App_TimerWheelRemove(appTimerWheelEntry_t* pEntry);
+static void App_TimerWheelCascade(uint32_t level, uint32_t slot);
+static uint32_t App_TimerWheelSlotDistance(uint32_t occupied, uint32_t current);
+static bool_t App_TimerWheelNextTick(uint32_t* pTick);
+static void App_TimerWheelAdvance(uint32_t nowTick);
+static void App_TimerWheelSchedule(void);
+static void App_TimerWheelCallback(void* pParam);
+
+/************************************************************************************
+*************************************************************************************
+* Private memory declarations
+*************************************************************************************
+************************************************************************************/
+static appTimerWheelEntry_t*    mTimerWheelSlots[gAppTimerWheelLevels_c][mAppTimerWheelSlots_c];
+
+/* One bit per non-empty slot */
+static uint32_t                 mTimerWheelOccupied[gAppTimerWheelLevels_c];
+
+/* Last tick processed by the wheel */
+static uint32_t                 mTimerWheelTick;
+
+static tmrTimerID_t             mTimerWheelTmrId = gTmrInvalidTimerID_c;
+static bool_t                   mTimerWheelArmed;
+static uint32_t                 mTimerWheelArmedTick;
+
+/* Changed each time the low power timer is reprogrammed */
+static uint32_t                 mTimerWheelArmSeq;
+
+/************************************************************************************
+*************************************************************************************
+* Public functions
+*************************************************************************************
+************************************************************************************/
+
+/*! *********************************************************************************
+* \brief  Initializes the timer wheel and allocates its low power timer.
+*
+* \return  gBleSuccess_c or gBleOutOfMemory_c if no timer is available.
+*
+********************************************************************************** */
+bleResult_t App_TimerWheelInit(void)
+{
+    uint32_t level;
+    uint32_t slot;
+
+    if( mTimerWheelTmrId == gTmrInvalidTimerID_c )
+    {
+        mTimerWheelTmrId = TMR_AllocateTimer();
+
+        if( mTimerWheelTmrId == gTmrInvalidTimerID_c )
+        {
+            return gBleOutOfMemory_c;
+        }
+    }
+    else
+    {
+        (void)TMR_StopTimer(mTimerWheelTmrId);
+    }
+
+    OSA_InterruptDisable();
+    for( level = 0U; level < gAppTimerWheelLevels_c; level++ )
+    {
+        for( slot = 0U; slot < mAppTimerWheelSlots_c; slot++ )
+        {
+            mTimerWheelSlots[level][slot] = NULL;
+        }
+        mTimerWheelOccupied[level] = 0U;
+    }
+
+    mTimerWheelTick = App_TimerWheelNow();
+    mTimerWheelArmed = FALSE;
+    OSA_InterruptEnable();
+
+    return gBleSuccess_c;
+}
+
+/*! *********************************************************************************
+* \brief  Starts or restarts a timer of the wheel.
+*
+* \param[in] pEntry     Timer, owned by the caller.
+* \param[in] delayMs    Time until the first expiry, in milliseconds.
+* \param[in] periodMs   Period of the following expiries, or 0 for a single shot.
+* \param[in] handler    Handler posted to the Application Task on each expiry.
+* \param[in] param      Parameter for the handler function.
+*
+* \return  gBleSuccess_c or gBleInvalidParameter_c.
+*
+********************************************************************************** */
+bleResult_t App_TimerWheelStart
+(
+    appTimerWheelEntry_t*   pEntry,
+    uint32_t                delayMs,
+    uint32_t                periodMs,
+    appCallbackHandler_t    handler,
+    appCallbackParam_t      param
+)
+{
+    uint32_t    delay = App_TimerWheelMsToTicks(delayMs);
+    uint32_t    now;
+    bool_t      schedule;
+
+    if( (NULL == pEntry) || (NULL == handler) || (mTimerWheelTmrId == gTmrInvalidTimerID_c) )
+    {
+        return gBleInvalidParameter_c;
+    }
+
+    if( delay == 0U )
+    {
+        delay = 1U;
+    }
+
+    now = App_TimerWheelNow();
+
+    OSA_InterruptDisable();
+    if( pEntry->active )
+    {
+        App_TimerWheelRemove(pEntry);
+    }
+
+    pEntry->handler = handler;
+    pEntry->param = param;
+    pEntry->period = App_TimerWheelMsToTicks(periodMs);
+
+    if( (periodMs != 0U) && (pEntry->period == 0U) )
+    {
+        pEntry->period = 1U;
+    }
+
+    /* The wheel may lag behind the current time. The delay is counted from now. */
+    pEntry->expiry = now + delay;
+    pEntry->active = TRUE;
+    App_TimerWheelInsert(pEntry);
+
+    /* The low power timer only needs to be moved for an earlier expiry */
+    schedule = !mTimerWheelArmed || ((int32_t)(pEntry->expiry - mTimerWheelArmedTick) < 0);
+    OSA_InterruptEnable();
+
+    if( schedule )
+    {
+        App_TimerWheelSchedule();
+    }
+
+    return gBleSuccess_c;
+}
+
+/*! *********************************************************************************
+* \brief  Stops a timer of the wheel.
+*
+* \param[in] pEntry     Timer, owned by the caller.
+*
+********************************************************************************** */
+void App_TimerWheelStop(appTimerWheelEntry_t* pEntry)
+{
+    bool_t      empty = TRUE;
+    uint32_t    level;
+
+    if( NULL == pEntry )
+    {
+        return;
+    }
+
+    OSA_InterruptDisable();
+    if( !pEntry->active )
+    {
+        OSA_InterruptEnable();
+        return;
+    }
+
+    App_TimerWheelRemove(pEntry);
+    pEntry->active = FALSE;
+
+    for( level = 0U; level < gAppTimerWheelLevels_c; level++ )
+    {
+        if( mTimerWheelOccupied[level] != 0U )
+        {
+            empty = FALSE;
+            break;
+        }
+    }
+    OSA_InterruptEnable();
+
+    /* An early wake-up is harmless, only stop the low power timer when idle */
+    if( empty )
+    {
+        App_TimerWheelSchedule();
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Tells whether a timer of the wheel is running.
+*
+* \param[in] pEntry     Timer, owned by the caller.
+*
+* \return  TRUE if the timer is running.
+*
+********************************************************************************** */
+bool_t App_TimerWheelIsActive(const appTimerWheelEntry_t* pEntry)
+{
+    return (NULL != pEntry) && pEntry->active;
+}
+
+/*! *********************************************************************************
+* \brief  Returns the time until the wheel needs to run again.
+*
+* \return  Time in milliseconds, or gAppTimerWheelNoExpiry_c if no timer is running.
+*
+********************************************************************************** */
+uint32_t App_TimerWheelGetNextExpiry(void)
+{
+    uint32_t    next;
+    uint32_t    now;
+    bool_t      pending;
+
+    OSA_InterruptDisable();
+    pending = App_TimerWheelNextTick(&next);
+    OSA_InterruptEnable();
+
+    if( !pending )
+    {
+        return gAppTimerWheelNoExpiry_c;
+    }
+
+    now = App_TimerWheelNow();
+
+    if( (int32_t)(next - now) <= 0 )
+    {
+        return 0U;
+    }
+
+    next -= now;
+
+    if( next >= (gAppTimerWheelNoExpiry_c / gAppTimerWheelTickMs_c) )
+    {
+        return gAppTimerWheelNoExpiry_c - 1U;
+    }
+
+    return next * gAppTimerWheelTickMs_c;
+}
+
+/************************************************************************************
+*************************************************************************************
+* Private functions
+*************************************************************************************
+************************************************************************************/
+
+/*! *********************************************************************************
+* \brief  Returns the current time, in ticks of the wheel.
+*
+********************************************************************************** */
+static uint32_t App_TimerWheelNow(void)
+{
+    /* TMR_GetTimestamp() counts microseconds */
+    return (uint32_t)(TMR_GetTimestamp() / ((uint64_t)gAppTimerWheelTickMs_c * 1000U));
+}
+
+/*! *********************************************************************************
+* \brief  Converts milliseconds to ticks of the wheel, rounding up.
+*
+********************************************************************************** */
+static uint32_t App_TimerWheelMsToTicks(uint32_t ms)
+{
+    uint32_t ticks = ms / gAppTimerWheelTickMs_c;
+
+    if( (ms % gAppTimerWheelTickMs_c) != 0U )
+    {
+        ticks++;
+    }
+
+    return ticks;
+}
+
+/*! *********************************************************************************
+* \brief  Links a timer in the slot matching its expiry.
+*
+* \param[in] pEntry     Timer with a valid expiry.
+*
+* \pre Called with interrupts disabled.
+*
+********************************************************************************** */
+static void App_TimerWheelInsert(appTimerWheelEntry_t* pEntry)
+{
+    uint32_t    delta = pEntry->expiry - mTimerWheelTick;
+    uint32_t    place = pEntry->expiry;
+    uint32_t    level = 0U;
+    uint32_t    slot;
+
+    if( (int32_t)delta <= 0 )
+    {
+        /* Due now, processed with the current tick */
+        slot = mTimerWheelTick & mAppTimerWheelSlotMask_c;
+    }
+    else
+    {
+        if( delta >= mAppTimerWheelLevelSpan(gAppTimerWheelLevels_c) )
+        {
+            /* Beyond the wheel: parked on the last slot of the top level, and
+               inserted again with its real expiry when the slot is reached */
+            delta = mAppTimerWheelLevelSpan(gAppTimerWheelLevels_c) - 1U;
+            place = mTimerWheelTick + delta;
+        }
+
+        while( delta >= mAppTimerWheelLevelSpan(level + 1U) )
+        {
+            level++;
+        }
+
+        slot = (place >> (mAppTimerWheelSlotBits_c * level)) & mAppTimerWheelSlotMask_c;
+    }
+
+    pEntry->level = (uint8_t)level;
+    pEntry->slot = (uint8_t)slot;
+    pEntry->pPrev = NULL;
+    pEntry->pNext = mTimerWheelSlots[level][slot];
+
+    if( NULL != pEntry->pNext )
+    {
+        pEntry->pNext->pPrev = pEntry;
+    }
+
+    mTimerWheelSlots[level][slot] = pEntry;
+    mTimerWheelOccupied[level] |= (1UL << slot);
+}
+
+/*! *********************************************************************************
+* \brief  Unlinks a timer from its slot.
+*
+* \param[in] pEntry     Linked timer.
+*
+* \pre Called with interrupts disabled.
+*
+********************************************************************************** */
+static void App_TimerWheelRemove(appTimerWheelEntry_t* pEntry)
+{
+    if( NULL != pEntry->pPrev )
+    {
+        pEntry->pPrev->pNext = pEntry->pNext;
+    }
+    else
+    {
+        mTimerWheelSlots[pEntry->level][pEntry->slot] = pEntry->pNext;
+    }
+
+    if( NULL != pEntry->pNext )
+    {
+        pEntry->pNext->pPrev = pEntry->pPrev;
+    }
+
+    if( NULL == mTimerWheelSlots[pEntry->level][pEntry->slot] )
+    {
+        mTimerWheelOccupied[pEntry->level] &= ~(1UL << pEntry->slot);
+    }
+
+    pEntry->pNext = NULL;
+    pEntry->pPrev = NULL;
+}
+
+/*! *********************************************************************************
+* \brief  Moves the timers of a slot down the wheel.
+*
+* \param[in] level      Level of the slot, at least 1.
+* \param[in] slot       Slot reached by the current tick.
+*
+* \pre Called with interrupts disabled.
+*
+********************************************************************************** */
+static void App_TimerWheelCascade(uint32_t level, uint32_t slot)
+{
+    appTimerWheelEntry_t* pEntry = mTimerWheelSlots[level][slot];
+    appTimerWheelEntry_t* pNext;
+
+    mTimerWheelSlots[level][slot] = NULL;
+    mTimerWheelOccupied[level] &= ~(1UL << slot);
+
+    while( NULL != pEntry )
+    {
+        pNext = pEntry->pNext;
+        App_TimerWheelInsert(pEntry);
+        pEntry = pNext;
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Returns the number of slots until the next non-empty slot of a level.
+*
+* \param[in] occupied   Non-empty slots of the level.
+* \param[in] current    Slot of the current tick on the level.
+*
+* \return  1 to 32, where 32 is the current slot on the next round.
+*
+********************************************************************************** */
+static uint32_t App_TimerWheelSlotDistance(uint32_t occupied, uint32_t current)
+{
+    uint32_t distance;
+
+    for( distance = 1U; distance < mAppTimerWheelSlots_c; distance++ )
+    {
+        if( (occupied & (1UL << ((current + distance) & mAppTimerWheelSlotMask_c))) != 0U )
+        {
+            break;
+        }
+    }
+
+    return distance;
+}
+
+/*! *********************************************************************************
+* \brief  Finds the next tick on which a slot of the wheel must be processed.
+*
+* \param[out] pTick     Next tick to process.
+*
+* \return  FALSE if the wheel is empty.
+*
+* \pre Called with interrupts disabled.
+*
+********************************************************************************** */
+static bool_t App_TimerWheelNextTick(uint32_t* pTick)
+{
+    bool_t      found = FALSE;
+    uint32_t    best = 0U;
+    uint32_t    shift;
+    uint32_t    block;
+    uint32_t    tick;
+    uint32_t    level;
+
+    for( level = 0U; level < gAppTimerWheelLevels_c; level++ )
+    {
+        if( mTimerWheelOccupied[level] == 0U )
+        {
+            continue;
+        }
+
+        /* A slot of a higher level is processed when its round starts */
+        shift = mAppTimerWheelSlotBits_c * level;
+        block = mTimerWheelTick >> shift;
+        block += App_TimerWheelSlotDistance(mTimerWheelOccupied[level], block & mAppTimerWheelSlotMask_c);
+        tick = block << shift;
+
+        if( !found || ((tick - mTimerWheelTick) < (best - mTimerWheelTick)) )
+        {
+            best = tick;
+            found = TRUE;
+        }
+    }
+
+    *pTick = best;
+
+    return found;
+}
+
+/*! *********************************************************************************
+* \brief  Processes the ticks of the wheel up to the current time and posts the
+*         handlers of the expired timers to the Application Task.
+*
+* \param[in] nowTick    Current time, in ticks.
+*
+********************************************************************************** */
+static void App_TimerWheelAdvance(uint32_t nowTick)
+{
+    appTimerWheelEntry_t*   pEntry;
+    appCallbackHandler_t    handler;
+    appCallbackParam_t      param;
+    uint32_t                level;
+    uint32_t                last;
+    uint32_t                slot;
+
+    for(;;)
+    {
+        OSA_InterruptDisable();
+        if( mTimerWheelTick == nowTick )
+        {
+            OSA_InterruptEnable();
+            break;
+        }
+
+        /* Skip the ticks on which no timer can expire or move down */
+        level = 0U;
+        while( (level < gAppTimerWheelLevels_c) && (mTimerWheelOccupied[level] == 0U) )
+        {
+            level++;
+        }
+
+        if( level == gAppTimerWheelLevels_c )
+        {
+            mTimerWheelTick = nowTick;
+            OSA_InterruptEnable();
+            break;
+        }
+
+        last = mTimerWheelTick | (mAppTimerWheelLevelSpan(level) - 1U);
+
+        if( (nowTick - mTimerWheelTick) <= (last - mTimerWheelTick) )
+        {
+            mTimerWheelTick = nowTick;
+            OSA_InterruptEnable();
+            break;
+        }
+
+        mTimerWheelTick = last + 1U;
+
+        /* Move the timers of the slots reached on the higher levels down */
+        slot = mTimerWheelTick & mAppTimerWheelSlotMask_c;
+        level = 1U;
+        while( (slot == 0U) && (level < gAppTimerWheelLevels_c) )
+        {
+            slot = (mTimerWheelTick >> (mAppTimerWheelSlotBits_c * level)) & mAppTimerWheelSlotMask_c;
+            App_TimerWheelCascade(level, slot);
+            level++;
+        }
+        OSA_InterruptEnable();
+
+        /* Post the expired timers one by one, with interrupts enabled */
+        slot = mTimerWheelTick & mAppTimerWheelSlotMask_c;
+        for(;;)
+        {
+            OSA_InterruptDisable();
+            pEntry = mTimerWheelSlots[0][slot];
+
+            if( NULL == pEntry )
+            {
+                OSA_InterruptEnable();
+                break;
+            }
+
+            App_TimerWheelRemove(pEntry);
+            handler = pEntry->handler;
+            param = pEntry->param;
+
+            if( pEntry->period != 0U )
+            {
+                pEntry->expiry += pEntry->period;
+
+                /* Periods missed while the wheel was late are not posted again */
+                if( (int32_t)(pEntry->expiry - nowTick) <= 0 )
+                {
+                    pEntry->expiry = nowTick + pEntry->period;
+                }
+
+                App_TimerWheelInsert(pEntry);
+            }
+            else
+            {
+                pEntry->active = FALSE;
+            }
+            OSA_InterruptEnable();
+
+            (void)App_PostCallbackMessage(handler, param);
+        }
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Programs the low power timer for the next tick to process, or stops it if
+*         the wheel is empty.
+*
+* \remarks Can run both in the Application Task and in the timer callback. The timer
+*          is programmed again if the other context did so meanwhile.
+*
+********************************************************************************** */
+static void App_TimerWheelSchedule(void)
+{
+    uint32_t    seq;
+    uint32_t    next;
+    uint32_t    delay;
+    bool_t      pending;
+    bool_t      again;
+
+    do
+    {
+        OSA_InterruptDisable();
+        seq = ++mTimerWheelArmSeq;
+        pending = App_TimerWheelNextTick(&next);
+        mTimerWheelArmed = pending;
+        mTimerWheelArmedTick = next;
+        OSA_InterruptEnable();
+
+        if( pending )
+        {
+            delay = next - App_TimerWheelNow();
+
+            if( ((int32_t)delay <= 0) )
+            {
+                delay = 1U;
+            }
+            else if( delay > (0xFFFFFFFFU / gAppTimerWheelTickMs_c) )
+            {
+                delay = 0xFFFFFFFFU / gAppTimerWheelTickMs_c;
+            }
+            else
+            {
+                /* MISRA rule 15.7 */
+            }
+
+            (void)TMR_StartLowPowerTimer(mTimerWheelTmrId, gTmrLowPowerSingleShotMillisTimer_c,
+                                         delay * gAppTimerWheelTickMs_c, App_TimerWheelCallback, NULL);
+        }
+        else
+        {
+            (void)TMR_StopTimer(mTimerWheelTmrId);
+        }
+
+        OSA_InterruptDisable();
+        again = (seq != mTimerWheelArmSeq);
+        OSA_InterruptEnable();
+    } while( again );
+}
+
+/*! *********************************************************************************
+* \brief  Callback of the low power timer of the wheel.
+*
+* \param[in] pParam     Not used.
+*
+********************************************************************************** */
+static void App_TimerWheelCallback(void* pParam)
+{
+    (void)pParam;
+
+    OSA_InterruptDisable();
+    mTimerWheelArmed = FALSE;
+    OSA_InterruptEnable();
+
+    App_TimerWheelAdvance(App_TimerWheelNow());
+    App_TimerWheelSchedule();
+}
+#endif /* gAppTimerWheel_d */
+
+/*! *********************************************************************************
+* @}
+********************************************************************************** */
@@ -0,0 +1,159 @@
+/*! *********************************************************************************
+ * \addtogroup BLE
+ * @{
+ ********************************************************************************* */
+/*! *********************************************************************************
+* Copyright 2026 NXP
+* All rights reserved.
+*
+* \file
+*
+* This is the interface of the application timer wheel. It runs all the delayed and
+* periodic application callbacks off a single low power timer and posts them to the
+* Application Task when they expire.
+*
+* SPDX-License-Identifier: BSD-3-Clause
+********************************************************************************** */
+
+#ifndef APP_TIMER_WHEEL_H
+#define APP_TIMER_WHEEL_H
+
+/************************************************************************************
+*************************************************************************************
+* Includes
+*************************************************************************************
+************************************************************************************/
+#include "ble_general.h"
+#include "ApplMain.h"
+
+/************************************************************************************
+*************************************************************************************
+* Public Macros
+*************************************************************************************
+************************************************************************************/
+/*! Enables the application timer wheel */
+#ifndef gAppTimerWheel_d
+#define gAppTimerWheel_d                0
+#endif
+
+/*! Resolution of the timer wheel, in milliseconds */
+#ifndef gAppTimerWheelTickMs_c
+#define gAppTimerWheelTickMs_c          10U
+#endif
+
+/*! Number of levels of the wheel. Each level has 32 slots, so the wheel covers
+    32^levels ticks before longer delays are re-inserted on the top level. */
+#ifndef gAppTimerWheelLevels_c
+#define gAppTimerWheelLevels_c          4U
+#endif
+
+/*! Returned by App_TimerWheelGetNextExpiry() when no timer is running */
+#define gAppTimerWheelNoExpiry_c        0xFFFFFFFFU
+
+/************************************************************************************
+*************************************************************************************
+* Public type definitions
+*************************************************************************************
+************************************************************************************/
+/*! Timer of the wheel. The memory is owned by the caller and must stay valid while
+    the timer is running. */
+typedef struct appTimerWheelEntry_tag
+{
+    struct appTimerWheelEntry_tag*  pNext;
+    struct appTimerWheelEntry_tag*  pPrev;
+    uint32_t                        expiry;     /*!< Absolute expiry, in ticks. */
+    uint32_t                        period;     /*!< Period in ticks, 0 for single shot. */
+    appCallbackHandler_t            handler;    /*!< Posted to the Application Task. */
+    appCallbackParam_t              param;      /*!< Parameter of the handler. */
+    uint8_t                         level;
+    uint8_t                         slot;
+    bool_t                          active;
+} appTimerWheelEntry_t;
+
+/************************************************************************************
+*************************************************************************************
+* Public prototypes
+*************************************************************************************
+************************************************************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if gAppTimerWheel_d
+/*! *********************************************************************************
+* \brief  Initializes the timer wheel and allocates its low power timer.
+*
+* \return  gBleSuccess_c or gBleOutOfMemory_c if no timer is available.
+*
+* \remarks Called by the application framework after the Timers Manager is
+*          initialized.
+*
+********************************************************************************** */
+bleResult_t App_TimerWheelInit(void);
+
+/*! *********************************************************************************
+* \brief  Starts or restarts a timer of the wheel.
+*
+* \param[in] pEntry     Timer, owned by the caller.
+* \param[in] delayMs    Time until the first expiry, in milliseconds.
+* \param[in] periodMs   Period of the following expiries, or 0 for a single shot.
+* \param[in] handler    Handler posted to the Application Task on each expiry.
+* \param[in] param      Parameter for the handler function.
+*
+* \return  gBleSuccess_c or gBleInvalidParameter_c.
+*
+* \remarks Delays are rounded up to the next tick of the wheel. O(1).
+*
+********************************************************************************** */
+bleResult_t App_TimerWheelStart
+(
+    appTimerWheelEntry_t*   pEntry,
+    uint32_t                delayMs,
+    uint32_t                periodMs,
+    appCallbackHandler_t    handler,
+    appCallbackParam_t      param
+);
+
+/*! *********************************************************************************
+* \brief  Stops a timer of the wheel. O(1).
+*
+* \param[in] pEntry     Timer, owned by the caller.
+*
+* \remarks A handler already posted to the Application Task is still executed.
+*
+********************************************************************************** */
+void App_TimerWheelStop(appTimerWheelEntry_t* pEntry);
+
+/*! *********************************************************************************
+* \brief  Tells whether a timer of the wheel is running.
+*
+* \param[in] pEntry     Timer, owned by the caller.
+*
+* \return  TRUE if the timer is running.
+*
+********************************************************************************** */
+bool_t App_TimerWheelIsActive(const appTimerWheelEntry_t* pEntry);
+
+/*! *********************************************************************************
+* \brief  Returns the time until the wheel needs to run again.
+*
+* \return  Time in milliseconds, or gAppTimerWheelNoExpiry_c if no timer is running.
+*
+* \remarks Timers far in the future are moved down the levels of the wheel on the
+*          way, so the returned time can be shorter than the earliest expiry. It
+*          is the time programmed on the low power timer of the wheel, and can be
+*          used to decide how long the device may sleep.
+*
+********************************************************************************** */
+uint32_t App_TimerWheelGetNextExpiry(void);
+#endif /* gAppTimerWheel_d */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_TIMER_WHEEL_H */
+
+/*! *********************************************************************************
+* @}
+********************************************************************************** */
@@ -29,8 +29,42 @@
  * These values should be modified by the application as necessary.
  * They are used by the task initialization code from ble_host_tasks.c.
  */
+/*! Host callbacks of App_* wrappers given to the application handlers directly,
+    in the Host task, instead of through the Application Task (ApplMain.c). The
+    handlers must not block. An event is still queued if Host messages or callbacks
+    are waiting in the Application Task, while App_Thread handles its messages, if a
+    handler is already running in the Host task, or if less than
+    gHost_TaskDirectDispatchStack_c bytes of the Host task stack are left. */
+#ifndef gAppDirectDispatchMask_c
+#define gAppDirectDispatchMask_c                    (0U)
+#endif
+
+#define gAppDirectDispatchGeneric_c                 (1U << 0U)
+#define gAppDirectDispatchConnection_c              (1U << 1U)
+#define gAppDirectDispatchAdvertising_c             (1U << 2U)
+#define gAppDirectDispatchScanning_c                (1U << 3U)
+#define gAppDirectDispatchGattServer_c              (1U << 4U)
+#define gAppDirectDispatchGattClientProcedure_c     (1U << 5U)
+#define gAppDirectDispatchGattClientNotification_c  (1U << 6U)
+#define gAppDirectDispatchGattClientIndication_c    (1U << 7U)
+#define gAppDirectDispatchL2caLeData_c              (1U << 8U)
+#define gAppDirectDispatchL2caLeControl_c           (1U << 9U)
+
+/* Stack reserved for the application handlers called in the Host task */
+#ifndef gHost_TaskDirectDispatchStack_c
+    #if (gAppDirectDispatchMask_c != 0U)
+        #define gHost_TaskDirectDispatchStack_c 0x200
+    #else
+        #define gHost_TaskDirectDispatchStack_c 0
+    #endif
+#endif
+
+#if (gAppDirectDispatchMask_c != 0U) && (gHost_TaskDirectDispatchStack_c == 0)
+#error "gAppDirectDispatchMask_c needs a stack reserve in gHost_TaskDirectDispatchStack_c"
+#endif
+
 #ifndef gHost_TaskStackSize_c
-    #define gHost_TaskStackMinSize_c 0x600
+    #define gHost_TaskStackMinSize_c ((0x600) + (gHost_TaskDirectDispatchStack_c))
     #define gHostTask_XtraStackSzForEcP256 0x280
     /* The use of the DSP extension optimized EC P256 library requires more stack */
     #if (defined(EC_P256_DSPEXT) && (EC_P256_DSPEXT == 1)) && (defined gAppUsePairing_d && (gAppUsePairing_d != 0))
@@ -63,6 +97,48 @@ extern "C" {
 ********************************************************************************** */
 osaStatus_t Ble_HostTaskInit(void);
 
+#if (defined(gHcitHostFlowControl_d) && gHcitHostFlowControl_d) || (defined(gHcitAclRxDemux_d) && gHcitAclRxDemux_d)
+/*! *********************************************************************************
+* \brief  Gives an HCI packet to the Host, as Ble_HciRecv(), and keeps track of the
+*         ACL packets it queues for the Host task.
+*
+* \param[in] packetType     The type of the packet sent by the LE Controller
+* \param[in] pHciPacket     Pointer to the packet sent by the LE Controller
+* \param[in] packetSize     Number of bytes sent by the LE Controller
+*
+* \return  Result of Ble_HciRecv().
+*
+********************************************************************************** */
+bleResult_t Ble_HostTaskHciRecv
+(
+    hciPacketType_t     packetType,
+    void*               pHciPacket,
+    uint16_t            packetSize
+);
+
+/*! *********************************************************************************
+* \brief  Returns the number of ACL packets given to the Host with
+*         Ble_HostTaskHciRecv() that the Host task has not taken yet.
+*
+* \remarks Used by the Controller to Host flow control and the ACL receive
+*          demultiplexing of the HCI transport (pfHostAclPending). Events in the
+*          queue are not counted.
+*
+********************************************************************************** */
+uint32_t Ble_HostTaskAclPending(void);
+#endif /* gHcitHostFlowControl_d || gHcitAclRxDemux_d */
+
+/*! *********************************************************************************
+* \brief  Returns the stack left to the code running in the Host task.
+*
+* \return  Bytes left below the current stack depth, or 0 outside the Host task.
+*
+* \remarks The depth is taken from the address of a local variable, against the top
+*          of the stack recorded when the task started.
+*
+********************************************************************************** */
+uint32_t Ble_HostTaskStackFree(void);
+
 #ifdef __cplusplus
 }
 #endif
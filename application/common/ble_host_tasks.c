@@ -17,10 +17,26 @@
 * Include
 *************************************************************************************
 ************************************************************************************/
+#if defined(gUseHciTransportDownward_d) && gUseHciTransportDownward_d
+#include "hci_transport.h"
+#endif
 #include "ble_host_tasks.h"
 #include "ble_host_task_config.h"
 #include "Panic.h"
 
+/************************************************************************************
+*************************************************************************************
+* Private macros
+*************************************************************************************
+************************************************************************************/
+#if defined(gHcitHostFlowControl_d) && gHcitHostFlowControl_d
+/* ACL packets that can wait for the Host with the flow control enabled */
+#define mHost_AclTrackDepth_c   ((gHcitHostFlowAclPackets_c) + (gHcitHostFlowQueueLimit_c))
+#elif defined(gHcitAclRxDemux_d) && gHcitAclRxDemux_d
+/* ACL packets given to the busy Host by the receive demultiplexing, when a queue is full */
+#define mHost_AclTrackDepth_c   ((gHcitAclRxHostDepth_c) + (gHcitAclRxQueueDepth_c))
+#endif
+
 /************************************************************************************
 *************************************************************************************
 * Public memory declarations
@@ -45,6 +61,19 @@ static void Host_Task(osaTaskParam_t argument);
 ************************************************************************************/
 OSA_TASK_DEFINE(Host_Task, gHost_TaskPriority_c, 1, gHost_TaskStackSize_c, FALSE);
 
+/* Stack depth at the start of the Host task, the stack grows down */
+static uintptr_t mHost_TaskStackTop = 0U;
+
+#if (defined(gHcitHostFlowControl_d) && gHcitHostFlowControl_d) || (defined(gHcitAclRxDemux_d) && gHcitAclRxDemux_d)
+/* Packets queued for the Host task by Ble_HostTaskHciRecv(). The Host task takes them
+   in order, so the ones taken are this count minus the size of its queue. */
+static uint32_t mHost_HciQueued = 0U;
+/* Values of mHost_HciQueued of the ACL packets not known to be taken, oldest first */
+static uint32_t maHost_AclQueued[mHost_AclTrackDepth_c];
+static uint32_t mHost_AclHead = 0U;
+static uint32_t mHost_AclCount = 0U;
+#endif
+
 /************************************************************************************
 *************************************************************************************
 * Public functions
@@ -92,6 +121,97 @@ osaStatus_t Ble_HostTaskInit(void)
     return osaStatus_Success;
 }
 
+/*! *********************************************************************************
+* \brief  Returns the stack left to the code running in the Host task.
+*
+* \return  Bytes left below the current stack depth, or 0 outside the Host task.
+*
+********************************************************************************** */
+uint32_t Ble_HostTaskStackFree(void)
+{
+    volatile uint8_t  marker = 0U;
+    uintptr_t         used;
+
+    if ((mHost_TaskStackTop == 0U) || (OSA_TaskGetId() != gHost_TaskId))
+    {
+        return 0U;
+    }
+
+    used = mHost_TaskStackTop - (uintptr_t)&marker;
+
+    if (used >= (uintptr_t)gHost_TaskStackSize_c)
+    {
+        return 0U;
+    }
+
+    return (uint32_t)((uintptr_t)gHost_TaskStackSize_c - used);
+}
+
+#if (defined(gHcitHostFlowControl_d) && gHcitHostFlowControl_d) || (defined(gHcitAclRxDemux_d) && gHcitAclRxDemux_d)
+/*! *********************************************************************************
+* \brief  Gives an HCI packet to the Host, as Ble_HciRecv(), and keeps track of the
+*         ACL packets it queues for the Host task.
+*
+* \param[in] packetType     The type of the packet sent by the LE Controller
+* \param[in] pHciPacket     Pointer to the packet sent by the LE Controller
+* \param[in] packetSize     Number of bytes sent by the LE Controller
+*
+* \return  Result of Ble_HciRecv().
+*
+********************************************************************************** */
+bleResult_t Ble_HostTaskHciRecv
+(
+    hciPacketType_t     packetType,
+    void*               pHciPacket,
+    uint16_t            packetSize
+)
+{
+    bleResult_t result = Ble_HciRecv(packetType, pHciPacket, packetSize);
+
+    /* Ble_HciRecv() queues each packet it accepts */
+    if (gBleSuccess_c == result)
+    {
+        OSA_InterruptDisable();
+        mHost_HciQueued++;
+
+        /* Packets received before the flow control was enabled, or given early by
+           the demultiplexing, may not fit: they are not counted */
+        if ((packetType == gHciDataPacket_c) && (mHost_AclCount < mHost_AclTrackDepth_c))
+        {
+            maHost_AclQueued[(mHost_AclHead + mHost_AclCount) % mHost_AclTrackDepth_c] = mHost_HciQueued;
+            mHost_AclCount++;
+        }
+        OSA_InterruptEnable();
+    }
+
+    return result;
+}
+
+/*! *********************************************************************************
+* \brief  Returns the number of ACL packets given to the Host with
+*         Ble_HostTaskHciRecv() that the Host task has not taken yet.
+*
+********************************************************************************** */
+uint32_t Ble_HostTaskAclPending(void)
+{
+    uint32_t taken;
+    uint32_t pending;
+
+    OSA_InterruptDisable();
+    taken = mHost_HciQueued - ListGetSize(&gHci2Host_TaskQueue);
+
+    while ((mHost_AclCount > 0U) && ((int32_t)(maHost_AclQueued[mHost_AclHead] - taken) <= 0))
+    {
+        mHost_AclHead = (mHost_AclHead + 1U) % mHost_AclTrackDepth_c;
+        mHost_AclCount--;
+    }
+    pending = mHost_AclCount;
+    OSA_InterruptEnable();
+
+    return pending;
+}
+#endif /* gHcitHostFlowControl_d || gHcitAclRxDemux_d */
+
 /************************************************************************************
 *************************************************************************************
 * Private functions
@@ -108,6 +228,10 @@ osaStatus_t Ble_HostTaskInit(void)
 ********************************************************************************** */
 static void Host_Task(osaTaskParam_t argument)
 {
+    volatile uint8_t marker = 0U;
+
+    mHost_TaskStackTop = (uintptr_t)&marker;
+
     Host_TaskHandler((void *) NULL);
 }
 
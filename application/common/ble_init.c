@@ -109,7 +109,20 @@ bleResult_t Ble_Initialize
         .interfaceType = gHcitInterfaceType_d,
         .interfaceChannel = gHcitInterfaceNumber_d,
         .interfaceBaudrate = gHcitInterfaceSpeed_d,
-        .transportInterface =  Ble_HciRecv
+#if (defined(gHcitHostFlowControl_d) && gHcitHostFlowControl_d) || (defined(gHcitAclRxDemux_d) && gHcitAclRxDemux_d)
+        /* The flow control holds the reports, and the demultiplexing the ACL data,
+           while the Host has ACL packets to take */
+        .transportInterface =  Ble_HostTaskHciRecv,
+        .pfHostAclPending = Ble_HostTaskAclPending,
+#else
+        .transportInterface =  Ble_HciRecv,
+#endif
+#if defined(gHcitSharedMemory_d) && gHcitSharedMemory_d
+        .pSharedMemory = gHcitShmemRegion_d,
+        .pfDoorbell = gHcitShmemDoorbell_d
+#elif !gHcitSerialManagerSupport_d
+        .writeInterface = gHcitWriteInterface_d
+#endif
     };
 
     /* Set the config structure to the host stack */
@@ -125,6 +138,11 @@ bleResult_t Ble_Initialize
         return gHciTransportError_c;
     }
 
+#if defined(gHcitSharedMemory_d) && gHcitSharedMemory_d
+    /* Packets from the Controller core are delivered from its doorbell interrupt */
+    gHcitShmemDoorbellInstall_d(Hcit_ShmemDoorbellHandler);
+#endif
+
     /* Check for available memory storage */
     if (!Ble_CheckMemoryStorage())
     {
@@ -181,10 +199,28 @@ bleResult_t Ble_Initialize
         .interfaceType = gHcitInterfaceType_d,
         .interfaceChannel = gHcitInterfaceNumber_d,
         .interfaceBaudrate = gHcitInterfaceSpeed_d,
-        .transportInterface =  (hciTransportInterface_t)Hci_SendPacketToController
+        .transportInterface =  (hciTransportInterface_t)Hci_SendPacketToController,
+#if defined(gHcitSharedMemory_d) && gHcitSharedMemory_d
+        .pSharedMemory = gHcitShmemRegion_d,
+        .pfDoorbell = gHcitShmemDoorbell_d
+#elif !gHcitSerialManagerSupport_d
+        .writeInterface = gHcitWriteInterface_d
+#endif
     };
 
+#if defined(gHcitSharedMemory_d) && gHcitSharedMemory_d
+    if (gHciSuccess_c != Hcit_Init(&hcitConfigStruct))
+    {
+        return gHciTransportError_c;
+    }
+
+    /* Packets from the Host core are delivered from its doorbell interrupt */
+    gHcitShmemDoorbellInstall_d(Hcit_ShmemDoorbellHandler);
+
+    return gBleSuccess_c;
+#else
     return Hcit_Init(&hcitConfigStruct);
+#endif
 
 #else
 
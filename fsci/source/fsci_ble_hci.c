@@ -21,6 +21,8 @@
 ************************************************************************************/
 
 #include "fsci_ble_hci.h"
+#include "hcit_stats.h"
+#include "hcit_snoop.h"
 
 
 #if gFsciIncluded_c && gFsciBleHciLayerEnabled_d
@@ -63,6 +65,12 @@
 
 #if gFsciBleTest_d
     static void fsciBleHciCmdOrEvtMonitor(fsciBleHciOpCode_t opCode, hciPacketType_t packetType, void* pPacket, uint16_t packetSize);
+#if gHcitStatistics_d
+    static void fsciBleHciTransportStatisticsMonitor(void);
+#endif /* gHcitStatistics_d */
+#if gHcitSnoop_d
+    static void fsciBleHciSnoopDataMonitor(uint32_t offset, uint16_t maxLength);
+#endif /* gHcitSnoop_d */
 #endif /* gFsciBleTest_d */
 
 /************************************************************************************
@@ -126,6 +134,54 @@ void fsciBleHciHandler(void* pData, void* param, uint32_t fsciBleInterfaceId)
                         fsciBleHciCallApiFunction(Ble_HciSend(gHciSynchronousDataPacket_c, pBuffer, packetSize));
                     }
                     break;
+
+#if gHcitStatistics_d
+                case gBleHciCmdGetTransportStatisticsOpCode_c:
+                    {
+                        /* No parameters - the packet size is ignored */
+                        fsciBleHciTransportStatisticsMonitor();
+                    }
+                    break;
+#endif /* gHcitStatistics_d */
+
+#if gHcitSnoop_d
+                case gBleHciCmdSnoopControlOpCode_c:
+                    {
+                        uint16_t    connectionHandle;
+                        uint8_t     packetTypeMask;
+                        bool_t      enable;
+                        bool_t      clear;
+
+                        /* The parameters do not start with a packet size */
+                        pBuffer = &pClientPacket->structured.payload[0];
+                        fsciBleGetUint16ValueFromBuffer(connectionHandle, pBuffer);
+                        fsciBleGetUint8ValueFromBuffer(packetTypeMask, pBuffer);
+                        fsciBleGetBoolValueFromBuffer(enable, pBuffer);
+                        fsciBleGetBoolValueFromBuffer(clear, pBuffer);
+
+                        Hcit_SnoopEnable(enable);
+                        Hcit_SnoopSetFilter(packetTypeMask, connectionHandle);
+                        if(TRUE == clear)
+                        {
+                            Hcit_SnoopClear();
+                        }
+                        fsciBleHciStatusMonitor(gBleSuccess_c);
+                    }
+                    break;
+
+                case gBleHciCmdSnoopReadOpCode_c:
+                    {
+                        uint32_t    offset;
+                        uint16_t    maxLength;
+
+                        /* The parameters do not start with a packet size */
+                        pBuffer = &pClientPacket->structured.payload[0];
+                        fsciBleGetUint32ValueFromBuffer(offset, pBuffer);
+                        fsciBleGetUint16ValueFromBuffer(maxLength, pBuffer);
+                        fsciBleHciSnoopDataMonitor(offset, maxLength);
+                    }
+                    break;
+#endif /* gHcitSnoop_d */
                     
                 default:
                     {
@@ -281,6 +337,125 @@ static void fsciBleHciCmdOrEvtMonitor(fsciBleHciOpCode_t opCode, hciPacketType_t
     fsciBleTransmitFormatedPacket(pClientPacket, fsciBleInterfaceId);
 }
 
+#if gHcitStatistics_d
+static void fsciBleHciTransportStatisticsMonitor(void)
+{
+    clientPacketStructured_t*   pClientPacket;
+    uint8_t*                    pBuffer;
+    hcitStats_t                 stats;
+    hcitCmdLatency_t            latency;
+    uint8_t                     nbOfHistograms = 0U;
+    uint32_t                    i;
+    uint32_t                    j;
+
+    Hcit_GetStatistics(&stats);
+
+    /* Only the histograms in use are sent */
+    for(i = 0U; i < gHcitStatsMaxOpcodes_c; i++)
+    {
+        if((gBleSuccess_c == Hcit_GetCommandLatency((uint8_t)i, &latency)) && (latency.opcode != 0U))
+        {
+            nbOfHistograms++;
+        }
+    }
+
+    /* Allocate the packet to be sent over UART */
+    pClientPacket = fsciBleHciAllocFsciPacket(gBleHciEvtTransportStatisticsOpCode_c,
+                                              (4U * gHcitStatsPacketTypes_c * sizeof(uint32_t)) +
+                                              (10U * sizeof(uint32_t)) + (2U * sizeof(uint16_t)) + sizeof(uint8_t) +
+                                              nbOfHistograms * (sizeof(uint16_t) + (2U + gHcitLatencyBucketCount_c) * sizeof(uint32_t)));
+
+    if(NULL == pClientPacket)
+    {
+        return;
+    }
+
+    pBuffer = &pClientPacket->payload[0];
+
+    for(i = 0U; i < gHcitStatsPacketTypes_c; i++)
+    {
+        fsciBleGetBufferFromUint32Value(stats.rxPackets[i], pBuffer);
+        fsciBleGetBufferFromUint32Value(stats.rxBytes[i], pBuffer);
+        fsciBleGetBufferFromUint32Value(stats.txPackets[i], pBuffer);
+        fsciBleGetBufferFromUint32Value(stats.txBytes[i], pBuffer);
+    }
+
+    fsciBleGetBufferFromUint32Value(stats.rxResyncs, pBuffer);
+    fsciBleGetBufferFromUint32Value(stats.rxSkippedBytes, pBuffer);
+    fsciBleGetBufferFromUint32Value(stats.rxOversizeAclDrops, pBuffer);
+    fsciBleGetBufferFromUint32Value(stats.rxOversizeIsoDrops, pBuffer);
+    fsciBleGetBufferFromUint32Value(stats.rxNoBufferDrops, pBuffer);
+    fsciBleGetBufferFromUint32Value(stats.rxAllocations, pBuffer);
+    fsciBleGetBufferFromUint32Value(stats.txAllocations, pBuffer);
+    fsciBleGetBufferFromUint32Value(stats.txAllocFailures, pBuffer);
+    fsciBleGetBufferFromUint32Value(stats.txWriteErrors, pBuffer);
+    fsciBleGetBufferFromUint32Value(stats.latencyOverflows, pBuffer);
+    fsciBleGetBufferFromUint16Value(stats.txQueueDepth, pBuffer);
+    fsciBleGetBufferFromUint16Value(stats.txQueueDepthMax, pBuffer);
+
+    fsciBleGetBufferFromUint8Value(nbOfHistograms, pBuffer);
+
+    for(i = 0U; (i < gHcitStatsMaxOpcodes_c) && (nbOfHistograms > 0U); i++)
+    {
+        if((gBleSuccess_c == Hcit_GetCommandLatency((uint8_t)i, &latency)) && (latency.opcode != 0U))
+        {
+            fsciBleGetBufferFromUint16Value(latency.opcode, pBuffer);
+            fsciBleGetBufferFromUint32Value(latency.count, pBuffer);
+            fsciBleGetBufferFromUint32Value(latency.maxUs, pBuffer);
+
+            for(j = 0U; j < gHcitLatencyBucketCount_c; j++)
+            {
+                fsciBleGetBufferFromUint32Value(latency.buckets[j], pBuffer);
+            }
+            nbOfHistograms--;
+        }
+    }
+
+    /* Transmit the packet over UART */
+    fsciBleTransmitFormatedPacket(pClientPacket, fsciBleInterfaceId);
+}
+#endif /* gHcitStatistics_d */
+
+#if gHcitSnoop_d
+static void fsciBleHciSnoopDataMonitor(uint32_t offset, uint16_t maxLength)
+{
+    clientPacketStructured_t*   pClientPacket;
+    uint8_t*                    pBuffer;
+    uint8_t*                    pTotalSize;
+    uint32_t                    totalSize = Hcit_SnoopGetSize();
+    uint16_t                    length = 0U;
+
+    /* Read no further than the end of the btsnoop file */
+    if(offset < totalSize)
+    {
+        length = (uint16_t)(((totalSize - offset) < maxLength) ? (totalSize - offset) : maxLength);
+    }
+
+    /* Allocate the packet to be sent over UART */
+    pClientPacket = fsciBleHciAllocFsciPacket(gBleHciEvtSnoopDataOpCode_c,
+                                              (2U * sizeof(uint32_t)) + sizeof(uint16_t) + length);
+
+    if(NULL == pClientPacket)
+    {
+        return;
+    }
+
+    pBuffer = &pClientPacket->payload[0];
+
+    /* The total size is set once read: a read at offset 0 freezes the capture */
+    pTotalSize = pBuffer;
+    pBuffer += sizeof(uint32_t);
+    fsciBleGetBufferFromUint32Value(offset, pBuffer);
+
+    fsciBleGetBufferFromUint16Value(length, pBuffer);
+    (void)Hcit_SnoopRead(offset, pBuffer, length);
+    fsciBleGetBufferFromUint32Value(Hcit_SnoopGetSize(), pTotalSize);
+
+    /* Transmit the packet over UART */
+    fsciBleTransmitFormatedPacket(pClientPacket, fsciBleInterfaceId);
+}
+#endif /* gHcitSnoop_d */
+
 #endif /* gFsciBleTest_d */
 
 #endif /* gFsciIncluded_c && gFsciBleHciLayerEnabled_d */
@@ -96,13 +96,18 @@ typedef enum
     gBleHciCmdCommandOpCode_c                   = gBleHciCmdFirstOpCode_c,  /*! HCI command operation code */
     gBleHciCmdDataOpCode_c,                                                 /*! HCI data operation code */
     gBleHciCmdSynchronousDataOpCode_c,                                      /*! HCI synchronous data operation code */
+    gBleHciCmdGetTransportStatisticsOpCode_c,                               /*! HCI transport statistics request operation code */
+    gBleHciCmdSnoopControlOpCode_c,                                         /*! HCI capture control operation code */
+    gBleHciCmdSnoopReadOpCode_c,                                            /*! HCI capture read operation code */
     
     gBleHciStatusOpCode_c                       = 0x80,                     /*! HCI status operation code */ 
 
     gBleHciEvtFirstOpCode_c                     = 0x81, 
     gBleHciEvtEventOpCode_c                     = gBleHciEvtFirstOpCode_c,  /*! HCI event operation code */
     gBleHciEvtDataOpCode_c,                                                 /*! HCI data operation code */
-    gBleHciEvtSynchronousDataOpCode_c                                       /*! HCI synchronous data operation code */
+    gBleHciEvtSynchronousDataOpCode_c,                                      /*! HCI synchronous data operation code */
+    gBleHciEvtTransportStatisticsOpCode_c,                                  /*! HCI transport statistics operation code */
+    gBleHciEvtSnoopDataOpCode_c                                             /*! HCI capture data operation code */
 }fsciBleHciOpCode_t;
 
 /************************************************************************************
@@ -24,6 +24,8 @@
 #include "hci_types.h"
 
 #include "SerialManager.h"
+#include "hcit_stats.h"
+#include "hcit_snoop.h"
 
 /************************************************************************************
 *************************************************************************************
@@ -67,10 +69,358 @@
 #endif
 #endif
 
+/* Uses the Serial Manager for the interface. When disabled, the interface is provided
+   through the writeInterface of the configuration and Hcit_InterfaceDataReceived(),
+   for example to run the transport over another driver or off-target. */
 #ifndef gHcitSerialManagerSupport_d
 #define gHcitSerialManagerSupport_d 1
 #endif
 
+/* Enables the baud rate upgrade (Downward HCI Transport).
+   After each successful HCI Reset, the transport asks the Controller to switch to the
+   upgrade baud rate with a vendor command, switches the interface and checks the link
+   with Read Local Version Information. If the Controller does not answer, the previous
+   baud rate is restored. The Host gets the Reset Command Complete afterwards, with the
+   Hardware Failure status if the Controller answers at neither baud rate. */
+#ifndef gHcitBaudRateUpgrade_d
+#define gHcitBaudRateUpgrade_d      0
+#endif
+
+#if (gHcitBaudRateUpgrade_d) && (!(gUseHciTransportDownward_d) || !(gHcitSerialManagerSupport_d))
+#error "The baud rate upgrade requires the Downward HCI Transport and the Serial Manager!"
+#endif
+
+/* Baud rate requested after each HCI Reset. Can be changed with Hcit_SetBaudRateUpgrade(). */
+#ifndef gHcitUpgradeSpeed_d
+#define gHcitUpgradeSpeed_d         (921600U)
+#endif
+
+/* Vendor command switching the Controller baud rate. Its only parameter is the baud
+   rate on 4 bytes, little endian. */
+#ifndef gHcitBaudVendorOpcode_c
+#define gHcitBaudVendorOpcode_c     (0xFC09U)
+#endif
+
+/* Time given to the Controller to switch after the vendor command completes */
+#ifndef gHcitBaudSettleTimeMs_c
+#define gHcitBaudSettleTimeMs_c     (10U)
+#endif
+
+/* Time to wait for the answer to the vendor command and to the verification */
+#ifndef gHcitBaudVerifyTimeoutMs_c
+#define gHcitBaudVerifyTimeoutMs_c  (100U)
+#endif
+
+/* Number of bytes reserved in front of packets allocated with Hcit_AllocPacket().
+   Must be at least 1 to hold the H4 packet type marker. */
+#ifndef gHcitTxHeadroom_c
+#define gHcitTxHeadroom_c           1U
+#endif
+
+#if (gHcitTxHeadroom_c < 1U)
+#error "gHcitTxHeadroom_c must hold at least the H4 packet type marker"
+#endif
+
+/* Enables TX coalescing.
+   Packets sent in a burst are gathered into one serial write, bounded by
+   gHcitTxCoalesceBufferSize_c bytes and gHcitTxCoalesceTimeoutMs_c milliseconds.
+   Command packets are written out immediately, together with any pending data. */
+#ifndef gHcitTxCoalescing_d
+#define gHcitTxCoalescing_d         0
+#endif
+
+#ifndef gHcitTxCoalesceBufferSize_c
+#define gHcitTxCoalesceBufferSize_c (512U)
+#endif
+
+#ifndef gHcitTxCoalesceTimeoutMs_c
+#define gHcitTxCoalesceTimeoutMs_c  (2U)
+#endif
+
+/* Enables the ACL credit scheduler (Downward HCI Transport).
+   ACL packets are queued per connection and sent to the Controller only while it has
+   free buffers, as reported by the Read Buffer Size commands and the Number Of
+   Completed Packets events. Connections are served in weighted round-robin order. */
+#ifndef gHcitAclScheduler_d
+#define gHcitAclScheduler_d         0
+#endif
+
+#if (gHcitAclScheduler_d) && !(gUseHciTransportDownward_d)
+#error "The ACL credit scheduler requires the Downward HCI Transport!"
+#endif
+
+/* Number of connections tracked by the ACL credit scheduler */
+#ifndef gHcitAclMaxLinks_c
+#define gHcitAclMaxLinks_c          (gAppMaxConnections_c)
+#endif
+
+/* Number of ACL packets queued per connection */
+#ifndef gHcitAclQueueDepth_c
+#define gHcitAclQueueDepth_c        (8U)
+#endif
+
+/* Default number of ACL packets sent per connection in each round */
+#ifndef gHcitAclDefaultWeight_c
+#define gHcitAclDefaultWeight_c     (1U)
+#endif
+
+/* Enables the demultiplexing of the received ACL data by connection (Downward HCI
+   Transport). While more than gHcitAclRxHostDepth_c ACL packets wait for the Host, as
+   told by pfHostAclPending, received ACL packets are copied into a queue per
+   connection instead of being given to the Host. Events are given to the Host at
+   once, so they wait behind at most gHcitAclRxHostDepth_c ACL packets, and the queues
+   are given to the Host in round-robin order as it takes its packets. */
+#ifndef gHcitAclRxDemux_d
+#define gHcitAclRxDemux_d           0
+#endif
+
+#if (gHcitAclRxDemux_d) && !(gUseHciTransportDownward_d)
+#error "The ACL receive demultiplexing requires the Downward HCI Transport!"
+#endif
+
+/* Number of received ACL packets held per connection. When full, the oldest packet
+   of the connection is given to the Host first. */
+#ifndef gHcitAclRxQueueDepth_c
+#define gHcitAclRxQueueDepth_c      (4U)
+#endif
+
+/* Number of ACL packets waiting for the Host below which received ACL packets are
+   given to it */
+#ifndef gHcitAclRxHostDepth_c
+#define gHcitAclRxHostDepth_c       (2U)
+#endif
+
+#if (gHcitAclRxDemux_d) && (gHcitAclRxHostDepth_c == 0U)
+#error "The ACL receive demultiplexing requires gHcitAclRxHostDepth_c of at least 1!"
+#endif
+
+/* Period of the checks of a busy Host while ACL packets are held, in milliseconds */
+#ifndef gHcitAclRxPollMs_c
+#define gHcitAclRxPollMs_c          (2U)
+#endif
+
+/* Enables the HCI command queue (Downward HCI Transport).
+   Commands are sent to the Controller only while it has command credits, as reported
+   by Num_HCI_Command_Packets in the Command Complete and Command Status events, and
+   queued otherwise. The events given to the Host report the credits of the Controller
+   plus the free queue entries, so that the Host can submit several commands at once. */
+#ifndef gHcitCmdPipelining_d
+#define gHcitCmdPipelining_d        0
+#endif
+
+#if (gHcitCmdPipelining_d) && !(gUseHciTransportDownward_d)
+#error "The HCI command queue requires the Downward HCI Transport!"
+#endif
+
+/* Number of commands queued while the Controller has no command credits */
+#ifndef gHcitCmdQueueDepth_c
+#define gHcitCmdQueueDepth_c        (8U)
+#endif
+
+/* Enables the Controller to Host flow control (Downward HCI Transport).
+   After each successful HCI Reset, the transport declares gHcitHostFlowAclPackets_c
+   Host buffers with Host Buffer Size and enables the ACL flow control, before giving
+   the Reset Command Complete to the Host. Received ACL packets are given back to the
+   Controller with Host Number Of Completed Packets once their buffer is released and
+   no more than gHcitHostFlowQueueLimit_c ACL packets wait for the Host, as told by
+   pfHostAclPending. The Host then holds at most gHcitHostFlowAclPackets_c +
+   gHcitHostFlowQueueLimit_c received ACL packets. */
+#ifndef gHcitHostFlowControl_d
+#define gHcitHostFlowControl_d      0
+#endif
+
+#if (gHcitHostFlowControl_d) && !(gUseHciTransportDownward_d)
+#error "The Controller to Host flow control requires the Downward HCI Transport!"
+#endif
+
+/* Number of released ACL packets reported to the Controller at once. Pending
+   packets are always reported when the whole ACL receive pool is free. */
+#ifndef gHcitHostFlowCreditBatch_c
+#define gHcitHostFlowCreditBatch_c  (1U)
+#endif
+
+/* Number of ACL packets the Host can hold, declared to the Controller. The Controller
+   sends no more ACL packets than this between two reports. */
+#ifndef gHcitHostFlowAclPackets_c
+#define gHcitHostFlowAclPackets_c   (8U)
+#endif
+
+#if (gHcitHostFlowControl_d) && (gHcitHostFlowAclPackets_c == 0U)
+#error "The Controller to Host flow control requires at least 1 Host ACL packet!"
+#endif
+
+/* Number of ACL packets waiting for the Host above which released ACL packets are
+   not reported to the Controller */
+#ifndef gHcitHostFlowQueueLimit_c
+#define gHcitHostFlowQueueLimit_c   (4U)
+#endif
+
+/* Period of the retries of a report held by a busy Host, in milliseconds */
+#ifndef gHcitHostFlowPollMs_c
+#define gHcitHostFlowPollMs_c       (5U)
+#endif
+
+/* Enables the Three-wire UART (H5) transport instead of H4.
+   Adds SLIP framing, acknowledgements with a sliding window and an optional CRC,
+   so that corrupted or lost packets are retransmitted instead of breaking the link. */
+#ifndef gHcitH5Transport_d
+#define gHcitH5Transport_d          0
+#endif
+
+#if (gHcitH5Transport_d) && (gHcitBaudRateUpgrade_d)
+#error "The baud rate upgrade is not supported with the H5 transport!"
+#endif
+
+#if (gHcitH5Transport_d) && (gHcitTxCoalescing_d)
+#error "TX coalescing is not supported by the H5 transport!"
+#endif
+
+/* Number of reliable packets sent without waiting for an acknowledgement (1 to 7) */
+#ifndef gHcitH5WindowSize_c
+#define gHcitH5WindowSize_c         (4U)
+#endif
+
+#if (gHcitH5WindowSize_c < 1U) || (gHcitH5WindowSize_c > 7U)
+#error "The H5 sliding window size must be between 1 and 7!"
+#endif
+
+/* Requests the H5 data integrity check (CRC-CCITT) during link configuration */
+#ifndef gHcitH5UseCrc_d
+#define gHcitH5UseCrc_d             1
+#endif
+
+/* Period of the H5 link establishment messages and retransmission checks */
+#ifndef gHcitH5TimerIntervalMs_c
+#define gHcitH5TimerIntervalMs_c    (100U)
+#endif
+
+/* Time after which unacknowledged H5 packets are sent again */
+#ifndef gHcitH5RetransmitTimeoutMs_c
+#define gHcitH5RetransmitTimeoutMs_c (250U)
+#endif
+
+/* Enables zero-copy reception.
+   The transport interface keeps ownership of the received packet and must give it
+   back using Hcit_RxBufferRelease(). When disabled, the packet is reclaimed as soon
+   as the transport interface returns. Only for a custom transport interface: the
+   Host (Ble_HciRecv) and the Controller copy the packet and never release it. */
+#ifndef gHcitRxZeroCopy_d
+#define gHcitRxZeroCopy_d           0
+#endif
+
+#if (gHcitRxZeroCopy_d) && ((gUseHciTransportDownward_d) || (gUseHciTransportUpward_d))
+#error "Zero-copy reception requires a transport interface calling Hcit_RxBufferRelease()!"
+#endif
+
+/* Number of receive buffers for HCI Event (or Command) packets. Without zero-copy, a
+   buffer is given back as soon as the transport interface returns, so one is enough,
+   plus one for the Reset Command Complete held by the flow control and baud rate
+   upgrade setup. */
+#ifndef gHcitRxEventBufferCount_c
+#if (gHcitRxZeroCopy_d) || (gHcitHostFlowControl_d) || (gHcitBaudRateUpgrade_d)
+#define gHcitRxEventBufferCount_c   2
+#else
+#define gHcitRxEventBufferCount_c   1
+#endif
+#endif
+
+/* Number of receive buffers for HCI ACL Data packets */
+#ifndef gHcitRxAclBufferCount_c
+#if gHcitRxZeroCopy_d
+#define gHcitRxAclBufferCount_c     2
+#else
+#define gHcitRxAclBufferCount_c     1
+#endif
+#endif
+
+#if ((gHcitHostFlowControl_d) || (gHcitBaudRateUpgrade_d)) && (gHcitRxEventBufferCount_c < 2U)
+#error "The flow control and the baud rate upgrade hold the Reset event: at least 2 event buffers are needed!"
+#endif
+
+/* Enables the synchronous and ISO data packets. They are received in their own pool,
+   so isochronous streams never compete with the ACL and event buffers. ISO packets
+   are given to the callback set with Hcit_SetIsoDataCallback(), synchronous packets
+   to the transport interface. */
+#ifndef gHcitIsoSupport_d
+#define gHcitIsoSupport_d           0
+#endif
+
+/* Number of receive buffers for synchronous and ISO data packets */
+#ifndef gHcitRxIsoBufferCount_c
+#define gHcitRxIsoBufferCount_c     (4U)
+#endif
+
+/* Largest ISO data load received. Longer ISO packets are dropped. */
+#ifndef gHcitIsoMaxDataLength_c
+#define gHcitIsoMaxDataLength_c     (300U)
+#endif
+
+/* H4 packet type marker of ISO data packets */
+#define gHcitIsoDataPacket_c        (0x05U)
+
+/* Uses a shared memory region instead of a serial interface, for dual-core parts.
+   Each direction is a single-producer single-consumer ring of packet slots in the
+   region. Packets are built and consumed in place and the other core is signaled
+   through the doorbell of the configuration. Replaces hcit_serial_interface.c. */
+#ifndef gHcitSharedMemory_d
+#define gHcitSharedMemory_d         0
+#endif
+
+#if (gHcitSharedMemory_d) && !(gUseHciTransportDownward_d) && !(gUseHciTransportUpward_d)
+#error "The shared memory transport requires the Downward or the Upward HCI Transport!"
+#endif
+
+#if (gHcitSharedMemory_d) && ((gHcitH5Transport_d) || (gHcitTxCoalescing_d) || (gHcitBaudRateUpgrade_d))
+#error "H5, TX coalescing and the baud rate upgrade are serial interface features!"
+#endif
+
+#if (gHcitSharedMemory_d) && ((gHcitAclScheduler_d) || (gHcitHostFlowControl_d) || (gHcitStatistics_d) || (gHcitIsoSupport_d))
+#error "The ACL scheduler, flow control, statistics and ISO support are not available with the shared memory transport!"
+#endif
+
+#if (gHcitSharedMemory_d) && ((gHcitCmdPipelining_d) || (gHcitAclRxDemux_d))
+#error "The command queue and the ACL receive demultiplexing are not available with the shared memory transport!"
+#endif
+
+/* Number of packet slots of each ring (power of 2) */
+#ifndef gHcitShmemSlotCount_c
+#define gHcitShmemSlotCount_c       (8U)
+#endif
+
+#if (gHcitShmemSlotCount_c & (gHcitShmemSlotCount_c - 1U)) != 0U
+#error "gHcitShmemSlotCount_c must be a power of 2!"
+#endif
+
+/* Largest packet carried by a slot, packet type marker excluded */
+#ifndef gHcitShmemSlotSize_c
+#define gHcitShmemSlotSize_c        (gHcitMaxPayloadLen_c)
+#endif
+
+/* Keeps the indices written by each core in separate cache lines */
+#ifndef gHcitShmemCacheLineSize_c
+#define gHcitShmemCacheLineSize_c   (32U)
+#endif
+
+/* Platform hooks of the shared memory transport, used by Ble_Initialize():
+   - gHcitShmemRegion_d: address of the hcitShmemRegion_t. The rings are not cache
+     maintained, so the region must be mapped non-cacheable on both cores.
+   - gHcitShmemDoorbell_d: hcitDoorbell_t raising the doorbell interrupt of the other core.
+   - gHcitShmemDoorbellInstall_d(handler): installs the handler on the doorbell
+     interrupt raised by the other core, and enables it. */
+#if (gHcitSharedMemory_d) && (!defined(gHcitShmemRegion_d) || !defined(gHcitShmemDoorbell_d) || !defined(gHcitShmemDoorbellInstall_d))
+#error "The shared memory transport requires gHcitShmemRegion_d, gHcitShmemDoorbell_d and gHcitShmemDoorbellInstall_d!"
+#endif
+
+#if (gHcitSharedMemory_d) && (gHcitRxZeroCopy_d)
+#error "Zero-copy reception is not available with the shared memory transport!"
+#endif
+
+/* Write interface passed by Ble_Initialize() when the Serial Manager is not used:
+   name of the hcitWriteInterface_t function of the platform. */
+#if !(gHcitSerialManagerSupport_d) && !(gHcitSharedMemory_d) && ((gUseHciTransportDownward_d) || (gUseHciTransportUpward_d)) && !defined(gHcitWriteInterface_d)
+#error "The HCI transport requires gHcitWriteInterface_d when the Serial Manager is not used!"
+#endif
+
 /************************************************************************************
 *************************************************************************************
 * Public type definitions
@@ -84,14 +434,136 @@ typedef bleResult_t (* hciTransportInterface_t)
     uint16_t packetSize             /*!< Packet payload size. */
 );
 
+/* Writes a buffer to the interface. pfWriteComplete(pParam) must be called once the
+   buffer is no longer needed, unless an error is returned. */
+typedef bleResult_t (* hcitWriteInterface_t)
+(
+    uint8_t*            pBuffer,            /*!< Data to write. */
+    uint16_t            length,             /*!< Number of bytes to write. */
+    pSerialCallBack_t   pfWriteComplete,    /*!< Write completion callback. */
+    void*               pParam              /*!< Parameter of the completion callback. */
+);
+
+/* Packet slot of a shared memory ring */
+typedef struct hcitShmemSlot_tag
+{
+    uint16_t        length;
+    uint8_t         packetType;     /*!< 0 for a cancelled allocation. */
+    uint8_t         state;
+    uint8_t         data[(gHcitShmemSlotSize_c + 3U) & ~3U];
+}hcitShmemSlot_t;
+
+/* Single-producer single-consumer ring. The indices run freely and are used modulo
+   gHcitShmemSlotCount_c. Slots between tail and head belong to the consumer. */
+typedef struct hcitShmemRing_tag
+{
+    volatile uint32_t   head;           /*!< Written by the producer only. */
+    uint32_t            reserve;        /*!< Next slot allocated by the producer. */
+    uint8_t             rfu0[gHcitShmemCacheLineSize_c - 8U];
+    volatile uint32_t   tail;           /*!< Written by the consumer only. */
+    uint32_t            read;           /*!< Next slot delivered by the consumer. */
+    uint8_t             rfu1[gHcitShmemCacheLineSize_c - 8U];
+    hcitShmemSlot_t     slots[gHcitShmemSlotCount_c];
+}hcitShmemRing_t;
+
+/* Shared memory region of the HCI transport, placed in memory seen by both cores and
+   mapped non-cacheable on both */
+typedef struct hcitShmemRegion_tag
+{
+    hcitShmemRing_t     hostToController;
+    hcitShmemRing_t     controllerToHost;
+}hcitShmemRegion_t;
+
+/* Signals the other core that packets were added to a ring */
+typedef void (* hcitDoorbell_t)
+(
+    void
+);
+
+/* Returns the number of ACL packets given to the transport interface and not yet
+   taken by the Host */
+typedef uint32_t (* hcitHostAclPending_t)
+(
+    void
+);
+
 typedef struct hcitConfigStruct_tag
 {
     serialInterfaceType_t   interfaceType;
     uint8_t                 interfaceChannel;
     uint32_t                interfaceBaudrate;
     hciTransportInterface_t transportInterface;
+    hcitWriteInterface_t    writeInterface;     /* Used only if gHcitSerialManagerSupport_d is 0 */
+    hcitShmemRegion_t*      pSharedMemory;      /* Used only if gHcitSharedMemory_d is 1 */
+    hcitDoorbell_t          pfDoorbell;         /* Used only if gHcitSharedMemory_d is 1 */
+    hcitHostAclPending_t    pfHostAclPending;   /* Used only if gHcitHostFlowControl_d or gHcitAclRxDemux_d
+                                                   is 1. If NULL, the reports wait only for the buffers
+                                                   and no ACL packet is held */
 }hcitConfigStruct_t;
 
+/* Reports the baud rate in use after an upgrade attempt. 0 if the Controller answers
+   at none of the baud rates. */
+typedef void (* hcitBaudRateCallback_t)
+(
+    uint32_t            baudrate
+);
+
+/* ISO data packet received from the Controller */
+typedef struct hcitIsoPacket_tag
+{
+    uint16_t        connectionHandle;
+    uint8_t         pbFlag;                 /*!< Packet boundary flag: first, continuation, complete or last fragment. */
+    bool_t          timestampPresent;
+    uint32_t        timestamp;              /*!< Time stamp in microseconds, if present. */
+    bool_t          sduHeaderPresent;       /*!< TRUE for first fragments and complete SDUs. */
+    uint16_t        packetSequenceNumber;   /*!< Valid if sduHeaderPresent is TRUE. */
+    uint16_t        isoSduLength;           /*!< Valid if sduHeaderPresent is TRUE. */
+    uint8_t         packetStatusFlag;       /*!< Valid if sduHeaderPresent is TRUE. */
+    const uint8_t*  pData;                  /*!< SDU fragment. */
+    uint16_t        dataLength;
+}hcitIsoPacket_t;
+
+/* Receives the ISO data packets. The packet is valid only during the call. */
+typedef void (* hcitIsoDataCallback_t)
+(
+    const hcitIsoPacket_t*  pPacket
+);
+
+/* TX coalescing counters. The batching ratio is packets / serialWrites. */
+typedef struct hcitTxCoalesceStats_tag
+{
+    uint32_t    packets;            /*!< Packets copied into a coalescing buffer. */
+    uint32_t    serialWrites;       /*!< Serial writes issued for coalesced packets. */
+    uint32_t    sizeFlushes;        /*!< Writes triggered because the buffer was full. */
+    uint32_t    timeoutFlushes;     /*!< Writes triggered by the latency timer. */
+    uint32_t    bypassed;           /*!< Packets written directly (no free buffer or too big). */
+    uint32_t    writeErrors;        /*!< Coalesced writes rejected by the serial interface. */
+}hcitTxCoalesceStats_t;
+
+/* Received ACL data counters of a connection */
+typedef struct hcitAclRxStats_tag
+{
+    uint32_t    packets;            /*!< ACL packets received on the connection. */
+    uint32_t    bytes;              /*!< ACL bytes received, header included. */
+    uint32_t    held;               /*!< Packets held because the Host was busy. */
+    uint32_t    overflows;          /*!< Held packets given to the Host early because the queue was full. */
+    uint32_t    bypassed;           /*!< Packets given to the Host at once, for lack of memory to hold them. */
+    uint8_t     queued;             /*!< Packets currently held. */
+    uint8_t     maxQueued;          /*!< Highest number of packets held. */
+}hcitAclRxStats_t;
+
+/* H5 link counters */
+typedef struct hcitH5Stats_tag
+{
+    uint32_t    rxFrames;           /*!< Valid frames received. */
+    uint32_t    rxErrors;           /*!< Frames dropped: SLIP, header checksum, length or CRC error. */
+    uint32_t    rxOutOfOrder;       /*!< Reliable frames dropped because of their sequence number. */
+    uint32_t    txFrames;           /*!< Frames written to the serial interface. */
+    uint32_t    txErrors;           /*!< Frames not written: no memory or serial error. */
+    uint32_t    retransmissions;    /*!< Reliable frames sent again. */
+    uint32_t    linkResets;         /*!< Link establishments restarted by the peer. */
+}hcitH5Stats_t;
+
 /************************************************************************************
 *************************************************************************************
 * Public memory declarations
@@ -163,6 +635,189 @@ bleResult_t Hcit_SendPacket(hciPacketType_t packetType, void* pPacket, uint16_t
 ********************************************************************************** */
 bleResult_t Hcit_RecvPacket(void* pPacket, uint16_t packetSize);
 
+/*! *********************************************************************************
+* \brief        Allocates a TX packet with headroom for the HCI transport header.
+*
+* \param[in]    packetSize  Size of the HCI packet, without the transport header
+*
+* \return       Pointer where the HCI packet must be built, or NULL on failure.
+*
+* \remarks      Send it with Hcit_SendAllocatedPacket(), or free it with
+*               Hcit_FreePacket() if it is not sent.
+*
+********************************************************************************** */
+void* Hcit_AllocPacket(uint16_t packetSize);
+
+/*! *********************************************************************************
+* \brief        Frees a TX packet allocated with Hcit_AllocPacket().
+*
+* \param[in]    pPacket     Packet returned by Hcit_AllocPacket()
+*
+********************************************************************************** */
+void Hcit_FreePacket(void* pPacket);
+
+/*! *********************************************************************************
+* \brief        Sends a packet allocated with Hcit_AllocPacket() without copying it.
+*
+* \param[in]    packetType  HCI packet type
+* \param[in]    pPacket     Packet returned by Hcit_AllocPacket()
+* \param[in]    packetSize  Size of the HCI packet, without the transport header
+*
+* \return       gBleSuccess_c or error.
+*
+* \remarks      Ownership of the packet passes to the transport, even on failure,
+*               except on gBleOverflow_c: the ACL or command queue is full and the
+*               caller keeps the packet, to send it again later or free it.
+*
+********************************************************************************** */
+bleResult_t Hcit_SendAllocatedPacket(hciPacketType_t packetType, void* pPacket, uint16_t packetSize);
+
+#if gHcitTxCoalescing_d
+/*! *********************************************************************************
+* \brief        Reads the TX coalescing counters.
+*
+* \param[out]   pStats      Copy of the counters
+* \param[in]    reset       If TRUE, the counters are cleared after being read
+*
+* \remarks      Available only when gHcitTxCoalescing_d is enabled.
+*
+********************************************************************************** */
+void Hcit_GetTxCoalesceStats(hcitTxCoalesceStats_t* pStats, bool_t reset);
+#endif /* gHcitTxCoalescing_d */
+
+/*! *********************************************************************************
+* \brief        Sets the ACL scheduling weight of a connection.
+*
+* \param[in]    connectionHandle    HCI connection handle
+* \param[in]    weight              ACL packets sent for the connection in each round
+*
+* \return       gBleSuccess_c or error.
+*
+* \remarks      Available only when gHcitAclScheduler_d is enabled. The weight goes
+*               back to gHcitAclDefaultWeight_c when the connection is closed.
+*
+********************************************************************************** */
+bleResult_t Hcit_AclSetLinkWeight(uint16_t connectionHandle, uint8_t weight);
+
+/*! *********************************************************************************
+* \brief        Reads the received ACL data counters of a connection.
+*
+* \param[in]    connectionHandle    HCI connection handle
+* \param[out]   pStats              Copy of the counters
+*
+* \return       gBleSuccess_c, or gBleInvalidParameter_c if no data was received on
+*               the connection.
+*
+* \remarks      Available only when gHcitAclRxDemux_d is enabled. The counters are
+*               cleared when the connection is closed.
+*
+********************************************************************************** */
+bleResult_t Hcit_AclRxGetStats(uint16_t connectionHandle, hcitAclRxStats_t* pStats);
+
+/*! *********************************************************************************
+* \brief        Reads the H5 link counters.
+*
+* \param[out]   pStats      Copy of the counters
+*
+* \remarks      Available only when gHcitH5Transport_d is enabled.
+*
+********************************************************************************** */
+void Hcit_H5GetStats(hcitH5Stats_t* pStats);
+
+/*! *********************************************************************************
+* \brief        Sets the baud rate requested after each HCI Reset.
+*
+* \param[in]    baudrate    Upgrade baud rate, or 0 to keep the current baud rate
+* \param[in]    pfCallback  Called with the baud rate in use after each attempt. Can be NULL.
+*
+* \remarks      Available only when gHcitBaudRateUpgrade_d is enabled. The callback is
+*               called from the HCI transport or timer context.
+*
+********************************************************************************** */
+void Hcit_SetBaudRateUpgrade(uint32_t baudrate, hcitBaudRateCallback_t pfCallback);
+
+/*! *********************************************************************************
+* \brief        Returns the baud rate of the interface.
+*
+* \return       Baud rate in use, or 0 if the last upgrade lost the Controller.
+*
+* \remarks      Available only when gHcitBaudRateUpgrade_d is enabled.
+*
+********************************************************************************** */
+uint32_t Hcit_GetBaudRate(void);
+
+/*! *********************************************************************************
+* \brief        Sets the callback receiving the ISO data packets.
+*
+* \param[in]    pfCallback  ISO data callback, or NULL to drop the ISO data packets
+*
+* \remarks      Available only when gHcitIsoSupport_d is enabled. ISO data packets are
+*               sent with Hcit_SendPacket() and the gHcitIsoDataPacket_c packet type.
+*
+********************************************************************************** */
+void Hcit_SetIsoDataCallback(hcitIsoDataCallback_t pfCallback);
+
+/*! *********************************************************************************
+* \brief        Gives a received packet back to the HCI transport receive pool.
+*
+* \param[in]    pPacket     Packet delivered to the transport interface
+*
+* \remarks      Required only when gHcitRxZeroCopy_d is enabled, from the custom
+*               transport interface once it is done with the packet.
+*
+********************************************************************************** */
+void Hcit_RxBufferRelease(void* pPacket);
+
+/*! *********************************************************************************
+* \brief        Feeds bytes received from the interface to the HCI transport.
+*
+* \param[in]    pData       Pointer to the received bytes
+* \param[in]    dataLength  Number of received bytes
+*
+* \remarks      Used when gHcitSerialManagerSupport_d is 0. With the H5 transport the
+*               bytes are SLIP decoded first, otherwise they are parsed as H4.
+*
+********************************************************************************** */
+void Hcit_InterfaceDataReceived(const uint8_t* pData, uint16_t dataLength);
+
+#if !(gHcitSerialManagerSupport_d) && defined(gHcitWriteInterface_d)
+/* Write interface of the platform, see gHcitWriteInterface_d */
+bleResult_t gHcitWriteInterface_d(uint8_t* pBuffer, uint16_t length, pSerialCallBack_t pfWriteComplete, void* pParam);
+#endif
+
+/*! *********************************************************************************
+* \brief        Feeds a span of raw H4 bytes received from the serial interface to
+*               the HCI packet parser.
+*
+* \param[in]    pData       Pointer to the received bytes
+* \param[in]    dataLength  Number of received bytes
+*
+* \remarks      The span does not need to be aligned to packet boundaries. Complete
+*               packets are delivered to the configured transport interface.
+*
+********************************************************************************** */
+void hci_processReceivedData(const uint8_t* pData, uint16_t dataLength);
+
+/*! *********************************************************************************
+* \brief        Feeds one raw H4 byte received from the serial interface to the
+*               HCI packet parser.
+*
+* \param[in]    recvChar    The received byte
+*
+********************************************************************************** */
+void hci_processReceivedChar(uint8_t recvChar);
+
+#if gHcitSharedMemory_d
+/*! *********************************************************************************
+* \brief        Delivers the packets added by the other core to the receive ring.
+*
+* \remarks      Called from the doorbell interrupt raised by the other core, or
+*               polled. It must always be called from the same context.
+*
+********************************************************************************** */
+void Hcit_ShmemDoorbellHandler(void);
+#endif /* gHcitSharedMemory_d */
+
 #ifdef __cplusplus
     }
 #endif
@@ -0,0 +1,123 @@
+/*! *********************************************************************************
+* \addtogroup HCI
+* @{
+********************************************************************************** */
+/*! *********************************************************************************
+* Copyright 2026 NXP
+* All rights reserved.
+*
+* \file
+*
+* This is the interface of the btsnoop capture of the HCI traffic. It has no
+* dependency on the serial interface, so that it can be used by the test and
+* monitoring modules.
+*
+* SPDX-License-Identifier: BSD-3-Clause
+********************************************************************************** */
+
+#ifndef HCIT_SNOOP_H
+#define HCIT_SNOOP_H
+
+/************************************************************************************
+*************************************************************************************
+* Include
+*************************************************************************************
+************************************************************************************/
+#include "ble_general.h"
+
+/************************************************************************************
+*************************************************************************************
+* Public constants & macros
+*************************************************************************************
+************************************************************************************/
+/* Enables the btsnoop capture of the HCI traffic in a RAM ring buffer */
+#ifndef gHcitSnoop_d
+#define gHcitSnoop_d                0
+#endif
+
+/* Size of the capture ring buffer. The oldest records are overwritten when full. */
+#ifndef gHcitSnoopBufferSize_c
+#define gHcitSnoopBufferSize_c      (4096U)
+#endif
+
+/* Number of ACL, synchronous and ISO payload bytes kept after the packet header */
+#ifndef gHcitSnoopDataSnapLen_c
+#define gHcitSnoopDataSnapLen_c     (32U)
+#endif
+
+/* Capture filter: bit n enables packets with the H4 packet type marker n */
+#define gHcitSnoopFilterAll_c       (0xFFU)
+/* Capture filter: no filtering on the connection handle */
+#define gHcitSnoopAnyHandle_c       (0xFFFFU)
+
+/************************************************************************************
+*************************************************************************************
+* Public prototypes
+*************************************************************************************
+************************************************************************************/
+#ifdef __cplusplus
+    extern "C" {
+#endif
+
+#if gHcitSnoop_d
+/*! *********************************************************************************
+* \brief        Starts or stops the btsnoop capture.
+*
+* \param[in]    enable      TRUE to capture the HCI traffic
+*
+* \remarks      The capture is enabled at startup. Also ends a read in progress.
+*
+********************************************************************************** */
+void Hcit_SnoopEnable(bool_t enable);
+
+/*! *********************************************************************************
+* \brief        Sets the btsnoop capture filters.
+*
+* \param[in]    packetTypeMask      Bit n enables packets with the H4 marker n
+* \param[in]    connectionHandle    Handle of the captured ACL, synchronous and ISO
+*                                   packets, or gHcitSnoopAnyHandle_c
+*
+********************************************************************************** */
+void Hcit_SnoopSetFilter(uint8_t packetTypeMask, uint16_t connectionHandle);
+
+/*! *********************************************************************************
+* \brief        Discards all captured records. Also ends a read in progress.
+*
+********************************************************************************** */
+void Hcit_SnoopClear(void);
+
+/*! *********************************************************************************
+* \brief        Returns the size of the capture as a btsnoop file.
+*
+* \return       Size of the file header and of the captured records, in bytes.
+*
+********************************************************************************** */
+uint32_t Hcit_SnoopGetSize(void);
+
+/*! *********************************************************************************
+* \brief        Reads a part of the capture, formatted as a btsnoop file.
+*
+* \param[in]    offset      Offset in the btsnoop file
+* \param[out]   pBuffer     Destination buffer
+* \param[in]    length      Size of the destination buffer
+*
+* \return       Number of bytes copied. 0 after the end of the file.
+*
+* \remarks      The file uses the HCI UART (H4) datalink type, the records are in
+*               chronological order. A read at offset 0 pauses the capture until the
+*               last byte of the file is read, so that the file does not change
+*               between chunks. The packets of the pause are counted as dropped.
+*
+********************************************************************************** */
+uint32_t Hcit_SnoopRead(uint32_t offset, uint8_t* pBuffer, uint32_t length);
+#endif /* gHcitSnoop_d */
+
+#ifdef __cplusplus
+    }
+#endif
+
+#endif /* HCIT_SNOOP_H */
+
+/*! *********************************************************************************
+* @}
+********************************************************************************** */
@@ -0,0 +1,136 @@
+/*! *********************************************************************************
+* \addtogroup HCI
+* @{
+********************************************************************************** */
+/*! *********************************************************************************
+* Copyright 2026 NXP
+* All rights reserved.
+*
+* \file
+*
+* This is the interface of the HCI transport statistics. It has no dependency on the
+* serial interface, so that it can be used by the test and monitoring modules.
+*
+* SPDX-License-Identifier: BSD-3-Clause
+********************************************************************************** */
+
+#ifndef HCIT_STATS_H
+#define HCIT_STATS_H
+
+/************************************************************************************
+*************************************************************************************
+* Include
+*************************************************************************************
+************************************************************************************/
+#include "ble_general.h"
+
+/************************************************************************************
+*************************************************************************************
+* Public constants & macros
+*************************************************************************************
+************************************************************************************/
+/* Enables the HCI transport statistics: packet and byte counters, parser and
+   allocation errors, TX queue depth and command latency histograms */
+#ifndef gHcitStatistics_d
+#define gHcitStatistics_d           0
+#endif
+
+/* Number of command opcodes with a latency histogram */
+#ifndef gHcitStatsMaxOpcodes_c
+#define gHcitStatsMaxOpcodes_c      (8U)
+#endif
+
+/* Number of commands tracked at the same time until their completion */
+#ifndef gHcitStatsMaxPendingCmds_c
+#define gHcitStatsMaxPendingCmds_c  (4U)
+#endif
+
+/* Packet counters are indexed by H4 packet type marker. Index 0 counts unknown types. */
+#define gHcitStatsPacketTypes_c     (6U)
+
+/* Command latency buckets: < 1, 2, 5, 10, 20, 50, 100 ms and >= 100 ms */
+#define gHcitLatencyBucketCount_c   (8U)
+
+/************************************************************************************
+*************************************************************************************
+* Public type definitions
+*************************************************************************************
+************************************************************************************/
+/* HCI transport counters */
+typedef struct hcitStats_tag
+{
+    uint32_t    rxPackets[gHcitStatsPacketTypes_c]; /*!< Packets received, per packet type. */
+    uint32_t    rxBytes[gHcitStatsPacketTypes_c];   /*!< Bytes received, packet type marker included. */
+    uint32_t    txPackets[gHcitStatsPacketTypes_c]; /*!< Packets sent, per packet type. */
+    uint32_t    txBytes[gHcitStatsPacketTypes_c];   /*!< Bytes sent, packet type marker included. */
+    uint32_t    rxResyncs;                          /*!< Times the parser lost the packet boundaries. */
+    uint32_t    rxSkippedBytes;                     /*!< Bytes skipped while looking for a packet type marker. */
+    uint32_t    rxOversizeAclDrops;                 /*!< ACL packets dropped for exceeding the maximum length. */
+    uint32_t    rxOversizeIsoDrops;                 /*!< ISO packets dropped for exceeding the maximum length. */
+    uint32_t    rxNoBufferDrops;                    /*!< Packets dropped for lack of a receive buffer. */
+    uint32_t    rxAllocations;                      /*!< Receive buffers taken from the pools. */
+    uint32_t    txAllocations;                      /*!< Buffers allocated by Hcit_AllocPacket(). */
+    uint32_t    txAllocFailures;                    /*!< Hcit_AllocPacket() calls that failed to allocate memory. */
+    uint32_t    txWriteErrors;                      /*!< Writes rejected by the serial interface. */
+    uint32_t    latencyOverflows;                   /*!< Commands not tracked because a table was full. */
+    uint16_t    txQueueDepth;                       /*!< Serial writes in progress. */
+    uint16_t    txQueueDepthMax;                    /*!< Highest number of serial writes in progress. */
+}hcitStats_t;
+
+/* Command to Command Complete / Command Status latency histogram */
+typedef struct hcitCmdLatency_tag
+{
+    uint16_t    opcode;                                 /*!< HCI command opcode, 0 if unused. */
+    uint32_t    count;                                  /*!< Number of completed commands. */
+    uint32_t    maxUs;                                  /*!< Highest latency, in microseconds. */
+    uint32_t    buckets[gHcitLatencyBucketCount_c];     /*!< Number of commands per latency range. */
+}hcitCmdLatency_t;
+
+/************************************************************************************
+*************************************************************************************
+* Public prototypes
+*************************************************************************************
+************************************************************************************/
+#ifdef __cplusplus
+    extern "C" {
+#endif
+
+#if gHcitStatistics_d
+/*! *********************************************************************************
+* \brief        Reads the HCI transport counters.
+*
+* \param[out]   pStats      Copy of the counters
+*
+********************************************************************************** */
+void Hcit_GetStatistics(hcitStats_t* pStats);
+
+/*! *********************************************************************************
+* \brief        Reads the latency histogram of one command opcode.
+*
+* \param[in]    index       Histogram index, from 0 to gHcitStatsMaxOpcodes_c - 1
+* \param[out]   pLatency    Copy of the histogram
+*
+* \return       gBleSuccess_c or gBleInvalidParameter_c.
+*
+* \remarks      Histograms are assigned to opcodes in the order their first command
+*               completes.
+*
+********************************************************************************** */
+bleResult_t Hcit_GetCommandLatency(uint8_t index, hcitCmdLatency_t* pLatency);
+
+/*! *********************************************************************************
+* \brief        Clears the HCI transport counters and latency histograms.
+*
+********************************************************************************** */
+void Hcit_ResetStatistics(void);
+#endif /* gHcitStatistics_d */
+
+#ifdef __cplusplus
+    }
+#endif
+
+#endif /* HCIT_STATS_H */
+
+/*! *********************************************************************************
+* @}
+********************************************************************************** */
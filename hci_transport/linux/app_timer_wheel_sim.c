@@ -0,0 +1,690 @@
+/*! *********************************************************************************
+* Copyright 2026 NXP
+* All rights reserved.
+*
+* \file
+*
+* Runs the application timer wheel (gAppTimerWheel_d) on a simulated clock and
+* checks when each timer expires.
+*
+* The Timers Manager stand-in is switched to simulated time: the tool moves the
+* clock to the next expiry of the low power timer of the wheel, so hours of
+* simulated time run in a few milliseconds. The posted handlers run after each
+* wake-up, like in the Application Task. Every timer is started on a tick of the
+* wheel, so it must expire on the exact tick that follows its delay. The scenarios
+* are:
+*   cancel    timers started, restarted and stopped in the same slot, and the low
+*             power timer stopped when the wheel is empty
+*   cascade   one timer on each level of the wheel, which must wake the device up
+*             only for its own slots on the way down
+*   beyond    delays longer than the wheel, parked on its top level
+*   periodic  periodic timers, stopped from their handler, and woken up late: the
+*             missed periods are posted once
+*   random    timers with random delays, started while the wheel lags behind the
+*             clock, and some of them stopped or restarted
+*
+* The exit status is nonzero if a check fails.
+*
+* SPDX-License-Identifier: BSD-3-Clause
+********************************************************************************** */
+
+/************************************************************************************
+*************************************************************************************
+* Include
+*************************************************************************************
+************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "app_timer_wheel.h"
+#include "TimersManager.h"
+
+/************************************************************************************
+*************************************************************************************
+* Private macros
+*************************************************************************************
+************************************************************************************/
+#define mWheelTickUs_c              ((uint64_t)gAppTimerWheelTickMs_c * 1000U)
+
+/* Ticks covered by the levels below the given one, and by the whole wheel */
+#define mWheelLevelSpan(level)      (1UL << (5U * (level)))
+#define mWheelSpanMs_c              ((uint64_t)mWheelLevelSpan(gAppTimerWheelLevels_c) * gAppTimerWheelTickMs_c)
+
+/* Handlers posted by one wake-up of the wheel */
+#define mWheelMaxPosts_c            (256U)
+
+#define mWheelRandomTimers_c        (200U)
+#define mWheelRandomMaxDelayMs_c    (600000U)
+
+/************************************************************************************
+*************************************************************************************
+* Private type definitions
+*************************************************************************************
+************************************************************************************/
+typedef struct wheelTimer_tag
+{
+    appTimerWheelEntry_t    entry;
+    uint32_t                id;
+    uint32_t                periodMs;
+    uint32_t                stopAfter;  /*!< The handler stops the timer after this many expiries, 0 for never. */
+    uint32_t                count;      /*!< Expiries. */
+    uint32_t                expected;   /*!< Expiries at the end of the scenario. */
+    uint64_t                dueMs;      /*!< Next expiry, before the rounding to the tick. */
+}wheelTimer_t;
+
+typedef struct wheelPost_tag
+{
+    appCallbackHandler_t    handler;
+    appCallbackParam_t      param;
+}wheelPost_t;
+
+/************************************************************************************
+*************************************************************************************
+* Private prototypes
+*************************************************************************************
+************************************************************************************/
+static uint64_t Wheel_NowMs(void);
+static uint64_t Wheel_RoundUpMs(uint64_t ms);
+static uint32_t Wheel_Level(uint32_t delayMs);
+static uint32_t Wheel_Random(void);
+static void Wheel_Expired(appCallbackParam_t param);
+static void Wheel_RunPosts(void);
+static void Wheel_Run(uint32_t ms);
+static void Wheel_StartTimer(const char* pName, wheelTimer_t* pTimer, uint32_t delayMs, uint32_t periodMs);
+static void Wheel_Check(const char* pName, bool_t condition, const char* pWhat);
+static void Wheel_CheckTimer(const char* pName, const wheelTimer_t* pTimer);
+static void Wheel_CheckIdle(const char* pName);
+static void Wheel_Start(const char* pName, wheelTimer_t* pTimers, uint32_t count);
+static int Wheel_Finish(const char* pName);
+static int Wheel_Cancel(void);
+static int Wheel_Cascade(void);
+static int Wheel_Beyond(void);
+static int Wheel_Periodic(void);
+static int Wheel_Mixed(void);
+static void Wheel_Usage(void);
+
+/************************************************************************************
+*************************************************************************************
+* Private memory declarations
+*************************************************************************************
+************************************************************************************/
+static uint32_t     mSeed = 1U;
+static bool_t       mQuiet;
+
+static uint64_t     mStartUs;
+static uint32_t     mWakeups;
+static uint32_t     mErrors;
+static uint32_t     mScenarioErrors;
+
+/* Handlers posted to the simulated Application Task */
+static wheelPost_t  mPosts[mWheelMaxPosts_c];
+static uint32_t     mPostCount;
+
+static wheelTimer_t mTimers[mWheelRandomTimers_c];
+
+/************************************************************************************
+*************************************************************************************
+* Public functions
+*************************************************************************************
+************************************************************************************/
+/*! *********************************************************************************
+* \brief  Posts a handler to the simulated Application Task.
+*
+********************************************************************************** */
+bleResult_t App_PostCallbackMessage
+(
+    appCallbackHandler_t   handler,
+    appCallbackParam_t     param
+)
+{
+    if( mPostCount == mWheelMaxPosts_c )
+    {
+        (void)fprintf(stderr, "too many handlers posted at once\n");
+        mErrors++;
+        return gBleOverflow_c;
+    }
+
+    mPosts[mPostCount].handler = handler;
+    mPosts[mPostCount].param = param;
+    mPostCount++;
+
+    return gBleSuccess_c;
+}
+
+int main(int argc, char* argv[])
+{
+    uint64_t    now;
+    int         opt;
+    int         result = 0;
+
+    while( (opt = getopt(argc, argv, "s:qh")) != -1 )
+    {
+        switch( opt )
+        {
+            case 's':
+                mSeed = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            case 'q':
+                mQuiet = TRUE;
+                break;
+            default:
+                Wheel_Usage();
+                return 2;
+        }
+    }
+
+    /* Simulated time, starting on a tick of the wheel */
+    TMR_AdvanceTimestamp(0U);
+    now = TMR_GetTimestamp();
+    TMR_AdvanceTimestamp((mWheelTickUs_c - (now % mWheelTickUs_c)) % mWheelTickUs_c);
+    mStartUs = TMR_GetTimestamp();
+
+    if( App_TimerWheelInit() != gBleSuccess_c )
+    {
+        (void)fprintf(stderr, "App_TimerWheelInit failed\n");
+        return 1;
+    }
+
+    result |= Wheel_Cancel();
+    result |= Wheel_Cascade();
+    result |= Wheel_Beyond();
+    result |= Wheel_Periodic();
+    result |= Wheel_Mixed();
+
+    return result;
+}
+
+/************************************************************************************
+*************************************************************************************
+* Private functions
+*************************************************************************************
+************************************************************************************/
+static uint64_t Wheel_NowMs(void)
+{
+    return (TMR_GetTimestamp() - mStartUs) / 1000U;
+}
+
+static uint64_t Wheel_RoundUpMs(uint64_t ms)
+{
+    return ((ms + gAppTimerWheelTickMs_c - 1U) / gAppTimerWheelTickMs_c) * gAppTimerWheelTickMs_c;
+}
+
+/*! *********************************************************************************
+* \brief  Returns the level on which a timer started on an up to date wheel is
+*         linked.
+*
+********************************************************************************** */
+static uint32_t Wheel_Level(uint32_t delayMs)
+{
+    uint64_t    ticks = Wheel_RoundUpMs(delayMs) / gAppTimerWheelTickMs_c;
+    uint32_t    level = 0U;
+
+    while( ((level + 1U) < gAppTimerWheelLevels_c) && (ticks >= mWheelLevelSpan(level + 1U)) )
+    {
+        level++;
+    }
+
+    return level;
+}
+
+static uint32_t Wheel_Random(void)
+{
+    mSeed = mSeed * 1103515245U + 12345U;
+
+    return mSeed >> 8;
+}
+
+/*! *********************************************************************************
+* \brief  Handler of the timers, run by the simulated Application Task.
+*
+********************************************************************************** */
+static void Wheel_Expired(appCallbackParam_t param)
+{
+    wheelTimer_t*   pTimer = (wheelTimer_t*)param;
+    uint64_t        now = Wheel_NowMs();
+
+    pTimer->count++;
+
+    if( now != Wheel_RoundUpMs(pTimer->dueMs) )
+    {
+        (void)fprintf(stderr, "timer %u: expired at %llu ms instead of %llu ms\n", pTimer->id,
+                      (unsigned long long)now, (unsigned long long)Wheel_RoundUpMs(pTimer->dueMs));
+        mErrors++;
+    }
+
+    if( App_TimerWheelIsActive(&pTimer->entry) != (pTimer->periodMs != 0U) )
+    {
+        (void)fprintf(stderr, "timer %u: active %u after its expiry\n", pTimer->id,
+                      App_TimerWheelIsActive(&pTimer->entry));
+        mErrors++;
+    }
+
+    pTimer->dueMs += pTimer->periodMs;
+
+    if( pTimer->count == pTimer->stopAfter )
+    {
+        App_TimerWheelStop(&pTimer->entry);
+    }
+}
+
+static void Wheel_RunPosts(void)
+{
+    wheelPost_t posts[mWheelMaxPosts_c];
+    uint32_t    count = mPostCount;
+    uint32_t    i;
+
+    /* The handlers may start timers, which post again on a later wake-up */
+    (void)memcpy(posts, mPosts, count * sizeof(wheelPost_t));
+    mPostCount = 0U;
+
+    for( i = 0U; i < count; i++ )
+    {
+        posts[i].handler(posts[i].param);
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Moves the clock forward, waking up on each expiry of the low power timer.
+*
+********************************************************************************** */
+static void Wheel_Run(uint32_t ms)
+{
+    uint64_t    end = TMR_GetTimestamp() + (uint64_t)ms * 1000U;
+    uint64_t    now;
+    uint64_t    step;
+    uint32_t    next;
+
+    for(;;)
+    {
+        next = TMR_Process();
+
+        if( mPostCount != 0U )
+        {
+            Wheel_RunPosts();
+            continue;
+        }
+
+        now = TMR_GetTimestamp();
+
+        if( now >= end )
+        {
+            break;
+        }
+
+        step = end - now;
+
+        if( (next != gTmrNoExpiry_c) && (((uint64_t)next * 1000U) <= step) )
+        {
+            step = (uint64_t)next * 1000U;
+            mWakeups++;
+        }
+
+        TMR_AdvanceTimestamp(step);
+    }
+}
+
+static void Wheel_StartTimer(const char* pName, wheelTimer_t* pTimer, uint32_t delayMs, uint32_t periodMs)
+{
+    pTimer->periodMs = periodMs;
+    /* A delay of 0 expires on the next tick */
+    pTimer->dueMs = Wheel_NowMs() + ((delayMs == 0U) ? gAppTimerWheelTickMs_c : delayMs);
+
+    if( App_TimerWheelStart(&pTimer->entry, delayMs, periodMs, Wheel_Expired, pTimer) != gBleSuccess_c )
+    {
+        (void)fprintf(stderr, "%s: timer %u not started\n", pName, pTimer->id);
+        mErrors++;
+    }
+}
+
+static void Wheel_Check(const char* pName, bool_t condition, const char* pWhat)
+{
+    if( !condition )
+    {
+        (void)fprintf(stderr, "%s: %s\n", pName, pWhat);
+        mErrors++;
+    }
+}
+
+static void Wheel_CheckTimer(const char* pName, const wheelTimer_t* pTimer)
+{
+    if( pTimer->count != pTimer->expected )
+    {
+        (void)fprintf(stderr, "%s: timer %u expired %u times instead of %u\n", pName, pTimer->id,
+                      pTimer->count, pTimer->expected);
+        mErrors++;
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Checks that the wheel is empty and its low power timer stopped.
+*
+********************************************************************************** */
+static void Wheel_CheckIdle(const char* pName)
+{
+    Wheel_Check(pName, App_TimerWheelGetNextExpiry() == gAppTimerWheelNoExpiry_c, "the wheel is not empty");
+    Wheel_Check(pName, TMR_Process() == gTmrNoExpiry_c, "the low power timer is running");
+}
+
+static void Wheel_Start(const char* pName, wheelTimer_t* pTimers, uint32_t count)
+{
+    uint32_t i;
+
+    (void)memset(pTimers, 0, count * sizeof(wheelTimer_t));
+
+    for( i = 0U; i < count; i++ )
+    {
+        pTimers[i].id = i;
+    }
+
+    mWakeups = 0U;
+    mScenarioErrors = mErrors;
+    Wheel_CheckIdle(pName);
+}
+
+static int Wheel_Finish(const char* pName)
+{
+    Wheel_CheckIdle(pName);
+
+    if( !mQuiet )
+    {
+        (void)printf("%s: %s\n", pName, (mErrors == mScenarioErrors) ? "ok" : "FAILED");
+    }
+
+    return (mErrors == mScenarioErrors) ? 0 : 1;
+}
+
+/*! *********************************************************************************
+* \brief  Starts, restarts and stops timers linked in the same slot.
+*
+********************************************************************************** */
+static int Wheel_Cancel(void)
+{
+    const char*     pName = "cancel";
+    wheelTimer_t*   pTimers = mTimers;
+    uint32_t        i;
+
+    Wheel_Start(pName, pTimers, 6U);
+
+    Wheel_Check(pName, App_TimerWheelStart(NULL, 10U, 0U, Wheel_Expired, NULL) == gBleInvalidParameter_c,
+                "started without a timer");
+    Wheel_Check(pName, App_TimerWheelStart(&pTimers[0].entry, 10U, 0U, NULL, NULL) == gBleInvalidParameter_c,
+                "started without a handler");
+    Wheel_Check(pName, !App_TimerWheelIsActive(&pTimers[0].entry), "timer 0 active after a failed start");
+
+    /* Timers 1, 2 and 3 share a slot, linked as 3, 2, 1 */
+    Wheel_StartTimer(pName, &pTimers[0], 50U, 0U);
+    Wheel_StartTimer(pName, &pTimers[1], 120U, 0U);
+    Wheel_StartTimer(pName, &pTimers[2], 120U, 0U);
+    Wheel_StartTimer(pName, &pTimers[3], 120U, 0U);
+    Wheel_StartTimer(pName, &pTimers[4], 300U, 0U);
+    Wheel_Check(pName, App_TimerWheelGetNextExpiry() == 50U, "next expiry is not timer 0");
+
+    /* Middle of the slot, then the tail moved to a later slot */
+    App_TimerWheelStop(&pTimers[2].entry);
+    Wheel_StartTimer(pName, &pTimers[1], 200U, 0U);
+    pTimers[0].expected = 1U;
+    pTimers[1].expected = 1U;
+    pTimers[3].expected = 1U;
+    pTimers[4].expected = 1U;
+
+    /* Stopping twice or a timer never started has no effect */
+    App_TimerWheelStop(&pTimers[2].entry);
+    App_TimerWheelStop(&pTimers[5].entry);
+    App_TimerWheelStop(NULL);
+
+    for( i = 0U; i < 5U; i++ )
+    {
+        Wheel_Check(pName, App_TimerWheelIsActive(&pTimers[i].entry) == (i != 2U), "wrong timer active");
+    }
+
+    Wheel_Run(60U);
+    Wheel_Check(pName, App_TimerWheelGetNextExpiry() == 60U, "next expiry is not timer 3");
+    Wheel_Run(340U);
+
+    for( i = 0U; i < 5U; i++ )
+    {
+        Wheel_CheckTimer(pName, &pTimers[i]);
+    }
+
+    /* The low power timer is stopped with the last timer */
+    Wheel_StartTimer(pName, &pTimers[5], 1000U, 0U);
+    Wheel_Check(pName, TMR_Process() != gTmrNoExpiry_c, "the low power timer is not running");
+    App_TimerWheelStop(&pTimers[5].entry);
+
+    return Wheel_Finish(pName);
+}
+
+/*! *********************************************************************************
+* \brief  Starts one timer on each level, at both ends of the level.
+*
+********************************************************************************** */
+static int Wheel_Cascade(void)
+{
+    const char*     pName = "cascade";
+    wheelTimer_t*   pTimers = mTimers;
+    uint32_t        delays[2U * gAppTimerWheelLevels_c];
+    uint32_t        maxDelay = 0U;
+    uint32_t        maxWakeups = 0U;
+    uint32_t        level;
+    uint32_t        i;
+
+    Wheel_Start(pName, pTimers, NumberOfElements(delays));
+
+    /* The wheel restarts from the current tick, so the levels are predictable */
+    (void)App_TimerWheelInit();
+
+    for( level = 0U; level < gAppTimerWheelLevels_c; level++ )
+    {
+        delays[2U * level] = (uint32_t)mWheelLevelSpan(level) * gAppTimerWheelTickMs_c;
+        delays[2U * level + 1U] = ((uint32_t)mWheelLevelSpan(level + 1U) - 1U) * gAppTimerWheelTickMs_c;
+    }
+
+    for( i = 0U; i < NumberOfElements(delays); i++ )
+    {
+        Wheel_StartTimer(pName, &pTimers[i], delays[i], 0U);
+        pTimers[i].expected = 1U;
+
+        if( pTimers[i].entry.level != Wheel_Level(delays[i]) )
+        {
+            (void)fprintf(stderr, "%s: timer %u of %u ms on level %u instead of %u\n", pName, i, delays[i],
+                          pTimers[i].entry.level, Wheel_Level(delays[i]));
+            mErrors++;
+        }
+
+        /* One wake-up for each slot on the way down, and one for the expiry */
+        maxWakeups += pTimers[i].entry.level + 1U;
+
+        if( delays[i] > maxDelay )
+        {
+            maxDelay = delays[i];
+        }
+    }
+
+    Wheel_Run(maxDelay);
+
+    for( i = 0U; i < NumberOfElements(delays); i++ )
+    {
+        Wheel_CheckTimer(pName, &pTimers[i]);
+    }
+
+    if( mWakeups > maxWakeups )
+    {
+        (void)fprintf(stderr, "%s: %u wake-ups, more than %u\n", pName, mWakeups, maxWakeups);
+        mErrors++;
+    }
+
+    if( !mQuiet )
+    {
+        (void)printf("cascade: %u timers over %llu s, %u wake-ups\n", (uint32_t)NumberOfElements(delays),
+                     (unsigned long long)(maxDelay / 1000U), mWakeups);
+    }
+
+    return Wheel_Finish(pName);
+}
+
+/*! *********************************************************************************
+* \brief  Starts timers longer than the wheel.
+*
+********************************************************************************** */
+static int Wheel_Beyond(void)
+{
+    const char*     pName = "beyond";
+    wheelTimer_t*   pTimers = mTimers;
+    const uint32_t  delays[] = { (uint32_t)mWheelSpanMs_c, (uint32_t)mWheelSpanMs_c + 12340U,
+                                 10U * (uint32_t)mWheelSpanMs_c, 0xFFFFFFF0U };
+    uint32_t        i;
+
+    Wheel_Start(pName, pTimers, NumberOfElements(delays));
+
+    for( i = 0U; i < NumberOfElements(delays); i++ )
+    {
+        Wheel_StartTimer(pName, &pTimers[i], delays[i], 0U);
+        pTimers[i].expected = 1U;
+        Wheel_Check(pName, pTimers[i].entry.level == (gAppTimerWheelLevels_c - 1U), "not parked on the top level");
+    }
+
+    /* The wheel wakes up on the way, at least once per round of the wheel */
+    Wheel_Check(pName, App_TimerWheelGetNextExpiry() <= mWheelSpanMs_c, "next expiry beyond the wheel");
+
+    Wheel_Run(delays[0] - gAppTimerWheelTickMs_c);
+    Wheel_Check(pName, pTimers[0].count == 0U, "timer 0 expired early");
+    Wheel_Run(delays[3] - delays[0] + gAppTimerWheelTickMs_c);
+
+    for( i = 0U; i < NumberOfElements(delays); i++ )
+    {
+        Wheel_CheckTimer(pName, &pTimers[i]);
+    }
+
+    return Wheel_Finish(pName);
+}
+
+/*! *********************************************************************************
+* \brief  Runs periodic timers, on time and late.
+*
+********************************************************************************** */
+static int Wheel_Periodic(void)
+{
+    const char*     pName = "periodic";
+    wheelTimer_t*   pTimers = mTimers;
+    uint64_t        late;
+    uint32_t        i;
+
+    Wheel_Start(pName, pTimers, 3U);
+
+    Wheel_StartTimer(pName, &pTimers[0], 30U, 100U);
+    Wheel_StartTimer(pName, &pTimers[1], 100U, 100U);
+    pTimers[1].stopAfter = 5U;
+    /* Period shorter than the tick, rounded up to one tick */
+    Wheel_StartTimer(pName, &pTimers[2], 0U, 1U);
+    pTimers[2].periodMs = gAppTimerWheelTickMs_c;
+
+    Wheel_Run(1030U);
+    pTimers[0].expected = 11U;
+    pTimers[1].expected = 5U;
+    pTimers[2].expected = 1030U / gAppTimerWheelTickMs_c;
+
+    for( i = 0U; i < 3U; i++ )
+    {
+        Wheel_CheckTimer(pName, &pTimers[i]);
+    }
+
+    Wheel_Check(pName, !App_TimerWheelIsActive(&pTimers[1].entry), "timer 1 not stopped by its handler");
+    App_TimerWheelStop(&pTimers[2].entry);
+
+    /* Woken up 20 ms late: the timer keeps its phase */
+    late = Wheel_NowMs() + 100U + 20U;
+    TMR_AdvanceTimestamp((100U + 20U) * 1000U);
+    pTimers[0].dueMs = late;
+    Wheel_Run(0U);
+    pTimers[0].expected++;
+    Wheel_CheckTimer(pName, &pTimers[0]);
+    pTimers[0].dueMs = late - 20U + 100U;
+    Wheel_Run(80U);
+    pTimers[0].expected++;
+    Wheel_CheckTimer(pName, &pTimers[0]);
+
+    /* Woken up 1050 ms late: the missed periods are posted once and the next ones
+       are counted from the wake-up */
+    late = Wheel_NowMs() + 100U + 1050U;
+    TMR_AdvanceTimestamp((100U + 1050U) * 1000U);
+    pTimers[0].dueMs = late;
+    Wheel_Run(0U);
+    pTimers[0].expected++;
+    Wheel_CheckTimer(pName, &pTimers[0]);
+    pTimers[0].dueMs = late + 100U;
+    Wheel_Run(1000U);
+    pTimers[0].expected += 10U;
+    Wheel_CheckTimer(pName, &pTimers[0]);
+
+    App_TimerWheelStop(&pTimers[0].entry);
+    Wheel_Check(pName, !App_TimerWheelIsActive(&pTimers[0].entry), "timer 0 not stopped");
+
+    return Wheel_Finish(pName);
+}
+
+/*! *********************************************************************************
+* \brief  Starts timers with random delays while the wheel is running.
+*
+********************************************************************************** */
+static int Wheel_Mixed(void)
+{
+    const char*     pName = "random";
+    wheelTimer_t*   pTimers = mTimers;
+    uint32_t        half = mWheelRandomTimers_c / 2U;
+    uint32_t        i;
+
+    Wheel_Start(pName, pTimers, mWheelRandomTimers_c);
+
+    for( i = 0U; i < half; i++ )
+    {
+        Wheel_StartTimer(pName, &pTimers[i], Wheel_Random() % mWheelRandomMaxDelayMs_c, 0U);
+        pTimers[i].expected = 1U;
+    }
+
+    /* The wheel only catches up with the clock when it wakes up */
+    Wheel_Run((Wheel_Random() % 1000U) * gAppTimerWheelTickMs_c);
+
+    for( i = half; i < mWheelRandomTimers_c; i++ )
+    {
+        Wheel_StartTimer(pName, &pTimers[i], Wheel_Random() % mWheelRandomMaxDelayMs_c, 0U);
+        pTimers[i].expected = 1U;
+    }
+
+    Wheel_Run((Wheel_Random() % 1000U) * gAppTimerWheelTickMs_c);
+
+    for( i = 0U; i < mWheelRandomTimers_c; i++ )
+    {
+        switch( Wheel_Random() % 4U )
+        {
+            case 0U:
+                App_TimerWheelStop(&pTimers[i].entry);
+                pTimers[i].expected = pTimers[i].count;
+                break;
+            case 1U:
+                Wheel_StartTimer(pName, &pTimers[i], Wheel_Random() % mWheelRandomMaxDelayMs_c, 0U);
+                pTimers[i].expected = pTimers[i].count + 1U;
+                break;
+            default:
+                break;
+        }
+    }
+
+    Wheel_Run(mWheelRandomMaxDelayMs_c + gAppTimerWheelTickMs_c);
+
+    for( i = 0U; i < mWheelRandomTimers_c; i++ )
+    {
+        Wheel_CheckTimer(pName, &pTimers[i]);
+    }
+
+    return Wheel_Finish(pName);
+}
+
+static void Wheel_Usage(void)
+{
+    (void)fprintf(stderr,
+        "usage: app_timer_wheel_sim [-s seed] [-q]\n"
+        "  -s seed    seed of the random scenario (default 1)\n"
+        "  -q         prints only on failure\n");
+}
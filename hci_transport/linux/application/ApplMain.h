@@ -0,0 +1,44 @@
+/*! *********************************************************************************
+* Copyright 2026 NXP
+* All rights reserved.
+*
+* \file
+*
+* Stand-in for the application framework interface, for the Linux build of the
+* application modules tested on the host. Only the callback messages are declared;
+* the tools define App_PostCallbackMessage().
+*
+* SPDX-License-Identifier: BSD-3-Clause
+********************************************************************************** */
+
+#ifndef APPL_MAIN_H
+#define APPL_MAIN_H
+
+/************************************************************************************
+*************************************************************************************
+* Includes
+*************************************************************************************
+************************************************************************************/
+#include "EmbeddedTypes.h"
+#include "ble_general.h"
+
+/************************************************************************************
+*************************************************************************************
+* Public type definitions
+*************************************************************************************
+************************************************************************************/
+typedef void* appCallbackParam_t;
+typedef void (*appCallbackHandler_t)(appCallbackParam_t param);
+
+/************************************************************************************
+*************************************************************************************
+* Public prototypes
+*************************************************************************************
+************************************************************************************/
+bleResult_t App_PostCallbackMessage
+(
+    appCallbackHandler_t   handler,
+    appCallbackParam_t     param
+);
+
+#endif /* APPL_MAIN_H */
@@ -0,0 +1,122 @@
+/*! *********************************************************************************
+* Copyright 2026 NXP
+* All rights reserved.
+*
+* \file
+*
+* Stand-in for the framework basic types, for the Linux build of the HCI transport.
+*
+* SPDX-License-Identifier: BSD-3-Clause
+********************************************************************************** */
+
+#ifndef EMBEDDED_TYPES_H
+#define EMBEDDED_TYPES_H
+
+/************************************************************************************
+*************************************************************************************
+* Includes
+*************************************************************************************
+************************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+
+/************************************************************************************
+*************************************************************************************
+* Public type definitions
+*************************************************************************************
+************************************************************************************/
+typedef uint8_t         bool_t;
+typedef unsigned char   uchar_t;
+
+/************************************************************************************
+*************************************************************************************
+* Public macros
+*************************************************************************************
+************************************************************************************/
+#ifndef TRUE
+#define TRUE    1U
+#endif
+
+#ifndef FALSE
+#define FALSE   0U
+#endif
+
+#define BIT0    (1UL << 0)
+#define BIT1    (1UL << 1)
+#define BIT2    (1UL << 2)
+#define BIT3    (1UL << 3)
+#define BIT4    (1UL << 4)
+#define BIT5    (1UL << 5)
+#define BIT6    (1UL << 6)
+#define BIT7    (1UL << 7)
+#define BIT8    (1UL << 8)
+#define BIT9    (1UL << 9)
+#define BIT10   (1UL << 10)
+#define BIT11   (1UL << 11)
+#define BIT12   (1UL << 12)
+#define BIT13   (1UL << 13)
+#define BIT14   (1UL << 14)
+#define BIT15   (1UL << 15)
+#define BIT16   (1UL << 16)
+#define BIT17   (1UL << 17)
+#define BIT18   (1UL << 18)
+#define BIT19   (1UL << 19)
+#define BIT20   (1UL << 20)
+#define BIT21   (1UL << 21)
+#define BIT22   (1UL << 22)
+#define BIT23   (1UL << 23)
+#define BIT24   (1UL << 24)
+#define BIT25   (1UL << 25)
+#define BIT26   (1UL << 26)
+#define BIT27   (1UL << 27)
+#define BIT28   (1UL << 28)
+#define BIT29   (1UL << 29)
+#define BIT30   (1UL << 30)
+#define BIT31   (1UL << 31)
+
+#define SHIFT0   (0U)
+#define SHIFT1   (1U)
+#define SHIFT2   (2U)
+#define SHIFT3   (3U)
+#define SHIFT4   (4U)
+#define SHIFT5   (5U)
+#define SHIFT6   (6U)
+#define SHIFT7   (7U)
+#define SHIFT8   (8U)
+#define SHIFT9   (9U)
+#define SHIFT10  (10U)
+#define SHIFT11  (11U)
+#define SHIFT12  (12U)
+#define SHIFT13  (13U)
+#define SHIFT14  (14U)
+#define SHIFT15  (15U)
+#define SHIFT16  (16U)
+#define SHIFT17  (17U)
+#define SHIFT18  (18U)
+#define SHIFT19  (19U)
+#define SHIFT20  (20U)
+#define SHIFT21  (21U)
+#define SHIFT22  (22U)
+#define SHIFT23  (23U)
+#define SHIFT24  (24U)
+#define SHIFT25  (25U)
+#define SHIFT26  (26U)
+#define SHIFT27  (27U)
+#define SHIFT28  (28U)
+#define SHIFT29  (29U)
+#define SHIFT30  (30U)
+#define SHIFT31  (31U)
+
+#define NumberOfElements(x)             (sizeof(x) / sizeof((x)[0]))
+#define GetRelAddr(strct, member)       ((uint32_t)(uintptr_t)&(((strct*)(void*)0)->member))
+#define GetSizeOfMember(strct, member)  sizeof(((strct*)(void*)0)->member)
+
+#ifndef PACKED_STRUCT
+#define PACKED_STRUCT   struct __attribute__ ((__packed__))
+#endif
+
+#ifndef PACKED_UNION
+#define PACKED_UNION    union __attribute__ ((__packed__))
+#endif
+
+#endif /* EMBEDDED_TYPES_H */
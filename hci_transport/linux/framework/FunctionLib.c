@@ -0,0 +1,74 @@
+/*! *********************************************************************************
+* Copyright 2026 NXP
+* All rights reserved.
+*
+* \file
+*
+* Stand-in for the framework function library, for the Linux build of the HCI
+* transport.
+*
+* SPDX-License-Identifier: BSD-3-Clause
+********************************************************************************** */
+
+/************************************************************************************
+*************************************************************************************
+* Include
+*************************************************************************************
+************************************************************************************/
+#include <string.h>
+#include "FunctionLib.h"
+
+/************************************************************************************
+*************************************************************************************
+* Public functions
+*************************************************************************************
+************************************************************************************/
+void FLib_MemCpy(void* pDst, const void* pSrc, uint32_t cBytes)
+{
+    if( cBytes != 0U )
+    {
+        (void)memcpy(pDst, pSrc, cBytes);
+    }
+}
+
+void FLib_MemCpyReverseOrder(void* pDst, const void* pSrc, uint32_t cBytes)
+{
+    uint8_t*        pD = (uint8_t*)pDst;
+    const uint8_t*  pS = (const uint8_t*)pSrc + cBytes;
+
+    while( cBytes-- != 0U )
+    {
+        *pD++ = *--pS;
+    }
+}
+
+void FLib_MemInPlaceCpy(void* pDst, void* pSrc, uint32_t cBytes)
+{
+    if( cBytes != 0U )
+    {
+        (void)memmove(pDst, pSrc, cBytes);
+    }
+}
+
+void FLib_MemSet(void* pData, uint8_t value, uint32_t cBytes)
+{
+    (void)memset(pData, value, cBytes);
+}
+
+bool_t FLib_MemCmp(const void* pData1, const void* pData2, uint32_t cBytes)
+{
+    return (memcmp(pData1, pData2, cBytes) == 0) ? TRUE : FALSE;
+}
+
+bool_t FLib_MemCmpToVal(const void* pAddr, uint8_t val, uint32_t len)
+{
+    const uint8_t*  pData = (const uint8_t*)pAddr;
+    bool_t          result = TRUE;
+
+    while( (len-- != 0U) && (result == TRUE) )
+    {
+        result = (*pData++ == val) ? TRUE : FALSE;
+    }
+
+    return result;
+}
@@ -0,0 +1,35 @@
+/*! *********************************************************************************
+* Copyright 2026 NXP
+* All rights reserved.
+*
+* \file
+*
+* Stand-in for the framework function library, for the Linux build of the HCI
+* transport.
+*
+* SPDX-License-Identifier: BSD-3-Clause
+********************************************************************************** */
+
+#ifndef FUNCTION_LIB_H
+#define FUNCTION_LIB_H
+
+/************************************************************************************
+*************************************************************************************
+* Includes
+*************************************************************************************
+************************************************************************************/
+#include "EmbeddedTypes.h"
+
+/************************************************************************************
+*************************************************************************************
+* Public prototypes
+*************************************************************************************
+************************************************************************************/
+void FLib_MemCpy(void* pDst, const void* pSrc, uint32_t cBytes);
+void FLib_MemCpyReverseOrder(void* pDst, const void* pSrc, uint32_t cBytes);
+void FLib_MemInPlaceCpy(void* pDst, void* pSrc, uint32_t cBytes);
+void FLib_MemSet(void* pData, uint8_t value, uint32_t cBytes);
+bool_t FLib_MemCmp(const void* pData1, const void* pData2, uint32_t cBytes);
+bool_t FLib_MemCmpToVal(const void* pAddr, uint8_t val, uint32_t len);
+
+#endif /* FUNCTION_LIB_H */
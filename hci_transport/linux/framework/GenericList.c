@@ -0,0 +1,224 @@
+/*! *********************************************************************************
+* Copyright 2026 NXP
+* All rights reserved.
+*
+* \file
+*
+* Stand-in for the framework generic list, for the Linux build of the HCI transport.
+* As on target, the list operations run with interrupts disabled.
+*
+* SPDX-License-Identifier: BSD-3-Clause
+********************************************************************************** */
+
+/************************************************************************************
+*************************************************************************************
+* Include
+*************************************************************************************
+************************************************************************************/
+#include "GenericList.h"
+#include "fsl_os_abstraction.h"
+
+/************************************************************************************
+*************************************************************************************
+* Private prototypes
+*************************************************************************************
+************************************************************************************/
+static void List_Unlink(listElementHandle_t element);
+
+/************************************************************************************
+*************************************************************************************
+* Public functions
+*************************************************************************************
+************************************************************************************/
+void ListInit(listHandle_t list, uint32_t max)
+{
+    list->head = NULL;
+    list->tail = NULL;
+    list->size = 0U;
+    list->max = max;
+}
+
+listStatus_t ListAddTail(listHandle_t list, listElementHandle_t element)
+{
+    listStatus_t status = gListOk_c;
+
+    OSA_InterruptDisable();
+    if( (list->max != 0U) && (list->size >= list->max) )
+    {
+        status = gListFull_c;
+    }
+    else
+    {
+        element->next = NULL;
+        element->prev = list->tail;
+        element->list = list;
+
+        if( list->tail == NULL )
+        {
+            list->head = element;
+        }
+        else
+        {
+            list->tail->next = element;
+        }
+
+        list->tail = element;
+        list->size++;
+    }
+    OSA_InterruptEnable();
+
+    return status;
+}
+
+listStatus_t ListAddHead(listHandle_t list, listElementHandle_t element)
+{
+    listStatus_t status = gListOk_c;
+
+    OSA_InterruptDisable();
+    if( (list->max != 0U) && (list->size >= list->max) )
+    {
+        status = gListFull_c;
+    }
+    else
+    {
+        element->next = list->head;
+        element->prev = NULL;
+        element->list = list;
+
+        if( list->head == NULL )
+        {
+            list->tail = element;
+        }
+        else
+        {
+            list->head->prev = element;
+        }
+
+        list->head = element;
+        list->size++;
+    }
+    OSA_InterruptEnable();
+
+    return status;
+}
+
+listStatus_t ListAddPrevElement(listElementHandle_t element, listElementHandle_t newElement)
+{
+    listStatus_t    status = gListOk_c;
+    listHandle_t    list;
+
+    OSA_InterruptDisable();
+    list = element->list;
+
+    if( list == NULL )
+    {
+        status = gOrphanElement_c;
+    }
+    else if( (list->max != 0U) && (list->size >= list->max) )
+    {
+        status = gListFull_c;
+    }
+    else
+    {
+        newElement->next = element;
+        newElement->prev = element->prev;
+        newElement->list = list;
+
+        if( element->prev == NULL )
+        {
+            list->head = newElement;
+        }
+        else
+        {
+            element->prev->next = newElement;
+        }
+
+        element->prev = newElement;
+        list->size++;
+    }
+    OSA_InterruptEnable();
+
+    return status;
+}
+
+listElementHandle_t ListRemoveHead(listHandle_t list)
+{
+    listElementHandle_t element;
+
+    OSA_InterruptDisable();
+    element = list->head;
+
+    if( element != NULL )
+    {
+        List_Unlink(element);
+    }
+    OSA_InterruptEnable();
+
+    return element;
+}
+
+listStatus_t ListRemoveElement(listElementHandle_t element)
+{
+    listStatus_t status = gListOk_c;
+
+    OSA_InterruptDisable();
+    if( element->list == NULL )
+    {
+        status = gOrphanElement_c;
+    }
+    else
+    {
+        List_Unlink(element);
+    }
+    OSA_InterruptEnable();
+
+    return status;
+}
+
+listElementHandle_t ListGetHead(listHandle_t list)
+{
+    return list->head;
+}
+
+listElementHandle_t ListGetNext(listElementHandle_t element)
+{
+    return element->next;
+}
+
+uint32_t ListGetSize(listHandle_t list)
+{
+    return list->size;
+}
+
+/************************************************************************************
+*************************************************************************************
+* Private functions
+*************************************************************************************
+************************************************************************************/
+static void List_Unlink(listElementHandle_t element)
+{
+    listHandle_t list = element->list;
+
+    if( element->prev == NULL )
+    {
+        list->head = element->next;
+    }
+    else
+    {
+        element->prev->next = element->next;
+    }
+
+    if( element->next == NULL )
+    {
+        list->tail = element->prev;
+    }
+    else
+    {
+        element->next->prev = element->prev;
+    }
+
+    element->next = NULL;
+    element->prev = NULL;
+    element->list = NULL;
+    list->size--;
+}
@@ -0,0 +1,65 @@
+/*! *********************************************************************************
+* Copyright 2026 NXP
+* All rights reserved.
+*
+* \file
+*
+* Stand-in for the framework generic list, for the Linux build of the HCI transport.
+*
+* SPDX-License-Identifier: BSD-3-Clause
+********************************************************************************** */
+
+#ifndef GENERIC_LIST_H
+#define GENERIC_LIST_H
+
+/************************************************************************************
+*************************************************************************************
+* Includes
+*************************************************************************************
+************************************************************************************/
+#include "EmbeddedTypes.h"
+
+/************************************************************************************
+*************************************************************************************
+* Public type definitions
+*************************************************************************************
+************************************************************************************/
+typedef enum
+{
+    gListOk_c = 0,
+    gListFull_c,
+    gListEmpty_c,
+    gOrphanElement_c
+}listStatus_t;
+
+typedef struct list_tag
+{
+    struct listElement_tag* head;
+    struct listElement_tag* tail;
+    uint32_t                size;
+    uint32_t                max;        /*!< 0 for no limit. */
+}list_t, *listHandle_t;
+
+typedef struct listElement_tag
+{
+    struct listElement_tag* next;
+    struct listElement_tag* prev;
+    struct list_tag*        list;
+}listElement_t, *listElementHandle_t;
+
+/************************************************************************************
+*************************************************************************************
+* Public prototypes
+*************************************************************************************
+************************************************************************************/
+void ListInit(listHandle_t list, uint32_t max);
+listStatus_t ListAddTail(listHandle_t list, listElementHandle_t element);
+listStatus_t ListAddHead(listHandle_t list, listElementHandle_t element);
+listStatus_t ListAddPrevElement(listElementHandle_t element, listElementHandle_t newElement);
+listElementHandle_t ListRemoveHead(listHandle_t list);
+listStatus_t ListRemoveElement(listElementHandle_t element);
+listElementHandle_t ListGetHead(listHandle_t list);
+listElementHandle_t ListGetNext(listElementHandle_t element);
+uint32_t ListGetSize(listHandle_t list);
+
+#endif /* GENERIC_LIST_H */
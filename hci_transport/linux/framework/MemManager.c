@@ -0,0 +1,163 @@
+/*! *********************************************************************************
+* Copyright 2026 NXP
+* All rights reserved.
+*
+* \file
+*
+* Stand-in for the framework memory manager, for the Linux build of the HCI
+* transport.
+*
+* SPDX-License-Identifier: BSD-3-Clause
+********************************************************************************** */
+
+/************************************************************************************
+*************************************************************************************
+* Include
+*************************************************************************************
+************************************************************************************/
+#include <stdlib.h>
+#include "MemManager.h"
+#include "GenericList.h"
+#include "fsl_os_abstraction.h"
+
+/************************************************************************************
+*************************************************************************************
+* Private macros
+*************************************************************************************
+************************************************************************************/
+#define mMemBlockMagic_c    (0x4D454D42U)
+
+/************************************************************************************
+*************************************************************************************
+* Private type definitions
+*************************************************************************************
+************************************************************************************/
+/* As on target, the header ends with the list element used by the Messaging module */
+typedef struct memBlockHeader_tag
+{
+    uint32_t        magic;
+    uint32_t        size;
+    uint8_t         rfu[16];        /* Keeps the buffer 16-byte aligned */
+    listElement_t   element;
+}memBlockHeader_t;
+
+/************************************************************************************
+*************************************************************************************
+* Private memory declarations
+*************************************************************************************
+************************************************************************************/
+static memStats_t   mMemStats;
+static uint32_t     mMemBlockLimit = 0U;
+
+/************************************************************************************
+*************************************************************************************
+* Public functions
+*************************************************************************************
+************************************************************************************/
+memStatus_t MEM_Init(void)
+{
+    return MEM_SUCCESS_c;
+}
+
+void* MEM_BufferAlloc(uint32_t numBytes)
+{
+    memBlockHeader_t*   pHeader = NULL;
+    bool_t              allowed;
+
+    OSA_InterruptDisable();
+    allowed = ((mMemBlockLimit == 0U) || (mMemStats.inUse < mMemBlockLimit)) ? TRUE : FALSE;
+    if( allowed == TRUE )
+    {
+        /* Counted before the allocation so the limit holds across threads */
+        mMemStats.inUse++;
+    }
+    else
+    {
+        mMemStats.failures++;
+    }
+    OSA_InterruptEnable();
+
+    if( allowed == TRUE )
+    {
+        pHeader = malloc(sizeof(memBlockHeader_t) + numBytes);
+
+        OSA_InterruptDisable();
+        if( pHeader == NULL )
+        {
+            mMemStats.inUse--;
+            mMemStats.failures++;
+        }
+        else
+        {
+            mMemStats.allocations++;
+            if( mMemStats.inUse > mMemStats.peakInUse )
+            {
+                mMemStats.peakInUse = mMemStats.inUse;
+            }
+        }
+        OSA_InterruptEnable();
+    }
+
+    if( pHeader != NULL )
+    {
+        pHeader->magic = mMemBlockMagic_c;
+        pHeader->size = numBytes;
+        pHeader->element.list = NULL;
+        pHeader = pHeader + 1;
+    }
+
+    return pHeader;
+}
+
+memStatus_t MEM_BufferFree(void* buffer)
+{
+    memBlockHeader_t* pHeader;
+
+    if( buffer == NULL )
+    {
+        return MEM_FREE_ERROR_c;
+    }
+
+    pHeader = (memBlockHeader_t*)buffer - 1;
+
+    if( pHeader->magic != mMemBlockMagic_c )
+    {
+        /* Double free or foreign buffer: stop here, the tools must not hide it */
+        abort();
+    }
+
+    pHeader->magic = 0U;
+    free(pHeader);
+
+    OSA_InterruptDisable();
+    mMemStats.frees++;
+    mMemStats.inUse--;
+    OSA_InterruptEnable();
+
+    return MEM_SUCCESS_c;
+}
+
+uint16_t MEM_BufferGetSize(void* buffer)
+{
+    return (uint16_t)((memBlockHeader_t*)buffer - 1)->size;
+}
+
+void MEM_GetStats(memStats_t* pStats, bool_t reset)
+{
+    OSA_InterruptDisable();
+    *pStats = mMemStats;
+
+    if( reset == TRUE )
+    {
+        mMemStats.allocations = 0U;
+        mMemStats.frees = 0U;
+        mMemStats.failures = 0U;
+        mMemStats.peakInUse = mMemStats.inUse;
+    }
+    OSA_InterruptEnable();
+}
+
+void MEM_SetBlockLimit(uint32_t maxBlocks)
+{
+    mMemBlockLimit = maxBlocks;
+}
@@ -0,0 +1,64 @@
+/*! *********************************************************************************
+* Copyright 2026 NXP
+* All rights reserved.
+*
+* \file
+*
+* Stand-in for the framework memory manager, for the Linux build of the HCI
+* transport. Buffers come from the C heap and are counted, so the tools can report
+* allocations per packet and catch leaks.
+*
+* SPDX-License-Identifier: BSD-3-Clause
+********************************************************************************** */
+
+#ifndef MEM_MANAGER_H
+#define MEM_MANAGER_H
+
+/************************************************************************************
+*************************************************************************************
+* Includes
+*************************************************************************************
+************************************************************************************/
+#include "EmbeddedTypes.h"
+
+/************************************************************************************
+*************************************************************************************
+* Public type definitions
+*************************************************************************************
+************************************************************************************/
+typedef enum
+{
+    MEM_SUCCESS_c = 0,
+    MEM_INIT_ERROR_c,
+    MEM_ALLOC_ERROR_c,
+    MEM_FREE_ERROR_c,
+    MEM_UNKNOWN_ERROR_c
+}memStatus_t;
+
+/* Counters of the stand-in, not part of the framework API */
+typedef struct memStats_tag
+{
+    uint32_t    allocations;        /*!< Successful MEM_BufferAlloc() calls. */
+    uint32_t    frees;              /*!< Successful MEM_BufferFree() calls. */
+    uint32_t    failures;           /*!< Allocations refused by the block limit. */
+    uint32_t    inUse;              /*!< Blocks allocated and not freed. */
+    uint32_t    peakInUse;          /*!< Largest value of inUse. */
+}memStats_t;
+
+/************************************************************************************
+*************************************************************************************
+* Public prototypes
+*************************************************************************************
+************************************************************************************/
+memStatus_t MEM_Init(void);
+void* MEM_BufferAlloc(uint32_t numBytes);
+memStatus_t MEM_BufferFree(void* buffer);
+uint16_t MEM_BufferGetSize(void* buffer);
+
+/* Stand-in only: reads the counters, and clears them except inUse if reset is TRUE */
+void MEM_GetStats(memStats_t* pStats, bool_t reset);
+
+/* Stand-in only: limits the number of blocks in use, 0 for no limit */
+void MEM_SetBlockLimit(uint32_t maxBlocks);
+
+#endif /* MEM_MANAGER_H */
@@ -0,0 +1,60 @@
+/*! *********************************************************************************
+* Copyright 2026 NXP
+* All rights reserved.
+*
+* \file
+*
+* Stand-in for the framework messaging, for the Linux build of the HCI transport.
+* As on target, a message is a MemManager buffer whose list element is kept in the
+* block header, just before the message.
+*
+* SPDX-License-Identifier: BSD-3-Clause
+********************************************************************************** */
+
+#ifndef MESSAGING_H
+#define MESSAGING_H
+
+/************************************************************************************
+*************************************************************************************
+* Includes
+*************************************************************************************
+************************************************************************************/
+#include "EmbeddedTypes.h"
+#include "GenericList.h"
+#include "MemManager.h"
+
+/************************************************************************************
+*************************************************************************************
+* Public type definitions
+*************************************************************************************
+************************************************************************************/
+typedef list_t anchor_t;
+typedef anchor_t msgQueue_t;
+
+/************************************************************************************
+*************************************************************************************
+* Public macros
+*************************************************************************************
+************************************************************************************/
+#define MSG_InitQueue(anchor)           ListInit((anchor), 0U)
+#define MSG_Alloc(size)                 MEM_BufferAlloc(size)
+#define MSG_AllocType(type)             MEM_BufferAlloc(sizeof(type))
+#define MSG_Free(pMsg)                  MEM_BufferFree(pMsg)
+#define MSG_Queue(anchor, pMsg)         (void)ListAddTail((anchor), (listElementHandle_t)(void*)(pMsg) - 1)
+#define MSG_QueueHead(anchor, pMsg)     (void)ListAddHead((anchor), (listElementHandle_t)(void*)(pMsg) - 1)
+#define MSG_Pending(anchor)             (((anchor)->head != NULL) ? TRUE : FALSE)
+#define MSG_GetCount(anchor)            ListGetSize(anchor)
+
+/************************************************************************************
+*************************************************************************************
+* Public functions
+*************************************************************************************
+************************************************************************************/
+static inline void* MSG_DeQueue(anchor_t* pAnchor)
+{
+    listElementHandle_t element = ListRemoveHead(pAnchor);
+
+    return (element != NULL) ? (void*)(element + 1) : NULL;
+}
+
+#endif /* MESSAGING_H */
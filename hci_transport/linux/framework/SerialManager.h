@@ -0,0 +1,63 @@
+/*! *********************************************************************************
+* Copyright 2026 NXP
+* All rights reserved.
+*
+* \file
+*
+* Stand-in for the Serial Manager types, for the Linux build of the HCI transport.
+* The transport is built with gHcitSerialManagerSupport_d set to 0, so only the
+* types are needed: the interface is driven through the write interface and
+* Hcit_InterfaceDataReceived().
+*
+* SPDX-License-Identifier: BSD-3-Clause
+********************************************************************************** */
+
+#ifndef SERIAL_MANAGER_H
+#define SERIAL_MANAGER_H
+
+/************************************************************************************
+*************************************************************************************
+* Includes
+*************************************************************************************
+************************************************************************************/
+#include "EmbeddedTypes.h"
+
+/************************************************************************************
+*************************************************************************************
+* Public macros
+*************************************************************************************
+************************************************************************************/
+#define gUARTBaudRate57600_c            (57600UL)
+#define gUARTBaudRate115200_c           (115200UL)
+
+#define APP_SERIAL_INTERFACE_TYPE       (gSerialMgrUart_c)
+#define APP_SERIAL_INTERFACE_INSTANCE   (0U)
+
+/************************************************************************************
+*************************************************************************************
+* Public type definitions
+*************************************************************************************
+************************************************************************************/
+typedef enum
+{
+    gSerialMgrNone_c = 0,
+    gSerialMgrUart_c
+}serialInterfaceType_t;
+
+typedef enum
+{
+    gSerial_Success_c = 0,
+    gSerial_InvalidParameter_c,
+    gSerial_InvalidInterface_c,
+    gSerial_MaxInterfacesReached_c,
+    gSerial_InterfaceNotReady_c,
+    gSerial_InterfaceInUse_c,
+    gSerial_InternalError_c,
+    gSerial_SemCreateError_c,
+    gSerial_OutOfMemory_c,
+    gSerial_OsError_c
+}serialStatus_t;
+
+typedef void (*pSerialCallBack_t)(void* param);
+
+#endif /* SERIAL_MANAGER_H */
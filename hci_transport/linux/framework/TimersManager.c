@@ -0,0 +1,243 @@
+/*! *********************************************************************************
+* Copyright 2026 NXP
+* All rights reserved.
+*
+* \file
+*
+* Stand-in for the framework timers manager, for the Linux build of the HCI
+* transport.
+*
+* SPDX-License-Identifier: BSD-3-Clause
+********************************************************************************** */
+
+/************************************************************************************
+*************************************************************************************
+* Include
+*************************************************************************************
+************************************************************************************/
+#include <time.h>
+#include "TimersManager.h"
+#include "fsl_os_abstraction.h"
+
+/************************************************************************************
+*************************************************************************************
+* Private type definitions
+*************************************************************************************
+************************************************************************************/
+typedef struct tmrTimer_tag
+{
+    bool_t          allocated;
+    bool_t          active;
+    tmrTimerType_t  type;
+    uint32_t        intervalMs;
+    uint64_t        expiry;         /*!< Absolute, in microseconds. */
+    pfTmrCallBack_t callback;
+    void*           param;
+}tmrTimer_t;
+
+/************************************************************************************
+*************************************************************************************
+* Private memory declarations
+*************************************************************************************
+************************************************************************************/
+static tmrTimer_t   mTimers[gTmrApplicationTimers_c];
+static uint64_t     mTmrEpoch = 0U;
+/* Simulated time, used once TMR_AdvanceTimestamp() has been called */
+static bool_t       mTmrSimulated = FALSE;
+static uint64_t     mTmrSimulatedTime;
+
+/************************************************************************************
+*************************************************************************************
+* Public functions
+*************************************************************************************
+************************************************************************************/
+tmrTimerID_t TMR_AllocateTimer(void)
+{
+    tmrTimerID_t    timerId = gTmrInvalidTimerID_c;
+    uint32_t        i;
+
+    OSA_InterruptDisable();
+    for( i = 0U; i < gTmrApplicationTimers_c; i++ )
+    {
+        if( mTimers[i].allocated == FALSE )
+        {
+            mTimers[i].allocated = TRUE;
+            mTimers[i].active = FALSE;
+            timerId = (tmrTimerID_t)i;
+            break;
+        }
+    }
+    OSA_InterruptEnable();
+
+    return timerId;
+}
+
+tmrErrCode_t TMR_FreeTimer(tmrTimerID_t timerId)
+{
+    if( timerId >= gTmrApplicationTimers_c )
+    {
+        return gTmrInvalidId_c;
+    }
+
+    OSA_InterruptDisable();
+    mTimers[timerId].active = FALSE;
+    mTimers[timerId].allocated = FALSE;
+    OSA_InterruptEnable();
+
+    return gTmrSuccess_c;
+}
+
+tmrErrCode_t TMR_StartTimer
+(
+    tmrTimerID_t            timerId,
+    tmrTimerType_t          timerType,
+    tmrTimeInMilliseconds_t timeInMilliseconds,
+    pfTmrCallBack_t         callback,
+    void*                   param
+)
+{
+    tmrTimer_t* pTimer;
+
+    if( (timerId >= gTmrApplicationTimers_c) || (mTimers[timerId].allocated == FALSE) )
+    {
+        return gTmrInvalidId_c;
+    }
+
+    pTimer = &mTimers[timerId];
+
+    OSA_InterruptDisable();
+    pTimer->type = timerType;
+    pTimer->intervalMs = timeInMilliseconds;
+    pTimer->expiry = TMR_GetTimestamp() + (uint64_t)timeInMilliseconds * 1000U;
+    pTimer->callback = callback;
+    pTimer->param = param;
+    pTimer->active = TRUE;
+    OSA_InterruptEnable();
+
+    return gTmrSuccess_c;
+}
+
+tmrErrCode_t TMR_StartSingleShotTimer(tmrTimerID_t timerId, tmrTimeInMilliseconds_t timeInMilliseconds, pfTmrCallBack_t callback, void* param)
+{
+    return TMR_StartTimer(timerId, gTmrSingleShotTimer_c, timeInMilliseconds, callback, param);
+}
+
+tmrErrCode_t TMR_StartIntervalTimer(tmrTimerID_t timerId, tmrTimeInMilliseconds_t timeInMilliseconds, pfTmrCallBack_t callback, void* param)
+{
+    return TMR_StartTimer(timerId, gTmrIntervalTimer_c, timeInMilliseconds, callback, param);
+}
+
+tmrErrCode_t TMR_StartLowPowerTimer(tmrTimerID_t timerId, tmrTimerType_t timerType, uint32_t timeIn, pfTmrCallBack_t callback, void* param)
+{
+    return TMR_StartTimer(timerId, timerType, timeIn, callback, param);
+}
+
+tmrErrCode_t TMR_StopTimer(tmrTimerID_t timerId)
+{
+    if( timerId >= gTmrApplicationTimers_c )
+    {
+        return gTmrInvalidId_c;
+    }
+
+    OSA_InterruptDisable();
+    mTimers[timerId].active = FALSE;
+    OSA_InterruptEnable();
+
+    return gTmrSuccess_c;
+}
+
+bool_t TMR_IsTimerActive(tmrTimerID_t timerId)
+{
+    return (timerId < gTmrApplicationTimers_c) ? mTimers[timerId].active : FALSE;
+}
+
+uint64_t TMR_GetTimestamp(void)
+{
+    struct timespec now;
+    uint64_t        timestamp;
+
+    if( mTmrSimulated == TRUE )
+    {
+        return mTmrSimulatedTime;
+    }
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    timestamp = (uint64_t)now.tv_sec * 1000000U + (uint64_t)now.tv_nsec / 1000U;
+
+    if( mTmrEpoch == 0U )
+    {
+        mTmrEpoch = timestamp;
+    }
+
+    return timestamp - mTmrEpoch;
+}
+
+void TMR_AdvanceTimestamp(uint64_t microseconds)
+{
+    if( mTmrSimulated == FALSE )
+    {
+        mTmrSimulatedTime = TMR_GetTimestamp();
+        mTmrSimulated = TRUE;
+    }
+
+    mTmrSimulatedTime += microseconds;
+}
+
+uint32_t TMR_Process(void)
+{
+    uint64_t        now = TMR_GetTimestamp();
+    uint64_t        next = UINT64_MAX;
+    pfTmrCallBack_t callback;
+    void*           param;
+    uint32_t        i;
+
+    for( i = 0U; i < gTmrApplicationTimers_c; i++ )
+    {
+        tmrTimer_t* pTimer = &mTimers[i];
+
+        callback = NULL;
+        param = NULL;
+
+        OSA_InterruptDisable();
+        if( (pTimer->active == TRUE) && (pTimer->expiry <= now) )
+        {
+            callback = pTimer->callback;
+            param = pTimer->param;
+
+            if( (pTimer->type & gTmrIntervalTimer_c) != 0U )
+            {
+                pTimer->expiry = now + (uint64_t)pTimer->intervalMs * 1000U;
+            }
+            else
+            {
+                pTimer->active = FALSE;
+            }
+        }
+        OSA_InterruptEnable();
+
+        /* Called like from the timer task: outside of any critical section */
+        if( callback != NULL )
+        {
+            callback(param);
+        }
+    }
+
+    OSA_InterruptDisable();
+    for( i = 0U; i < gTmrApplicationTimers_c; i++ )
+    {
+        if( (mTimers[i].active == TRUE) && (mTimers[i].expiry < next) )
+        {
+            next = mTimers[i].expiry;
+        }
+    }
+    OSA_InterruptEnable();
+
+    if( next == UINT64_MAX )
+    {
+        return gTmrNoExpiry_c;
+    }
+
+    now = TMR_GetTimestamp();
+
+    return (next <= now) ? 0U : (uint32_t)((next - now + 999U) / 1000U);
+}
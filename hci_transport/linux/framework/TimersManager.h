@@ -0,0 +1,87 @@
+/*! *********************************************************************************
+* Copyright 2026 NXP
+* All rights reserved.
+*
+* \file
+*
+* Stand-in for the framework timers manager, for the Linux build of the HCI
+* transport. There is no timer task: the tools call TMR_Process() from their poll
+* loop and the expired callbacks run there.
+*
+* SPDX-License-Identifier: BSD-3-Clause
+********************************************************************************** */
+
+#ifndef TIMERS_MANAGER_H
+#define TIMERS_MANAGER_H
+
+/************************************************************************************
+*************************************************************************************
+* Includes
+*************************************************************************************
+************************************************************************************/
+#include "EmbeddedTypes.h"
+
+/************************************************************************************
+*************************************************************************************
+* Public macros
+*************************************************************************************
+************************************************************************************/
+#define gTmrInvalidTimerID_c                (0xFFU)
+
+/* Number of timers that can be allocated */
+#ifndef gTmrApplicationTimers_c
+#define gTmrApplicationTimers_c             (16U)
+#endif
+
+/* Returned by TMR_Process() when no timer is running */
+#define gTmrNoExpiry_c                      (0xFFFFFFFFU)
+
+#define gTmrSingleShotTimer_c               (0x01U)
+#define gTmrIntervalTimer_c                 (0x02U)
+#define gTmrLowPowerTimer_c                 (0x20U)
+#define gTmrLowPowerSingleShotMillisTimer_c (gTmrSingleShotTimer_c | gTmrLowPowerTimer_c)
+#define gTmrLowPowerIntervalMillisTimer_c   (gTmrIntervalTimer_c | gTmrLowPowerTimer_c)
+
+/************************************************************************************
+*************************************************************************************
+* Public type definitions
+*************************************************************************************
+************************************************************************************/
+typedef uint8_t     tmrTimerID_t;
+typedef uint8_t     tmrTimerType_t;
+typedef uint32_t    tmrTimeInMilliseconds_t;
+typedef void (*pfTmrCallBack_t)(void* param);
+
+typedef enum
+{
+    gTmrSuccess_c = 0,
+    gTmrInvalidId_c,
+    gTmrOutOfRange_c
+}tmrErrCode_t;
+
+/************************************************************************************
+*************************************************************************************
+* Public prototypes
+*************************************************************************************
+************************************************************************************/
+tmrTimerID_t TMR_AllocateTimer(void);
+tmrErrCode_t TMR_FreeTimer(tmrTimerID_t timerId);
+tmrErrCode_t TMR_StartTimer(tmrTimerID_t timerId, tmrTimerType_t timerType, tmrTimeInMilliseconds_t timeInMilliseconds, pfTmrCallBack_t callback, void* param);
+tmrErrCode_t TMR_StartSingleShotTimer(tmrTimerID_t timerId, tmrTimeInMilliseconds_t timeInMilliseconds, pfTmrCallBack_t callback, void* param);
+tmrErrCode_t TMR_StartIntervalTimer(tmrTimerID_t timerId, tmrTimeInMilliseconds_t timeInMilliseconds, pfTmrCallBack_t callback, void* param);
+tmrErrCode_t TMR_StartLowPowerTimer(tmrTimerID_t timerId, tmrTimerType_t timerType, uint32_t timeIn, pfTmrCallBack_t callback, void* param);
+tmrErrCode_t TMR_StopTimer(tmrTimerID_t timerId);
+bool_t TMR_IsTimerActive(tmrTimerID_t timerId);
+
+/* Time since the first call, in microseconds */
+uint64_t TMR_GetTimestamp(void);
+
+/* Stand-in only: stops following the real time and moves the timestamp forward.
+   From the first call, the time only changes through this function. */
+void TMR_AdvanceTimestamp(uint64_t microseconds);
+
+/* Stand-in only: runs the expired callbacks and returns the time until the next
+   expiry in milliseconds, or gTmrNoExpiry_c */
+uint32_t TMR_Process(void);
+
+#endif /* TIMERS_MANAGER_H */
@@ -0,0 +1,157 @@
+/*! *********************************************************************************
+* Copyright 2026 NXP
+* All rights reserved.
+*
+* \file
+*
+* Stand-in for the OS abstraction, for the Linux build of the HCI transport.
+*
+* SPDX-License-Identifier: BSD-3-Clause
+********************************************************************************** */
+
+/************************************************************************************
+*************************************************************************************
+* Include
+*************************************************************************************
+************************************************************************************/
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+#include "fsl_os_abstraction.h"
+
+/************************************************************************************
+*************************************************************************************
+* Private type definitions
+*************************************************************************************
+************************************************************************************/
+typedef struct osaSemaphore_tag
+{
+    pthread_mutex_t mutex;
+    pthread_cond_t  cond;
+    uint32_t        count;
+}osaSemaphore_t;
+
+/************************************************************************************
+*************************************************************************************
+* Private memory declarations
+*************************************************************************************
+************************************************************************************/
+#if !gOsaInterruptsPerThread_d
+static pthread_mutex_t mOsaInterruptLock = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+#endif
+
+/************************************************************************************
+*************************************************************************************
+* Public functions
+*************************************************************************************
+************************************************************************************/
+#if gOsaInterruptsPerThread_d
+/* A core runs a single thread, which nothing preempts: the other cores are not
+   stopped by masking interrupts */
+void OSA_InterruptDisable(void)
+{
+}
+
+void OSA_InterruptEnable(void)
+{
+}
+#else
+void OSA_InterruptDisable(void)
+{
+    (void)pthread_mutex_lock(&mOsaInterruptLock);
+}
+
+void OSA_InterruptEnable(void)
+{
+    (void)pthread_mutex_unlock(&mOsaInterruptLock);
+}
+#endif
+
+osaSemaphoreId_t OSA_SemaphoreCreate(uint32_t initValue)
+{
+    osaSemaphore_t* pSem = malloc(sizeof(osaSemaphore_t));
+
+    if( pSem != NULL )
+    {
+        (void)pthread_mutex_init(&pSem->mutex, NULL);
+        (void)pthread_cond_init(&pSem->cond, NULL);
+        pSem->count = initValue;
+    }
+
+    return pSem;
+}
+
+osaStatus_t OSA_SemaphoreDestroy(osaSemaphoreId_t semId)
+{
+    osaSemaphore_t* pSem = semId;
+
+    (void)pthread_cond_destroy(&pSem->cond);
+    (void)pthread_mutex_destroy(&pSem->mutex);
+    free(pSem);
+
+    return osaStatus_Success;
+}
+
+osaStatus_t OSA_SemaphoreWait(osaSemaphoreId_t semId, uint32_t millisec)
+{
+    osaSemaphore_t* pSem = semId;
+    osaStatus_t     status = osaStatus_Success;
+    struct timespec deadline;
+    int             error = 0;
+
+    (void)clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += (time_t)(millisec / 1000U);
+    deadline.tv_nsec += (long)(millisec % 1000U) * 1000000L;
+    if( deadline.tv_nsec >= 1000000000L )
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    (void)pthread_mutex_lock(&pSem->mutex);
+    while( (pSem->count == 0U) && (error == 0) )
+    {
+        if( millisec == osaWaitForever_c )
+        {
+            error = pthread_cond_wait(&pSem->cond, &pSem->mutex);
+        }
+        else
+        {
+            error = pthread_cond_timedwait(&pSem->cond, &pSem->mutex, &deadline);
+        }
+    }
+
+    if( pSem->count != 0U )
+    {
+        pSem->count--;
+    }
+    else
+    {
+        status = (error == ETIMEDOUT) ? osaStatus_Timeout : osaStatus_Error;
+    }
+    (void)pthread_mutex_unlock(&pSem->mutex);
+
+    return status;
+}
+
+osaStatus_t OSA_SemaphorePost(osaSemaphoreId_t semId)
+{
+    osaSemaphore_t* pSem = semId;
+
+    (void)pthread_mutex_lock(&pSem->mutex);
+    pSem->count++;
+    (void)pthread_cond_signal(&pSem->cond);
+    (void)pthread_mutex_unlock(&pSem->mutex);
+
+    return osaStatus_Success;
+}
+
+uint32_t OSA_TimeGetMsec(void)
+{
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint32_t)((uint64_t)now.tv_sec * 1000U + (uint64_t)now.tv_nsec / 1000000U);
+}
@@ -0,0 +1,70 @@
+/*! *********************************************************************************
+* Copyright 2026 NXP
+* All rights reserved.
+*
+* \file
+*
+* Stand-in for the OS abstraction, for the Linux build of the HCI transport.
+* Disabling interrupts takes one process-wide recursive lock, so the threads of a
+* tool run the critical sections of the transport one at a time, as on target.
+* With gOsaInterruptsPerThread_d, each thread stands for a core instead, and masks
+* only its own interrupts.
+*
+* SPDX-License-Identifier: BSD-3-Clause
+********************************************************************************** */
+
+#ifndef FSL_OS_ABSTRACTION_H
+#define FSL_OS_ABSTRACTION_H
+
+/************************************************************************************
+*************************************************************************************
+* Includes
+*************************************************************************************
+************************************************************************************/
+#include "EmbeddedTypes.h"
+
+/************************************************************************************
+*************************************************************************************
+* Public macros
+*************************************************************************************
+************************************************************************************/
+#define osaWaitForever_c    (0xFFFFFFFFU)
+
+/* Each thread is a core with its own interrupt mask, for the dual-core transports */
+#ifndef gOsaInterruptsPerThread_d
+#define gOsaInterruptsPerThread_d   0
+#endif
+
+/************************************************************************************
+*************************************************************************************
+* Public type definitions
+*************************************************************************************
+************************************************************************************/
+typedef enum
+{
+    osaStatus_Success = 0,
+    osaStatus_Error,
+    osaStatus_Timeout,
+    osaStatus_Idle
+}osaStatus_t;
+
+typedef void*       osaSemaphoreId_t;
+typedef void*       osaMutexId_t;
+typedef void*       osaEventId_t;
+typedef void*       osaTaskId_t;
+typedef uint32_t    osaEventFlags_t;
+
+/************************************************************************************
+*************************************************************************************
+* Public prototypes
+*************************************************************************************
+************************************************************************************/
+void OSA_InterruptDisable(void);
+void OSA_InterruptEnable(void);
+osaSemaphoreId_t OSA_SemaphoreCreate(uint32_t initValue);
+osaStatus_t OSA_SemaphoreDestroy(osaSemaphoreId_t semId);
+osaStatus_t OSA_SemaphoreWait(osaSemaphoreId_t semId, uint32_t millisec);
+osaStatus_t OSA_SemaphorePost(osaSemaphoreId_t semId);
+uint32_t OSA_TimeGetMsec(void);
+
+#endif /* FSL_OS_ABSTRACTION_H */
@@ -0,0 +1,648 @@
+/*! *********************************************************************************
+* Copyright 2026 NXP
+* All rights reserved.
+*
+* \file
+*
+* Simulates ACL contention on the Linux build of the HCI transport, with the ACL
+* scheduler enabled (gHcitAclScheduler_d), and checks the share of the Controller
+* buffers each connection gets.
+*
+* The simulated Controller announces its buffers with LE Read Buffer Size and
+* transmits a fixed number of packets per tick, oldest first, returning the credits
+* with Number Of Completed Packets. On each tick, the busy connections send with
+* Hcit_SendPacket() until their queue is full, and the light connections send one
+* packet every few ticks. The scenarios are:
+*   equal     gHcitAclMaxLinks_c busy connections with the same weight
+*   weighted  busy connections with weights 1, 2, 3 and 4
+*   light     one busy connection and light connections, which must not wait more
+*             than one round-robin round
+* The first scenario ends with an HCI Reset instead of disconnections, so the next
+* ones check that the reset gave back every credit and every connection slot.
+*
+* The Controller never holds more packets than it announced, and each connection
+* keeps its packets in order. The exit status is nonzero if a check fails.
+*
+* SPDX-License-Identifier: BSD-3-Clause
+********************************************************************************** */
+
+/************************************************************************************
+*************************************************************************************
+* Include
+*************************************************************************************
+************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "hci_transport.h"
+#include "hcit_linux.h"
+#include "MemManager.h"
+
+/************************************************************************************
+*************************************************************************************
+* Private macros
+*************************************************************************************
+************************************************************************************/
+/* Simulated Controller */
+#define mFairCredits_c              (8U)
+#define mFairPacketsPerTick_c       (2U)
+#define mFairMaxInFlight_c          (64U)
+
+/* Payload of the ACL packets: tick of the send, then sequence number */
+#define mFairPayloadLength_c        (27U)
+#define mFairFirstHandle_c          (0x0040U)
+
+/* Ticks before the shares are counted */
+#define mFairWarmupTicks_c          (100U)
+
+/* Largest difference between the measured and the expected share, in percent */
+#define mFairShareTolerance_c       (1.0)
+
+#define mFairLightPeriod_c          (16U)
+
+/************************************************************************************
+*************************************************************************************
+* Private type definitions
+*************************************************************************************
+************************************************************************************/
+typedef struct fairLink_tag
+{
+    uint16_t    handle;
+    uint8_t     weight;
+    uint32_t    period;         /*!< Ticks between two packets, 0 for a busy link. */
+    uint32_t    nextSequence;   /*!< Sent by the Host. */
+    uint32_t    expected;       /*!< Next sequence number written by the transport. */
+    uint32_t    written;        /*!< Written after the warm-up. */
+    uint32_t    maxLatency;     /*!< Ticks between the send and the write. */
+    bool_t      pending;        /*!< Light link: one packet is refused and sent again. */
+}fairLink_t;
+
+typedef struct fairScenario_tag
+{
+    const char* pName;
+    bool_t      reset;          /*!< Ends with an HCI Reset instead of disconnections. */
+    uint32_t    linkCount;
+    uint8_t     weights[gHcitAclMaxLinks_c];
+    uint32_t    periods[gHcitAclMaxLinks_c];
+}fairScenario_t;
+
+/************************************************************************************
+*************************************************************************************
+* Private prototypes
+*************************************************************************************
+************************************************************************************/
+static bleResult_t Fair_TransportInterface(hciPacketType_t packetType, void* pPacket, uint16_t packetSize);
+static void Fair_WriteHook(const uint8_t* pData, uint16_t length);
+static void Fair_AclWritten(const uint8_t* pPacket, uint16_t length);
+static fairLink_t* Fair_FindLink(uint16_t handle);
+static void Fair_ReceiveEvent(const uint8_t* pEvent, uint16_t length);
+static void Fair_Send(fairLink_t* pLink);
+static void Fair_Transmit(void);
+static void Fair_Disconnect(void);
+static void Fair_Reset(void);
+static void Fair_Flush(void);
+static int Fair_Run(const fairScenario_t* pScenario);
+static void Fair_Usage(void);
+
+/************************************************************************************
+*************************************************************************************
+* Private memory declarations
+*************************************************************************************
+************************************************************************************/
+static const fairScenario_t mScenarios[] =
+{
+    { "equal",    TRUE,  gHcitAclMaxLinks_c, { 1U, 1U, 1U, 1U, 1U, 1U, 1U, 1U }, { 0U } },
+    { "weighted", FALSE, 4U,                 { 1U, 2U, 3U, 4U },                 { 0U } },
+    { "light",    FALSE, gHcitAclMaxLinks_c, { 1U, 1U, 1U, 1U, 1U, 1U, 1U, 1U },
+                                      { 0U, mFairLightPeriod_c, mFairLightPeriod_c, mFairLightPeriod_c,
+                                        mFairLightPeriod_c, mFairLightPeriod_c, mFairLightPeriod_c, mFairLightPeriod_c } },
+};
+
+static uint32_t     mTicks = 20000U;
+static bool_t       mQuiet;
+
+static fairLink_t   mLinks[gHcitAclMaxLinks_c];
+static uint32_t     mLinkCount;
+/* Each scenario uses new handles */
+static uint16_t     mNextHandle = mFairFirstHandle_c;
+static uint32_t     mTick;
+static uint32_t     mErrors;
+
+/* Packets held by the simulated Controller, oldest first */
+static uint16_t     mInFlight[mFairMaxInFlight_c];
+static uint32_t     mInFlightHead;
+static uint32_t     mInFlightCount;
+static uint32_t     mMaxInFlight;
+
+/************************************************************************************
+*************************************************************************************
+* Public functions
+*************************************************************************************
+************************************************************************************/
+/*! *********************************************************************************
+* \brief  Host entry point used by Hcit_RecvPacket().
+*
+********************************************************************************** */
+bleResult_t Ble_HciRecv
+(
+    hciPacketType_t     packetType,
+    void*               pHciPacket,
+    uint16_t            packetSize
+)
+{
+    return Fair_TransportInterface(packetType, pHciPacket, packetSize);
+}
+
+/* LE Read Buffer Size Command Complete: 251-byte buffers */
+static const uint8_t mBufferSizeEvent[] = { 0x0EU, 0x07U, 0x01U, 0x02U, 0x20U, 0x00U, 0xFBU, 0x00U, mFairCredits_c };
+
+int main(int argc, char* argv[])
+{
+    hcitConfigStruct_t  config;
+    memStats_t          memStats;
+    uint32_t            i;
+    int                 opt;
+    int                 result = 0;
+
+    while( (opt = getopt(argc, argv, "t:qh")) != -1 )
+    {
+        switch( opt )
+        {
+            case 't':
+                mTicks = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            case 'q':
+                mQuiet = TRUE;
+                break;
+            default:
+                Fair_Usage();
+                return 2;
+        }
+    }
+
+    if( mTicks <= mFairWarmupTicks_c )
+    {
+        Fair_Usage();
+        return 2;
+    }
+
+    (void)MEM_Init();
+    (void)memset(&config, 0, sizeof(config));
+    config.interfaceType = gHcitInterfaceType_d;
+    config.interfaceChannel = gHcitInterfaceNumber_d;
+    config.interfaceBaudrate = gHcitInterfaceSpeed_d;
+    config.transportInterface = Fair_TransportInterface;
+    config.writeInterface = gHcitWriteInterface_d;
+
+    if( Hcit_Init(&config) != gHciSuccess_c )
+    {
+        (void)fprintf(stderr, "Hcit_Init failed\n");
+        return 1;
+    }
+
+    HcitLinux_SetFd(-1);
+    HcitLinux_SetWriteHook(Fair_WriteHook);
+    MEM_GetStats(&memStats, TRUE);
+
+    Fair_ReceiveEvent(mBufferSizeEvent, sizeof(mBufferSizeEvent));
+
+    for( i = 0U; i < NumberOfElements(mScenarios); i++ )
+    {
+        result |= Fair_Run(&mScenarios[i]);
+    }
+
+    MEM_GetStats(&memStats, FALSE);
+    if( memStats.inUse != 0U )
+    {
+        (void)fprintf(stderr, "%u buffers leaked\n", memStats.inUse);
+        result = 1;
+    }
+
+    return result;
+}
+
+/************************************************************************************
+*************************************************************************************
+* Private functions
+*************************************************************************************
+************************************************************************************/
+static bleResult_t Fair_TransportInterface(hciPacketType_t packetType, void* pPacket, uint16_t packetSize)
+{
+    /* The events are used by the scheduler before they get here */
+    return gBleSuccess_c;
+}
+
+/*! *********************************************************************************
+* \brief  Splits the written buffers in H4 packets. The transport writes whole
+*         packets, one or more per buffer.
+*
+********************************************************************************** */
+static void Fair_WriteHook(const uint8_t* pData, uint16_t length)
+{
+    uint32_t    offset = 0U;
+    uint32_t    size;
+
+    while( offset < length )
+    {
+        if( (pData[offset] == (uint8_t)gHciDataPacket_c) && ((offset + 5U) <= length) )
+        {
+            size = 4U + ((uint32_t)pData[offset + 3U] | ((uint32_t)pData[offset + 4U] << 8));
+            if( (offset + 1U + size) <= length )
+            {
+                Fair_AclWritten(&pData[offset + 1U], (uint16_t)size);
+            }
+        }
+        else if( (pData[offset] == (uint8_t)gHciCommandPacket_c) && ((offset + 4U) <= length) )
+        {
+            size = 3U + (uint32_t)pData[offset + 3U];
+        }
+        else
+        {
+            (void)fprintf(stderr, "unexpected write of %u bytes\n", length);
+            mErrors++;
+            return;
+        }
+
+        offset += 1U + size;
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Hands a written ACL packet to the simulated Controller.
+*
+********************************************************************************** */
+static void Fair_AclWritten(const uint8_t* pPacket, uint16_t length)
+{
+    uint16_t    handle = (uint16_t)(((uint32_t)pPacket[0] | ((uint32_t)pPacket[1] << 8)) & 0x0FFFU);
+    fairLink_t* pLink = Fair_FindLink(handle);
+    uint32_t    tick;
+    uint32_t    sequence;
+
+    if( (pLink == NULL) || (length != (4U + mFairPayloadLength_c)) )
+    {
+        (void)fprintf(stderr, "unexpected ACL packet for handle 0x%04X\n", handle);
+        mErrors++;
+        return;
+    }
+
+    (void)memcpy(&tick, &pPacket[4], sizeof(tick));
+    (void)memcpy(&sequence, &pPacket[8], sizeof(sequence));
+
+    if( sequence != pLink->expected )
+    {
+        (void)fprintf(stderr, "handle 0x%04X: packet %u written instead of %u\n", handle, sequence, pLink->expected);
+        mErrors++;
+    }
+    pLink->expected = sequence + 1U;
+
+    if( mTick >= mFairWarmupTicks_c )
+    {
+        pLink->written++;
+    }
+    if( (mTick - tick) > pLink->maxLatency )
+    {
+        pLink->maxLatency = mTick - tick;
+    }
+
+    if( mInFlightCount == mFairMaxInFlight_c )
+    {
+        (void)fprintf(stderr, "Controller overrun\n");
+        mErrors++;
+        return;
+    }
+
+    mInFlight[(mInFlightHead + mInFlightCount) % mFairMaxInFlight_c] = handle;
+    mInFlightCount++;
+    if( mInFlightCount > mMaxInFlight )
+    {
+        mMaxInFlight = mInFlightCount;
+    }
+}
+
+static fairLink_t* Fair_FindLink(uint16_t handle)
+{
+    uint32_t i;
+
+    for( i = 0U; i < mLinkCount; i++ )
+    {
+        if( mLinks[i].handle == handle )
+        {
+            return &mLinks[i];
+        }
+    }
+
+    return NULL;
+}
+
+/*! *********************************************************************************
+* \brief  Feeds an event to the transport, as received from the Controller.
+*
+********************************************************************************** */
+static void Fair_ReceiveEvent(const uint8_t* pEvent, uint16_t length)
+{
+    uint8_t h4[260];
+
+    h4[0] = (uint8_t)gHciEventPacket_c;
+    (void)memcpy(&h4[1], pEvent, length);
+    Hcit_InterfaceDataReceived(h4, (uint16_t)(length + 1U));
+    Fair_Flush();
+}
+
+/*! *********************************************************************************
+* \brief  Sends the next packet of a connection. A busy connection sends until its
+*         queue is full.
+*
+********************************************************************************** */
+static void Fair_Send(fairLink_t* pLink)
+{
+    uint8_t     packet[4U + mFairPayloadLength_c];
+    bleResult_t result;
+
+    if( (pLink->period != 0U) && !pLink->pending && ((mTick % pLink->period) != 0U) )
+    {
+        return;
+    }
+
+    do
+    {
+        packet[0] = (uint8_t)pLink->handle;
+        packet[1] = (uint8_t)(pLink->handle >> 8);
+        packet[2] = mFairPayloadLength_c;
+        packet[3] = 0U;
+        (void)memset(&packet[4], 0xA5, mFairPayloadLength_c);
+        (void)memcpy(&packet[4], &mTick, sizeof(mTick));
+        (void)memcpy(&packet[8], &pLink->nextSequence, sizeof(pLink->nextSequence));
+
+        result = Hcit_SendPacket(gHciDataPacket_c, packet, sizeof(packet));
+        if( result == gBleSuccess_c )
+        {
+            pLink->nextSequence++;
+        }
+        else if( result != gBleOverflow_c )
+        {
+            (void)fprintf(stderr, "Hcit_SendPacket failed: 0x%04X\n", (unsigned)result);
+            mErrors++;
+        }
+        else
+        {
+            /* Queue full: sent again on the next tick */
+        }
+
+        Fair_Flush();
+    } while( (result == gBleSuccess_c) && (pLink->period == 0U) );
+
+    pLink->pending = (result == gBleOverflow_c);
+}
+
+/*! *********************************************************************************
+* \brief  Transmits the oldest packets held by the simulated Controller and reports
+*         them with Number Of Completed Packets.
+*
+********************************************************************************** */
+static void Fair_Transmit(void)
+{
+    uint8_t     event[3U + 4U * mFairPacketsPerTick_c];
+    uint32_t    handles = 0U;
+    uint32_t    i;
+    uint32_t    j;
+    uint16_t    handle;
+
+    for( i = 0U; (i < mFairPacketsPerTick_c) && (mInFlightCount > 0U); i++ )
+    {
+        handle = mInFlight[mInFlightHead];
+        mInFlightHead = (mInFlightHead + 1U) % mFairMaxInFlight_c;
+        mInFlightCount--;
+
+        for( j = 0U; j < handles; j++ )
+        {
+            if( (event[3U + 4U * j] | ((uint16_t)event[4U + 4U * j] << 8)) == handle )
+            {
+                event[5U + 4U * j]++;
+                break;
+            }
+        }
+
+        if( j == handles )
+        {
+            event[3U + 4U * j] = (uint8_t)handle;
+            event[4U + 4U * j] = (uint8_t)(handle >> 8);
+            event[5U + 4U * j] = 1U;
+            event[6U + 4U * j] = 0U;
+            handles++;
+        }
+    }
+
+    if( handles > 0U )
+    {
+        event[0] = (uint8_t)gHciNumberOfCompletedPacketsEvent_c;
+        event[1] = (uint8_t)(1U + 4U * handles);
+        event[2] = (uint8_t)handles;
+        Fair_ReceiveEvent(event, (uint16_t)(3U + 4U * handles));
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Closes the connections of a scenario. The Controller drops the packets it
+*         holds for them, and the transport drops the queued ones.
+*
+********************************************************************************** */
+static void Fair_Disconnect(void)
+{
+    uint8_t     event[6];
+    uint32_t    i;
+
+    for( i = 0U; i < mLinkCount; i++ )
+    {
+        event[0] = (uint8_t)gHciDisconnectionCompleteEvent_c;
+        event[1] = 4U;
+        event[2] = (uint8_t)gHciSuccess_c;
+        event[3] = (uint8_t)mLinks[i].handle;
+        event[4] = (uint8_t)(mLinks[i].handle >> 8);
+        event[5] = 0x13U;
+        Fair_ReceiveEvent(event, sizeof(event));
+    }
+
+    mInFlightHead = 0U;
+    mInFlightCount = 0U;
+    mLinkCount = 0U;
+}
+
+/*! *********************************************************************************
+* \brief  Resets the Controller with the connections of a scenario still open. The
+*         Controller drops them and the packets it holds, and the Host reads the
+*         buffer size again.
+*
+********************************************************************************** */
+static void Fair_Reset(void)
+{
+    /* Reset Command Complete */
+    const uint8_t reset[] = { 0x0EU, 0x04U, 0x01U, 0x03U, 0x0CU, 0x00U };
+
+    Fair_ReceiveEvent(reset, sizeof(reset));
+
+    mInFlightHead = 0U;
+    mInFlightCount = 0U;
+    mLinkCount = 0U;
+
+    Fair_ReceiveEvent(mBufferSizeEvent, sizeof(mBufferSizeEvent));
+}
+
+/*! *********************************************************************************
+* \brief  Completes the writes, so the transport writes the next packets.
+*
+********************************************************************************** */
+static void Fair_Flush(void)
+{
+    while( HcitLinux_CompleteWrites() > 0U )
+    {
+    }
+}
+
+static int Fair_Run(const fairScenario_t* pScenario)
+{
+    uint32_t    totalWeight = 0U;
+    uint32_t    totalWritten = 0U;
+    uint32_t    busyWritten = 0U;
+    uint32_t    busyLinks = 0U;
+    uint32_t    latencyLimit;
+    double      sum = 0.0;
+    double      sumSquares = 0.0;
+    double      perWeight;
+    double      share;
+    double      expected;
+    uint32_t    i;
+
+    (void)memset(mLinks, 0, sizeof(mLinks));
+    mLinkCount = pScenario->linkCount;
+    mMaxInFlight = 0U;
+    mErrors = 0U;
+
+    for( i = 0U; i < mLinkCount; i++ )
+    {
+        mLinks[i].handle = mNextHandle;
+        mNextHandle++;
+        mLinks[i].weight = pScenario->weights[i];
+        mLinks[i].period = pScenario->periods[i];
+
+        if( Hcit_AclSetLinkWeight(mLinks[i].handle, mLinks[i].weight) != gBleSuccess_c )
+        {
+            (void)fprintf(stderr, "%s: Hcit_AclSetLinkWeight failed\n", pScenario->pName);
+            mErrors++;
+        }
+
+        if( mLinks[i].period == 0U )
+        {
+            totalWeight += mLinks[i].weight;
+        }
+    }
+
+    for( mTick = 0U; mTick < mTicks; mTick++ )
+    {
+        for( i = 0U; i < mLinkCount; i++ )
+        {
+            Fair_Send(&mLinks[(i + mTick) % mLinkCount]);
+        }
+
+        Fair_Transmit();
+    }
+
+    for( i = 0U; i < mLinkCount; i++ )
+    {
+        totalWritten += mLinks[i].written;
+
+        if( mLinks[i].period == 0U )
+        {
+            /* Jain's index of the packets per unit of weight */
+            perWeight = (double)mLinks[i].written / (double)mLinks[i].weight;
+            busyWritten += mLinks[i].written;
+            sum += perWeight;
+            sumSquares += perWeight * perWeight;
+            busyLinks++;
+        }
+    }
+
+    if( !mQuiet )
+    {
+        (void)printf("%s: %u ticks, %u credits, %u packets per tick, at most %u packets in the Controller\n",
+                     pScenario->pName, mTicks, mFairCredits_c, mFairPacketsPerTick_c, mMaxInFlight);
+        (void)printf("  handle  weight  period  written   share  expected  latency\n");
+    }
+
+    /* A light packet waits for the Controller to free a credit, and at most for one
+       packet of each other link */
+    latencyLimit = (mLinkCount + mFairCredits_c + mFairPacketsPerTick_c - 1U) / mFairPacketsPerTick_c;
+
+    for( i = 0U; i < mLinkCount; i++ )
+    {
+        share = 100.0 * (double)mLinks[i].written / (double)totalWritten;
+
+        if( mLinks[i].period == 0U )
+        {
+            /* The busy links share what the light links leave, by weight */
+            expected = 100.0 * ((double)busyWritten / (double)totalWritten) * (double)mLinks[i].weight / (double)totalWeight;
+
+            if( ((share - expected) > mFairShareTolerance_c) || ((expected - share) > mFairShareTolerance_c) )
+            {
+                (void)fprintf(stderr, "%s: handle 0x%04X got %.1f%% instead of %.1f%%\n", pScenario->pName,
+                              mLinks[i].handle, share, expected);
+                mErrors++;
+            }
+        }
+        else
+        {
+            /* Every light packet is written, and soon */
+            expected = share;
+
+            if( (mLinks[i].written + 1U) < ((mTicks - mFairWarmupTicks_c) / mLinks[i].period) )
+            {
+                (void)fprintf(stderr, "%s: handle 0x%04X starved\n", pScenario->pName, mLinks[i].handle);
+                mErrors++;
+            }
+            if( mLinks[i].maxLatency > latencyLimit )
+            {
+                (void)fprintf(stderr, "%s: handle 0x%04X waited %u ticks\n", pScenario->pName,
+                              mLinks[i].handle, mLinks[i].maxLatency);
+                mErrors++;
+            }
+        }
+
+        if( !mQuiet )
+        {
+            (void)printf("  0x%04X  %6u  %6u  %7u  %5.1f%%  %7.1f%%  %7u\n", mLinks[i].handle, mLinks[i].weight,
+                         mLinks[i].period, mLinks[i].written, share, expected, mLinks[i].maxLatency);
+        }
+    }
+
+    if( !mQuiet )
+    {
+        (void)printf("  fairness index of the busy links: %.4f\n", (sum * sum) / ((double)busyLinks * sumSquares));
+    }
+
+    if( mMaxInFlight != mFairCredits_c )
+    {
+        (void)fprintf(stderr, "%s: at most %u packets sent for %u credits\n", pScenario->pName, mMaxInFlight, mFairCredits_c);
+        mErrors++;
+    }
+
+    if( pScenario->reset )
+    {
+        Fair_Reset();
+    }
+    else
+    {
+        Fair_Disconnect();
+    }
+    Fair_Flush();
+
+    return (mErrors == 0U) ? 0 : 1;
+}
+
+static void Fair_Usage(void)
+{
+    (void)fprintf(stderr,
+        "usage: hcit_acl_fairness [-t ticks] [-q]\n"
+        "  -t ticks   length of each scenario (default 20000)\n"
+        "  -q         prints only on failure\n");
+}
@@ -0,0 +1,899 @@
+/*! *********************************************************************************
+* Copyright 2026 NXP
+* All rights reserved.
+*
+* \file
+*
+* Simulates a busy Host on the Linux build of the HCI transport, with the ACL
+* receive demultiplexing enabled (gHcitAclRxDemux_d), and checks what it holds back.
+*
+* The simulated Host queues the packets given by the transport in one queue, as the
+* Host task, takes a fixed number of them per tick and reports its pending ACL packets
+* with pfHostAclPending. The poll timer expires at once, so each tick ends with one
+* timer run. The scenarios are:
+*   flood     one connection receives bursts, another one a packet now and then, and
+*             vendor events arrive in between: the events and the light connection
+*             must not wait behind the bursts
+*   state     Encryption Change and Disconnection Complete come after the held data
+*             of their connection, other events go ahead of it
+*   deferred  packets received while the poll timer gives packets to the Host are
+*             given by the timer, in order
+*   nomem     without memory for the copies, the packets are given at once, in order
+*   reset     HCI Reset drops the held packets and the connections
+*
+* Each connection keeps its packets in order, no packet is lost and no buffer leaks.
+* The exit status is nonzero if a check fails.
+*
+* SPDX-License-Identifier: BSD-3-Clause
+********************************************************************************** */
+
+/************************************************************************************
+*************************************************************************************
+* Include
+*************************************************************************************
+************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "hci_transport.h"
+#include "hcit_linux.h"
+#include "MemManager.h"
+#include "TimersManager.h"
+
+/************************************************************************************
+*************************************************************************************
+* Private macros
+*************************************************************************************
+************************************************************************************/
+/* Simulated Host */
+#define mRxHostQueueSize_c          (1024U)
+#define mRxHostTakePerTick_c        (2U)
+
+/* Payload of the ACL packets and of the vendor events: tick of the reception, then
+   sequence number */
+#define mRxPayloadLength_c          (8U)
+#define mRxVendorEvent_c            (0xFFU)
+#define mRxNoHandle_c               (0xFFFFU)
+
+#define mRxFirstHandle_c            (0x0040U)
+
+/* ACL packets fed at once */
+#define mRxSpanPackets_c            (gHcitAclRxHostDepth_c + gHcitAclRxQueueDepth_c + 1U)
+
+/* flood: a burst every mRxBurstPeriod_c ticks, a light packet and an event every
+   mRxLightPeriod_c and mRxEventPeriod_c ticks, then ticks to let the Host catch up */
+#define mRxBurstLength_c            (6U)
+#define mRxBurstPeriod_c            (4U)
+#define mRxLightPeriod_c            (4U)
+#define mRxEventPeriod_c            (5U)
+#define mRxDrainTicks_c             (100U)
+
+/* A light packet waits for the ACL packets the Host holds when it is received, and
+   for one held packet of the busy connection */
+#define mRxLightLatencyLimit_c      ((gHcitAclRxHostDepth_c + gHcitAclRxQueueDepth_c + 1U + \
+                                      mRxHostTakePerTick_c - 1U) / mRxHostTakePerTick_c)
+
+/************************************************************************************
+*************************************************************************************
+* Private type definitions
+*************************************************************************************
+************************************************************************************/
+/* Packet given to the simulated Host */
+typedef struct rxHostPacket_tag
+{
+    uint8_t     packetType;
+    uint8_t     eventCode;
+    uint16_t    handle;         /*!< mRxNoHandle_c for the events without a connection. */
+    uint32_t    tick;           /*!< Tick of the reception. */
+    uint32_t    sequence;
+}rxHostPacket_t;
+
+typedef struct rxLink_tag
+{
+    uint16_t    handle;
+    uint32_t    sent;
+    uint32_t    expected;       /*!< Next sequence number taken by the Host. */
+    uint32_t    maxLatency;     /*!< Ticks between the reception and the Host. */
+}rxLink_t;
+
+/************************************************************************************
+*************************************************************************************
+* Private prototypes
+*************************************************************************************
+************************************************************************************/
+static bleResult_t Rx_TransportInterface(hciPacketType_t packetType, void* pPacket, uint16_t packetSize);
+static uint32_t Rx_HostAclPending(void);
+static void Rx_WriteHook(const uint8_t* pData, uint16_t length);
+static uint32_t Rx_HostTake(uint32_t count);
+static void Rx_Tick(uint32_t take);
+static rxLink_t* Rx_FindLink(uint16_t handle);
+static uint16_t Rx_BuildAcl(uint8_t* pH4, rxLink_t* pLink);
+static uint16_t Rx_BuildVendorEvent(uint8_t* pH4);
+static void Rx_ReceiveAcl(rxLink_t* pLink, uint32_t count);
+static void Rx_ReceiveEvent(const uint8_t* pEvent, uint16_t length);
+static void Rx_ReceiveVendorEvent(void);
+static void Rx_ReceiveLinkEvent(uint8_t eventCode, uint16_t handle);
+static void Rx_Start(const char* pName);
+static void Rx_CheckQueue(const char* pName, const uint8_t* pTypes, const uint16_t* pHandles, uint32_t count);
+static void Rx_CheckHeld(const char* pName, uint16_t handle, uint8_t queued);
+static int Rx_Finish(const char* pName);
+static int Rx_Flood(void);
+static int Rx_State(void);
+static int Rx_Deferred(void);
+static int Rx_NoMemory(void);
+static int Rx_Reset(void);
+static void Rx_Usage(void);
+
+/************************************************************************************
+*************************************************************************************
+* Private memory declarations
+*************************************************************************************
+************************************************************************************/
+static uint32_t         mTicks = 4000U;
+static bool_t           mQuiet;
+
+static rxLink_t         mLinks[2];
+/* Each scenario uses new handles */
+static uint16_t         mNextHandle = mRxFirstHandle_c;
+static uint32_t         mTick;
+static uint32_t         mErrors;
+
+/* Simulated Host queue, oldest first */
+static rxHostPacket_t   mHostQueue[mRxHostQueueSize_c];
+static uint32_t         mHostHead;
+static uint32_t         mHostCount;
+static uint32_t         mHostAcl;           /*!< ACL packets in the Host queue. */
+
+/* Vendor events */
+static uint32_t         mEventsSent;
+static uint32_t         mEventsExpected;
+static uint32_t         mEventMaxLatency;
+static uint32_t         mEventMaxAclAhead;  /*!< ACL packets in the Host queue at delivery. */
+
+/* Received from the transport interface once the next packet is given to the Host,
+   as an interrupt preempting the poll timer */
+static uint8_t          mInterruptBytes[64];
+static uint16_t         mInterruptLength;
+
+/************************************************************************************
+*************************************************************************************
+* Public functions
+*************************************************************************************
+************************************************************************************/
+/*! *********************************************************************************
+* \brief  Host entry point used by Hcit_RecvPacket().
+*
+********************************************************************************** */
+bleResult_t Ble_HciRecv
+(
+    hciPacketType_t     packetType,
+    void*               pHciPacket,
+    uint16_t            packetSize
+)
+{
+    return Rx_TransportInterface(packetType, pHciPacket, packetSize);
+}
+
+int main(int argc, char* argv[])
+{
+    hcitConfigStruct_t  config;
+    memStats_t          memStats;
+    int                 opt;
+    int                 result = 0;
+
+    while( (opt = getopt(argc, argv, "t:qh")) != -1 )
+    {
+        switch( opt )
+        {
+            case 't':
+                mTicks = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            case 'q':
+                mQuiet = TRUE;
+                break;
+            default:
+                Rx_Usage();
+                return 2;
+        }
+    }
+
+    if( mTicks == 0U )
+    {
+        Rx_Usage();
+        return 2;
+    }
+
+    (void)MEM_Init();
+    (void)memset(&config, 0, sizeof(config));
+    config.interfaceType = gHcitInterfaceType_d;
+    config.interfaceChannel = gHcitInterfaceNumber_d;
+    config.interfaceBaudrate = gHcitInterfaceSpeed_d;
+    config.transportInterface = Rx_TransportInterface;
+    config.writeInterface = gHcitWriteInterface_d;
+    config.pfHostAclPending = Rx_HostAclPending;
+
+    if( Hcit_Init(&config) != gHciSuccess_c )
+    {
+        (void)fprintf(stderr, "Hcit_Init failed\n");
+        return 1;
+    }
+
+    HcitLinux_SetFd(-1);
+    HcitLinux_SetWriteHook(Rx_WriteHook);
+    MEM_GetStats(&memStats, TRUE);
+
+    result |= Rx_Flood();
+    result |= Rx_State();
+    result |= Rx_Deferred();
+    result |= Rx_NoMemory();
+    result |= Rx_Reset();
+
+    MEM_GetStats(&memStats, FALSE);
+    if( memStats.inUse != 0U )
+    {
+        (void)fprintf(stderr, "%u buffers leaked\n", memStats.inUse);
+        result = 1;
+    }
+
+    return result;
+}
+
+/************************************************************************************
+*************************************************************************************
+* Private functions
+*************************************************************************************
+************************************************************************************/
+/*! *********************************************************************************
+* \brief  Queues a packet for the simulated Host, as Ble_HciRecv().
+*
+********************************************************************************** */
+static bleResult_t Rx_TransportInterface(hciPacketType_t packetType, void* pPacket, uint16_t packetSize)
+{
+    const uint8_t*  pRaw = (const uint8_t*)pPacket;
+    rxHostPacket_t* pEntry;
+    uint16_t        length;
+
+    if( mHostCount == mRxHostQueueSize_c )
+    {
+        (void)fprintf(stderr, "Host queue overrun\n");
+        mErrors++;
+        return gBleOverflow_c;
+    }
+
+    pEntry = &mHostQueue[(mHostHead + mHostCount) % mRxHostQueueSize_c];
+    (void)memset(pEntry, 0, sizeof(rxHostPacket_t));
+    pEntry->packetType = (uint8_t)packetType;
+    pEntry->handle = mRxNoHandle_c;
+
+    if( (packetType == gHciDataPacket_c) && (packetSize == (4U + mRxPayloadLength_c)) )
+    {
+        pEntry->handle = (uint16_t)(((uint32_t)pRaw[0] | ((uint32_t)pRaw[1] << 8)) & 0x0FFFU);
+        (void)memcpy(&pEntry->tick, &pRaw[4], sizeof(uint32_t));
+        (void)memcpy(&pEntry->sequence, &pRaw[8], sizeof(uint32_t));
+        mHostAcl++;
+    }
+    else if( packetType == gHciEventPacket_c )
+    {
+        pEntry->eventCode = pRaw[0];
+
+        if( (pRaw[0] == mRxVendorEvent_c) && (packetSize == (2U + mRxPayloadLength_c)) )
+        {
+            (void)memcpy(&pEntry->tick, &pRaw[2], sizeof(uint32_t));
+            (void)memcpy(&pEntry->sequence, &pRaw[6], sizeof(uint32_t));
+
+            if( mHostAcl > mEventMaxAclAhead )
+            {
+                mEventMaxAclAhead = mHostAcl;
+            }
+        }
+        else if( ((pRaw[0] == (uint8_t)gHciDisconnectionCompleteEvent_c) ||
+                  (pRaw[0] == (uint8_t)gHciEncryptionChangeEvent_c)) && (packetSize >= 5U) )
+        {
+            pEntry->handle = (uint16_t)(((uint32_t)pRaw[3] | ((uint32_t)pRaw[4] << 8)) & 0x0FFFU);
+        }
+        else
+        {
+            /* Command Complete */
+        }
+    }
+    else
+    {
+        (void)fprintf(stderr, "unexpected packet of type %u\n", (unsigned)packetType);
+        mErrors++;
+        return gBleSuccess_c;
+    }
+    mHostCount++;
+
+    /* The interrupt is taken once */
+    length = mInterruptLength;
+    if( length > 0U )
+    {
+        mInterruptLength = 0U;
+        Hcit_InterfaceDataReceived(mInterruptBytes, length);
+    }
+
+    return gBleSuccess_c;
+}
+
+static uint32_t Rx_HostAclPending(void)
+{
+    return mHostAcl;
+}
+
+/*! *********************************************************************************
+* \brief  The transport writes nothing in these scenarios.
+*
+********************************************************************************** */
+static void Rx_WriteHook(const uint8_t* pData, uint16_t length)
+{
+    (void)pData;
+    (void)fprintf(stderr, "unexpected write of %u bytes\n", length);
+    mErrors++;
+}
+
+/*! *********************************************************************************
+* \brief  Takes packets from the Host queue, as the Host task, and checks their
+*         order.
+*
+* \return  Number of packets taken.
+*
+********************************************************************************** */
+static uint32_t Rx_HostTake(uint32_t count)
+{
+    rxHostPacket_t* pEntry;
+    rxLink_t*       pLink;
+    uint32_t        taken = 0U;
+
+    while( (taken < count) && (mHostCount > 0U) )
+    {
+        pEntry = &mHostQueue[mHostHead];
+        mHostHead = (mHostHead + 1U) % mRxHostQueueSize_c;
+        mHostCount--;
+        taken++;
+
+        if( pEntry->packetType == (uint8_t)gHciDataPacket_c )
+        {
+            mHostAcl--;
+            pLink = Rx_FindLink(pEntry->handle);
+
+            if( NULL == pLink )
+            {
+                (void)fprintf(stderr, "ACL packet for unknown handle 0x%04X\n", pEntry->handle);
+                mErrors++;
+                continue;
+            }
+
+            if( pEntry->sequence != pLink->expected )
+            {
+                (void)fprintf(stderr, "handle 0x%04X: packet %u taken instead of %u\n",
+                              pLink->handle, pEntry->sequence, pLink->expected);
+                mErrors++;
+            }
+            pLink->expected = pEntry->sequence + 1U;
+
+            if( (mTick - pEntry->tick) > pLink->maxLatency )
+            {
+                pLink->maxLatency = mTick - pEntry->tick;
+            }
+        }
+        else if( pEntry->eventCode == mRxVendorEvent_c )
+        {
+            if( pEntry->sequence != mEventsExpected )
+            {
+                (void)fprintf(stderr, "event %u taken instead of %u\n", pEntry->sequence, mEventsExpected);
+                mErrors++;
+            }
+            mEventsExpected = pEntry->sequence + 1U;
+
+            if( (mTick - pEntry->tick) > mEventMaxLatency )
+            {
+                mEventMaxLatency = mTick - pEntry->tick;
+            }
+        }
+        else
+        {
+            /* State events are checked with Rx_CheckQueue() */
+        }
+    }
+
+    return taken;
+}
+
+/*! *********************************************************************************
+* \brief  Ends a tick: the Host takes its packets, then the poll timer runs.
+*
+********************************************************************************** */
+static void Rx_Tick(uint32_t take)
+{
+    (void)Rx_HostTake(take);
+    (void)TMR_Process();
+    mTick++;
+}
+
+static rxLink_t* Rx_FindLink(uint16_t handle)
+{
+    uint32_t i;
+
+    for( i = 0U; i < NumberOfElements(mLinks); i++ )
+    {
+        if( mLinks[i].handle == handle )
+        {
+            return &mLinks[i];
+        }
+    }
+
+    return NULL;
+}
+
+/*! *********************************************************************************
+* \brief  Builds the next H4 ACL packet of a connection.
+*
+* \return  Size of the H4 packet.
+*
+********************************************************************************** */
+static uint16_t Rx_BuildAcl(uint8_t* pH4, rxLink_t* pLink)
+{
+    pH4[0] = (uint8_t)gHciDataPacket_c;
+    pH4[1] = (uint8_t)pLink->handle;
+    pH4[2] = (uint8_t)((pLink->handle >> 8) | 0x20U);    /* First automatically flushable */
+    pH4[3] = (uint8_t)mRxPayloadLength_c;
+    pH4[4] = 0U;
+    (void)memcpy(&pH4[5], &mTick, sizeof(uint32_t));
+    (void)memcpy(&pH4[9], &pLink->sent, sizeof(uint32_t));
+    pLink->sent++;
+
+    return (uint16_t)(5U + mRxPayloadLength_c);
+}
+
+static uint16_t Rx_BuildVendorEvent(uint8_t* pH4)
+{
+    pH4[0] = (uint8_t)gHciEventPacket_c;
+    pH4[1] = mRxVendorEvent_c;
+    pH4[2] = (uint8_t)mRxPayloadLength_c;
+    (void)memcpy(&pH4[3], &mTick, sizeof(uint32_t));
+    (void)memcpy(&pH4[7], &mEventsSent, sizeof(uint32_t));
+    mEventsSent++;
+
+    return (uint16_t)(3U + mRxPayloadLength_c);
+}
+
+/*! *********************************************************************************
+* \brief  Feeds ACL packets of a connection to the transport, in one span.
+*
+********************************************************************************** */
+static void Rx_ReceiveAcl(rxLink_t* pLink, uint32_t count)
+{
+    uint8_t     span[mRxSpanPackets_c * (5U + mRxPayloadLength_c)];
+    uint16_t    length = 0U;
+    uint32_t    i;
+
+    for( i = 0U; i < count; i++ )
+    {
+        length += Rx_BuildAcl(&span[length], pLink);
+    }
+
+    Hcit_InterfaceDataReceived(span, length);
+}
+
+/*! *********************************************************************************
+* \brief  Feeds an event to the transport, as received from the Controller.
+*
+********************************************************************************** */
+static void Rx_ReceiveEvent(const uint8_t* pEvent, uint16_t length)
+{
+    uint8_t h4[260];
+
+    h4[0] = (uint8_t)gHciEventPacket_c;
+    (void)memcpy(&h4[1], pEvent, length);
+    Hcit_InterfaceDataReceived(h4, (uint16_t)(length + 1U));
+}
+
+static void Rx_ReceiveVendorEvent(void)
+{
+    uint8_t     h4[3U + mRxPayloadLength_c];
+    uint16_t    length = Rx_BuildVendorEvent(h4);
+
+    Hcit_InterfaceDataReceived(h4, length);
+}
+
+/*! *********************************************************************************
+* \brief  Feeds a successful Encryption Change or Disconnection Complete event.
+*
+********************************************************************************** */
+static void Rx_ReceiveLinkEvent(uint8_t eventCode, uint16_t handle)
+{
+    uint8_t event[6];
+
+    event[0] = eventCode;
+    event[1] = 4U;
+    event[2] = (uint8_t)gHciSuccess_c;
+    event[3] = (uint8_t)handle;
+    event[4] = (uint8_t)(handle >> 8);
+    event[5] = (eventCode == (uint8_t)gHciDisconnectionCompleteEvent_c) ? 0x13U : 0x01U;
+    Rx_ReceiveEvent(event, sizeof(event));
+}
+
+/*! *********************************************************************************
+* \brief  Starts a scenario with an empty Host queue and two new connections.
+*
+********************************************************************************** */
+static void Rx_Start(const char* pName)
+{
+    uint32_t i;
+
+    (void)pName;
+    (void)memset(mLinks, 0, sizeof(mLinks));
+    for( i = 0U; i < NumberOfElements(mLinks); i++ )
+    {
+        mLinks[i].handle = mNextHandle;
+        mNextHandle++;
+    }
+
+    mHostHead = 0U;
+    mHostCount = 0U;
+    mHostAcl = 0U;
+    mEventsSent = 0U;
+    mEventsExpected = 0U;
+    mEventMaxLatency = 0U;
+    mEventMaxAclAhead = 0U;
+    mErrors = 0U;
+}
+
+/*! *********************************************************************************
+* \brief  Checks the packets of the Host queue, oldest first, without taking them.
+*
+********************************************************************************** */
+static void Rx_CheckQueue(const char* pName, const uint8_t* pTypes, const uint16_t* pHandles, uint32_t count)
+{
+    const rxHostPacket_t*   pEntry;
+    uint8_t                 type;
+    uint32_t                i;
+
+    if( mHostCount != count )
+    {
+        (void)fprintf(stderr, "%s: %u packets given to the Host instead of %u\n", pName, mHostCount, count);
+        mErrors++;
+        return;
+    }
+
+    for( i = 0U; i < count; i++ )
+    {
+        pEntry = &mHostQueue[(mHostHead + i) % mRxHostQueueSize_c];
+        type = (pEntry->packetType == (uint8_t)gHciDataPacket_c) ? (uint8_t)gHciDataPacket_c : pEntry->eventCode;
+
+        if( (type != pTypes[i]) || (pEntry->handle != pHandles[i]) )
+        {
+            (void)fprintf(stderr, "%s: packet %u given to the Host is 0x%02X for 0x%04X instead of 0x%02X for 0x%04X\n",
+                          pName, i, type, pEntry->handle, pTypes[i], pHandles[i]);
+            mErrors++;
+        }
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Checks the number of packets held for a connection. 0xFF if the connection
+*         must be unknown to the transport.
+*
+********************************************************************************** */
+static void Rx_CheckHeld(const char* pName, uint16_t handle, uint8_t queued)
+{
+    hcitAclRxStats_t    stats;
+    bleResult_t         result = Hcit_AclRxGetStats(handle, &stats);
+
+    if( queued == 0xFFU )
+    {
+        if( result != gBleInvalidParameter_c )
+        {
+            (void)fprintf(stderr, "%s: handle 0x%04X still known to the transport\n", pName, handle);
+            mErrors++;
+        }
+    }
+    else if( (result != gBleSuccess_c) || (stats.queued != queued) )
+    {
+        (void)fprintf(stderr, "%s: handle 0x%04X holds %u packets instead of %u\n", pName, handle,
+                      (result == gBleSuccess_c) ? stats.queued : 0U, queued);
+        mErrors++;
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Lets the Host take every packet, checks that none is lost and closes the
+*         connections.
+*
+********************************************************************************** */
+static int Rx_Finish(const char* pName)
+{
+    uint32_t i;
+
+    for( i = 0U; (i < mRxDrainTicks_c) && (mHostCount > 0U); i++ )
+    {
+        Rx_Tick(mRxHostQueueSize_c);
+    }
+
+    for( i = 0U; i < NumberOfElements(mLinks); i++ )
+    {
+        if( mLinks[i].expected != mLinks[i].sent )
+        {
+            (void)fprintf(stderr, "%s: handle 0x%04X: %u packets taken out of %u\n", pName,
+                          mLinks[i].handle, mLinks[i].expected, mLinks[i].sent);
+            mErrors++;
+        }
+
+        Rx_ReceiveLinkEvent((uint8_t)gHciDisconnectionCompleteEvent_c, mLinks[i].handle);
+        Rx_CheckHeld(pName, mLinks[i].handle, 0xFFU);
+    }
+
+    if( mEventsExpected != mEventsSent )
+    {
+        (void)fprintf(stderr, "%s: %u events taken out of %u\n", pName, mEventsExpected, mEventsSent);
+        mErrors++;
+    }
+
+    (void)Rx_HostTake(mRxHostQueueSize_c);
+
+    if( !mQuiet )
+    {
+        (void)printf("%s: %s\n", pName, (mErrors == 0U) ? "ok" : "FAILED");
+    }
+
+    return (mErrors == 0U) ? 0 : 1;
+}
+
+/*! *********************************************************************************
+* \brief  Bursts on one connection, light traffic on the other one and events.
+*
+********************************************************************************** */
+static int Rx_Flood(void)
+{
+    hcitAclRxStats_t    stats;
+    rxLink_t*           pBusy = &mLinks[0];
+    rxLink_t*           pLight = &mLinks[1];
+    uint32_t            eventLatencyLimit;
+
+    Rx_Start("flood");
+
+    for( mTick = 0U; mTick < mTicks; )
+    {
+        if( (mTick % mRxBurstPeriod_c) == 0U )
+        {
+            Rx_ReceiveAcl(pBusy, mRxBurstLength_c);
+        }
+        if( (mTick % mRxLightPeriod_c) == (mRxLightPeriod_c / 2U) )
+        {
+            Rx_ReceiveAcl(pLight, 1U);
+        }
+        if( (mTick % mRxEventPeriod_c) == 1U )
+        {
+            Rx_ReceiveVendorEvent();
+        }
+
+        Rx_Tick(mRxHostTakePerTick_c);
+    }
+
+    if( Hcit_AclRxGetStats(pBusy->handle, &stats) != gBleSuccess_c )
+    {
+        (void)fprintf(stderr, "flood: no counters for handle 0x%04X\n", pBusy->handle);
+        return 1;
+    }
+
+    if( !mQuiet )
+    {
+        (void)printf("flood: %u ticks, Host takes %u packets per tick, holds at most %u ACL packets ahead\n",
+                     mTicks, mRxHostTakePerTick_c, gHcitAclRxHostDepth_c);
+        (void)printf("  busy  0x%04X: %u packets, %u held, %u given early, at most %u queued, latency %u ticks\n",
+                     pBusy->handle, stats.packets, stats.held, stats.overflows, stats.maxQueued, pBusy->maxLatency);
+        (void)printf("  light 0x%04X: latency %u ticks\n", pLight->handle, pLight->maxLatency);
+        (void)printf("  events: latency %u ticks, at most %u ACL packets ahead\n", mEventMaxLatency, mEventMaxAclAhead);
+    }
+
+    if( (stats.packets != pBusy->sent) || (stats.held == 0U) || (stats.maxQueued > gHcitAclRxQueueDepth_c) )
+    {
+        (void)fprintf(stderr, "flood: handle 0x%04X: %u packets counted out of %u, %u held, at most %u queued\n",
+                      pBusy->handle, stats.packets, pBusy->sent, stats.held, stats.maxQueued);
+        mErrors++;
+    }
+
+    /* The events and the light packets wait behind the ACL packets the Host already
+       holds, not behind the held bursts */
+    if( mEventMaxAclAhead > (gHcitAclRxHostDepth_c + gHcitAclRxQueueDepth_c) )
+    {
+        (void)fprintf(stderr, "flood: an event waited behind %u ACL packets\n", mEventMaxAclAhead);
+        mErrors++;
+    }
+
+    eventLatencyLimit = (gHcitAclRxHostDepth_c + gHcitAclRxQueueDepth_c + mRxHostTakePerTick_c) / mRxHostTakePerTick_c;
+    if( mEventMaxLatency > eventLatencyLimit )
+    {
+        (void)fprintf(stderr, "flood: an event waited %u ticks\n", mEventMaxLatency);
+        mErrors++;
+    }
+
+    if( pLight->maxLatency > mRxLightLatencyLimit_c )
+    {
+        (void)fprintf(stderr, "flood: handle 0x%04X waited %u ticks\n", pLight->handle, pLight->maxLatency);
+        mErrors++;
+    }
+
+    return Rx_Finish("flood");
+}
+
+/*! *********************************************************************************
+* \brief  State events of a connection come after its held data, other events go
+*         ahead of it.
+*
+********************************************************************************** */
+static int Rx_State(void)
+{
+    const uint8_t   data = (uint8_t)gHciDataPacket_c;
+    const uint8_t   encryption = (uint8_t)gHciEncryptionChangeEvent_c;
+    const uint8_t   disconnection = (uint8_t)gHciDisconnectionCompleteEvent_c;
+    rxLink_t*       pFirst = &mLinks[0];
+    rxLink_t*       pSecond = &mLinks[1];
+    uint16_t        a;
+    uint16_t        b;
+
+    Rx_Start("state");
+    a = pFirst->handle;
+    b = pSecond->handle;
+
+    /* The Host takes nothing: the first gHcitAclRxHostDepth_c packets are given */
+    Rx_ReceiveAcl(pFirst, 3U);
+    Rx_CheckHeld("state", a, 1U);
+    Rx_ReceiveAcl(pSecond, 2U);
+    Rx_CheckHeld("state", b, 2U);
+
+    /* Ahead of the held data */
+    Rx_ReceiveVendorEvent();
+    /* After the held data of its connection only */
+    Rx_ReceiveLinkEvent(encryption, a);
+    Rx_CheckHeld("state", a, 0U);
+    Rx_CheckHeld("state", b, 2U);
+    {
+        const uint8_t   types[] = { data, data, mRxVendorEvent_c, data, encryption };
+        const uint16_t  handles[] = { a, a, mRxNoHandle_c, a, a };
+
+        Rx_CheckQueue("state", types, handles, NumberOfElements(types));
+    }
+
+    Rx_ReceiveAcl(pFirst, 2U);
+    Rx_ReceiveLinkEvent(disconnection, b);
+    Rx_CheckHeld("state", a, 2U);
+    Rx_CheckHeld("state", b, 0xFFU);
+    {
+        const uint8_t   types[] = { data, data, mRxVendorEvent_c, data, encryption, data, data, disconnection };
+        const uint16_t  handles[] = { a, a, mRxNoHandle_c, a, a, b, b, b };
+
+        Rx_CheckQueue("state", types, handles, NumberOfElements(types));
+    }
+
+    return Rx_Finish("state");
+}
+
+/*! *********************************************************************************
+* \brief  An interrupt received while the poll timer gives a packet to the Host.
+*
+********************************************************************************** */
+static int Rx_Deferred(void)
+{
+    const uint8_t   data = (uint8_t)gHciDataPacket_c;
+    rxLink_t*       pFirst = &mLinks[0];
+    rxLink_t*       pSecond = &mLinks[1];
+    uint16_t        a;
+    uint16_t        b;
+
+    Rx_Start("deferred");
+    a = pFirst->handle;
+    b = pSecond->handle;
+
+    /* Two packets given, two held */
+    Rx_ReceiveAcl(pFirst, 4U);
+    Rx_CheckHeld("deferred", a, 2U);
+
+    /* The Host takes one: the poll timer gives the third packet, and an event and a
+       packet of the second connection are received meanwhile */
+    mInterruptLength = Rx_BuildVendorEvent(mInterruptBytes);
+    mInterruptLength += Rx_BuildAcl(&mInterruptBytes[mInterruptLength], pSecond);
+    Rx_Tick(1U);
+
+    if( mInterruptLength != 0U )
+    {
+        (void)fprintf(stderr, "deferred: the poll timer gave no packet to the Host\n");
+        mErrors++;
+    }
+
+    Rx_CheckHeld("deferred", a, 1U);
+    Rx_CheckHeld("deferred", b, 1U);
+    {
+        const uint8_t   types[] = { data, data, mRxVendorEvent_c };
+        const uint16_t  handles[] = { a, a, mRxNoHandle_c };
+
+        Rx_CheckQueue("deferred", types, handles, NumberOfElements(types));
+    }
+
+    return Rx_Finish("deferred");
+}
+
+/*! *********************************************************************************
+* \brief  No memory for the copies of the held packets.
+*
+********************************************************************************** */
+static int Rx_NoMemory(void)
+{
+    hcitAclRxStats_t    stats;
+    memStats_t          memStats;
+    rxLink_t*           pFirst = &mLinks[0];
+
+    Rx_Start("nomem");
+
+    Rx_ReceiveAcl(pFirst, 3U);
+    Rx_CheckHeld("nomem", pFirst->handle, 1U);
+
+    MEM_GetStats(&memStats, FALSE);
+    MEM_SetBlockLimit(memStats.inUse);
+    Rx_ReceiveAcl(pFirst, 2U);
+    MEM_SetBlockLimit(0U);
+
+    /* The held packet goes first, which frees the memory for the next copy */
+    Rx_CheckHeld("nomem", pFirst->handle, 1U);
+    if( (Hcit_AclRxGetStats(pFirst->handle, &stats) != gBleSuccess_c) || (stats.bypassed != 1U) )
+    {
+        (void)fprintf(stderr, "nomem: %u packets given without a copy instead of 1\n", stats.bypassed);
+        mErrors++;
+    }
+
+    return Rx_Finish("nomem");
+}
+
+/*! *********************************************************************************
+* \brief  HCI Reset with held packets.
+*
+********************************************************************************** */
+static int Rx_Reset(void)
+{
+    /* Reset Command Complete */
+    const uint8_t   reset[] = { 0x0EU, 0x04U, 0x01U, 0x03U, 0x0CU, 0x00U };
+    hcitAclRxStats_t    stats;
+    memStats_t          memStats;
+    rxLink_t*           pFirst = &mLinks[0];
+    rxLink_t*           pSecond = &mLinks[1];
+
+    Rx_Start("reset");
+
+    /* Two packets given, a full queue and one more: the oldest held packet is given */
+    Rx_ReceiveAcl(pFirst, gHcitAclRxHostDepth_c + gHcitAclRxQueueDepth_c + 1U);
+    Rx_ReceiveAcl(pSecond, 2U);
+    Rx_CheckHeld("reset", pFirst->handle, gHcitAclRxQueueDepth_c);
+    Rx_CheckHeld("reset", pSecond->handle, 2U);
+    if( (Hcit_AclRxGetStats(pFirst->handle, &stats) != gBleSuccess_c) || (stats.overflows != 1U) )
+    {
+        (void)fprintf(stderr, "reset: %u packets given early instead of 1\n", stats.overflows);
+        mErrors++;
+    }
+
+    Rx_ReceiveEvent(reset, sizeof(reset));
+    Rx_CheckHeld("reset", pFirst->handle, 0xFFU);
+    Rx_CheckHeld("reset", pSecond->handle, 0xFFU);
+
+    MEM_GetStats(&memStats, FALSE);
+    if( memStats.inUse != 0U )
+    {
+        (void)fprintf(stderr, "reset: %u held packets not freed\n", memStats.inUse);
+        mErrors++;
+    }
+
+    /* The dropped packets are not expected */
+    pFirst->sent = gHcitAclRxHostDepth_c + 1U;
+    pSecond->sent = 0U;
+
+    return Rx_Finish("reset");
+}
+
+static void Rx_Usage(void)
+{
+    (void)fprintf(stderr,
+        "usage: hcit_acl_rx [-t ticks] [-q]\n"
+        "  -t ticks   length of the flood scenario (default 4000)\n"
+        "  -q         prints only on failure\n");
+}
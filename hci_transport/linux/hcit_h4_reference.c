@@ -0,0 +1,222 @@
+/*! *********************************************************************************
+* Copyright (c) 2014, Freescale Semiconductor, Inc.
+* Copyright 2016-2017, 2026 NXP
+* All rights reserved.
+*
+* \file
+*
+* Per-byte H4 receive parser used by the HCI transport before the span parser,
+* unchanged except for its names.
+*
+* SPDX-License-Identifier: BSD-3-Clause
+********************************************************************************** */
+
+/************************************************************************************
+*************************************************************************************
+* Include
+*************************************************************************************
+************************************************************************************/
+#include "hcit_h4_reference.h"
+#include "FunctionLib.h"
+
+/************************************************************************************
+*************************************************************************************
+* Private type definitions
+*************************************************************************************
+************************************************************************************/
+typedef PACKED_STRUCT hciCommandPacketHeader_tag
+{
+    uint16_t    opCode;
+    uint8_t     parameterTotalLength;
+}hciCommandPacketHeader_t;
+
+typedef PACKED_STRUCT hciAclDataPacketHeader_tag
+{
+    uint16_t    handle      :12;
+    uint16_t    pbFlag      :2;
+    uint16_t    bcFlag      :2;
+    uint16_t    dataTotalLength;
+}hciAclDataPacketHeader_t;
+
+typedef PACKED_STRUCT hciEventPacketHeader_tag
+{
+    hciEventCode_t  eventCode;
+    uint8_t     dataTotalLength;
+}hciEventPacketHeader_t;
+
+typedef PACKED_STRUCT hcitPacketHdr_tag
+{
+    hciPacketType_t packetTypeMarker;
+    PACKED_UNION
+    {
+        hciAclDataPacketHeader_t    aclDataPacket;
+        hciEventPacketHeader_t      eventPacket;
+        hciCommandPacketHeader_t    commandPacket;
+    };
+}hcitPacketHdr_t;
+
+typedef PACKED_STRUCT hcitPacketStructured_tag
+{
+    hcitPacketHdr_t header;
+    uint8_t         payload[gHcitMaxPayloadLen_c];
+} hcitPacketStructured_t;
+
+typedef PACKED_UNION hcitPacket_tag
+{
+    /* The entire packet as unformatted data. */
+    uint8_t raw[sizeof(hcitPacketStructured_t)];
+}hcitPacket_t;
+
+typedef struct hcitComm_tag
+{
+    hcitPacket_t        *pPacket;
+    hcitPacketHdr_t     pktHeader;
+    uint16_t            bytesReceived;
+    uint16_t            expectedLength;
+}hcitComm_t;
+
+typedef uint8_t detectState_t;
+typedef enum{
+    mDetectMarker_c       = 0,
+    mDetectHeader_c,
+    mPacketInProgress_c
+}detectState_tag;
+
+/************************************************************************************
+*************************************************************************************
+* Private prototypes
+*************************************************************************************
+************************************************************************************/
+static void HcitRef_SendMessage(void);
+
+/************************************************************************************
+*************************************************************************************
+* Private memory declarations
+*************************************************************************************
+************************************************************************************/
+static hcitComm_t mHcitData;
+static hciTransportInterface_t  mTransportInterface;
+
+static detectState_t  mPacketDetectStep;
+
+static hcitPacket_t mHcitPacketRaw;
+
+/************************************************************************************
+*************************************************************************************
+* Public functions
+*************************************************************************************
+************************************************************************************/
+void HcitRef_Init(hciTransportInterface_t pfInterface)
+{
+    mTransportInterface = pfInterface;
+    mHcitData.pPacket = NULL;
+    mPacketDetectStep = mDetectMarker_c;
+}
+
+void HcitRef_ProcessReceivedChar(uint8_t recvChar)
+{
+    switch( mPacketDetectStep )
+    {
+        case mDetectMarker_c:
+            if( (recvChar == gHciDataPacket_c) || (recvChar == gHciEventPacket_c) ||
+                (recvChar == gHciCommandPacket_c) )
+            {
+                mHcitData.pPacket = (hcitPacket_t*)&mHcitData.pktHeader;
+
+                mHcitData.pktHeader.packetTypeMarker = (hciPacketType_t)recvChar;
+                mHcitData.bytesReceived = 1;
+
+                mPacketDetectStep = mDetectHeader_c;
+            }
+            break;
+
+        case mDetectHeader_c:
+            mHcitData.pPacket->raw[mHcitData.bytesReceived++] = recvChar;
+            switch( mHcitData.pktHeader.packetTypeMarker )
+            {
+                case gHciDataPacket_c:
+                    /* ACL Data Packet */
+                    if( mHcitData.bytesReceived == (gHciAclDataPacketHeaderLength_c + 1) )
+                    {
+                        /* Validate ACL Data packet length */
+                        if( mHcitData.pktHeader.aclDataPacket.dataTotalLength > gHcLeAclDataPacketLengthDefault_c )
+                        {
+                            mHcitData.pPacket = NULL;
+                            mPacketDetectStep = mDetectMarker_c;
+                            break;
+                        }
+                        mHcitData.expectedLength = gHciAclDataPacketHeaderLength_c +
+                                                    mHcitData.pktHeader.aclDataPacket.dataTotalLength;
+
+                        mPacketDetectStep = mPacketInProgress_c;
+                    }
+                    break;
+
+                case gHciEventPacket_c:
+                    /* HCI Event Packet */
+                    if( mHcitData.bytesReceived == (gHciEventPacketHeaderLength_c + 1) )
+                    {
+                        mHcitData.expectedLength = gHciEventPacketHeaderLength_c +
+                                                    mHcitData.pktHeader.eventPacket.dataTotalLength;
+                        mPacketDetectStep = mPacketInProgress_c;
+                    }
+                    break;
+
+                case gHciCommandPacket_c:
+                    /* HCI Command Packet */
+                    if( mHcitData.bytesReceived == (gHciCommandPacketHeaderLength_c + 1) )
+                    {
+
+                        mHcitData.expectedLength = gHciCommandPacketHeaderLength_c +
+                                                    mHcitData.pktHeader.commandPacket.parameterTotalLength;
+                        mPacketDetectStep = mPacketInProgress_c;
+                    }
+                    break;
+                case gHciSynchronousDataPacket_c:
+                default:
+                    /* Not Supported */
+                    break;
+            }
+
+            if( mPacketDetectStep == mPacketInProgress_c )
+            {
+                mHcitData.pPacket = &mHcitPacketRaw;
+                FLib_MemCpy(mHcitData.pPacket, (uint8_t*)&mHcitData.pktHeader + 1, sizeof(hcitPacketHdr_t) - 1);
+                mHcitData.bytesReceived -= 1;
+
+                if( mHcitData.bytesReceived == mHcitData.expectedLength )
+                {
+                    HcitRef_SendMessage();
+                }
+            }
+            break;
+
+        case mPacketInProgress_c:
+            mHcitData.pPacket->raw[mHcitData.bytesReceived++] = recvChar;
+
+            if( mHcitData.bytesReceived == mHcitData.expectedLength )
+            {
+                HcitRef_SendMessage();
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+/************************************************************************************
+*************************************************************************************
+* Private functions
+*************************************************************************************
+************************************************************************************/
+static void HcitRef_SendMessage(void)
+{
+    /* Send the message to HCI */
+    mTransportInterface( mHcitData.pktHeader.packetTypeMarker,
+                                mHcitData.pPacket,
+                                mHcitData.bytesReceived);
+
+    mHcitData.pPacket = NULL;
+    mPacketDetectStep = mDetectMarker_c;
+}
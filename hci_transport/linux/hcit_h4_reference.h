@@ -0,0 +1,44 @@
+/*! *********************************************************************************
+* Copyright 2026 NXP
+* All rights reserved.
+*
+* \file
+*
+* Per-byte H4 receive parser used by the HCI transport before the span parser. It
+* is kept only as the reference of the equivalence checks of hcit_replay.
+*
+* SPDX-License-Identifier: BSD-3-Clause
+********************************************************************************** */
+
+#ifndef HCIT_H4_REFERENCE_H
+#define HCIT_H4_REFERENCE_H
+
+/************************************************************************************
+*************************************************************************************
+* Includes
+*************************************************************************************
+************************************************************************************/
+#include "hci_transport.h"
+
+/************************************************************************************
+*************************************************************************************
+* Public prototypes
+*************************************************************************************
+************************************************************************************/
+/*! *********************************************************************************
+* \brief        Resets the reference parser.
+*
+* \param[in]    pfInterface     Receives the complete packets
+*
+********************************************************************************** */
+void HcitRef_Init(hciTransportInterface_t pfInterface);
+
+/*! *********************************************************************************
+* \brief        Feeds one received byte to the reference parser.
+*
+* \param[in]    recvChar    The received byte
+*
+********************************************************************************** */
+void HcitRef_ProcessReceivedChar(uint8_t recvChar);
+
+#endif /* HCIT_H4_REFERENCE_H */
@@ -0,0 +1,377 @@
+/*! *********************************************************************************
+* Copyright 2026 NXP
+* All rights reserved.
+*
+* \file
+*
+* Runs an H5 link (gHcitH5Transport_d) between two instances of the Linux build of
+* the HCI transport, one in each process, over a PTY pair. Each side sends ACL
+* packets to the other with Hcit_SendPacket(), and checks that the packets it
+* receives are complete, unchanged and in order.
+*
+* With -e, the port flips random bits in everything each side writes, so the link
+* establishment, the CRC, the acknowledgements and the retransmissions are all
+* exercised. The payloads hold the SLIP delimiter and escape bytes. Each side
+* prints its H5 counters and the exit status is nonzero if a side fails or the
+* transfer does not end in time.
+*
+* SPDX-License-Identifier: BSD-3-Clause
+********************************************************************************** */
+
+/************************************************************************************
+*************************************************************************************
+* Include
+*************************************************************************************
+************************************************************************************/
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "hci_transport.h"
+#include "hcit_linux.h"
+#include "MemManager.h"
+
+/************************************************************************************
+*************************************************************************************
+* Private macros
+*************************************************************************************
+************************************************************************************/
+#define mLinkAclHandle_c            (0x0001U)
+
+/* Payload: sequence number, then a pattern derived from it */
+#define mLinkMinPayload_c           (4U)
+#define mLinkMaxPayload_c           (gHcitMaxPayloadLen_c - gHciAclDataPacketHeaderLength_c)
+
+/* Packets given to the transport and not yet received by the peer */
+#define mLinkSendAhead_c            (32U)
+
+/************************************************************************************
+*************************************************************************************
+* Private type definitions
+*************************************************************************************
+************************************************************************************/
+typedef struct linkSide_tag
+{
+    const char* pName;
+    int         fd;             /*!< Side of the PTY pair. */
+    int         doneOut;        /*!< Written once every packet of the peer is received. */
+    int         doneIn;         /*!< Readable once the peer received every packet. */
+    uint32_t    seed;
+}linkSide_t;
+
+/************************************************************************************
+*************************************************************************************
+* Private prototypes
+*************************************************************************************
+************************************************************************************/
+static bleResult_t Link_TransportInterface(hciPacketType_t packetType, void* pPacket, uint16_t packetSize);
+static uint16_t Link_Payload(uint32_t sequence, uint8_t* pPayload);
+static int Link_Run(const linkSide_t* pSide);
+static uint64_t Link_NowMs(void);
+static void Link_Usage(void);
+
+/************************************************************************************
+*************************************************************************************
+* Private memory declarations
+*************************************************************************************
+************************************************************************************/
+static uint32_t     mPackets = 1000U;
+static uint32_t     mBitErrorOneIn;
+static uint32_t     mSeed = 1U;
+static uint32_t     mTimeoutMs = 60000U;
+static bool_t       mQuiet;
+
+/* Received from the peer */
+static uint32_t     mRxExpected;
+static uint32_t     mRxErrors;
+
+/************************************************************************************
+*************************************************************************************
+* Public functions
+*************************************************************************************
+************************************************************************************/
+/*! *********************************************************************************
+* \brief  Host entry point used by Hcit_RecvPacket().
+*
+********************************************************************************** */
+bleResult_t Ble_HciRecv
+(
+    hciPacketType_t     packetType,
+    void*               pHciPacket,
+    uint16_t            packetSize
+)
+{
+    return Link_TransportInterface(packetType, pHciPacket, packetSize);
+}
+
+int main(int argc, char* argv[])
+{
+    linkSide_t  master = { "master" };
+    linkSide_t  slave = { "slave" };
+    int         toMaster[2];
+    int         toSlave[2];
+    int         status;
+    int         opt;
+    int         result;
+    pid_t       child;
+
+    while( (opt = getopt(argc, argv, "n:e:s:t:qh")) != -1 )
+    {
+        switch( opt )
+        {
+            case 'n':
+                mPackets = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            case 'e':
+                mBitErrorOneIn = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            case 's':
+                mSeed = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            case 't':
+                mTimeoutMs = 1000U * (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            case 'q':
+                mQuiet = TRUE;
+                break;
+            default:
+                Link_Usage();
+                return 2;
+        }
+    }
+
+    if( (HcitLinux_OpenPty(&master.fd, &slave.fd) != 0) || (pipe(toMaster) != 0) || (pipe(toSlave) != 0) )
+    {
+        (void)fprintf(stderr, "cannot open the PTY pair: %s\n", strerror(errno));
+        return 1;
+    }
+
+    /* Each side tells the other when it has received everything */
+    master.doneIn = toMaster[0];
+    master.doneOut = toSlave[1];
+    master.seed = mSeed;
+    slave.doneIn = toSlave[0];
+    slave.doneOut = toMaster[1];
+    slave.seed = mSeed + 1U;
+
+    (void)fflush(stdout);
+    child = fork();
+
+    if( child < 0 )
+    {
+        (void)fprintf(stderr, "fork failed: %s\n", strerror(errno));
+        return 1;
+    }
+
+    if( child == 0 )
+    {
+        (void)close(master.fd);
+        exit(Link_Run(&slave));
+    }
+
+    (void)close(slave.fd);
+    result = Link_Run(&master);
+
+    if( result != 0 )
+    {
+        (void)kill(child, SIGTERM);
+    }
+
+    if( (waitpid(child, &status, 0) != child) || !WIFEXITED(status) || (WEXITSTATUS(status) != 0) )
+    {
+        result = 1;
+    }
+
+    return result;
+}
+
+/************************************************************************************
+*************************************************************************************
+* Private functions
+*************************************************************************************
+************************************************************************************/
+static bleResult_t Link_TransportInterface(hciPacketType_t packetType, void* pPacket, uint16_t packetSize)
+{
+    uint8_t         expected[mLinkMaxPayload_c];
+    const uint8_t*  pAcl = (const uint8_t*)pPacket;
+    uint16_t        length;
+
+    if( packetType != gHciDataPacket_c )
+    {
+        (void)fprintf(stderr, "unexpected packet of type %u\n", (unsigned)packetType);
+        mRxErrors++;
+        return gBleSuccess_c;
+    }
+
+    length = Link_Payload(mRxExpected, expected);
+
+    if( (packetSize != (gHciAclDataPacketHeaderLength_c + length)) ||
+        (pAcl[0] != (uint8_t)mLinkAclHandle_c) || (pAcl[2] != (uint8_t)length) || (pAcl[3] != (uint8_t)(length >> 8)) ||
+        (memcmp(&pAcl[gHciAclDataPacketHeaderLength_c], expected, length) != 0) )
+    {
+        (void)fprintf(stderr, "packet %u received damaged or out of order\n", mRxExpected);
+        mRxErrors++;
+    }
+
+    mRxExpected++;
+
+    return gBleSuccess_c;
+}
+
+/*! *********************************************************************************
+* \brief  Builds the payload of a packet: its sequence number, then bytes that
+*         include the SLIP delimiter and escape, on a length that changes with it.
+*
+********************************************************************************** */
+static uint16_t Link_Payload(uint32_t sequence, uint8_t* pPayload)
+{
+    static const uint8_t pattern[] = { 0xC0U, 0xDBU, 0xDCU, 0xDDU, 0x00U, 0xFFU };
+    uint16_t length = (uint16_t)(mLinkMinPayload_c + (sequence % (mLinkMaxPayload_c - mLinkMinPayload_c + 1U)));
+    uint16_t i;
+
+    (void)memcpy(pPayload, &sequence, sizeof(sequence));
+
+    for( i = mLinkMinPayload_c; i < length; i++ )
+    {
+        pPayload[i] = (uint8_t)(pattern[(sequence + i) % sizeof(pattern)] ^ ((i & 1U) ? 0U : (uint8_t)(sequence * i)));
+    }
+
+    return length;
+}
+
+/*! *********************************************************************************
+* \brief  Runs one side of the link until both sides received every packet.
+*
+********************************************************************************** */
+static int Link_Run(const linkSide_t* pSide)
+{
+    uint8_t             packet[gHcitMaxPayloadLen_c];
+    hcitConfigStruct_t  config;
+    hcitH5Stats_t       h5Stats;
+    hcitLinuxStats_t    portStats;
+    uint32_t            sent = 0U;
+    uint64_t            startMs;
+    uint64_t            elapsedMs;
+    uint16_t            length;
+    bool_t              done = FALSE;
+    bool_t              peerDone = FALSE;
+    bool_t              closed;
+    char                signal = 'd';
+    int                 result = 0;
+
+    (void)MEM_Init();
+    (void)memset(&config, 0, sizeof(config));
+    config.interfaceType = gHcitInterfaceType_d;
+    config.interfaceChannel = gHcitInterfaceNumber_d;
+    config.interfaceBaudrate = gHcitInterfaceSpeed_d;
+    config.transportInterface = Link_TransportInterface;
+    config.writeInterface = gHcitWriteInterface_d;
+
+    HcitLinux_SetFd(pSide->fd);
+    HcitLinux_SetBitErrorRate(mBitErrorOneIn, pSide->seed);
+    (void)fcntl(pSide->doneIn, F_SETFL, fcntl(pSide->doneIn, F_GETFL) | O_NONBLOCK);
+
+    if( Hcit_Init(&config) != gHciSuccess_c )
+    {
+        (void)fprintf(stderr, "%s: Hcit_Init failed\n", pSide->pName);
+        return 1;
+    }
+
+    startMs = Link_NowMs();
+
+    while( !(done && peerDone) && (mRxErrors == 0U) )
+    {
+        /* Paced on the packets received from the peer, as both sides send the same */
+        while( (sent < mPackets) && (sent < (mRxExpected + mLinkSendAhead_c)) )
+        {
+            packet[0] = (uint8_t)mLinkAclHandle_c;
+            packet[1] = (uint8_t)(mLinkAclHandle_c >> 8);
+            length = Link_Payload(sent, &packet[gHciAclDataPacketHeaderLength_c]);
+            packet[2] = (uint8_t)length;
+            packet[3] = (uint8_t)(length >> 8);
+
+            if( Hcit_SendPacket(gHciDataPacket_c, packet, (uint16_t)(gHciAclDataPacketHeaderLength_c + length)) != gBleSuccess_c )
+            {
+                break;
+            }
+            sent++;
+        }
+
+        closed = (HcitLinux_Poll(1U, 0U) < 0);
+
+        if( !done && (mRxExpected == mPackets) )
+        {
+            done = TRUE;
+            (void)write(pSide->doneOut, &signal, 1U);
+        }
+
+        if( !peerDone && (read(pSide->doneIn, &signal, 1U) == 1) )
+        {
+            peerDone = TRUE;
+        }
+
+        /* The peer leaves once both sides are done */
+        if( closed && !(done && peerDone) )
+        {
+            (void)fprintf(stderr, "%s: the peer closed the link\n", pSide->pName);
+            result = 1;
+            break;
+        }
+
+        if( (Link_NowMs() - startMs) > mTimeoutMs )
+        {
+            (void)fprintf(stderr, "%s: timeout, %u of %u packets received\n", pSide->pName, mRxExpected, mPackets);
+            result = 1;
+            break;
+        }
+    }
+
+    elapsedMs = Link_NowMs() - startMs;
+    Hcit_H5GetStats(&h5Stats);
+    HcitLinux_GetStats(&portStats);
+
+    if( mRxErrors != 0U )
+    {
+        result = 1;
+    }
+
+    if( !mQuiet || (result != 0) )
+    {
+        (void)printf("%s: %u packets sent, %u received in %u ms, %u bits flipped\n"
+                     "  frames: %u sent, %u received, %u dropped, %u out of order, %u retransmitted, %u link resets\n",
+                     pSide->pName, sent, mRxExpected, (unsigned)elapsedMs, portStats.bitErrors,
+                     h5Stats.txFrames, h5Stats.rxFrames, h5Stats.rxErrors, h5Stats.rxOutOfOrder,
+                     h5Stats.retransmissions, h5Stats.linkResets);
+        (void)fflush(stdout);
+    }
+
+    (void)close(pSide->fd);
+
+    return result;
+}
+
+static uint64_t Link_NowMs(void)
+{
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return ((uint64_t)now.tv_sec * 1000U) + ((uint64_t)now.tv_nsec / 1000000U);
+}
+
+static void Link_Usage(void)
+{
+    (void)fprintf(stderr,
+        "usage: hcit_h5_link [-n packets] [-e bits] [-s seed] [-t seconds] [-q]\n"
+        "  -n packets sent by each side (default 1000)\n"
+        "  -e bits    flips one bit in this many of the written data, on average\n"
+        "  -s seed    seed of the bit errors (default 1)\n"
+        "  -t seconds longest run (default 60)\n"
+        "  -q         prints only on failure\n");
+}
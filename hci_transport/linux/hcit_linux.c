@@ -0,0 +1,411 @@
+/*! *********************************************************************************
+* Copyright 2026 NXP
+* All rights reserved.
+*
+* \file
+*
+* Linux port of the HCI transport, used by the host tools.
+*
+* SPDX-License-Identifier: BSD-3-Clause
+********************************************************************************** */
+
+/************************************************************************************
+*************************************************************************************
+* Include
+*************************************************************************************
+************************************************************************************/
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "hcit_linux.h"
+#include "hci_transport.h"
+#include "TimersManager.h"
+
+/************************************************************************************
+*************************************************************************************
+* Private macros
+*************************************************************************************
+************************************************************************************/
+#define mHcitLinuxReadBufferSize_c      (4096U)
+
+/************************************************************************************
+*************************************************************************************
+* Private type definitions
+*************************************************************************************
+************************************************************************************/
+typedef struct hcitLinuxWrite_tag
+{
+    const uint8_t*      pData;          /*!< Transport buffer, or pCopy. */
+    uint8_t*            pCopy;          /*!< Copy with the injected bit errors. */
+    uint16_t            length;
+    uint16_t            offset;         /*!< Bytes already written. */
+    pSerialCallBack_t   pfWriteComplete;
+    void*               pParam;
+}hcitLinuxWrite_t;
+
+/************************************************************************************
+*************************************************************************************
+* Private prototypes
+*************************************************************************************
+************************************************************************************/
+static void HcitLinux_Flush(void);
+static uint8_t* HcitLinux_InjectErrors(const uint8_t* pData, uint16_t length);
+
+/************************************************************************************
+*************************************************************************************
+* Private memory declarations
+*************************************************************************************
+************************************************************************************/
+static int                  mFd = -1;
+static hcitLinuxWriteHook_t mpfWriteHook = NULL;
+static hcitLinuxWrite_t     mWrites[gHcitLinuxMaxPendingWrites_c];
+static uint32_t             mWriteHead = 0U;        /* Oldest write */
+static uint32_t             mWriteCount = 0U;
+static uint32_t             mBitErrorOneIn = 0U;
+static uint32_t             mBitErrorSeed = 1U;
+static uint32_t             mBitsToNextError = 0U;
+static hcitLinuxStats_t     mStats;
+static uint8_t              mReadBuffer[mHcitLinuxReadBufferSize_c];
+
+/************************************************************************************
+*************************************************************************************
+* Public functions
+*************************************************************************************
+************************************************************************************/
+void HcitLinux_SetFd(int fd)
+{
+    mFd = fd;
+
+    if( fd >= 0 )
+    {
+        (void)fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    }
+}
+
+void HcitLinux_SetWriteHook(hcitLinuxWriteHook_t pfHook)
+{
+    mpfWriteHook = pfHook;
+}
+
+void HcitLinux_SetBitErrorRate(uint32_t oneIn, uint32_t seed)
+{
+    mBitErrorOneIn = oneIn;
+    mBitErrorSeed = (seed != 0U) ? seed : 1U;
+    mBitsToNextError = 0U;
+}
+
+bleResult_t HcitLinux_Write(uint8_t* pBuffer, uint16_t length, pSerialCallBack_t pfWriteComplete, void* pParam)
+{
+    hcitLinuxWrite_t* pWrite;
+
+    if( mWriteCount >= gHcitLinuxMaxPendingWrites_c )
+    {
+        return gHciTransportError_c;
+    }
+
+    pWrite = &mWrites[(mWriteHead + mWriteCount) % gHcitLinuxMaxPendingWrites_c];
+    pWrite->pCopy = HcitLinux_InjectErrors(pBuffer, length);
+    pWrite->pData = (pWrite->pCopy != NULL) ? pWrite->pCopy : pBuffer;
+    pWrite->length = length;
+    pWrite->offset = (mFd < 0) ? length : 0U;
+    pWrite->pfWriteComplete = pfWriteComplete;
+    pWrite->pParam = pParam;
+    mWriteCount++;
+
+    mStats.writes++;
+    mStats.writtenBytes += length;
+
+    if( mpfWriteHook != NULL )
+    {
+        mpfWriteHook(pWrite->pData, length);
+    }
+
+    HcitLinux_Flush();
+
+    return gBleSuccess_c;
+}
+
+uint32_t HcitLinux_CompleteWrites(void)
+{
+    hcitLinuxWrite_t    write;
+    uint32_t            count = 0U;
+
+    while( (mWriteCount != 0U) &&
+           (mWrites[mWriteHead].offset == mWrites[mWriteHead].length) )
+    {
+        /* Removed first: the callback can write again */
+        write = mWrites[mWriteHead];
+        mWriteHead = (mWriteHead + 1U) % gHcitLinuxMaxPendingWrites_c;
+        mWriteCount--;
+
+        free(write.pCopy);
+
+        if( write.pfWriteComplete != NULL )
+        {
+            write.pfWriteComplete(write.pParam);
+        }
+
+        count++;
+    }
+
+    return count;
+}
+
+int HcitLinux_Poll(uint32_t timeoutMs, uint16_t readSize)
+{
+    struct pollfd   pfd;
+    uint32_t        nextTimer;
+    ssize_t         received = 0;
+
+    HcitLinux_Flush();
+    (void)HcitLinux_CompleteWrites();
+
+    nextTimer = TMR_Process();
+    if( nextTimer < timeoutMs )
+    {
+        timeoutMs = nextTimer;
+    }
+
+    if( mFd < 0 )
+    {
+        if( timeoutMs != 0U )
+        {
+            (void)usleep(timeoutMs * 1000U);
+        }
+
+        return 0;
+    }
+
+    if( (readSize == 0U) || (readSize > mHcitLinuxReadBufferSize_c) )
+    {
+        readSize = mHcitLinuxReadBufferSize_c;
+    }
+
+    pfd.fd = mFd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+
+    if( mWriteCount != 0U )
+    {
+        pfd.events |= POLLOUT;
+    }
+
+    if( poll(&pfd, 1U, (int)timeoutMs) > 0 )
+    {
+        if( (pfd.revents & POLLOUT) != 0 )
+        {
+            HcitLinux_Flush();
+        }
+
+        if( (pfd.revents & POLLIN) != 0 )
+        {
+            received = read(mFd, mReadBuffer, readSize);
+
+            if( received > 0 )
+            {
+                mStats.reads++;
+                mStats.readBytes += (uint64_t)received;
+                Hcit_InterfaceDataReceived(mReadBuffer, (uint16_t)received);
+            }
+            else if( (received < 0) && (errno == EAGAIN) )
+            {
+                received = 0;
+            }
+            else
+            {
+                received = -1;
+            }
+        }
+        else if( (pfd.revents & (POLLHUP | POLLERR)) != 0 )
+        {
+            received = -1;
+        }
+        else
+        {
+            /* Only ready for writing */
+        }
+    }
+
+    (void)HcitLinux_CompleteWrites();
+    (void)TMR_Process();
+
+    return (int)received;
+}
+
+int HcitLinux_OpenPty(int* pMaster, int* pSlave)
+{
+    struct termios  tio;
+    int             master;
+    int             slave;
+
+    master = posix_openpt(O_RDWR | O_NOCTTY);
+    if( master < 0 )
+    {
+        return -1;
+    }
+
+    if( (grantpt(master) != 0) || (unlockpt(master) != 0) )
+    {
+        (void)close(master);
+        return -1;
+    }
+
+    slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+    if( slave < 0 )
+    {
+        (void)close(master);
+        return -1;
+    }
+
+    /* Raw 8-bit link, no echo and no line discipline processing */
+    (void)tcgetattr(slave, &tio);
+    cfmakeraw(&tio);
+    (void)tcsetattr(slave, TCSANOW, &tio);
+    (void)tcgetattr(master, &tio);
+    cfmakeraw(&tio);
+    (void)tcsetattr(master, TCSANOW, &tio);
+
+    *pMaster = master;
+    *pSlave = slave;
+
+    return 0;
+}
+
+void HcitLinux_GetStats(hcitLinuxStats_t* pStats)
+{
+    *pStats = mStats;
+}
+
+#if gHcitSnoop_d
+int HcitLinux_SnoopDump(const char* pFile)
+{
+    FILE*       pStream = fopen(pFile, "wb");
+    uint32_t    offset = 0U;
+    uint32_t    length;
+    int         result = 0;
+
+    if( pStream == NULL )
+    {
+        return -1;
+    }
+
+    /* The capture is paused from the first chunk until the last one */
+    do
+    {
+        length = Hcit_SnoopRead(offset, mReadBuffer, sizeof(mReadBuffer));
+
+        if( fwrite(mReadBuffer, 1U, length, pStream) != length )
+        {
+            result = -1;
+            break;
+        }
+        offset += length;
+    } while( length == sizeof(mReadBuffer) );
+
+    if( fclose(pStream) != 0 )
+    {
+        result = -1;
+    }
+
+    return result;
+}
+#endif
+
+/************************************************************************************
+*************************************************************************************
+* Private functions
+*************************************************************************************
+************************************************************************************/
+/*! *********************************************************************************
+* \brief  Writes as much of the pending data as the descriptor accepts.
+*
+********************************************************************************** */
+static void HcitLinux_Flush(void)
+{
+    hcitLinuxWrite_t*   pWrite;
+    uint32_t            i;
+    ssize_t             written;
+
+    for( i = 0U; i < mWriteCount; i++ )
+    {
+        pWrite = &mWrites[(mWriteHead + i) % gHcitLinuxMaxPendingWrites_c];
+
+        while( pWrite->offset < pWrite->length )
+        {
+            written = write(mFd, &pWrite->pData[pWrite->offset], (size_t)pWrite->length - pWrite->offset);
+
+            if( written > 0 )
+            {
+                pWrite->offset += (uint16_t)written;
+            }
+            else if( (written < 0) && (errno == EAGAIN) )
+            {
+                /* Resumed from the poll loop */
+                return;
+            }
+            else
+            {
+                /* The other side is gone: the bytes are lost, as on a broken wire */
+                pWrite->offset = pWrite->length;
+            }
+        }
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Returns a copy of the buffer with bits flipped, or NULL if no bit error
+*         falls in the buffer.
+*
+********************************************************************************** */
+static uint8_t* HcitLinux_InjectErrors(const uint8_t* pData, uint16_t length)
+{
+    uint8_t*    pCopy = NULL;
+    uint32_t    bits = (uint32_t)length * 8U;
+    uint32_t    bit = 0U;
+
+    if( mBitErrorOneIn == 0U )
+    {
+        return NULL;
+    }
+
+    for( ;; )
+    {
+        if( mBitsToNextError == 0U )
+        {
+            /* Uniform gap between errors, with a mean of mBitErrorOneIn bits */
+            mBitErrorSeed = mBitErrorSeed * 1103515245U + 12345U;
+            mBitsToNextError = 1U + ((mBitErrorSeed >> 8) % (2U * mBitErrorOneIn - 1U));
+        }
+
+        if( (bits - bit) < mBitsToNextError )
+        {
+            mBitsToNextError -= bits - bit;
+            break;
+        }
+
+        bit += mBitsToNextError - 1U;
+        mBitsToNextError = 0U;
+
+        if( pCopy == NULL )
+        {
+            pCopy = malloc(length);
+            if( pCopy == NULL )
+            {
+                break;
+            }
+            (void)memcpy(pCopy, pData, length);
+        }
+
+        pCopy[bit / 8U] ^= (uint8_t)(1U << (bit % 8U));
+        mStats.bitErrors++;
+        bit++;
+    }
+
+    return pCopy;
+}
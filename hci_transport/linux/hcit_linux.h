@@ -0,0 +1,166 @@
+/*! *********************************************************************************
+* Copyright 2026 NXP
+* All rights reserved.
+*
+* \file
+*
+* Linux port of the HCI transport, used by the host tools. The transport is built
+* with gHcitSerialManagerSupport_d set to 0 and gHcitWriteInterface_d set to
+* HcitLinux_Write. The interface is a file descriptor, normally one side of a PTY
+* pair. Writes are done at once and completed from the poll loop, like the
+* asynchronous writes of the Serial Manager.
+*
+* SPDX-License-Identifier: BSD-3-Clause
+********************************************************************************** */
+
+#ifndef HCIT_LINUX_H
+#define HCIT_LINUX_H
+
+/************************************************************************************
+*************************************************************************************
+* Includes
+*************************************************************************************
+************************************************************************************/
+#include "ble_general.h"
+#include "SerialManager.h"
+#include "hcit_snoop.h"
+
+/************************************************************************************
+*************************************************************************************
+* Public macros
+*************************************************************************************
+************************************************************************************/
+/* Writes waiting for their completion callback */
+#ifndef gHcitLinuxMaxPendingWrites_c
+#define gHcitLinuxMaxPendingWrites_c    (256U)
+#endif
+
+/************************************************************************************
+*************************************************************************************
+* Public type definitions
+*************************************************************************************
+************************************************************************************/
+/* Sees each buffer written by the transport, after the bit errors are injected */
+typedef void (* hcitLinuxWriteHook_t)
+(
+    const uint8_t*  pData,
+    uint16_t        length
+);
+
+typedef struct hcitLinuxStats_tag
+{
+    uint32_t    writes;             /*!< Buffers written by the transport. */
+    uint64_t    writtenBytes;
+    uint32_t    reads;              /*!< Reads given to Hcit_InterfaceDataReceived(). */
+    uint64_t    readBytes;
+    uint32_t    bitErrors;          /*!< Bits flipped in the written buffers. */
+}hcitLinuxStats_t;
+
+/************************************************************************************
+*************************************************************************************
+* Public prototypes
+*************************************************************************************
+************************************************************************************/
+#ifdef __cplusplus
+    extern "C" {
+#endif
+
+/*! *********************************************************************************
+* \brief        Sets the file descriptor of the interface.
+*
+* \param[in]    fd      Descriptor written by the transport and read by the poll
+*                       loop, or -1 to discard the writes
+*
+********************************************************************************** */
+void HcitLinux_SetFd(int fd);
+
+/*! *********************************************************************************
+* \brief        Sets the function that sees each written buffer.
+*
+* \param[in]    pfHook  Write hook, or NULL
+*
+********************************************************************************** */
+void HcitLinux_SetWriteHook(hcitLinuxWriteHook_t pfHook);
+
+/*! *********************************************************************************
+* \brief        Flips random bits in the written buffers.
+*
+* \param[in]    oneIn   One bit out of oneIn is flipped on average, 0 for none
+* \param[in]    seed    Seed of the error pattern
+*
+********************************************************************************** */
+void HcitLinux_SetBitErrorRate(uint32_t oneIn, uint32_t seed);
+
+/*! *********************************************************************************
+* \brief        Write interface of the transport (gHcitWriteInterface_d).
+*
+* \param[in]    pBuffer             Data to write
+* \param[in]    length              Number of bytes to write
+* \param[in]    pfWriteComplete     Called from the poll loop once written
+* \param[in]    pParam              Parameter of the completion callback
+*
+* \return       gBleSuccess_c, or gHciTransportError_c if the descriptor fails or
+*               too many writes wait for their completion.
+*
+********************************************************************************** */
+bleResult_t HcitLinux_Write(uint8_t* pBuffer, uint16_t length, pSerialCallBack_t pfWriteComplete, void* pParam);
+
+/*! *********************************************************************************
+* \brief        Calls the completion callbacks of the done writes.
+*
+* \return       Number of callbacks called.
+*
+********************************************************************************** */
+uint32_t HcitLinux_CompleteWrites(void);
+
+/*! *********************************************************************************
+* \brief        Runs one iteration of the poll loop: write completions, timers, and
+*               one read of the interface given to Hcit_InterfaceDataReceived().
+*
+* \param[in]    timeoutMs   Longest wait for received bytes
+* \param[in]    readSize    Largest read, in bytes
+*
+* \return       Number of bytes received, 0 on timeout, or -1 if the interface is
+*               closed.
+*
+********************************************************************************** */
+int HcitLinux_Poll(uint32_t timeoutMs, uint16_t readSize);
+
+/*! *********************************************************************************
+* \brief        Opens a PTY pair in raw mode.
+*
+* \param[out]   pMaster     Master side
+* \param[out]   pSlave      Slave side
+*
+* \return       0, or -1 on failure.
+*
+********************************************************************************** */
+int HcitLinux_OpenPty(int* pMaster, int* pSlave);
+
+/*! *********************************************************************************
+* \brief        Reads the counters of the port.
+*
+* \param[out]   pStats      Copy of the counters
+*
+********************************************************************************** */
+void HcitLinux_GetStats(hcitLinuxStats_t* pStats);
+
+#if gHcitSnoop_d
+/*! *********************************************************************************
+* \brief        Writes the btsnoop capture of the transport to a file.
+*
+* \param[in]    pFile       Path of the btsnoop file
+*
+* \return       0, or -1 on failure.
+*
+* \remarks      The capture is read in chunks with Hcit_SnoopRead(), as over FSCI.
+*
+********************************************************************************** */
+int HcitLinux_SnoopDump(const char* pFile);
+#endif
+
+#ifdef __cplusplus
+    }
+#endif
+
+#endif /* HCIT_LINUX_H */
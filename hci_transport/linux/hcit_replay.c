@@ -0,0 +1,1300 @@
+/*! *********************************************************************************
+* Copyright 2026 NXP
+* All rights reserved.
+*
+* \file
+*
+* Replays HCI traffic through the Linux build of the HCI transport and reports the
+* throughput, the CPU time per packet and the allocations per packet.
+*
+* The input is an H4 capture (raw H4 stream or btsnoop file, only the packets
+* received from the Controller are used) or a synthetic scan storm or ACL transfer.
+* The packets go through one of these paths:
+*   span      Hcit_InterfaceDataReceived() with reads of -c bytes (0 for random sizes)
+*   byte      hci_processReceivedChar() for each byte
+*   reference the per-byte parser used before the span parser, for comparison
+*   recv      Hcit_RecvPacket() for each packet, as received over FSCI
+*   pty       written to a PTY and read by the poll loop of the port
+*   send      Hcit_SendPacket() for each packet, written to nowhere
+*   loopback  Hcit_SendPacket() over a PTY looped back to the transport
+*
+* Every path checks that the transport delivers or writes exactly the input
+* packets, so the exit status can be used as a regression test. With -e, bit errors
+* are injected in the input and the receive paths must deliver the same packets as
+* the reference parser.
+*
+* When the transport is built with gHcitSnoop_d, -d writes its btsnoop capture to a
+* file after the run. The packets received in the file must be the packets the
+* transport delivered.
+*
+* SPDX-License-Identifier: BSD-3-Clause
+********************************************************************************** */
+
+/************************************************************************************
+*************************************************************************************
+* Include
+*************************************************************************************
+************************************************************************************/
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "hci_transport.h"
+#include "hcit_linux.h"
+#include "hcit_h4_reference.h"
+#include "MemManager.h"
+#include "TimersManager.h"
+
+/************************************************************************************
+*************************************************************************************
+* Private macros
+*************************************************************************************
+************************************************************************************/
+#define mReplayFnvBasis_c           (0x811C9DC5U)
+#define mReplayFnvPrime_c           (0x01000193U)
+
+#define mReplayAclHandle_c          (0x0040U)
+#define mReplayAclDataLength_c      (251U)
+
+/* Packets sent and not received back yet in loopback mode */
+#define mReplayLoopbackWindow_c     (16U)
+#define mReplayLoopbackTimeoutMs_c  (2000U)
+
+#define mBtsnoopHeaderSize_c        (16U)
+#define mBtsnoopRecordHeaderSize_c  (24U)
+#define mBtsnoopDatalinkHci_c       (1001U)
+#define mBtsnoopDatalinkH4_c        (1002U)
+
+/************************************************************************************
+*************************************************************************************
+* Private type definitions
+*************************************************************************************
+************************************************************************************/
+typedef enum
+{
+    mReplayPathSpan_c,
+    mReplayPathByte_c,
+    mReplayPathRecv_c,
+    mReplayPathPty_c,
+    mReplayPathSend_c,
+    mReplayPathLoopback_c,
+    mReplayPathReference_c
+}replayPath_t;
+
+typedef struct replayPacket_tag
+{
+    uint32_t    offset;         /*!< Offset of the packet type marker in the stream. */
+    uint16_t    length;         /*!< HCI packet length, marker excluded. */
+    uint8_t     type;
+}replayPacket_t;
+
+/* H4 byte stream and the packets it holds */
+typedef struct replayInput_tag
+{
+    uint8_t*        pStream;
+    uint32_t        streamLength;
+    replayPacket_t* pPackets;
+    uint32_t        packetCount;
+    uint32_t        capacity;
+}replayInput_t;
+
+typedef struct replayOptions_tag
+{
+    replayPath_t    path;
+    const char*     pFile;
+    const char*     pGenerator;
+    const char*     pOutput;        /*!< Saves the input as a raw H4 capture. */
+    uint32_t        generatedPackets;
+    uint32_t        seed;
+    uint16_t        chunkSize;      /*!< 0 for random sizes. */
+    uint32_t        baudrate;       /*!< 0 for no pacing. */
+    uint32_t        loops;
+    uint32_t        bitErrorOneIn;  /*!< 0 for an error-free input. */
+    const char*     pSnoopFile;     /*!< Dumps the btsnoop capture of the transport. */
+    bool_t          quiet;
+}replayOptions_t;
+
+/************************************************************************************
+*************************************************************************************
+* Private prototypes
+*************************************************************************************
+************************************************************************************/
+static bleResult_t Replay_TransportInterface(hciPacketType_t packetType, void* pPacket, uint16_t packetSize);
+static void Replay_WriteHook(const uint8_t* pData, uint16_t length);
+static uint32_t Replay_Fnv(uint32_t hash, const uint8_t* pData, uint32_t length);
+static uint32_t Replay_Random(void);
+static uint16_t Replay_HeaderLength(uint8_t type);
+static uint16_t Replay_PayloadLength(uint8_t type, const uint8_t* pHeader);
+static uint32_t Replay_Be32(const uint8_t* pData);
+static int Replay_AddPacket(replayInput_t* pInput, uint8_t type, const uint8_t* pPacket, uint16_t length);
+static int Replay_LoadH4(replayInput_t* pInput, const uint8_t* pData, uint32_t length);
+static int Replay_LoadBtsnoop(replayInput_t* pInput, const uint8_t* pData, uint32_t length);
+static int Replay_LoadFile(replayInput_t* pInput, const char* pFile);
+static int Replay_Generate(replayInput_t* pInput, const char* pGenerator, uint32_t count);
+static uint16_t Replay_NextChunk(uint32_t remaining);
+static void Replay_Pace(uint64_t startNs, uint64_t bytes);
+static void Replay_Expected(const replayInput_t* pInput, uint32_t* pPackets, uint32_t* pDigest);
+static void Replay_InjectErrors(replayInput_t* pInput);
+static int Replay_Report(const replayInput_t* pInput, uint32_t expectedPackets, uint32_t expectedDigest,
+                         uint32_t packets, uint32_t digest, uint64_t wallNs, uint64_t cpuNs);
+static int Replay_RunReceive(const replayInput_t* pInput);
+static int Replay_RunPty(const replayInput_t* pInput);
+static int Replay_RunSend(const replayInput_t* pInput);
+static int Replay_RunLoopback(const replayInput_t* pInput);
+#if gHcitSnoop_d
+static int Replay_CheckSnoop(void);
+#endif
+static uint64_t Replay_Now(clockid_t clock);
+static void Replay_Usage(void);
+
+/************************************************************************************
+*************************************************************************************
+* Private memory declarations
+*************************************************************************************
+************************************************************************************/
+static replayOptions_t  mOptions =
+{
+    .path = mReplayPathSpan_c,
+    .generatedPackets = 100000U,
+    .seed = 1U,
+    .chunkSize = 64U,
+    .loops = 1U,
+};
+
+static uint32_t     mRandomState;
+
+/* Delivered by the transport */
+static uint32_t     mRxPackets;
+static uint32_t     mRxEvents;
+static uint32_t     mRxAcl;
+static uint32_t     mRxDigest = mReplayFnvBasis_c;
+
+/* Written by the transport */
+static uint64_t     mTxBytes;
+static uint32_t     mTxDigest = mReplayFnvBasis_c;
+
+/************************************************************************************
+*************************************************************************************
+* Public functions
+*************************************************************************************
+************************************************************************************/
+/*! *********************************************************************************
+* \brief  Host entry point used by Hcit_RecvPacket().
+*
+********************************************************************************** */
+bleResult_t Ble_HciRecv
+(
+    hciPacketType_t     packetType,
+    void*               pHciPacket,
+    uint16_t            packetSize
+)
+{
+    return Replay_TransportInterface(packetType, pHciPacket, packetSize);
+}
+
+int main(int argc, char* argv[])
+{
+    hcitConfigStruct_t  config;
+    replayInput_t       input;
+    int                 opt;
+    int                 result;
+
+    while( (opt = getopt(argc, argv, "m:g:n:o:s:c:b:l:e:d:qh")) != -1 )
+    {
+        switch( opt )
+        {
+            case 'm':
+                if( strcmp(optarg, "span") == 0 )          { mOptions.path = mReplayPathSpan_c; }
+                else if( strcmp(optarg, "byte") == 0 )     { mOptions.path = mReplayPathByte_c; }
+                else if( strcmp(optarg, "recv") == 0 )     { mOptions.path = mReplayPathRecv_c; }
+                else if( strcmp(optarg, "pty") == 0 )      { mOptions.path = mReplayPathPty_c; }
+                else if( strcmp(optarg, "send") == 0 )     { mOptions.path = mReplayPathSend_c; }
+                else if( strcmp(optarg, "loopback") == 0 ) { mOptions.path = mReplayPathLoopback_c; }
+                else if( strcmp(optarg, "reference") == 0 ) { mOptions.path = mReplayPathReference_c; }
+                else { Replay_Usage(); return 2; }
+                break;
+            case 'g':
+                mOptions.pGenerator = optarg;
+                break;
+            case 'n':
+                mOptions.generatedPackets = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            case 'o':
+                mOptions.pOutput = optarg;
+                break;
+            case 's':
+                mOptions.seed = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            case 'c':
+                mOptions.chunkSize = (uint16_t)strtoul(optarg, NULL, 0);
+                break;
+            case 'b':
+                mOptions.baudrate = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            case 'l':
+                mOptions.loops = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            case 'e':
+                mOptions.bitErrorOneIn = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            case 'd':
+                mOptions.pSnoopFile = optarg;
+                break;
+            case 'q':
+                mOptions.quiet = TRUE;
+                break;
+            default:
+                Replay_Usage();
+                return 2;
+        }
+    }
+
+    if( optind < argc )
+    {
+        mOptions.pFile = argv[optind];
+    }
+
+    if( ((mOptions.pFile == NULL) == (mOptions.pGenerator == NULL)) || (mOptions.loops == 0U) ||
+        ((mOptions.bitErrorOneIn != 0U) && ((mOptions.path == mReplayPathRecv_c) || (mOptions.path == mReplayPathSend_c) ||
+                                             (mOptions.path == mReplayPathLoopback_c))) ||
+        ((mOptions.pSnoopFile != NULL) && (!gHcitSnoop_d || (mOptions.path == mReplayPathSend_c) ||
+                                           (mOptions.path == mReplayPathRecv_c) || (mOptions.path == mReplayPathReference_c))) )
+    {
+        Replay_Usage();
+        return 2;
+    }
+
+    mRandomState = mOptions.seed;
+    (void)memset(&input, 0, sizeof(input));
+
+    result = (mOptions.pFile != NULL) ? Replay_LoadFile(&input, mOptions.pFile)
+                                      : Replay_Generate(&input, mOptions.pGenerator, mOptions.generatedPackets);
+    if( result != 0 )
+    {
+        return 2;
+    }
+
+    Replay_InjectErrors(&input);
+
+    if( mOptions.pOutput != NULL )
+    {
+        FILE* pStream = fopen(mOptions.pOutput, "wb");
+
+        if( (pStream == NULL) || (fwrite(input.pStream, 1U, input.streamLength, pStream) != input.streamLength) )
+        {
+            (void)fprintf(stderr, "%s: cannot write the capture\n", mOptions.pOutput);
+            return 2;
+        }
+        (void)fclose(pStream);
+    }
+
+    (void)MEM_Init();
+    HcitRef_Init(Replay_TransportInterface);
+    (void)memset(&config, 0, sizeof(config));
+    config.interfaceType = gHcitInterfaceType_d;
+    config.interfaceChannel = gHcitInterfaceNumber_d;
+    config.interfaceBaudrate = gHcitInterfaceSpeed_d;
+    config.transportInterface = Replay_TransportInterface;
+    config.writeInterface = gHcitWriteInterface_d;
+
+    if( Hcit_Init(&config) != gHciSuccess_c )
+    {
+        (void)fprintf(stderr, "Hcit_Init failed\n");
+        return 1;
+    }
+
+    switch( mOptions.path )
+    {
+        case mReplayPathPty_c:
+            result = Replay_RunPty(&input);
+            break;
+        case mReplayPathSend_c:
+            result = Replay_RunSend(&input);
+            break;
+        case mReplayPathLoopback_c:
+            result = Replay_RunLoopback(&input);
+            break;
+        default:
+            result = Replay_RunReceive(&input);
+            break;
+    }
+
+#if gHcitSnoop_d
+    if( (mOptions.pSnoopFile != NULL) && (Replay_CheckSnoop() != 0) )
+    {
+        result = 1;
+    }
+#endif
+
+    free(input.pStream);
+    free(input.pPackets);
+
+    return result;
+}
+
+/************************************************************************************
+*************************************************************************************
+* Private functions
+*************************************************************************************
+************************************************************************************/
+static bleResult_t Replay_TransportInterface(hciPacketType_t packetType, void* pPacket, uint16_t packetSize)
+{
+    uint8_t header[3];
+
+    header[0] = (uint8_t)packetType;
+    header[1] = (uint8_t)packetSize;
+    header[2] = (uint8_t)(packetSize >> 8);
+
+    mRxDigest = Replay_Fnv(mRxDigest, header, sizeof(header));
+    mRxDigest = Replay_Fnv(mRxDigest, (const uint8_t*)pPacket, packetSize);
+    mRxPackets++;
+
+    if( packetType == gHciEventPacket_c )
+    {
+        mRxEvents++;
+    }
+    else if( packetType == gHciDataPacket_c )
+    {
+        mRxAcl++;
+    }
+    else
+    {
+        /* Counted in mRxPackets only */
+    }
+
+    return gBleSuccess_c;
+}
+
+static void Replay_WriteHook(const uint8_t* pData, uint16_t length)
+{
+    mTxBytes += length;
+    mTxDigest = Replay_Fnv(mTxDigest, pData, length);
+}
+
+static uint32_t Replay_Fnv(uint32_t hash, const uint8_t* pData, uint32_t length)
+{
+    uint32_t i;
+
+    for( i = 0U; i < length; i++ )
+    {
+        hash = (hash ^ pData[i]) * mReplayFnvPrime_c;
+    }
+
+    return hash;
+}
+
+static uint32_t Replay_Random(void)
+{
+    /* xorshift32 */
+    mRandomState ^= mRandomState << 13;
+    mRandomState ^= mRandomState >> 17;
+    mRandomState ^= mRandomState << 5;
+
+    return mRandomState;
+}
+
+static uint16_t Replay_HeaderLength(uint8_t type)
+{
+    uint16_t length;
+
+    switch( type )
+    {
+        case gHciCommandPacket_c:       length = gHciCommandPacketHeaderLength_c; break;
+        case gHciDataPacket_c:          length = gHciAclDataPacketHeaderLength_c; break;
+        case gHciSynchronousDataPacket_c: length = 3U; break;
+        case gHciEventPacket_c:         length = gHciEventPacketHeaderLength_c; break;
+        case 0x05U:                     length = 4U; break;     /* ISO data */
+        default:                        length = 0U; break;
+    }
+
+    return length;
+}
+
+static uint16_t Replay_PayloadLength(uint8_t type, const uint8_t* pHeader)
+{
+    uint16_t length;
+
+    switch( type )
+    {
+        case gHciCommandPacket_c:           length = pHeader[2]; break;
+        case gHciDataPacket_c:              length = (uint16_t)(pHeader[2] | ((uint16_t)pHeader[3] << 8)); break;
+        case gHciSynchronousDataPacket_c:   length = pHeader[2]; break;
+        case gHciEventPacket_c:             length = pHeader[1]; break;
+        default:                            length = (uint16_t)((pHeader[2] | ((uint16_t)pHeader[3] << 8)) & 0x3FFFU); break;
+    }
+
+    return length;
+}
+
+static int Replay_AddPacket(replayInput_t* pInput, uint8_t type, const uint8_t* pPacket, uint16_t length)
+{
+    replayPacket_t* pPackets;
+    uint8_t*        pStream;
+
+    if( pInput->packetCount == pInput->capacity )
+    {
+        pInput->capacity = (pInput->capacity == 0U) ? 1024U : 2U * pInput->capacity;
+        pPackets = realloc(pInput->pPackets, pInput->capacity * sizeof(replayPacket_t));
+        if( pPackets == NULL )
+        {
+            return -1;
+        }
+        pInput->pPackets = pPackets;
+    }
+
+    pStream = realloc(pInput->pStream, pInput->streamLength + 1U + length);
+    if( pStream == NULL )
+    {
+        return -1;
+    }
+    pInput->pStream = pStream;
+
+    pInput->pPackets[pInput->packetCount].offset = pInput->streamLength;
+    pInput->pPackets[pInput->packetCount].length = length;
+    pInput->pPackets[pInput->packetCount].type = type;
+    pInput->packetCount++;
+
+    pStream[pInput->streamLength] = type;
+    (void)memcpy(&pStream[pInput->streamLength + 1U], pPacket, length);
+    pInput->streamLength += 1U + length;
+
+    return 0;
+}
+
+static int Replay_LoadH4(replayInput_t* pInput, const uint8_t* pData, uint32_t length)
+{
+    uint32_t    offset = 0U;
+    uint16_t    headerLength;
+    uint32_t    packetLength;
+
+    while( offset < length )
+    {
+        headerLength = Replay_HeaderLength(pData[offset]);
+
+        if( (headerLength == 0U) || ((length - offset - 1U) < headerLength) )
+        {
+            (void)fprintf(stderr, "invalid H4 packet at offset %u\n", offset);
+            return -1;
+        }
+
+        packetLength = headerLength + (uint32_t)Replay_PayloadLength(pData[offset], &pData[offset + 1U]);
+
+        if( (length - offset - 1U) < packetLength )
+        {
+            (void)fprintf(stderr, "truncated H4 packet at offset %u\n", offset);
+            return -1;
+        }
+
+        if( Replay_AddPacket(pInput, pData[offset], &pData[offset + 1U], (uint16_t)packetLength) != 0 )
+        {
+            return -1;
+        }
+
+        offset += 1U + packetLength;
+    }
+
+    return 0;
+}
+
+static uint32_t Replay_Be32(const uint8_t* pData)
+{
+    return ((uint32_t)pData[0] << 24) | ((uint32_t)pData[1] << 16) | ((uint32_t)pData[2] << 8) | pData[3];
+}
+
+static int Replay_LoadBtsnoop(replayInput_t* pInput, const uint8_t* pData, uint32_t length)
+{
+    uint32_t    datalink = Replay_Be32(&pData[12]);
+    uint32_t    offset = mBtsnoopHeaderSize_c;
+    uint32_t    included;
+    uint32_t    original;
+    uint32_t    flags;
+    uint8_t     type;
+    const uint8_t* pRecord;
+
+    if( (datalink != mBtsnoopDatalinkHci_c) && (datalink != mBtsnoopDatalinkH4_c) )
+    {
+        (void)fprintf(stderr, "unsupported btsnoop datalink %u\n", datalink);
+        return -1;
+    }
+
+    while( (length - offset) >= mBtsnoopRecordHeaderSize_c )
+    {
+        original = Replay_Be32(&pData[offset]);
+        included = Replay_Be32(&pData[offset + 4U]);
+        flags = Replay_Be32(&pData[offset + 8U]);
+        pRecord = &pData[offset + mBtsnoopRecordHeaderSize_c];
+        offset += mBtsnoopRecordHeaderSize_c;
+
+        if( (length - offset) < included )
+        {
+            break;
+        }
+        offset += included;
+
+        /* Only the complete packets received from the Controller */
+        if( ((flags & 1U) == 0U) || (included != original) || (included == 0U) )
+        {
+            continue;
+        }
+
+        if( datalink == mBtsnoopDatalinkH4_c )
+        {
+            type = pRecord[0];
+            pRecord++;
+            included--;
+        }
+        else
+        {
+            type = ((flags & 2U) != 0U) ? (uint8_t)gHciEventPacket_c : (uint8_t)gHciDataPacket_c;
+        }
+
+        if( Replay_AddPacket(pInput, type, pRecord, (uint16_t)included) != 0 )
+        {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static int Replay_LoadFile(replayInput_t* pInput, const char* pFile)
+{
+    FILE*       pStream = fopen(pFile, "rb");
+    uint8_t*    pData = NULL;
+    long        size;
+    int         result = -1;
+
+    if( pStream == NULL )
+    {
+        (void)fprintf(stderr, "%s: %s\n", pFile, strerror(errno));
+        return -1;
+    }
+
+    if( (fseek(pStream, 0, SEEK_END) == 0) && ((size = ftell(pStream)) > 0) )
+    {
+        pData = malloc((size_t)size);
+        rewind(pStream);
+
+        if( (pData != NULL) && (fread(pData, 1U, (size_t)size, pStream) == (size_t)size) )
+        {
+            if( (size >= (long)mBtsnoopHeaderSize_c) && (memcmp(pData, "btsnoop\0", 8U) == 0) )
+            {
+                result = Replay_LoadBtsnoop(pInput, pData, (uint32_t)size);
+            }
+            else
+            {
+                result = Replay_LoadH4(pInput, pData, (uint32_t)size);
+            }
+        }
+    }
+
+    free(pData);
+    (void)fclose(pStream);
+
+    if( (result == 0) && (pInput->packetCount == 0U) )
+    {
+        (void)fprintf(stderr, "%s: no packet to replay\n", pFile);
+        result = -1;
+    }
+
+    return result;
+}
+
+/*! *********************************************************************************
+* \brief  Builds a synthetic capture.
+*
+* \remarks scan: LE Advertising Reports of 0 to 31 bytes of data.
+*          extscan: LE Extended Advertising Reports of 0 to 229 bytes of data.
+*          acl: one long transfer cut in ACL fragments, with a Number Of Completed
+*          Packets event every 8 fragments.
+*          mixed: the scan reports and ACL fragments of 4 links interleaved.
+*
+********************************************************************************** */
+static int Replay_Generate(replayInput_t* pInput, const char* pGenerator, uint32_t count)
+{
+    uint8_t     packet[4U + mReplayAclDataLength_c];
+    uint32_t    i;
+    uint32_t    j;
+    uint16_t    length;
+    uint16_t    handle;
+    bool_t      scan;
+    bool_t      extended = (strcmp(pGenerator, "extscan") == 0) ? TRUE : FALSE;
+    bool_t      mixed = (strcmp(pGenerator, "mixed") == 0) ? TRUE : FALSE;
+
+    if( !extended && !mixed && (strcmp(pGenerator, "scan") != 0) && (strcmp(pGenerator, "acl") != 0) )
+    {
+        Replay_Usage();
+        return -1;
+    }
+
+    for( i = 0U; i < count; i++ )
+    {
+        scan = (extended || (strcmp(pGenerator, "scan") == 0) || (mixed && ((Replay_Random() & 1U) != 0U))) ? TRUE : FALSE;
+
+        if( scan && !extended )
+        {
+            /* Subevent, reports, event type, address type, address, data length, data, RSSI */
+            uint8_t dataLength = (uint8_t)(Replay_Random() % 32U);
+
+            length = (uint16_t)(11U + dataLength + 1U);
+            packet[0] = gHciLeMetaEvent_c;
+            packet[1] = (uint8_t)length;
+            packet[2] = 0x02U;
+            packet[3] = 1U;
+            packet[4] = (uint8_t)(Replay_Random() % 5U);
+            packet[5] = 0U;
+            for( j = 0U; j < 6U; j++ )
+            {
+                packet[6U + j] = (uint8_t)Replay_Random();
+            }
+            packet[12] = dataLength;
+            for( j = 0U; j < dataLength; j++ )
+            {
+                packet[13U + j] = (uint8_t)Replay_Random();
+            }
+            packet[13U + dataLength] = (uint8_t)(0xC0U + (Replay_Random() % 0x30U));
+            length = (uint16_t)(length + 2U);
+        }
+        else if( scan )
+        {
+            /* Subevent, reports, 24 bytes of report header, data length, data */
+            uint8_t dataLength = (uint8_t)(Replay_Random() % 230U);
+
+            length = (uint16_t)(2U + 24U + dataLength);
+            packet[0] = gHciLeMetaEvent_c;
+            packet[1] = (uint8_t)length;
+            packet[2] = 0x0DU;
+            packet[3] = 1U;
+            for( j = 0U; j < 23U; j++ )
+            {
+                packet[4U + j] = (uint8_t)Replay_Random();
+            }
+            packet[27] = dataLength;
+            for( j = 0U; j < dataLength; j++ )
+            {
+                packet[28U + j] = (uint8_t)Replay_Random();
+            }
+            length = (uint16_t)(length + 2U);
+        }
+        else if( !mixed && ((i % 9U) == 8U) )
+        {
+            /* Number Of Completed Packets for the 8 previous fragments */
+            length = 5U;
+            packet[0] = gHciNumberOfCompletedPacketsEvent_c;
+            packet[1] = (uint8_t)length;
+            packet[2] = 1U;
+            packet[3] = (uint8_t)mReplayAclHandle_c;
+            packet[4] = (uint8_t)(mReplayAclHandle_c >> 8);
+            packet[5] = 8U;
+            packet[6] = 0U;
+            length = (uint16_t)(length + 2U);
+        }
+        else
+        {
+            /* First fragment every 16, continuation otherwise */
+            handle = (uint16_t)(mReplayAclHandle_c + (mixed ? (Replay_Random() % 4U) : 0U));
+            handle |= ((i % 16U) == 0U) ? 0x2000U : 0x1000U;
+            length = mReplayAclDataLength_c;
+            packet[0] = (uint8_t)handle;
+            packet[1] = (uint8_t)(handle >> 8);
+            packet[2] = (uint8_t)length;
+            packet[3] = (uint8_t)(length >> 8);
+            for( j = 0U; j < length; j++ )
+            {
+                packet[4U + j] = (uint8_t)Replay_Random();
+            }
+            if( Replay_AddPacket(pInput, gHciDataPacket_c, packet, (uint16_t)(length + 4U)) != 0 )
+            {
+                return -1;
+            }
+            continue;
+        }
+
+        if( Replay_AddPacket(pInput, gHciEventPacket_c, packet, length) != 0 )
+        {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static uint16_t Replay_NextChunk(uint32_t remaining)
+{
+    uint32_t chunk = mOptions.chunkSize;
+
+    if( chunk == 0U )
+    {
+        chunk = 1U + (Replay_Random() % 256U);
+    }
+
+    return (uint16_t)((chunk < remaining) ? chunk : remaining);
+}
+
+static uint64_t Replay_Now(clockid_t clock)
+{
+    struct timespec now;
+
+    (void)clock_gettime(clock, &now);
+
+    return (uint64_t)now.tv_sec * 1000000000U + (uint64_t)now.tv_nsec;
+}
+
+/*! *********************************************************************************
+* \brief  Waits until the bytes fed so far would have been received at the baud rate
+*         of the options (8N1).
+*
+********************************************************************************** */
+static void Replay_Pace(uint64_t startNs, uint64_t bytes)
+{
+    uint64_t            due;
+    uint64_t            now;
+    struct timespec     delay;
+
+    if( mOptions.baudrate == 0U )
+    {
+        return;
+    }
+
+    due = startNs + (bytes * 10U * 1000000000U) / mOptions.baudrate;
+    now = Replay_Now(CLOCK_MONOTONIC);
+
+    if( due > now )
+    {
+        delay.tv_sec = (time_t)((due - now) / 1000000000U);
+        delay.tv_nsec = (long)((due - now) % 1000000000U);
+        (void)nanosleep(&delay, NULL);
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Prints the measurements and checks the delivered packets against the input.
+*
+********************************************************************************** */
+static int Replay_Report
+(
+    const replayInput_t*    pInput,
+    uint32_t                expectedPackets,
+    uint32_t                expectedDigest,
+    uint32_t                packets,
+    uint32_t                digest,
+    uint64_t                wallNs,
+    uint64_t                cpuNs
+)
+{
+    static const char* const paths[] = { "span", "byte", "recv", "pty", "send", "loopback", "reference" };
+    memStats_t  memStats;
+    bool_t      match = ((packets == expectedPackets) && (digest == expectedDigest)) ? TRUE : FALSE;
+
+    MEM_GetStats(&memStats, FALSE);
+
+    if( !mOptions.quiet || !match )
+    {
+        (void)printf("input       : %s, %u packets, %u bytes, %u loop(s)",
+                     (mOptions.pFile != NULL) ? mOptions.pFile : mOptions.pGenerator,
+                     pInput->packetCount, pInput->streamLength, mOptions.loops);
+        (void)printf((mOptions.bitErrorOneIn != 0U) ? ", 1 bit error in %u\n" : "\n", mOptions.bitErrorOneIn);
+        (void)printf("path        : %s", paths[mOptions.path]);
+        if( (mOptions.path == mReplayPathSpan_c) || (mOptions.path == mReplayPathPty_c) )
+        {
+            (void)printf((mOptions.chunkSize != 0U) ? ", %u-byte reads" : ", random reads", mOptions.chunkSize);
+        }
+        (void)printf((mOptions.baudrate != 0U) ? ", paced at %u baud\n" : "\n", mOptions.baudrate);
+        if( mOptions.path == mReplayPathSend_c )
+        {
+            (void)printf("packets     : %u sent, %llu bytes written\n", packets, (unsigned long long)mTxBytes);
+        }
+        else
+        {
+            (void)printf("packets     : %u (%u events, %u ACL)\n", packets, mRxEvents, mRxAcl);
+        }
+        (void)printf("packets/s   : %.0f\n", (wallNs != 0U) ? (double)packets * 1e9 / (double)wallNs : 0.0);
+        (void)printf("cpu/packet  : %.1f ns\n", (packets != 0U) ? (double)cpuNs / (double)packets : 0.0);
+        (void)printf("allocs/pkt  : %.2f (peak %u in use, %u not freed, %u failed)\n",
+                     (packets != 0U) ? (double)memStats.allocations / (double)packets : 0.0,
+                     memStats.peakInUse, memStats.inUse, memStats.failures);
+        (void)printf("digest      : %08x, %s\n", digest, !match ? "MISMATCH" :
+                     ((mOptions.bitErrorOneIn != 0U) ? "matches the reference parser" : "matches the input"));
+    }
+
+    if( !match )
+    {
+        (void)printf("expected    : %u packets, digest %08x\n", expectedPackets, expectedDigest);
+    }
+
+    return (match && (memStats.inUse == 0U)) ? 0 : 1;
+}
+
+/*! *********************************************************************************
+* \brief  Digest and count of the input packets the Downward transport delivers.
+*
+********************************************************************************** */
+static void Replay_Expected(const replayInput_t* pInput, uint32_t* pPackets, uint32_t* pDigest)
+{
+    const replayPacket_t*   pPacket;
+    uint8_t                 header[3];
+    uint32_t                digest = mReplayFnvBasis_c;
+    uint32_t                count = 0U;
+    uint32_t                loop;
+    uint32_t                i;
+
+    if( mOptions.bitErrorOneIn != 0U )
+    {
+        /* The packet table no longer describes the stream: the reference parser does */
+        for( loop = 0U; loop < mOptions.loops; loop++ )
+        {
+            for( i = 0U; i < pInput->streamLength; i++ )
+            {
+                HcitRef_ProcessReceivedChar(pInput->pStream[i]);
+            }
+        }
+
+        *pPackets = mRxPackets;
+        *pDigest = mRxDigest;
+        HcitRef_Init(Replay_TransportInterface);
+        mRxPackets = 0U;
+        mRxEvents = 0U;
+        mRxAcl = 0U;
+        mRxDigest = mReplayFnvBasis_c;
+        return;
+    }
+
+    for( loop = 0U; loop < mOptions.loops; loop++ )
+    {
+        for( i = 0U; i < pInput->packetCount; i++ )
+        {
+            pPacket = &pInput->pPackets[i];
+
+            if( (pPacket->type != (uint8_t)gHciEventPacket_c) && (pPacket->type != (uint8_t)gHciDataPacket_c) )
+            {
+                continue;
+            }
+
+            header[0] = pPacket->type;
+            header[1] = (uint8_t)pPacket->length;
+            header[2] = (uint8_t)(pPacket->length >> 8);
+            digest = Replay_Fnv(digest, header, sizeof(header));
+            digest = Replay_Fnv(digest, &pInput->pStream[pPacket->offset + 1U], pPacket->length);
+            count++;
+        }
+    }
+
+    *pPackets = count;
+    *pDigest = digest;
+}
+
+/*! *********************************************************************************
+* \brief  Flips random bits of the input stream, one in mOptions.bitErrorOneIn on
+*         average.
+*
+********************************************************************************** */
+static void Replay_InjectErrors(replayInput_t* pInput)
+{
+    uint64_t bits = (uint64_t)pInput->streamLength * 8U;
+    uint64_t bit = 0U;
+
+    if( mOptions.bitErrorOneIn == 0U )
+    {
+        return;
+    }
+
+    for( ;; )
+    {
+        bit += 1U + (Replay_Random() % (2U * mOptions.bitErrorOneIn - 1U));
+
+        if( bit > bits )
+        {
+            break;
+        }
+
+        pInput->pStream[(bit - 1U) / 8U] ^= (uint8_t)(1U << ((bit - 1U) % 8U));
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Feeds the stream to the receive parser: span, byte, reference and recv paths.
+*
+********************************************************************************** */
+static int Replay_RunReceive(const replayInput_t* pInput)
+{
+    const replayPacket_t*   pPacket;
+    uint32_t                expectedPackets;
+    uint32_t                expectedDigest;
+    uint64_t                startNs;
+    uint64_t                startCpu;
+    uint64_t                fed = 0U;
+    uint32_t                offset;
+    uint32_t                loop;
+    uint32_t                i;
+    uint16_t                chunk;
+    uint8_t*                pBuffer;
+    memStats_t              memStats;
+
+    Replay_Expected(pInput, &expectedPackets, &expectedDigest);
+    MEM_GetStats(&memStats, TRUE);
+
+    startNs = Replay_Now(CLOCK_MONOTONIC);
+    startCpu = Replay_Now(CLOCK_PROCESS_CPUTIME_ID);
+
+    for( loop = 0U; loop < mOptions.loops; loop++ )
+    {
+        if( mOptions.path == mReplayPathRecv_c )
+        {
+            for( i = 0U; i < pInput->packetCount; i++ )
+            {
+                pPacket = &pInput->pPackets[i];
+
+                if( (pPacket->type != (uint8_t)gHciEventPacket_c) && (pPacket->type != (uint8_t)gHciDataPacket_c) )
+                {
+                    continue;
+                }
+
+                /* As FSCI does: a buffer per packet, freed by Hcit_RecvPacket() */
+                pBuffer = MEM_BufferAlloc(1U + (uint32_t)pPacket->length);
+                if( pBuffer == NULL )
+                {
+                    return 1;
+                }
+
+                (void)memcpy(pBuffer, &pInput->pStream[pPacket->offset], 1U + (size_t)pPacket->length);
+                (void)Hcit_RecvPacket(pBuffer, (uint16_t)(1U + pPacket->length));
+                fed += 1U + (uint64_t)pPacket->length;
+                Replay_Pace(startNs, fed);
+            }
+        }
+        else
+        {
+            for( offset = 0U; offset < pInput->streamLength; offset += chunk )
+            {
+                chunk = (mOptions.path == mReplayPathSpan_c) ? Replay_NextChunk(pInput->streamLength - offset) : 1U;
+
+                if( mOptions.path == mReplayPathByte_c )
+                {
+                    hci_processReceivedChar(pInput->pStream[offset]);
+                }
+                else if( mOptions.path == mReplayPathReference_c )
+                {
+                    HcitRef_ProcessReceivedChar(pInput->pStream[offset]);
+                }
+                else
+                {
+                    Hcit_InterfaceDataReceived(&pInput->pStream[offset], chunk);
+                }
+
+                fed += chunk;
+                Replay_Pace(startNs, fed);
+            }
+        }
+    }
+
+    return Replay_Report(pInput, expectedPackets, expectedDigest, mRxPackets, mRxDigest,
+                         Replay_Now(CLOCK_MONOTONIC) - startNs,
+                         Replay_Now(CLOCK_PROCESS_CPUTIME_ID) - startCpu);
+}
+
+/*! *********************************************************************************
+* \brief  Writes the stream to the slave side of a PTY and lets the poll loop of
+*         the port read it from the master side.
+*
+********************************************************************************** */
+static int Replay_RunPty(const replayInput_t* pInput)
+{
+    uint32_t    expectedPackets;
+    uint32_t    expectedDigest;
+    uint64_t    startNs;
+    uint64_t    startCpu;
+    uint64_t    fed = 0U;
+    uint64_t    total = (uint64_t)pInput->streamLength * mOptions.loops;
+    uint32_t    offset = 0U;
+    uint32_t    idleMs = 0U;
+    uint16_t    chunk;
+    ssize_t     written;
+    int         master;
+    int         slave;
+    int         received;
+    memStats_t  memStats;
+
+    if( HcitLinux_OpenPty(&master, &slave) != 0 )
+    {
+        (void)fprintf(stderr, "cannot open a PTY pair\n");
+        return 1;
+    }
+
+    HcitLinux_SetFd(master);
+    (void)fcntl(slave, F_SETFL, fcntl(slave, F_GETFL) | O_NONBLOCK);
+
+    Replay_Expected(pInput, &expectedPackets, &expectedDigest);
+    MEM_GetStats(&memStats, TRUE);
+
+    startNs = Replay_Now(CLOCK_MONOTONIC);
+    startCpu = Replay_Now(CLOCK_PROCESS_CPUTIME_ID);
+
+    while( (mRxPackets < expectedPackets) && (idleMs < mReplayLoopbackTimeoutMs_c) )
+    {
+        if( fed < total )
+        {
+            chunk = Replay_NextChunk(pInput->streamLength - offset);
+            written = write(slave, &pInput->pStream[offset], chunk);
+
+            if( written > 0 )
+            {
+                fed += (uint64_t)written;
+                offset = (uint32_t)((offset + (uint32_t)written) % pInput->streamLength);
+                Replay_Pace(startNs, fed);
+            }
+        }
+
+        /* Read everything the PTY holds before writing more */
+        do
+        {
+            received = HcitLinux_Poll((fed < total) ? 0U : 1U, mOptions.chunkSize);
+        } while( received > 0 );
+
+        idleMs = ((fed < total) || (received > 0)) ? 0U : (idleMs + 1U);
+    }
+
+    (void)close(slave);
+    (void)close(master);
+
+    return Replay_Report(pInput, expectedPackets, expectedDigest, mRxPackets, mRxDigest,
+                         Replay_Now(CLOCK_MONOTONIC) - startNs,
+                         Replay_Now(CLOCK_PROCESS_CPUTIME_ID) - startCpu);
+}
+
+/*! *********************************************************************************
+* \brief  Sends the packets with Hcit_SendPacket() and checks the written stream.
+*
+********************************************************************************** */
+static int Replay_RunSend(const replayInput_t* pInput)
+{
+    const replayPacket_t*   pPacket;
+    uint32_t                expectedDigest = mReplayFnvBasis_c;
+    uint32_t                sent = 0U;
+    uint64_t                startNs;
+    uint64_t                startCpu;
+    uint64_t                fed = 0U;
+    uint32_t                loop;
+    uint32_t                i;
+    memStats_t              memStats;
+
+    for( loop = 0U; loop < mOptions.loops; loop++ )
+    {
+        expectedDigest = Replay_Fnv(expectedDigest, pInput->pStream, pInput->streamLength);
+    }
+
+    HcitLinux_SetFd(-1);
+    HcitLinux_SetWriteHook(Replay_WriteHook);
+    MEM_GetStats(&memStats, TRUE);
+
+    startNs = Replay_Now(CLOCK_MONOTONIC);
+    startCpu = Replay_Now(CLOCK_PROCESS_CPUTIME_ID);
+
+    for( loop = 0U; loop < mOptions.loops; loop++ )
+    {
+        for( i = 0U; i < pInput->packetCount; i++ )
+        {
+            pPacket = &pInput->pPackets[i];
+
+            if( Hcit_SendPacket((hciPacketType_t)pPacket->type, &pInput->pStream[pPacket->offset + 1U], pPacket->length) == gBleSuccess_c )
+            {
+                sent++;
+            }
+
+            (void)HcitLinux_CompleteWrites();
+            fed += 1U + (uint64_t)pPacket->length;
+            Replay_Pace(startNs, fed);
+        }
+    }
+
+    /* Wait for the timers of the transport, if any, to flush the last writes */
+    while( (mTxBytes < fed) && (TMR_Process() != gTmrNoExpiry_c) )
+    {
+        (void)HcitLinux_Poll(1U, 0U);
+    }
+    (void)HcitLinux_CompleteWrites();
+
+    return Replay_Report(pInput, pInput->packetCount * mOptions.loops, expectedDigest, sent, mTxDigest,
+                         Replay_Now(CLOCK_MONOTONIC) - startNs,
+                         Replay_Now(CLOCK_PROCESS_CPUTIME_ID) - startCpu);
+}
+
+/*! *********************************************************************************
+* \brief  Sends the event and ACL packets with Hcit_SendPacket() over a PTY whose
+*         other side echoes everything back, and checks they are received unchanged.
+*
+********************************************************************************** */
+static int Replay_RunLoopback(const replayInput_t* pInput)
+{
+    static uint8_t          echo[4096];
+    const replayPacket_t*   pPacket;
+    uint32_t                expectedPackets;
+    uint32_t                expectedDigest;
+    uint32_t                sent = 0U;
+    uint32_t                echoLength = 0U;
+    uint32_t                echoOffset = 0U;
+    uint32_t                idleMs = 0U;
+    uint32_t                loop = 0U;
+    uint32_t                i = 0U;
+    uint64_t                startNs;
+    uint64_t                startCpu;
+    ssize_t                 count;
+    bool_t                  progress;
+    int                     master;
+    int                     slave;
+    memStats_t              memStats;
+
+    if( HcitLinux_OpenPty(&master, &slave) != 0 )
+    {
+        (void)fprintf(stderr, "cannot open a PTY pair\n");
+        return 1;
+    }
+
+    HcitLinux_SetFd(master);
+    (void)fcntl(slave, F_SETFL, fcntl(slave, F_GETFL) | O_NONBLOCK);
+
+    Replay_Expected(pInput, &expectedPackets, &expectedDigest);
+    MEM_GetStats(&memStats, TRUE);
+
+    startNs = Replay_Now(CLOCK_MONOTONIC);
+    startCpu = Replay_Now(CLOCK_PROCESS_CPUTIME_ID);
+
+    while( (mRxPackets < expectedPackets) && (idleMs < mReplayLoopbackTimeoutMs_c) )
+    {
+        progress = FALSE;
+
+        /* Keep a bounded number of packets in the loop */
+        while( (loop < mOptions.loops) && ((sent - mRxPackets) < mReplayLoopbackWindow_c) )
+        {
+            pPacket = &pInput->pPackets[i];
+
+            if( (pPacket->type == (uint8_t)gHciEventPacket_c) || (pPacket->type == (uint8_t)gHciDataPacket_c) )
+            {
+                if( Hcit_SendPacket((hciPacketType_t)pPacket->type, &pInput->pStream[pPacket->offset + 1U], pPacket->length) != gBleSuccess_c )
+                {
+                    break;
+                }
+                sent++;
+            }
+
+            if( ++i == pInput->packetCount )
+            {
+                i = 0U;
+                loop++;
+            }
+            progress = TRUE;
+        }
+
+        /* The far end: everything read on the slave side is written back */
+        if( echoOffset == echoLength )
+        {
+            count = read(slave, echo, sizeof(echo));
+            echoOffset = 0U;
+            echoLength = (count > 0) ? (uint32_t)count : 0U;
+        }
+
+        if( echoOffset < echoLength )
+        {
+            count = write(slave, &echo[echoOffset], echoLength - echoOffset);
+            if( count > 0 )
+            {
+                echoOffset += (uint32_t)count;
+                progress = TRUE;
+            }
+        }
+
+        if( HcitLinux_Poll(progress ? 0U : 1U, mOptions.chunkSize) > 0 )
+        {
+            progress = TRUE;
+        }
+
+        idleMs = progress ? 0U : (idleMs + 1U);
+    }
+
+    (void)HcitLinux_Poll(0U, 0U);
+    (void)close(slave);
+    (void)close(master);
+
+    return Replay_Report(pInput, expectedPackets, expectedDigest, mRxPackets, mRxDigest,
+                         Replay_Now(CLOCK_MONOTONIC) - startNs,
+                         Replay_Now(CLOCK_PROCESS_CPUTIME_ID) - startCpu);
+}
+
+#if gHcitSnoop_d
+/*! *********************************************************************************
+* \brief  Dumps the btsnoop capture of the transport and checks that it holds the
+*         packets the transport delivered.
+*
+********************************************************************************** */
+static int Replay_CheckSnoop(void)
+{
+    const replayPacket_t*   pPacket;
+    replayInput_t           capture;
+    uint8_t                 header[3];
+    uint32_t                digest = mReplayFnvBasis_c;
+    uint32_t                i;
+    int                     result;
+
+    if( HcitLinux_SnoopDump(mOptions.pSnoopFile) != 0 )
+    {
+        (void)fprintf(stderr, "%s: cannot write the capture\n", mOptions.pSnoopFile);
+        return 1;
+    }
+
+    (void)memset(&capture, 0, sizeof(capture));
+    result = Replay_LoadFile(&capture, mOptions.pSnoopFile);
+
+    for( i = 0U; (result == 0) && (i < capture.packetCount); i++ )
+    {
+        pPacket = &capture.pPackets[i];
+        header[0] = pPacket->type;
+        header[1] = (uint8_t)pPacket->length;
+        header[2] = (uint8_t)(pPacket->length >> 8);
+        digest = Replay_Fnv(digest, header, sizeof(header));
+        digest = Replay_Fnv(digest, &capture.pStream[pPacket->offset + 1U], pPacket->length);
+    }
+
+    if( (result != 0) || (capture.packetCount != mRxPackets) || (digest != mRxDigest) )
+    {
+        (void)printf("capture     : %s, %u packets, digest %08x, MISMATCH\n", mOptions.pSnoopFile,
+                     capture.packetCount, digest);
+        result = 1;
+    }
+    else if( !mOptions.quiet )
+    {
+        (void)printf("capture     : %s, %u packets, %u bytes, matches the delivered packets\n",
+                     mOptions.pSnoopFile, capture.packetCount, Hcit_SnoopGetSize());
+    }
+    else
+    {
+        /* Quiet */
+    }
+
+    free(capture.pStream);
+    free(capture.pPackets);
+
+    return result;
+}
+#endif /* gHcitSnoop_d */
+
+static void Replay_Usage(void)
+{
+    (void)fprintf(stderr,
+        "usage: hcit_replay [options] capture.{h4,btsnoop}\n"
+        "       hcit_replay [options] -g scan|extscan|acl|mixed [-n packets]\n"
+        "  -m path    span (default), byte, reference, recv, pty, send or loopback\n"
+        "  -c bytes   read size of the span and pty paths, 0 for random (default 64)\n"
+        "  -b baud    feeds the data at this baud rate, 8N1 (default: no pacing)\n"
+        "  -l loops   replays the input this many times (default 1)\n"
+        "  -e bits    flips one bit in this many of the input, on average (span, byte,\n"
+        "             reference and pty paths)\n"
+        "  -s seed    seed of the generator and random reads (default 1)\n"
+        "  -o file    saves the input as a raw H4 capture\n"
+        "  -d file    writes the btsnoop capture of the transport to a file, when built\n"
+        "             with gHcitSnoop_d (span, byte, pty and loopback paths)\n"
+        "  -q         prints only on failure\n");
+}
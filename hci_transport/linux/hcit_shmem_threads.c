@@ -0,0 +1,579 @@
+/*! *********************************************************************************
+* Copyright 2026 NXP
+* All rights reserved.
+*
+* \file
+*
+* Runs the shared memory HCI transport (gHcitSharedMemory_d) with two threads
+* standing in for the two cores of a dual-core part. Each thread masks only its own
+* interrupts (gOsaInterruptsPerThread_d), so the rings get no help from a common
+* lock.
+*
+* The host thread uses the transport as the Host does: Hcit_SendPacket(), then
+* Hcit_AllocPacket() with Hcit_SendAllocatedPacket() or Hcit_FreePacket(), and
+* Hcit_ShmemDoorbellHandler() when its doorbell rings. The controller thread drives
+* the other side of the rings with the functions of hcit_shmem.h, and releases the
+* received slots out of order. The doorbells are condition variables.
+*
+* Both threads send at the same time and check that the packets they receive are
+* complete, unchanged and in order. The exit status is nonzero if a check fails.
+*
+* SPDX-License-Identifier: BSD-3-Clause
+********************************************************************************** */
+
+/************************************************************************************
+*************************************************************************************
+* Include
+*************************************************************************************
+************************************************************************************/
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "hci_transport.h"
+#include "hcit_shmem.h"
+#include "MemManager.h"
+
+/************************************************************************************
+*************************************************************************************
+* Private macros
+*************************************************************************************
+************************************************************************************/
+/* Payload: sequence number, then a pattern derived from it */
+#define mThreadsMinPayload_c        (4U)
+#define mThreadsMaxPayload_c        (gHcitShmemSlotSize_c - gHciAclDataPacketHeaderLength_c)
+#define mThreadsMaxEventParams_c    (255U)
+
+/* One host allocation in this many is cancelled with Hcit_FreePacket() */
+#define mThreadsCancelPeriod_c      (7U)
+
+/* Received slots the controller holds before releasing them, newest first */
+#define mThreadsHeldSlots_c         (3U)
+
+#define mThreadsDoorbellWaitUs_c    (1000U)
+
+/************************************************************************************
+*************************************************************************************
+* Private type definitions
+*************************************************************************************
+************************************************************************************/
+typedef struct threadsDoorbell_tag
+{
+    pthread_mutex_t mutex;
+    pthread_cond_t  cond;
+    bool_t          rung;
+    uint32_t        count;
+}threadsDoorbell_t;
+
+/************************************************************************************
+*************************************************************************************
+* Private prototypes
+*************************************************************************************
+************************************************************************************/
+static void Threads_RingController(void);
+static void Threads_RingHost(void);
+static void Threads_InstallDoorbell(void (* pfHandler)(void));
+static bool_t Threads_CheckDoorbell(threadsDoorbell_t* pDoorbell, bool_t wait);
+static void Threads_Ring(threadsDoorbell_t* pDoorbell);
+static bleResult_t Threads_TransportInterface(hciPacketType_t packetType, void* pPacket, uint16_t packetSize);
+static uint16_t Threads_Payload(uint32_t sequence, uint8_t* pPayload, uint16_t maxLength);
+static bool_t Threads_CheckPayload(uint32_t sequence, const uint8_t* pPayload, uint16_t length, uint16_t maxLength);
+static bool_t Threads_HostSend(void);
+static void Threads_ReleaseHeld(hcitShmemRing_t* pRing, void** pHeld, uint32_t* pHeldCount);
+static void* Threads_Controller(void* pParam);
+static uint64_t Threads_Now(clockid_t clock);
+static void Threads_Usage(void);
+
+/************************************************************************************
+*************************************************************************************
+* Private memory declarations
+*************************************************************************************
+************************************************************************************/
+static hcitShmemRegion_t    mRegion;
+
+static threadsDoorbell_t    mControllerDoorbell = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER };
+static threadsDoorbell_t    mHostDoorbell = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER };
+static void                 (* mpfHostDoorbellHandler)(void);
+
+static uint32_t     mPackets = 200000U;
+static uint32_t     mTimeoutMs = 60000U;
+static bool_t       mQuiet;
+static volatile bool_t mAbort;
+
+/* Host thread */
+static uint32_t     mHostSent;
+static uint32_t     mHostAllocations;
+static uint32_t     mHostRingFull;
+static uint32_t     mHostReceived;
+static uint32_t     mHostErrors;
+
+/* Controller thread */
+static uint32_t     mControllerSent;
+static uint32_t     mControllerRingFull;
+static uint32_t     mControllerReceived;
+static uint32_t     mControllerErrors;
+
+/************************************************************************************
+*************************************************************************************
+* Public functions
+*************************************************************************************
+************************************************************************************/
+/*! *********************************************************************************
+* \brief  Host entry point used by Hcit_RecvPacket().
+*
+********************************************************************************** */
+bleResult_t Ble_HciRecv
+(
+    hciPacketType_t     packetType,
+    void*               pHciPacket,
+    uint16_t            packetSize
+)
+{
+    return Threads_TransportInterface(packetType, pHciPacket, packetSize);
+}
+
+int main(int argc, char* argv[])
+{
+    hcitConfigStruct_t  config;
+    pthread_t           controller;
+    uint64_t            startNs;
+    uint64_t            startCpu;
+    uint64_t            wallNs;
+    uint64_t            cpuNs;
+    int                 opt;
+    int                 result = 0;
+
+    while( (opt = getopt(argc, argv, "n:t:qh")) != -1 )
+    {
+        switch( opt )
+        {
+            case 'n':
+                mPackets = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            case 't':
+                mTimeoutMs = 1000U * (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            case 'q':
+                mQuiet = TRUE;
+                break;
+            default:
+                Threads_Usage();
+                return 2;
+        }
+    }
+
+    /* As Ble_Initialize() does */
+    (void)MEM_Init();
+    (void)memset(&config, 0, sizeof(config));
+    config.transportInterface = Threads_TransportInterface;
+    config.pSharedMemory = gHcitShmemRegion_d;
+    config.pfDoorbell = gHcitShmemDoorbell_d;
+
+    if( Hcit_Init(&config) != gHciSuccess_c )
+    {
+        (void)fprintf(stderr, "Hcit_Init failed\n");
+        return 1;
+    }
+
+    gHcitShmemDoorbellInstall_d(Hcit_ShmemDoorbellHandler);
+
+    startNs = Threads_Now(CLOCK_MONOTONIC);
+    startCpu = Threads_Now(CLOCK_PROCESS_CPUTIME_ID);
+
+    /* The Host side empties the rings before the Controller core starts */
+    if( pthread_create(&controller, NULL, Threads_Controller, NULL) != 0 )
+    {
+        (void)fprintf(stderr, "cannot start the controller thread\n");
+        return 1;
+    }
+
+    while( ((mHostSent < mPackets) || (mHostReceived < mPackets)) && (mHostErrors == 0U) && !mAbort )
+    {
+        /* Releasing slots rings no doorbell: a full ring is tried again */
+        if( (mHostSent < mPackets) && !Threads_HostSend() )
+        {
+            (void)sched_yield();
+        }
+
+        if( Threads_CheckDoorbell(&mHostDoorbell, (mHostSent == mPackets) ? TRUE : FALSE) )
+        {
+            mpfHostDoorbellHandler();
+        }
+
+        if( (Threads_Now(CLOCK_MONOTONIC) - startNs) > ((uint64_t)mTimeoutMs * 1000000U) )
+        {
+            (void)fprintf(stderr, "host: timeout, %u packets sent, %u received\n", mHostSent, mHostReceived);
+            mAbort = TRUE;
+        }
+    }
+
+    if( mHostErrors != 0U )
+    {
+        mAbort = TRUE;
+    }
+
+    Threads_Ring(&mControllerDoorbell);
+    (void)pthread_join(controller, NULL);
+
+    wallNs = Threads_Now(CLOCK_MONOTONIC) - startNs;
+    cpuNs = Threads_Now(CLOCK_PROCESS_CPUTIME_ID) - startCpu;
+
+    /* Every slot is given back */
+    if( (mRegion.hostToController.tail != mRegion.hostToController.reserve) ||
+        (mRegion.controllerToHost.tail != mRegion.controllerToHost.reserve) )
+    {
+        (void)fprintf(stderr, "slots not released\n");
+        result = 1;
+    }
+
+    if( mAbort || (mHostErrors != 0U) || (mControllerErrors != 0U) )
+    {
+        result = 1;
+    }
+
+    if( !mQuiet || (result != 0) )
+    {
+        (void)printf("%u slots of %u bytes per ring, %u packets each way\n",
+                     gHcitShmemSlotCount_c, gHcitShmemSlotSize_c, mPackets);
+        (void)printf("host      : %u sent (%u allocated, %u cancelled), %u received, ring full %u times\n",
+                     mHostSent, mHostAllocations, mHostAllocations / mThreadsCancelPeriod_c, mHostReceived, mHostRingFull);
+        (void)printf("controller: %u sent, %u received, ring full %u times\n",
+                     mControllerSent, mControllerReceived, mControllerRingFull);
+        (void)printf("doorbells : %u to the controller, %u to the host\n",
+                     mControllerDoorbell.count, mHostDoorbell.count);
+
+        /* The rates mean nothing if the run stopped early */
+        if( result == 0 )
+        {
+            (void)printf("rate      : %.1f ms, %.0f packets/s each way\n",
+                         (double)wallNs / 1e6, (double)mPackets * 1e9 / (double)wallNs);
+            (void)printf("cpu/packet: %.1f ns, both threads and directions\n", (double)cpuNs / (2.0 * (double)mPackets));
+        }
+    }
+
+    return result;
+}
+
+/************************************************************************************
+*************************************************************************************
+* Private functions
+*************************************************************************************
+************************************************************************************/
+/*! *********************************************************************************
+* \brief  Doorbell of the host core to the controller core (gHcitShmemDoorbell_d).
+*
+********************************************************************************** */
+static void Threads_RingController(void)
+{
+    Threads_Ring(&mControllerDoorbell);
+}
+
+/*! *********************************************************************************
+* \brief  Doorbell of the controller core to the host core.
+*
+********************************************************************************** */
+static void Threads_RingHost(void)
+{
+    Threads_Ring(&mHostDoorbell);
+}
+
+/*! *********************************************************************************
+* \brief  Installs the handler of the host doorbell (gHcitShmemDoorbellInstall_d).
+*         The host thread calls it when the doorbell rings, as its interrupt would.
+*
+********************************************************************************** */
+static void Threads_InstallDoorbell(void (* pfHandler)(void))
+{
+    mpfHostDoorbellHandler = pfHandler;
+}
+
+/*! *********************************************************************************
+* \brief  Checks a doorbell, optionally waiting a little for it.
+*
+* \return  TRUE if the doorbell rang since the last call.
+*
+********************************************************************************** */
+static bool_t Threads_CheckDoorbell(threadsDoorbell_t* pDoorbell, bool_t wait)
+{
+    struct timespec deadline;
+    bool_t          rung;
+
+    (void)clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_nsec += (long)mThreadsDoorbellWaitUs_c * 1000L;
+    if( deadline.tv_nsec >= 1000000000L )
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    (void)pthread_mutex_lock(&pDoorbell->mutex);
+    if( wait && !pDoorbell->rung )
+    {
+        (void)pthread_cond_timedwait(&pDoorbell->cond, &pDoorbell->mutex, &deadline);
+    }
+    rung = pDoorbell->rung;
+    pDoorbell->rung = FALSE;
+    (void)pthread_mutex_unlock(&pDoorbell->mutex);
+
+    return rung;
+}
+
+static void Threads_Ring(threadsDoorbell_t* pDoorbell)
+{
+    (void)pthread_mutex_lock(&pDoorbell->mutex);
+    pDoorbell->rung = TRUE;
+    pDoorbell->count++;
+    (void)pthread_cond_signal(&pDoorbell->cond);
+    (void)pthread_mutex_unlock(&pDoorbell->mutex);
+}
+
+/*! *********************************************************************************
+* \brief  Receives the events of the controller thread, on the host thread.
+*
+********************************************************************************** */
+static bleResult_t Threads_TransportInterface(hciPacketType_t packetType, void* pPacket, uint16_t packetSize)
+{
+    const uint8_t* pEvent = (const uint8_t*)pPacket;
+
+    if( (packetType != gHciEventPacket_c) || (packetSize < 2U) || (pEvent[1] != (packetSize - 2U)) ||
+        !Threads_CheckPayload(mHostReceived, &pEvent[2], (uint16_t)(packetSize - 2U), mThreadsMaxEventParams_c) )
+    {
+        (void)fprintf(stderr, "host: event %u received damaged or out of order\n", mHostReceived);
+        mHostErrors++;
+    }
+
+    mHostReceived++;
+
+    return gBleSuccess_c;
+}
+
+/*! *********************************************************************************
+* \brief  Builds the payload of a packet: its sequence number, then a pattern, on a
+*         length that changes with it.
+*
+********************************************************************************** */
+static uint16_t Threads_Payload(uint32_t sequence, uint8_t* pPayload, uint16_t maxLength)
+{
+    uint16_t length = (uint16_t)(mThreadsMinPayload_c + ((sequence * 7U) % (maxLength - mThreadsMinPayload_c + 1U)));
+    uint16_t i;
+
+    (void)memcpy(pPayload, &sequence, sizeof(sequence));
+
+    for( i = mThreadsMinPayload_c; i < length; i++ )
+    {
+        pPayload[i] = (uint8_t)(sequence + i);
+    }
+
+    return length;
+}
+
+static bool_t Threads_CheckPayload(uint32_t sequence, const uint8_t* pPayload, uint16_t length, uint16_t maxLength)
+{
+    uint8_t     expected[mThreadsMaxPayload_c];
+    uint16_t    expectedLength = Threads_Payload(sequence, expected, maxLength);
+
+    return ((length == expectedLength) && (memcmp(pPayload, expected, length) == 0)) ? TRUE : FALSE;
+}
+
+/*! *********************************************************************************
+* \brief  Sends the next ACL packet of the host thread. Every other packet is built
+*         in place in the ring.
+*
+* \return  TRUE if the packet was sent, FALSE if the ring is full.
+*
+********************************************************************************** */
+static bool_t Threads_HostSend(void)
+{
+    uint8_t     packet[gHciAclDataPacketHeaderLength_c + mThreadsMaxPayload_c];
+    uint8_t*    pPacket = packet;
+    uint16_t    length;
+    bleResult_t result;
+
+    if( (mHostSent & 1U) != 0U )
+    {
+        /* Zero copy: the slot is reserved first, and sometimes given back unused */
+        pPacket = Hcit_AllocPacket(gHciAclDataPacketHeaderLength_c + mThreadsMaxPayload_c);
+        if( NULL == pPacket )
+        {
+            mHostRingFull++;
+            return FALSE;
+        }
+
+        mHostAllocations++;
+        if( (mHostAllocations % mThreadsCancelPeriod_c) == 0U )
+        {
+            /* The controller skips the slot: the next packet takes its number */
+            Hcit_FreePacket(pPacket);
+            return TRUE;
+        }
+    }
+
+    length = Threads_Payload(mHostSent, &pPacket[gHciAclDataPacketHeaderLength_c], mThreadsMaxPayload_c);
+    pPacket[0] = 0x01U;
+    pPacket[1] = 0x00U;
+    pPacket[2] = (uint8_t)length;
+    pPacket[3] = (uint8_t)(length >> 8);
+
+    if( pPacket == packet )
+    {
+        result = Hcit_SendPacket(gHciDataPacket_c, packet, (uint16_t)(gHciAclDataPacketHeaderLength_c + length));
+    }
+    else
+    {
+        result = Hcit_SendAllocatedPacket(gHciDataPacket_c, pPacket, (uint16_t)(gHciAclDataPacketHeaderLength_c + length));
+    }
+
+    if( result == gBleOutOfMemory_c )
+    {
+        mHostRingFull++;
+        return FALSE;
+    }
+
+    mHostSent++;
+
+    return TRUE;
+}
+
+/*! *********************************************************************************
+* \brief  Controller core: checks the ACL packets of the host and sends events.
+*
+********************************************************************************** */
+static void* Threads_Controller(void* pParam)
+{
+    hcitShmemRing_t*    pRx = &mRegion.hostToController;
+    hcitShmemRing_t*    pTx = &mRegion.controllerToHost;
+    void*               held[mThreadsHeldSlots_c];
+    uint32_t            heldCount = 0U;
+    uint8_t*            pPacket;
+    uint8_t*            pEvent;
+    uint8_t             packetType;
+    uint16_t            length;
+    uint16_t            dataLength;
+    bool_t              progress;
+
+    (void)pParam;
+
+    while( ((mControllerSent < mPackets) || (mControllerReceived < mPackets)) && !mAbort )
+    {
+        progress = FALSE;
+
+        pPacket = Hcit_ShmemRingReceive(pRx, &packetType, &length);
+        if( NULL != pPacket )
+        {
+            progress = TRUE;
+            dataLength = (uint16_t)(pPacket[2] | ((uint16_t)pPacket[3] << 8));
+
+            if( (packetType != (uint8_t)gHciDataPacket_c) || (length != (gHciAclDataPacketHeaderLength_c + dataLength)) ||
+                !Threads_CheckPayload(mControllerReceived, &pPacket[gHciAclDataPacketHeaderLength_c], dataLength, mThreadsMaxPayload_c) )
+            {
+                (void)fprintf(stderr, "controller: packet %u received damaged or out of order\n", mControllerReceived);
+                mControllerErrors++;
+                mAbort = TRUE;
+            }
+
+            mControllerReceived++;
+
+            /* Slots are released out of order: newest first, once a few are held */
+            held[heldCount] = pPacket;
+            heldCount++;
+            if( heldCount == mThreadsHeldSlots_c )
+            {
+                Threads_ReleaseHeld(pRx, held, &heldCount);
+            }
+        }
+        else
+        {
+            /* Nothing more to receive for now: the host waits for the held slots */
+            Threads_ReleaseHeld(pRx, held, &heldCount);
+        }
+
+        if( mControllerSent < mPackets )
+        {
+            pEvent = Hcit_ShmemRingAlloc(pTx, 2U + mThreadsMaxEventParams_c);
+            if( NULL != pEvent )
+            {
+                progress = TRUE;
+                length = Threads_Payload(mControllerSent, &pEvent[2], mThreadsMaxEventParams_c);
+                pEvent[0] = 0xFFU;
+                pEvent[1] = (uint8_t)length;
+
+                if( Hcit_ShmemRingSend(pTx, pEvent, (uint8_t)gHciEventPacket_c, (uint16_t)(2U + length)) )
+                {
+                    Threads_RingHost();
+                }
+                mControllerSent++;
+            }
+            else
+            {
+                mControllerRingFull++;
+            }
+        }
+
+        if( progress )
+        {
+            /* Keep going */
+        }
+        else if( mControllerSent < mPackets )
+        {
+            /* The host releases the slots without a doorbell */
+            (void)sched_yield();
+        }
+        else
+        {
+            (void)Threads_CheckDoorbell(&mControllerDoorbell, TRUE);
+        }
+    }
+
+    Threads_ReleaseHeld(pRx, held, &heldCount);
+
+    return NULL;
+}
+
+/*! *********************************************************************************
+* \brief  Releases the slots held by the controller, newest first.
+*
+* \remarks  Only the consumer moves the tail, so it must stay put until the oldest
+*           held slot is released: the host could otherwise reuse slots still in use.
+*
+********************************************************************************** */
+static void Threads_ReleaseHeld(hcitShmemRing_t* pRing, void** pHeld, uint32_t* pHeldCount)
+{
+    uint32_t    tail;
+
+    while( *pHeldCount > 0U )
+    {
+        (*pHeldCount)--;
+        tail = pRing->tail;
+
+        if( !Hcit_ShmemRingRelease(pRing, pHeld[*pHeldCount]) ||
+            ((*pHeldCount > 0U) && (pRing->tail != tail)) )
+        {
+            (void)fprintf(stderr, "controller: slot released out of order freed older slots\n");
+            mControllerErrors++;
+            mAbort = TRUE;
+        }
+    }
+}
+
+static uint64_t Threads_Now(clockid_t clock)
+{
+    struct timespec now;
+
+    (void)clock_gettime(clock, &now);
+
+    return ((uint64_t)now.tv_sec * 1000000000U) + (uint64_t)now.tv_nsec;
+}
+
+static void Threads_Usage(void)
+{
+    (void)fprintf(stderr,
+        "usage: hcit_shmem_threads [-n packets] [-t seconds] [-q]\n"
+        "  -n packets sent each way (default 200000)\n"
+        "  -t seconds longest run (default 60)\n"
+        "  -q         prints only on failure\n");
+}
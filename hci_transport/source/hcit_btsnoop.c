@@ -0,0 +1,395 @@
+/*! *********************************************************************************
+* \addtogroup HCI
+* @{
+********************************************************************************** */
+/*! *********************************************************************************
+* Copyright 2026 NXP
+* All rights reserved.
+*
+* \file
+*
+* This file implements the btsnoop capture of the HCI traffic. The records are
+* stored in a RAM ring buffer directly in the btsnoop format, so that the capture
+* can be read back as a btsnoop file.
+*
+* SPDX-License-Identifier: BSD-3-Clause
+********************************************************************************** */
+
+/************************************************************************************
+*************************************************************************************
+* Include
+*************************************************************************************
+************************************************************************************/
+#include "hci_transport.h"
+
+#if gHcitSnoop_d
+
+#include "TimersManager.h"
+#include "FunctionLib.h"
+#include "fsl_os_abstraction.h"
+
+#include "ble_general.h"
+#include "hcit_btsnoop.h"
+
+/************************************************************************************
+*************************************************************************************
+* Private macros
+*************************************************************************************
+************************************************************************************/
+#define mSnoopFileHeaderLength_c    (16U)
+#define mSnoopRecordHeaderLength_c  (24U)
+#define mSnoopVersion_c             (1U)
+#define mSnoopDatalinkH4_c          (1002U)
+
+/* Packet flags */
+#define mSnoopFlagReceived_c        (BIT0)
+#define mSnoopFlagCommandEvent_c    (BIT1)
+
+/* Microseconds from 0000-01-01 to 1970-01-01. The timestamps are relative to the
+   system start, so the capture starts at 1970-01-01. */
+#define mSnoopEpochOffsetUs_c       (0x00DCDDB30F2F8000ULL)
+
+#define mSnoopIsoDataPacket_c       (0x05U)
+#define mSnoopHandleMask_c          (0x0FFFU)
+
+#if (gHcitSnoopBufferSize_c < (mSnoopRecordHeaderLength_c + 8U))
+#error "gHcitSnoopBufferSize_c is too small"
+#endif
+
+/************************************************************************************
+*************************************************************************************
+* Private memory declarations
+*************************************************************************************
+************************************************************************************/
+static const uint8_t mSnoopFileHeader[mSnoopFileHeaderLength_c] =
+{
+    'b', 't', 's', 'n', 'o', 'o', 'p', 0x00U,
+    0x00U, 0x00U, 0x00U, mSnoopVersion_c,
+    0x00U, 0x00U, (uint8_t)(mSnoopDatalinkH4_c >> 8U), (uint8_t)mSnoopDatalinkH4_c
+};
+
+static uint8_t      mSnoopRing[gHcitSnoopBufferSize_c];
+static uint32_t     mSnoopHead;     /* Where the next record is written */
+static uint32_t     mSnoopTail;     /* Oldest record */
+static uint32_t     mSnoopUsed;
+static uint32_t     mSnoopDrops;    /* Records lost since the capture was cleared */
+
+static bool_t       mSnoopEnabled = TRUE;
+static bool_t       mSnoopReading = FALSE;  /* Capture paused until the file is read */
+static uint8_t      mSnoopTypeMask = gHcitSnoopFilterAll_c;
+static uint16_t     mSnoopHandle = gHcitSnoopAnyHandle_c;
+
+/************************************************************************************
+*************************************************************************************
+* Private functions prototypes
+*************************************************************************************
+************************************************************************************/
+static void Snoop_RingWrite(const uint8_t* pData, uint32_t length);
+static void Snoop_RingRead(uint32_t position, uint8_t* pData, uint32_t length);
+static void Snoop_PackUint32(uint8_t* pDest, uint32_t value);
+
+/************************************************************************************
+*************************************************************************************
+* Public functions
+*************************************************************************************
+************************************************************************************/
+
+/*! *********************************************************************************
+* \brief  Adds a record for the packet, overwriting the oldest records if needed.
+*
+* \param[in]    packetType  HCI packet type
+* \param[in]    pPacket     HCI packet, without the packet type marker
+* \param[in]    packetSize  Size of the HCI packet
+* \param[in]    received    TRUE for a packet received from the interface
+*
+********************************************************************************** */
+void Hcit_SnoopPacket(hciPacketType_t packetType, const uint8_t* pPacket, uint16_t packetSize, bool_t received)
+{
+    uint8_t     header[mSnoopRecordHeaderLength_c + 1U];
+    uint8_t     marker = (uint8_t)packetType;
+    uint16_t    dataHeaderLength = 0U;
+    uint32_t    includedLength = packetSize;
+    uint32_t    recordLength;
+    uint32_t    flags = 0U;
+    uint64_t    timestamp;
+
+    if( (!mSnoopEnabled) || (marker > 7U) || ((mSnoopTypeMask & (1U << marker)) == 0U) )
+    {
+        return;
+    }
+
+    switch( marker )
+    {
+        case gHciCommandPacket_c:
+        case gHciEventPacket_c:
+            flags |= mSnoopFlagCommandEvent_c;
+            break;
+
+        case gHciDataPacket_c:
+        case mSnoopIsoDataPacket_c:
+            dataHeaderLength = 4U;
+            break;
+
+        case gHciSynchronousDataPacket_c:
+            dataHeaderLength = 3U;
+            break;
+
+        default:
+            ; /* For MISRA compliance */
+            break;
+    }
+
+    if( dataHeaderLength > 0U )
+    {
+        if( (mSnoopHandle != gHcitSnoopAnyHandle_c) &&
+            ((packetSize < 2U) || ((Utils_ExtractTwoByteValue(pPacket) & mSnoopHandleMask_c) != mSnoopHandle)) )
+        {
+            return;
+        }
+
+        if( includedLength > ((uint32_t)dataHeaderLength + gHcitSnoopDataSnapLen_c) )
+        {
+            includedLength = (uint32_t)dataHeaderLength + gHcitSnoopDataSnapLen_c;
+        }
+    }
+
+    if( received )
+    {
+        flags |= mSnoopFlagReceived_c;
+    }
+
+    timestamp = TMR_GetTimestamp() + mSnoopEpochOffsetUs_c;
+
+    /* The stored packet starts with the H4 packet type marker */
+    Snoop_PackUint32(&header[0], (uint32_t)packetSize + 1U);
+    Snoop_PackUint32(&header[4], includedLength + 1U);
+    Snoop_PackUint32(&header[8], flags);
+    Snoop_PackUint32(&header[16], (uint32_t)(timestamp >> 32U));
+    Snoop_PackUint32(&header[20], (uint32_t)timestamp);
+    header[mSnoopRecordHeaderLength_c] = marker;
+
+    recordLength = mSnoopRecordHeaderLength_c + 1U + includedLength;
+
+    OSA_InterruptDisable();
+
+    if( mSnoopReading || (recordLength > gHcitSnoopBufferSize_c) )
+    {
+        mSnoopDrops++;
+    }
+    else
+    {
+        /* Make room by discarding the oldest records */
+        while( (gHcitSnoopBufferSize_c - mSnoopUsed) < recordLength )
+        {
+            uint8_t  length[4];
+            uint32_t oldLength;
+
+            Snoop_RingRead(mSnoopTail + 4U, length, sizeof(length));
+            oldLength = mSnoopRecordHeaderLength_c + Utils_BeExtractFourByteValue(length);
+
+            mSnoopTail = (mSnoopTail + oldLength) % gHcitSnoopBufferSize_c;
+            mSnoopUsed -= oldLength;
+            mSnoopDrops++;
+        }
+
+        Snoop_PackUint32(&header[12], mSnoopDrops);
+
+        Snoop_RingWrite(header, sizeof(header));
+        Snoop_RingWrite(pPacket, includedLength);
+        mSnoopUsed += recordLength;
+    }
+
+    OSA_InterruptEnable();
+}
+
+/*! *********************************************************************************
+* \brief  Starts or stops the btsnoop capture.
+*
+* \param[in]    enable      TRUE to capture the HCI traffic
+*
+********************************************************************************** */
+void Hcit_SnoopEnable(bool_t enable)
+{
+    OSA_InterruptDisable();
+    mSnoopEnabled = enable;
+    mSnoopReading = FALSE;
+    OSA_InterruptEnable();
+}
+
+/*! *********************************************************************************
+* \brief  Sets the btsnoop capture filters.
+*
+* \param[in]    packetTypeMask      Bit n enables packets with the H4 marker n
+* \param[in]    connectionHandle    Handle of the captured data packets, or
+*                                   gHcitSnoopAnyHandle_c
+*
+********************************************************************************** */
+void Hcit_SnoopSetFilter(uint8_t packetTypeMask, uint16_t connectionHandle)
+{
+    OSA_InterruptDisable();
+    mSnoopTypeMask = packetTypeMask;
+    mSnoopHandle = connectionHandle;
+    OSA_InterruptEnable();
+}
+
+/*! *********************************************************************************
+* \brief  Discards all captured records.
+*
+********************************************************************************** */
+void Hcit_SnoopClear(void)
+{
+    OSA_InterruptDisable();
+    mSnoopHead = 0U;
+    mSnoopTail = 0U;
+    mSnoopUsed = 0U;
+    mSnoopDrops = 0U;
+    mSnoopReading = FALSE;
+    OSA_InterruptEnable();
+}
+
+/*! *********************************************************************************
+* \brief  Returns the size of the capture as a btsnoop file.
+*
+* \return  Size of the file header and of the captured records, in bytes.
+*
+********************************************************************************** */
+uint32_t Hcit_SnoopGetSize(void)
+{
+    return mSnoopFileHeaderLength_c + mSnoopUsed;
+}
+
+/*! *********************************************************************************
+* \brief  Reads a part of the capture, formatted as a btsnoop file.
+*
+* \param[in]    offset      Offset in the btsnoop file
+* \param[out]   pBuffer     Destination buffer
+* \param[in]    length      Size of the destination buffer
+*
+* \return  Number of bytes copied.
+*
+* \remarks A read at offset 0 pauses the capture, and reading the last byte resumes
+*          it, so that the records do not move between the chunks of a read.
+*
+********************************************************************************** */
+uint32_t Hcit_SnoopRead(uint32_t offset, uint8_t* pBuffer, uint32_t length)
+{
+    uint32_t copied = 0U;
+    uint32_t chunk;
+
+    OSA_InterruptDisable();
+
+    if( (offset == 0U) && (length > 0U) )
+    {
+        mSnoopReading = TRUE;
+    }
+
+    if( offset < mSnoopFileHeaderLength_c )
+    {
+        chunk = mSnoopFileHeaderLength_c - offset;
+        if( chunk > length )
+        {
+            chunk = length;
+        }
+
+        FLib_MemCpy(pBuffer, &mSnoopFileHeader[offset], chunk);
+        copied = chunk;
+        offset += chunk;
+    }
+
+    if( offset >= mSnoopFileHeaderLength_c )
+    {
+        offset -= mSnoopFileHeaderLength_c;
+
+        if( offset < mSnoopUsed )
+        {
+            chunk = mSnoopUsed - offset;
+            if( chunk > (length - copied) )
+            {
+                chunk = length - copied;
+            }
+
+            Snoop_RingRead(mSnoopTail + offset, &pBuffer[copied], chunk);
+            copied += chunk;
+            offset += chunk;
+        }
+
+        if( offset >= mSnoopUsed )
+        {
+            /* End of the file: the capture goes on */
+            mSnoopReading = FALSE;
+        }
+    }
+
+    OSA_InterruptEnable();
+
+    return copied;
+}
+
+/************************************************************************************
+*************************************************************************************
+* Private functions
+*************************************************************************************
+************************************************************************************/
+
+/*! *********************************************************************************
+* \brief  Copies data at the head of the ring buffer.
+*
+* \remarks  Called with interrupts disabled. The caller makes room for the data.
+*
+********************************************************************************** */
+static void Snoop_RingWrite(const uint8_t* pData, uint32_t length)
+{
+    uint32_t chunk = gHcitSnoopBufferSize_c - mSnoopHead;
+
+    if( chunk > length )
+    {
+        chunk = length;
+    }
+
+    FLib_MemCpy(&mSnoopRing[mSnoopHead], pData, chunk);
+    FLib_MemCpy(mSnoopRing, &pData[chunk], length - chunk);
+
+    mSnoopHead = (mSnoopHead + length) % gHcitSnoopBufferSize_c;
+}
+
+/*! *********************************************************************************
+* \brief  Copies data out of the ring buffer.
+*
+* \param[in]    position    Ring buffer position, may be past the end of the buffer
+* \param[out]   pData       Destination buffer
+* \param[in]    length      Number of bytes to copy
+*
+********************************************************************************** */
+static void Snoop_RingRead(uint32_t position, uint8_t* pData, uint32_t length)
+{
+    uint32_t chunk;
+
+    position %= gHcitSnoopBufferSize_c;
+    chunk = gHcitSnoopBufferSize_c - position;
+
+    if( chunk > length )
+    {
+        chunk = length;
+    }
+
+    FLib_MemCpy(pData, &mSnoopRing[position], chunk);
+    FLib_MemCpy(&pData[chunk], mSnoopRing, length - chunk);
+}
+
+/*! *********************************************************************************
+* \brief  Packs a 32 bit value in big endian order, as required by btsnoop.
+*
+********************************************************************************** */
+static void Snoop_PackUint32(uint8_t* pDest, uint32_t value)
+{
+    pDest[0] = (uint8_t)(value >> 24U);
+    pDest[1] = (uint8_t)(value >> 16U);
+    pDest[2] = (uint8_t)(value >> 8U);
+    pDest[3] = (uint8_t)value;
+}
+
+#endif /* gHcitSnoop_d */
+
+/*! *********************************************************************************
+* @}
+********************************************************************************** */
@@ -0,0 +1,50 @@
+/*! *********************************************************************************
+* \addtogroup HCI
+* @{
+********************************************************************************** */
+/*! *********************************************************************************
+* Copyright 2026 NXP
+* All rights reserved.
+*
+* \file
+*
+* This is the private interface of the HCI btsnoop capture.
+*
+* SPDX-License-Identifier: BSD-3-Clause
+********************************************************************************** */
+
+#ifndef HCIT_BTSNOOP_H
+#define HCIT_BTSNOOP_H
+
+/************************************************************************************
+*************************************************************************************
+* Include
+*************************************************************************************
+************************************************************************************/
+#include "hci_transport.h"
+
+/************************************************************************************
+*************************************************************************************
+* Public prototypes
+*************************************************************************************
+************************************************************************************/
+#if gHcitSnoop_d
+
+/*! *********************************************************************************
+* \brief        Adds a packet to the capture, if it passes the filters.
+*
+* \param[in]    packetType  HCI packet type
+* \param[in]    pPacket     HCI packet, without the packet type marker
+* \param[in]    packetSize  Size of the HCI packet
+* \param[in]    received    TRUE for a packet received from the interface
+*
+********************************************************************************** */
+void Hcit_SnoopPacket(hciPacketType_t packetType, const uint8_t* pPacket, uint16_t packetSize, bool_t received);
+
+#endif /* gHcitSnoop_d */
+
+#endif /* HCIT_BTSNOOP_H */
+
+/*! *********************************************************************************
+* @}
+********************************************************************************** */
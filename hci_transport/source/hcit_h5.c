@@ -0,0 +1,1052 @@
+/*! *********************************************************************************
+* \addtogroup HCI
+* @{
+********************************************************************************** */
+/*! *********************************************************************************
+* Copyright 2026 NXP
+* All rights reserved.
+*
+* \file
+*
+* This file implements the Three-wire UART (H5) HCI transport: SLIP framing,
+* link establishment, sliding window with acknowledgements and the optional
+* data integrity check (CRC-CCITT).
+*
+* SPDX-License-Identifier: BSD-3-Clause
+********************************************************************************** */
+
+/************************************************************************************
+*************************************************************************************
+* Include
+*************************************************************************************
+************************************************************************************/
+#include "hci_transport.h"
+
+#if gHcitH5Transport_d
+
+#include "MemManager.h"
+#include "Messaging.h"
+#include "TimersManager.h"
+
+#include "ble_general.h"
+#include "hcit_h5.h"
+
+/************************************************************************************
+*************************************************************************************
+* Private macros
+*************************************************************************************
+************************************************************************************/
+/* SLIP */
+#define mH5SlipDelimiter_c          (0xC0U)
+#define mH5SlipEscape_c             (0xDBU)
+#define mH5SlipEscDelimiter_c       (0xDCU)
+#define mH5SlipEscEscape_c          (0xDDU)
+
+/* Packet header */
+#define mH5HeaderLength_c           (4U)
+#define mH5CrcLength_c              (2U)
+#define mH5SeqMask_c                (0x07U)
+
+#define mH5HdrSeq(pHdr)             ((pHdr)[0] & 0x07U)
+#define mH5HdrAck(pHdr)             (((pHdr)[0] >> 3U) & 0x07U)
+#define mH5HdrCrcPresent(pHdr)      (((pHdr)[0] & BIT6) != 0U)
+#define mH5HdrReliable(pHdr)        (((pHdr)[0] & BIT7) != 0U)
+#define mH5HdrType(pHdr)            ((pHdr)[1] & 0x0FU)
+#define mH5HdrPayloadLength(pHdr)   ((uint16_t)(((pHdr)[1] >> 4U) | ((uint16_t)(pHdr)[2] << 4U)))
+
+/* Packet types not shared with H4 */
+#define mH5AckPacket_c              (0x00U)
+#define mH5VendorPacket_c           (0x0EU)
+#define mH5LinkControlPacket_c      (0x0FU)
+
+/* Configuration field */
+#define mH5CfgWindowMask_c          (0x07U)
+#define mH5CfgCrc_c                 (BIT4)
+
+#define mH5MaxPayloadLength_c       (gHcitMaxPayloadLen_c)
+#define mH5MaxFrameLength_c         (mH5HeaderLength_c + mH5MaxPayloadLength_c + mH5CrcLength_c)
+
+/************************************************************************************
+*************************************************************************************
+* Private type definitions
+*************************************************************************************
+************************************************************************************/
+typedef uint8_t h5LinkState_t;
+typedef enum{
+    mH5Uninitialized_c    = 0,
+    mH5Initialized_c,
+    mH5Active_c
+}h5LinkState_tag;
+
+typedef uint8_t h5RxState_t;
+typedef enum{
+    mH5RxHunt_c           = 0,  /* Waiting for a frame delimiter */
+    mH5RxFrame_c,
+    mH5RxEscape_c
+}h5RxState_tag;
+
+/* Packet waiting to be sent, or reliable packet waiting to be acknowledged */
+typedef struct h5TxPacket_tag
+{
+    uint16_t    length;
+    uint8_t     type;
+    uint8_t     seq;
+    uint8_t     payload[1];
+}h5TxPacket_t;
+
+/* Frame selected under the lock and written outside of it */
+typedef struct h5TxFrame_tag
+{
+    const uint8_t*  pPayload;
+    h5TxPacket_t*   pToFree;                /* Unreliable packet, freed once written */
+    uint16_t        length;
+    uint8_t         header[mH5HeaderLength_c];
+    uint8_t         linkControl[3];
+}h5TxFrame_t;
+
+/************************************************************************************
+*************************************************************************************
+* Private memory declarations
+*************************************************************************************
+************************************************************************************/
+static const uint8_t mH5Sync[]          = {0x01U, 0x7EU};
+static const uint8_t mH5SyncResponse[]  = {0x02U, 0x7DU};
+static const uint8_t mH5Config[]        = {0x03U, 0xFCU};
+static const uint8_t mH5ConfigResponse[]= {0x04U, 0x7BU};
+static const uint8_t mH5Wakeup[]        = {0x05U, 0xFAU};
+static const uint8_t mH5Woken[]         = {0x06U, 0xF9U};
+
+static h5LinkState_t    mH5LinkState;
+static uint8_t          mH5WindowSize;
+static bool_t           mH5UseCrc;
+
+/* Sequence numbers */
+static uint8_t          mH5TxSeq;       /* Sequence number of the next reliable packet */
+static uint8_t          mH5RxAck;       /* Next sequence number expected from the peer */
+
+/* Reliable packets not yet sent, and sent but not yet acknowledged */
+static anchor_t         mH5TxPending;
+static h5TxPacket_t*    mH5TxUnacked[7];
+static uint8_t          mH5TxUnackedHead;
+static uint8_t          mH5TxUnackedCount;
+static uint8_t          mH5TxUnackedSent;   /* Packets of the window already written */
+
+/* Frames waiting for the writer. Acknowledged packets are freed by the writer,
+   which may still be encoding them. */
+static anchor_t         mH5TxUnreliable;
+static anchor_t         mH5TxAcked;
+static uint8_t          mH5TxLinkControl[3];
+static uint8_t          mH5TxLinkControlLength; /* 0 if no link control message is pending */
+static bool_t           mH5TxAckPending;
+static bool_t           mH5TxBusy;              /* A context is writing frames */
+
+static tmrTimerID_t     mH5TimerId = gTmrInvalidTimerID_c;
+static uint32_t         mH5TxElapsedMs;  /* Time since the peer last acknowledged a packet */
+
+/* Decoder */
+static h5RxState_t      mH5RxState;
+static uint16_t         mH5RxLength;
+static uint8_t          mH5RxFrame[mH5MaxFrameLength_c];
+
+static hcitH5Stats_t    mH5Stats;
+
+/* CRC-CCITT, least significant bit first (polynomial 0x8408) */
+static const uint16_t   mH5CrcTable[256] =
+{
+    0x0000U, 0x1189U, 0x2312U, 0x329BU, 0x4624U, 0x57ADU, 0x6536U, 0x74BFU,
+    0x8C48U, 0x9DC1U, 0xAF5AU, 0xBED3U, 0xCA6CU, 0xDBE5U, 0xE97EU, 0xF8F7U,
+    0x1081U, 0x0108U, 0x3393U, 0x221AU, 0x56A5U, 0x472CU, 0x75B7U, 0x643EU,
+    0x9CC9U, 0x8D40U, 0xBFDBU, 0xAE52U, 0xDAEDU, 0xCB64U, 0xF9FFU, 0xE876U,
+    0x2102U, 0x308BU, 0x0210U, 0x1399U, 0x6726U, 0x76AFU, 0x4434U, 0x55BDU,
+    0xAD4AU, 0xBCC3U, 0x8E58U, 0x9FD1U, 0xEB6EU, 0xFAE7U, 0xC87CU, 0xD9F5U,
+    0x3183U, 0x200AU, 0x1291U, 0x0318U, 0x77A7U, 0x662EU, 0x54B5U, 0x453CU,
+    0xBDCBU, 0xAC42U, 0x9ED9U, 0x8F50U, 0xFBEFU, 0xEA66U, 0xD8FDU, 0xC974U,
+    0x4204U, 0x538DU, 0x6116U, 0x709FU, 0x0420U, 0x15A9U, 0x2732U, 0x36BBU,
+    0xCE4CU, 0xDFC5U, 0xED5EU, 0xFCD7U, 0x8868U, 0x99E1U, 0xAB7AU, 0xBAF3U,
+    0x5285U, 0x430CU, 0x7197U, 0x601EU, 0x14A1U, 0x0528U, 0x37B3U, 0x263AU,
+    0xDECDU, 0xCF44U, 0xFDDFU, 0xEC56U, 0x98E9U, 0x8960U, 0xBBFBU, 0xAA72U,
+    0x6306U, 0x728FU, 0x4014U, 0x519DU, 0x2522U, 0x34ABU, 0x0630U, 0x17B9U,
+    0xEF4EU, 0xFEC7U, 0xCC5CU, 0xDDD5U, 0xA96AU, 0xB8E3U, 0x8A78U, 0x9BF1U,
+    0x7387U, 0x620EU, 0x5095U, 0x411CU, 0x35A3U, 0x242AU, 0x16B1U, 0x0738U,
+    0xFFCFU, 0xEE46U, 0xDCDDU, 0xCD54U, 0xB9EBU, 0xA862U, 0x9AF9U, 0x8B70U,
+    0x8408U, 0x9581U, 0xA71AU, 0xB693U, 0xC22CU, 0xD3A5U, 0xE13EU, 0xF0B7U,
+    0x0840U, 0x19C9U, 0x2B52U, 0x3ADBU, 0x4E64U, 0x5FEDU, 0x6D76U, 0x7CFFU,
+    0x9489U, 0x8500U, 0xB79BU, 0xA612U, 0xD2ADU, 0xC324U, 0xF1BFU, 0xE036U,
+    0x18C1U, 0x0948U, 0x3BD3U, 0x2A5AU, 0x5EE5U, 0x4F6CU, 0x7DF7U, 0x6C7EU,
+    0xA50AU, 0xB483U, 0x8618U, 0x9791U, 0xE32EU, 0xF2A7U, 0xC03CU, 0xD1B5U,
+    0x2942U, 0x38CBU, 0x0A50U, 0x1BD9U, 0x6F66U, 0x7EEFU, 0x4C74U, 0x5DFDU,
+    0xB58BU, 0xA402U, 0x9699U, 0x8710U, 0xF3AFU, 0xE226U, 0xD0BDU, 0xC134U,
+    0x39C3U, 0x284AU, 0x1AD1U, 0x0B58U, 0x7FE7U, 0x6E6EU, 0x5CF5U, 0x4D7CU,
+    0xC60CU, 0xD785U, 0xE51EU, 0xF497U, 0x8028U, 0x91A1U, 0xA33AU, 0xB2B3U,
+    0x4A44U, 0x5BCDU, 0x6956U, 0x78DFU, 0x0C60U, 0x1DE9U, 0x2F72U, 0x3EFBU,
+    0xD68DU, 0xC704U, 0xF59FU, 0xE416U, 0x90A9U, 0x8120U, 0xB3BBU, 0xA232U,
+    0x5AC5U, 0x4B4CU, 0x79D7U, 0x685EU, 0x1CE1U, 0x0D68U, 0x3FF3U, 0x2E7AU,
+    0xE70EU, 0xF687U, 0xC41CU, 0xD595U, 0xA12AU, 0xB0A3U, 0x8238U, 0x93B1U,
+    0x6B46U, 0x7ACFU, 0x4854U, 0x59DDU, 0x2D62U, 0x3CEBU, 0x0E70U, 0x1FF9U,
+    0xF78FU, 0xE606U, 0xD49DU, 0xC514U, 0xB1ABU, 0xA022U, 0x92B9U, 0x8330U,
+    0x7BC7U, 0x6A4EU, 0x58D5U, 0x495CU, 0x3DE3U, 0x2C6AU, 0x1EF1U, 0x0F78U
+};
+
+/************************************************************************************
+*************************************************************************************
+* Private functions prototypes
+*************************************************************************************
+************************************************************************************/
+static void H5_ProcessFrame(void);
+static void H5_ProcessLinkControl(const uint8_t* pPayload, uint16_t length);
+static void H5_ProcessAck(uint8_t ack);
+static void H5_FillWindow(void);
+static void H5_Transmit(void);
+static bool_t H5_NextFrame(h5TxFrame_t* pFrame);
+static void H5_BuildHeader(h5TxFrame_t* pFrame, uint8_t type, bool_t reliable, uint8_t seq, const uint8_t* pPayload, uint16_t length);
+static bool_t H5_WriteFrame(const h5TxFrame_t* pFrame);
+static void H5_SendLinkControl(const uint8_t* pMessage, uint16_t length, bool_t withConfig);
+static void H5_ResetLink(void);
+static void H5_TimerCallback(void* pParam);
+static void H5_StartTimer(void);
+static uint16_t H5_CrcUpdate(uint16_t crc, const uint8_t* pData, uint16_t length);
+static uint16_t H5_CrcFinal(uint16_t crc);
+static uint16_t H5_SlipEncode(uint8_t* pDest, const uint8_t* pData, uint16_t length);
+
+/************************************************************************************
+*************************************************************************************
+* Public functions
+*************************************************************************************
+************************************************************************************/
+
+/*! *********************************************************************************
+* \brief  Initializes the H5 link and starts sending SYNC messages.
+*
+* \return  gBleSuccess_c or gHciTransportError_c if no timer is available.
+*
+********************************************************************************** */
+bleResult_t Hcit_H5Init(void)
+{
+    MSG_InitQueue(&mH5TxPending);
+    MSG_InitQueue(&mH5TxUnreliable);
+    MSG_InitQueue(&mH5TxAcked);
+
+    mH5TimerId = TMR_AllocateTimer();
+
+    if( mH5TimerId == gTmrInvalidTimerID_c )
+    {
+        return gHciTransportError_c;
+    }
+
+    OSA_InterruptDisable();
+    H5_ResetLink();
+    OSA_InterruptEnable();
+
+    /* The first tick sends SYNC */
+    H5_StartTimer();
+
+    return gBleSuccess_c;
+}
+
+/*! *********************************************************************************
+* \brief  Decodes SLIP frames from the received bytes.
+*
+* \param[in]    pData       Pointer to the received bytes
+* \param[in]    dataLength  Number of received bytes
+*
+********************************************************************************** */
+void Hcit_H5ReceiveData(const uint8_t* pData, uint16_t dataLength)
+{
+    uint8_t byte;
+
+    while( dataLength > 0U )
+    {
+        byte = *pData;
+        pData++;
+        dataLength--;
+
+        if( byte == mH5SlipDelimiter_c )
+        {
+            if( (mH5RxState == mH5RxFrame_c) && (mH5RxLength > 0U) )
+            {
+                H5_ProcessFrame();
+            }
+            else if( mH5RxState == mH5RxEscape_c )
+            {
+                mH5Stats.rxErrors++;
+            }
+            else
+            {
+                /* Start of frame, or consecutive delimiters */
+            }
+
+            mH5RxState = mH5RxFrame_c;
+            mH5RxLength = 0U;
+            continue;
+        }
+
+        if( mH5RxState == mH5RxHunt_c )
+        {
+            continue;
+        }
+
+        if( mH5RxState == mH5RxEscape_c )
+        {
+            if( byte == mH5SlipEscDelimiter_c )
+            {
+                byte = mH5SlipDelimiter_c;
+            }
+            else if( byte == mH5SlipEscEscape_c )
+            {
+                byte = mH5SlipEscape_c;
+            }
+            else
+            {
+                /* Invalid escape sequence: drop the frame */
+                mH5Stats.rxErrors++;
+                mH5RxState = mH5RxHunt_c;
+                continue;
+            }
+            mH5RxState = mH5RxFrame_c;
+        }
+        else if( byte == mH5SlipEscape_c )
+        {
+            mH5RxState = mH5RxEscape_c;
+            continue;
+        }
+        else
+        {
+            /* Regular byte */
+        }
+
+        if( mH5RxLength == mH5MaxFrameLength_c )
+        {
+            /* Frame too long: drop it */
+            mH5Stats.rxErrors++;
+            mH5RxState = mH5RxHunt_c;
+            continue;
+        }
+
+        mH5RxFrame[mH5RxLength] = byte;
+        mH5RxLength++;
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Sends an HCI packet over the H5 link.
+*
+* \param[in]    packetType  HCI packet type
+* \param[in]    pPacket     HCI packet
+* \param[in]    packetSize  Size of the HCI packet
+*
+* \return  gBleSuccess_c or error.
+*
+********************************************************************************** */
+bleResult_t Hcit_H5SendPacket(hciPacketType_t packetType, const void* pPacket, uint16_t packetSize)
+{
+    h5TxPacket_t*   pTxPacket;
+    bool_t          reliable;
+    bleResult_t     result = gBleSuccess_c;
+
+    if( packetSize > mH5MaxPayloadLength_c )
+    {
+        return gBleInvalidParameter_c;
+    }
+
+    reliable = (packetType == gHciCommandPacket_c) ||
+               (packetType == gHciDataPacket_c) ||
+               (packetType == gHciEventPacket_c);
+
+    pTxPacket = MSG_Alloc(sizeof(h5TxPacket_t) + packetSize);
+
+    if( NULL == pTxPacket )
+    {
+        return gBleOutOfMemory_c;
+    }
+
+    pTxPacket->type = packetType;
+    pTxPacket->length = packetSize;
+    FLib_MemCpy(pTxPacket->payload, pPacket, packetSize);
+
+    OSA_InterruptDisable();
+    if( reliable )
+    {
+        MSG_Queue(&mH5TxPending, pTxPacket);
+    }
+    else if( mH5LinkState == mH5Active_c )
+    {
+        /* Unreliable packet: sent only if the link is up */
+        MSG_Queue(&mH5TxUnreliable, pTxPacket);
+    }
+    else
+    {
+        result = gBleInvalidState_c;
+    }
+    OSA_InterruptEnable();
+
+    if( result != gBleSuccess_c )
+    {
+        (void)MSG_Free(pTxPacket);
+        return result;
+    }
+
+    H5_Transmit();
+
+    /* Retransmit if not acknowledged in time */
+    H5_StartTimer();
+
+    return result;
+}
+
+/*! *********************************************************************************
+* \brief  Reads the H5 link counters.
+*
+* \param[out]   pStats      Copy of the counters
+*
+********************************************************************************** */
+void Hcit_H5GetStats(hcitH5Stats_t* pStats)
+{
+    OSA_InterruptDisable();
+    FLib_MemCpy(pStats, &mH5Stats, sizeof(hcitH5Stats_t));
+    OSA_InterruptEnable();
+}
+
+/************************************************************************************
+*************************************************************************************
+* Private functions
+*************************************************************************************
+************************************************************************************/
+
+/*! *********************************************************************************
+* \brief  Validates a decoded frame and handles its content.
+*
+********************************************************************************** */
+static void H5_ProcessFrame(void)
+{
+    const uint8_t*  pHdr = mH5RxFrame;
+    const uint8_t*  pPayload = &mH5RxFrame[mH5HeaderLength_c];
+    uint16_t        payloadLength;
+    uint16_t        crc;
+    bool_t          deliver = FALSE;
+    uint8_t         marker;
+
+    if( (mH5RxLength < mH5HeaderLength_c) ||
+        (((uint8_t)(pHdr[0] + pHdr[1] + pHdr[2] + pHdr[3])) != 0xFFU) )
+    {
+        mH5Stats.rxErrors++;
+        return;
+    }
+
+    payloadLength = mH5HdrPayloadLength(pHdr);
+
+    if( mH5RxLength != (mH5HeaderLength_c + payloadLength + (mH5HdrCrcPresent(pHdr) ? mH5CrcLength_c : 0U)) )
+    {
+        mH5Stats.rxErrors++;
+        return;
+    }
+
+    if( mH5HdrCrcPresent(pHdr) )
+    {
+        crc = H5_CrcFinal(H5_CrcUpdate(0xFFFFU, mH5RxFrame, mH5HeaderLength_c + payloadLength));
+
+        if( crc != Utils_BeExtractTwoByteValue(&pPayload[payloadLength]) )
+        {
+            mH5Stats.rxErrors++;
+            return;
+        }
+    }
+
+    mH5Stats.rxFrames++;
+
+    if( mH5HdrType(pHdr) == mH5LinkControlPacket_c )
+    {
+        OSA_InterruptDisable();
+        H5_ProcessLinkControl(pPayload, payloadLength);
+        OSA_InterruptEnable();
+
+        H5_Transmit();
+
+        /* Keep the link establishment going, or retransmit what was queued meanwhile */
+        H5_StartTimer();
+        return;
+    }
+
+    OSA_InterruptDisable();
+
+    if( mH5LinkState == mH5Active_c )
+    {
+        H5_ProcessAck(mH5HdrAck(pHdr));
+
+        if( mH5HdrReliable(pHdr) )
+        {
+            if( mH5HdrSeq(pHdr) == mH5RxAck )
+            {
+                mH5RxAck = (mH5RxAck + 1U) & mH5SeqMask_c;
+                deliver = TRUE;
+            }
+            else
+            {
+                /* Duplicate or out of order: acknowledge again what was received */
+                mH5Stats.rxOutOfOrder++;
+            }
+
+            /* Carried by the next frame written, or sent alone */
+            mH5TxAckPending = TRUE;
+        }
+        else
+        {
+            deliver = (mH5HdrType(pHdr) != mH5AckPacket_c) && (mH5HdrType(pHdr) != mH5VendorPacket_c);
+        }
+    }
+
+    OSA_InterruptEnable();
+
+    if( deliver )
+    {
+        /* Hand the packet to the H4 parser, which owns the receive buffers */
+        marker = mH5HdrType(pHdr);
+        hci_processReceivedData(&marker, 1U);
+        hci_processReceivedData(pPayload, payloadLength);
+    }
+
+    /* Acknowledgement, and packets the window has room for again */
+    H5_Transmit();
+}
+
+/*! *********************************************************************************
+* \brief  Handles a link control message (link establishment).
+*
+* \param[in]    pPayload    Link control message
+* \param[in]    length      Length of the message
+*
+* \pre Called with interrupts disabled.
+*
+********************************************************************************** */
+static void H5_ProcessLinkControl(const uint8_t* pPayload, uint16_t length)
+{
+    uint8_t peerConfig;
+
+    if( length < 2U )
+    {
+        return;
+    }
+
+    if( FLib_MemCmp(pPayload, mH5Sync, sizeof(mH5Sync)) )
+    {
+        if( mH5LinkState == mH5Active_c )
+        {
+            /* The peer restarted: start over */
+            mH5Stats.linkResets++;
+            H5_ResetLink();
+        }
+        H5_SendLinkControl(mH5SyncResponse, sizeof(mH5SyncResponse), FALSE);
+    }
+    else if( FLib_MemCmp(pPayload, mH5SyncResponse, sizeof(mH5SyncResponse)) )
+    {
+        if( mH5LinkState == mH5Uninitialized_c )
+        {
+            mH5LinkState = mH5Initialized_c;
+            H5_SendLinkControl(mH5Config, sizeof(mH5Config), TRUE);
+        }
+    }
+    else if( FLib_MemCmp(pPayload, mH5Config, sizeof(mH5Config)) )
+    {
+        if( mH5LinkState != mH5Uninitialized_c )
+        {
+            H5_SendLinkControl(mH5ConfigResponse, sizeof(mH5ConfigResponse), TRUE);
+        }
+    }
+    else if( FLib_MemCmp(pPayload, mH5ConfigResponse, sizeof(mH5ConfigResponse)) )
+    {
+        if( mH5LinkState == mH5Initialized_c )
+        {
+            /* The configuration field is optional: no field means window 1, no CRC */
+            peerConfig = (length > 2U) ? pPayload[2] : 0x01U;
+
+            mH5WindowSize = peerConfig & mH5CfgWindowMask_c;
+            if( (mH5WindowSize == 0U) || (mH5WindowSize > gHcitH5WindowSize_c) )
+            {
+                mH5WindowSize = (mH5WindowSize == 0U) ? 1U : gHcitH5WindowSize_c;
+            }
+            mH5UseCrc = (gHcitH5UseCrc_d && ((peerConfig & mH5CfgCrc_c) != 0U)) ? TRUE : FALSE;
+            mH5LinkState = mH5Active_c;
+        }
+    }
+    else if( FLib_MemCmp(pPayload, mH5Wakeup, sizeof(mH5Wakeup)) )
+    {
+        H5_SendLinkControl(mH5Woken, sizeof(mH5Woken), FALSE);
+    }
+    else
+    {
+        /* Sleep and woken messages are not used */
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Releases the reliable packets acknowledged by the peer.
+*
+* \param[in]    ack     Next sequence number expected by the peer
+*
+* \pre Called with interrupts disabled.
+*
+********************************************************************************** */
+static void H5_ProcessAck(uint8_t ack)
+{
+    h5TxPacket_t*   pOldest;
+    uint8_t         acked;
+
+    if( mH5TxUnackedCount == 0U )
+    {
+        return;
+    }
+
+    pOldest = mH5TxUnacked[mH5TxUnackedHead];
+    acked = (ack - pOldest->seq) & mH5SeqMask_c;
+
+    if( acked > mH5TxUnackedCount )
+    {
+        /* Acknowledges something never sent: ignore */
+        return;
+    }
+
+    if( acked > 0U )
+    {
+        mH5TxElapsedMs = 0U;
+    }
+
+    mH5TxUnackedSent = (mH5TxUnackedSent > acked) ? (uint8_t)(mH5TxUnackedSent - acked) : 0U;
+
+    while( acked > 0U )
+    {
+        MSG_Queue(&mH5TxAcked, mH5TxUnacked[mH5TxUnackedHead]);
+        mH5TxUnackedHead = (mH5TxUnackedHead + 1U) % NumberOfElements(mH5TxUnacked);
+        mH5TxUnackedCount--;
+        acked--;
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Moves pending reliable packets to the window while it has room, and gives
+*         them their sequence number.
+*
+* \pre Called with interrupts disabled.
+*
+********************************************************************************** */
+static void H5_FillWindow(void)
+{
+    h5TxPacket_t* pTxPacket;
+
+    while( (mH5TxUnackedCount < mH5WindowSize) && MSG_Pending(&mH5TxPending) )
+    {
+        pTxPacket = MSG_DeQueue(&mH5TxPending);
+        pTxPacket->seq = mH5TxSeq;
+        mH5TxSeq = (mH5TxSeq + 1U) & mH5SeqMask_c;
+
+        mH5TxUnacked[(mH5TxUnackedHead + mH5TxUnackedCount) % NumberOfElements(mH5TxUnacked)] = pTxPacket;
+        mH5TxUnackedCount++;
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Writes the frames waiting to be sent. Only one context writes at a time:
+*         the others leave their frames to it.
+*
+* \remarks The frames are selected with interrupts disabled, then built, encoded and
+*          written with interrupts enabled.
+*
+********************************************************************************** */
+static void H5_Transmit(void)
+{
+    h5TxFrame_t     frame;
+    h5TxPacket_t*   pAcked;
+    bool_t          written;
+    bool_t          done = FALSE;
+
+    OSA_InterruptDisable();
+
+    if( mH5TxBusy )
+    {
+        OSA_InterruptEnable();
+        return;
+    }
+    mH5TxBusy = TRUE;
+
+    while( !done )
+    {
+        pAcked = MSG_DeQueue(&mH5TxAcked);
+
+        if( NULL != pAcked )
+        {
+            OSA_InterruptEnable();
+            (void)MSG_Free(pAcked);
+            OSA_InterruptDisable();
+        }
+        else if( H5_NextFrame(&frame) )
+        {
+            OSA_InterruptEnable();
+
+            written = H5_WriteFrame(&frame);
+            if( NULL != frame.pToFree )
+            {
+                (void)MSG_Free(frame.pToFree);
+            }
+
+            OSA_InterruptDisable();
+
+            if( written )
+            {
+                mH5Stats.txFrames++;
+            }
+            else
+            {
+                mH5Stats.txErrors++;
+            }
+        }
+        else
+        {
+            done = TRUE;
+        }
+    }
+
+    mH5TxBusy = FALSE;
+    OSA_InterruptEnable();
+}
+
+/*! *********************************************************************************
+* \brief  Selects the next frame to write: link control message, unreliable packet,
+*         reliable packet of the window, or acknowledgement alone.
+*
+* \param[out]   pFrame      Frame to write
+*
+* \return  TRUE if there is a frame to write.
+*
+* \pre Called with interrupts disabled.
+*
+********************************************************************************** */
+static bool_t H5_NextFrame(h5TxFrame_t* pFrame)
+{
+    h5TxPacket_t*   pTxPacket;
+    bool_t          found = TRUE;
+
+    pFrame->pToFree = NULL;
+
+    if( mH5TxLinkControlLength > 0U )
+    {
+        FLib_MemCpy(pFrame->linkControl, mH5TxLinkControl, mH5TxLinkControlLength);
+        H5_BuildHeader(pFrame, mH5LinkControlPacket_c, FALSE, 0U, pFrame->linkControl, mH5TxLinkControlLength);
+        mH5TxLinkControlLength = 0U;
+    }
+    else if( mH5LinkState != mH5Active_c )
+    {
+        found = FALSE;
+    }
+    else if( MSG_Pending(&mH5TxUnreliable) )
+    {
+        pTxPacket = MSG_DeQueue(&mH5TxUnreliable);
+        pFrame->pToFree = pTxPacket;
+        H5_BuildHeader(pFrame, pTxPacket->type, FALSE, 0U, pTxPacket->payload, pTxPacket->length);
+    }
+    else
+    {
+        H5_FillWindow();
+
+        if( mH5TxUnackedSent < mH5TxUnackedCount )
+        {
+            /* Stays allocated until acknowledged, and then until the writer frees it */
+            pTxPacket = mH5TxUnacked[(mH5TxUnackedHead + mH5TxUnackedSent) % NumberOfElements(mH5TxUnacked)];
+            mH5TxUnackedSent++;
+            H5_BuildHeader(pFrame, pTxPacket->type, TRUE, pTxPacket->seq, pTxPacket->payload, pTxPacket->length);
+        }
+        else if( mH5TxAckPending )
+        {
+            H5_BuildHeader(pFrame, mH5AckPacket_c, FALSE, 0U, NULL, 0U);
+        }
+        else
+        {
+            found = FALSE;
+        }
+    }
+
+    return found;
+}
+
+/*! *********************************************************************************
+* \brief  Fills the packet header of a frame. Every frame carries the current
+*         acknowledgement number.
+*
+* \param[out]   pFrame      Frame to write
+* \param[in]    type        H5 packet type
+* \param[in]    reliable    TRUE for a reliable packet
+* \param[in]    seq         Sequence number of a reliable packet
+* \param[in]    pPayload    Packet payload
+* \param[in]    length      Length of the payload
+*
+* \pre Called with interrupts disabled.
+*
+********************************************************************************** */
+static void H5_BuildHeader(h5TxFrame_t* pFrame, uint8_t type, bool_t reliable, uint8_t seq, const uint8_t* pPayload, uint16_t length)
+{
+    uint8_t* pHdr = pFrame->header;
+
+    pFrame->pPayload = pPayload;
+    pFrame->length = length;
+
+    pHdr[0] = (uint8_t)(seq | (uint8_t)(mH5RxAck << 3U));
+    if( mH5UseCrc )
+    {
+        pHdr[0] |= BIT6;
+    }
+    if( reliable )
+    {
+        pHdr[0] |= BIT7;
+    }
+    pHdr[1] = (uint8_t)(type | (uint8_t)((length & 0x0FU) << 4U));
+    pHdr[2] = (uint8_t)(length >> 4U);
+    pHdr[3] = (uint8_t)(0xFFU - (uint8_t)(pHdr[0] + pHdr[1] + pHdr[2]));
+
+    mH5TxAckPending = FALSE;
+}
+
+/*! *********************************************************************************
+* \brief  SLIP encodes a frame, with its data integrity check, and writes it.
+*
+* \param[in]    pFrame      Frame selected by H5_NextFrame()
+*
+* \return  TRUE if the frame was written.
+*
+* \remarks Called with interrupts enabled, by the writer only.
+*
+********************************************************************************** */
+static bool_t H5_WriteFrame(const h5TxFrame_t* pFrame)
+{
+    uint8_t     crc[mH5CrcLength_c];
+    uint8_t*    pBuffer;
+    uint16_t    frameLength = 0U;
+    uint16_t    value;
+
+    /* Worst case: every byte escaped, plus the two delimiters */
+    pBuffer = MEM_BufferAlloc(2U + 2U * (mH5HeaderLength_c + (uint32_t)pFrame->length + mH5CrcLength_c));
+
+    if( NULL == pBuffer )
+    {
+        return FALSE;
+    }
+
+    pBuffer[frameLength++] = mH5SlipDelimiter_c;
+    frameLength += H5_SlipEncode(&pBuffer[frameLength], pFrame->header, mH5HeaderLength_c);
+    frameLength += H5_SlipEncode(&pBuffer[frameLength], pFrame->pPayload, pFrame->length);
+
+    if( mH5HdrCrcPresent(pFrame->header) )
+    {
+        value = H5_CrcUpdate(0xFFFFU, pFrame->header, mH5HeaderLength_c);
+        value = H5_CrcFinal(H5_CrcUpdate(value, pFrame->pPayload, pFrame->length));
+        Utils_BePackTwoByteValue(value, crc);
+        frameLength += H5_SlipEncode(&pBuffer[frameLength], crc, mH5CrcLength_c);
+    }
+
+    pBuffer[frameLength++] = mH5SlipDelimiter_c;
+
+    return (gBleSuccess_c == Hcit_SerialWrite(pBuffer, frameLength)) ? TRUE : FALSE;
+}
+
+/*! *********************************************************************************
+* \brief  Queues a link control message for the writer. A message not written yet
+*         is replaced.
+*
+* \param[in]    pMessage    Link control message
+* \param[in]    length      Length of the message
+* \param[in]    withConfig  TRUE to append the local configuration field
+*
+* \pre Called with interrupts disabled. H5_Transmit() must be called afterwards.
+*
+********************************************************************************** */
+static void H5_SendLinkControl(const uint8_t* pMessage, uint16_t length, bool_t withConfig)
+{
+    FLib_MemCpy(mH5TxLinkControl, pMessage, length);
+
+    if( withConfig )
+    {
+        mH5TxLinkControl[length] = (uint8_t)(gHcitH5WindowSize_c & mH5CfgWindowMask_c);
+#if gHcitH5UseCrc_d
+        mH5TxLinkControl[length] |= mH5CfgCrc_c;
+#endif
+        length++;
+    }
+
+    mH5TxLinkControlLength = (uint8_t)length;
+}
+
+/*! *********************************************************************************
+* \brief  Goes back to the uninitialized state. Packets not yet acknowledged are sent
+*         again, with new sequence numbers, once the link is active.
+*
+* \pre Called with interrupts disabled.
+*
+********************************************************************************** */
+static void H5_ResetLink(void)
+{
+    mH5LinkState = mH5Uninitialized_c;
+    mH5WindowSize = 1U;
+    mH5UseCrc = FALSE;
+    mH5TxSeq = 0U;
+    mH5RxAck = 0U;
+    mH5TxElapsedMs = 0U;
+    mH5TxAckPending = FALSE;
+
+    /* Put the unacknowledged packets back in front of the pending ones, in order */
+    while( mH5TxUnackedCount > 0U )
+    {
+        mH5TxUnackedCount--;
+        MSG_QueueHead(&mH5TxPending,
+                      mH5TxUnacked[(mH5TxUnackedHead + mH5TxUnackedCount) % NumberOfElements(mH5TxUnacked)]);
+    }
+    mH5TxUnackedHead = 0U;
+    mH5TxUnackedSent = 0U;
+}
+
+/*! *********************************************************************************
+* \brief  Periodic timer. Drives the link establishment and retransmits the packets
+*         not acknowledged in time.
+*
+* \param[in]    pParam      Not used
+*
+********************************************************************************** */
+static void H5_TimerCallback(void* pParam)
+{
+    (void)pParam;
+
+    OSA_InterruptDisable();
+
+    switch( mH5LinkState )
+    {
+        case mH5Uninitialized_c:
+            H5_SendLinkControl(mH5Sync, sizeof(mH5Sync), FALSE);
+            break;
+
+        case mH5Initialized_c:
+            H5_SendLinkControl(mH5Config, sizeof(mH5Config), TRUE);
+            break;
+
+        case mH5Active_c:
+        default:
+            mH5TxElapsedMs += gHcitH5TimerIntervalMs_c;
+
+            if( mH5TxUnackedCount == 0U )
+            {
+                /* Nothing to watch: let the device sleep */
+                mH5TxElapsedMs = 0U;
+                (void)TMR_StopTimer(mH5TimerId);
+            }
+            else if( mH5TxElapsedMs >= gHcitH5RetransmitTimeoutMs_c )
+            {
+                /* Go back N: send the whole window again, with the current ack */
+                mH5TxElapsedMs = 0U;
+                mH5Stats.retransmissions += mH5TxUnackedSent;
+                mH5TxUnackedSent = 0U;
+            }
+            else
+            {
+                /* Wait for the acknowledgement */
+            }
+            break;
+    }
+
+    OSA_InterruptEnable();
+
+    H5_Transmit();
+}
+
+/*! *********************************************************************************
+* \brief  Starts the periodic timer, if not already running.
+*
+********************************************************************************** */
+static void H5_StartTimer(void)
+{
+    if( !TMR_IsTimerActive(mH5TimerId) )
+    {
+        (void)TMR_StartIntervalTimer(mH5TimerId, gHcitH5TimerIntervalMs_c, H5_TimerCallback, NULL);
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Updates the data integrity check: CRC-CCITT (x^16 + x^12 + x^5 + 1),
+*         computed least significant bit first, one byte at a time.
+*
+* \param[in]    crc         Current value, 0xFFFF initially
+* \param[in]    pData       Data
+* \param[in]    length      Length of the data
+*
+* \return  Updated value.
+*
+********************************************************************************** */
+static uint16_t H5_CrcUpdate(uint16_t crc, const uint8_t* pData, uint16_t length)
+{
+    while( length > 0U )
+    {
+        crc = (uint16_t)((crc >> 8U) ^ mH5CrcTable[(uint8_t)(crc ^ *pData)]);
+        pData++;
+        length--;
+    }
+
+    return crc;
+}
+
+/*! *********************************************************************************
+* \brief  Returns the data integrity check as sent on the link: bit-reversed, to be
+*         written most significant byte first.
+*
+* \param[in]    crc         Value returned by H5_CrcUpdate()
+*
+* \return  Data integrity check.
+*
+********************************************************************************** */
+static uint16_t H5_CrcFinal(uint16_t crc)
+{
+    uint16_t    reversed = 0U;
+    uint8_t     bit;
+
+    for( bit = 0U; bit < 16U; bit++ )
+    {
+        reversed = (uint16_t)((reversed << 1U) | ((crc >> bit) & 1U));
+    }
+
+    return reversed;
+}
+
+/*! *********************************************************************************
+* \brief  SLIP encodes a block of data.
+*
+* \param[out]   pDest       Destination, with room for 2 * length bytes
+* \param[in]    pData       Data to encode
+* \param[in]    length      Length of the data
+*
+* \return  Number of bytes written.
+*
+********************************************************************************** */
+static uint16_t H5_SlipEncode(uint8_t* pDest, const uint8_t* pData, uint16_t length)
+{
+    uint16_t written = 0U;
+
+    while( length > 0U )
+    {
+        if( *pData == mH5SlipDelimiter_c )
+        {
+            pDest[written++] = mH5SlipEscape_c;
+            pDest[written++] = mH5SlipEscDelimiter_c;
+        }
+        else if( *pData == mH5SlipEscape_c )
+        {
+            pDest[written++] = mH5SlipEscape_c;
+            pDest[written++] = mH5SlipEscEscape_c;
+        }
+        else
+        {
+            pDest[written++] = *pData;
+        }
+        pData++;
+        length--;
+    }
+
+    return written;
+}
+
+#endif /* gHcitH5Transport_d */
+
+/*! *********************************************************************************
+* @}
+********************************************************************************** */
@@ -0,0 +1,85 @@
+/*! *********************************************************************************
+* \addtogroup HCI
+* @{
+********************************************************************************** */
+/*! *********************************************************************************
+* Copyright 2026 NXP
+* All rights reserved.
+*
+* \file
+*
+* This is the private interface of the Three-wire UART (H5) HCI transport.
+*
+* SPDX-License-Identifier: BSD-3-Clause
+********************************************************************************** */
+
+#ifndef HCIT_H5_H
+#define HCIT_H5_H
+
+/************************************************************************************
+*************************************************************************************
+* Include
+*************************************************************************************
+************************************************************************************/
+#include "hci_transport.h"
+
+/************************************************************************************
+*************************************************************************************
+* Public prototypes
+*************************************************************************************
+************************************************************************************/
+#if gHcitH5Transport_d
+
+/*! *********************************************************************************
+* \brief        Initializes the H5 link and starts the link establishment.
+*
+* \return       gBleSuccess_c or error.
+*
+********************************************************************************** */
+bleResult_t Hcit_H5Init(void);
+
+/*! *********************************************************************************
+* \brief        Feeds bytes received from the serial interface to the H5 decoder.
+*
+* \param[in]    pData       Pointer to the received bytes
+* \param[in]    dataLength  Number of received bytes
+*
+********************************************************************************** */
+void Hcit_H5ReceiveData(const uint8_t* pData, uint16_t dataLength);
+
+/*! *********************************************************************************
+* \brief        Sends an HCI packet over the H5 link.
+*
+* \param[in]    packetType  HCI packet type
+* \param[in]    pPacket     HCI packet
+* \param[in]    packetSize  Size of the HCI packet
+*
+* \return       gBleSuccess_c or error.
+*
+* \remarks      The packet is copied. Command, ACL and event packets are reliable
+*               and are queued until the link is active.
+*
+********************************************************************************** */
+bleResult_t Hcit_H5SendPacket(hciPacketType_t packetType, const void* pPacket, uint16_t packetSize);
+
+/*! *********************************************************************************
+* \brief        Writes an encoded frame to the serial interface.
+*
+* \param[in]    pBuffer     Frame allocated with MEM_BufferAlloc()
+* \param[in]    length      Length of the frame
+*
+* \return       gBleSuccess_c or error.
+*
+* \remarks      Implemented by the serial interface. The buffer is freed when the
+*               write completes or fails.
+*
+********************************************************************************** */
+bleResult_t Hcit_SerialWrite(uint8_t* pBuffer, uint16_t length);
+
+#endif /* gHcitH5Transport_d */
+
+#endif /* HCIT_H5_H */
+
+/*! *********************************************************************************
+* @}
+********************************************************************************** */
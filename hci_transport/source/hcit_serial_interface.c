@@ -18,15 +18,110 @@
 *************************************************************************************
 ************************************************************************************/
 #include "MemManager.h"
+#if gHcitTxCoalescing_d || gHcitStatistics_d || gHcitBaudRateUpgrade_d || gHcitHostFlowControl_d || gHcitAclRxDemux_d
+#include "TimersManager.h"
+#endif
+#if gHcitAclScheduler_d || gHcitHostFlowControl_d || gHcitAclRxDemux_d
+#include "ble_config.h"
+#endif
+#if gHcitH5Transport_d
+#include "hcit_h5.h"
+#endif
+#if gHcitSnoop_d
+#include "hcit_btsnoop.h"
+#endif
 
 #include "ble_general.h"
 #include "hci_transport.h"
 
+/* Replaced by hcit_shmem_interface.c */
+#if !gHcitSharedMemory_d
+
 /************************************************************************************
 *************************************************************************************
 * Private macros
 *************************************************************************************
 ************************************************************************************/
+/* Receive buffer sizes. Command packets (Upward HCI Transport) use the event pool. */
+#define mHcitRxEventBufferSize_c    (gHciCommandPacketHeaderLength_c + 255U)
+#define mHcitRxAclBufferSize_c      (gHcitMaxPayloadLen_c)
+/* Synchronous packets carry up to 255 bytes */
+#define mHcitRxIsoBufferSize_c      ((((uint32_t)mHcitIsoHeaderLength_c + gHcitIsoMaxDataLength_c) > (mHcitSyncHeaderLength_c + 255U)) ? \
+                                     ((uint32_t)mHcitIsoHeaderLength_c + gHcitIsoMaxDataLength_c) : (mHcitSyncHeaderLength_c + 255U))
+
+#define mHcitSyncHeaderLength_c     (3U)
+#define mHcitIsoHeaderLength_c      (4U)
+#define mHcitIsoDataLengthMask_c    (0x3FFFU)
+#define mHcitIsoTsFlag_c            (0x4000U)
+#define mHcitIsoPbFirstFragment_c   (0x00U)
+#define mHcitIsoPbComplete_c        (0x02U)
+
+/* Size of the scratch area used to skip the payload of dropped packets */
+#define mHcitRxDiscardChunkSize_c   (16U)
+
+/* Number of bytes read at once from the serial interface by the H5 decoder */
+#define mHcitH5RxChunkSize_c        (32U)
+
+#if (gHcitRxEventBufferCount_c > 32U) || (gHcitRxAclBufferCount_c > 32U) || \
+    ((gHcitIsoSupport_d) && (gHcitRxIsoBufferCount_c > 32U))
+#error "A receive buffer pool supports at most 32 buffers"
+#endif
+
+#define mHcitAclInvalidHandle_c     (0xFFFFU)
+#define mHcitAclHandleMask_c        (0x0FFFU)
+
+/* Offset of the HCI packet in the buffers allocated by Hcit_AllocPacket() */
+#define mHcitTxPacketOffset_c       (sizeof(hcitTxPacket_t) + gHcitTxHeadroom_c)
+
+/* Setup of the Controller run after each HCI Reset */
+#define mHcitResetSetup_d           ((gHcitBaudRateUpgrade_d) || (gHcitHostFlowControl_d))
+
+/* TRUE when the baud rate upgrade lost the Controller: the setup cannot go on */
+#if gHcitBaudRateUpgrade_d
+    #define mHcitSetupLinkLost()    (mHcitBaudRate == 0U)
+#else
+    #define mHcitSetupLinkLost()    (FALSE)
+#endif
+
+/* Packet bytes of a copy made by the ACL receive demultiplexing */
+#define mHcitAclRxPacketData(pCopy) ((uint8_t*)&(pCopy)[1])
+
+/* ACL packets held by the ACL receive demultiplexing */
+#if gHcitAclRxDemux_d
+    #define mHcitAclRxHeld()        ((uint32_t)mHcitAclRxHeld)
+#else
+    #define mHcitAclRxHeld()        (0U)
+#endif
+
+/* Parameters of Host Number Of Completed Packets */
+#define mHcitHfcMaxParamsLength_c   (1U + 4U * (gHcitAclMaxLinks_c))
+
+/* Statistics hooks */
+#if gHcitStatistics_d
+    #define mHcitStatsCount(counter)        Hcit_StatsCount(&mHcitStats.counter)
+    #define mHcitStatsPacket(type, pPacket, size, received) \
+                                            Hcit_StatsPacket((type), (const uint8_t*)(pPacket), (size), (received))
+    #define mHcitStatsTxWriteStarted()      Hcit_StatsTxQueue(TRUE)
+    #define mHcitStatsTxWriteDone()         Hcit_StatsTxQueue(FALSE)
+    #define mHcitTxBufferWrittenCb          Hcit_TxBufferWritten
+#else
+    #define mHcitStatsCount(counter)
+    #define mHcitStatsPacket(type, pPacket, size, received)
+    #define mHcitStatsTxWriteStarted()
+    #define mHcitStatsTxWriteDone()
+    #define mHcitTxBufferWrittenCb          ((pSerialCallBack_t)MEM_BufferFree)
+#endif
+
+/* Capture hook */
+#if gHcitSnoop_d
+    #define mHcitSnoopPacket(type, pPacket, size, received) \
+                                            Hcit_SnoopPacket((type), (const uint8_t*)(pPacket), (size), (received))
+#else
+    #define mHcitSnoopPacket(type, pPacket, size, received)
+#endif
+
+/* Upper bounds of the command latency histogram buckets, in microseconds */
+#define mHcitLatencyBucketBoundsUs_c    {1000U, 2000U, 5000U, 10000U, 20000U, 50000U, 100000U}
 
 /************************************************************************************
 *************************************************************************************
@@ -47,6 +142,24 @@ typedef PACKED_STRUCT hciAclDataPacketHeader_tag
     uint16_t    dataTotalLength;
 }hciAclDataPacketHeader_t;
 
+typedef PACKED_STRUCT hciSyncDataPacketHeader_tag
+{
+    uint16_t    handle      :12;
+    uint16_t    statusFlag  :2;
+    uint16_t    rfu         :2;
+    uint8_t     dataTotalLength;
+}hciSyncDataPacketHeader_t;
+
+typedef PACKED_STRUCT hciIsoDataPacketHeader_tag
+{
+    uint16_t    handle      :12;
+    uint16_t    pbFlag      :2;
+    uint16_t    tsFlag      :1;
+    uint16_t    rfu         :1;
+    uint16_t    dataTotalLength :14;
+    uint16_t    rfu2        :2;
+}hciIsoDataPacketHeader_t;
+
 typedef PACKED_STRUCT hciEventPacketHeader_tag
 {
     hciEventCode_t  eventCode;
@@ -59,6 +172,8 @@ typedef PACKED_STRUCT hcitPacketHdr_tag
     PACKED_UNION
     {
         hciAclDataPacketHeader_t    aclDataPacket;
+        hciSyncDataPacketHeader_t   syncDataPacket;
+        hciIsoDataPacketHeader_t    isoDataPacket;
         hciEventPacketHeader_t      eventPacket;
         hciCommandPacketHeader_t    commandPacket;
     };
@@ -88,30 +203,353 @@ typedef uint8_t detectState_t;
 typedef enum{
     mDetectMarker_c       = 0,
     mDetectHeader_c,
-    mPacketInProgress_c
+    mPacketInProgress_c,
+    mPacketDiscard_c
 }detectState_tag;
 
+typedef struct hcitRxPool_tag
+{
+    uint8_t*    pBuffers;
+    uint16_t    bufferSize;
+    uint8_t     bufferCount;
+    uint32_t    inUseMask;      /* Bit n is set while buffer n is owned by the parser or the upper layer */
+}hcitRxPool_t;
+
+typedef enum{
+    mHcitRxEventPool_c    = 0,
+    mHcitRxAclPool_c,
+#if gHcitIsoSupport_d
+    mHcitRxIsoPool_c,
+#endif
+    mHcitRxPoolCount_c
+}hcitRxPoolId_t;
+
+/* Kept in front of the headroom of the packets allocated with Hcit_AllocPacket(),
+   to queue them until they are written */
+typedef struct hcitTxPacket_tag
+{
+    struct hcitTxPacket_tag*    pNext;
+    uint16_t                    packetSize;
+    hciPacketType_t             packetType;
+}hcitTxPacket_t;
+
+#if gHcitTxCoalescing_d
+typedef uint8_t hcitTxBufferState_t;
+typedef enum{
+    mHcitTxBufferFree_c    = 0,
+    mHcitTxBufferFilling_c,
+    mHcitTxBufferQueued_c       /* Handed to the serial interface */
+}hcitTxBufferState_tag;
+
+typedef struct hcitTxBuffer_tag
+{
+    hcitTxBufferState_t state;
+    uint16_t            length;
+    uint8_t             data[gHcitTxCoalesceBufferSize_c];
+}hcitTxBuffer_t;
+#endif /* gHcitTxCoalescing_d */
+
+#if gHcitAclScheduler_d
+typedef struct hcitAclTxEntry_tag
+{
+    void*       pPacket;            /* Allocated with Hcit_AllocPacket() */
+    uint16_t    packetSize;
+}hcitAclTxEntry_t;
+
+typedef struct hcitAclLink_tag
+{
+    uint16_t            handle;     /* mHcitAclInvalidHandle_c if the slot is free */
+    uint16_t            inFlight;   /* Packets sent and not yet reported as completed */
+    uint8_t             weight;     /* Packets sent per scheduling round */
+    uint8_t             quantum;    /* Packets left in the current round */
+    uint8_t             head;
+    uint8_t             count;
+    hcitAclTxEntry_t    queue[gHcitAclQueueDepth_c];
+}hcitAclLink_t;
+#endif /* gHcitAclScheduler_d */
+
+#if gHcitAclRxDemux_d
+/* Kept in front of the copies of the received packets, to queue them until they are
+   given to the Host */
+typedef struct hcitAclRxPacket_tag
+{
+    struct hcitAclRxPacket_tag* pNext;
+    uint16_t                    packetSize;
+    hciPacketType_t             packetType;
+}hcitAclRxPacket_t;
+
+typedef struct hcitAclRxLink_tag
+{
+    uint16_t            handle;     /* mHcitAclInvalidHandle_c if the slot is free */
+    hcitAclRxPacket_t*  pHead;
+    hcitAclRxPacket_t*  pTail;
+    hcitAclRxStats_t    stats;      /* stats.queued is the number of held packets */
+}hcitAclRxLink_t;
+#endif /* gHcitAclRxDemux_d */
+
+#if gHcitCmdPipelining_d
+typedef struct hcitCmdTxEntry_tag
+{
+    void*       pPacket;            /* Allocated with Hcit_AllocPacket() */
+    uint16_t    packetSize;
+}hcitCmdTxEntry_t;
+#endif /* gHcitCmdPipelining_d */
+
+#if mHcitResetSetup_d
+typedef uint8_t hcitSetupStep_t;
+typedef enum{
+    mHcitSetupIdle_c      = 0,  /* Reset Command Complete not held */
+    mHcitSetupBaudRate_c,
+    mHcitSetupFlowControl_c,
+    mHcitSetupDone_c
+}hcitSetupStep_tag;
+#endif /* mHcitResetSetup_d */
+
+#if gHcitBaudRateUpgrade_d
+typedef uint8_t hcitBaudState_t;
+typedef enum{
+    mHcitBaudIdle_c       = 0,
+    mHcitBaudSwitching_c,       /* Vendor command sent */
+    mHcitBaudSettling_c,        /* Waiting for the Controller to switch */
+    mHcitBaudVerifying_c,       /* Ping sent at the upgrade baud rate */
+    mHcitBaudFallback_c         /* Ping sent at the previous baud rate */
+}hcitBaudState_tag;
+#endif /* gHcitBaudRateUpgrade_d */
+
+#if gHcitHostFlowControl_d
+typedef uint8_t hcitHfcState_t;
+typedef enum{
+    mHcitHfcDisabled_c    = 0,
+    mHcitHfcBufferSize_c,       /* Host Buffer Size sent */
+    mHcitHfcEnabling_c,         /* Set Controller To Host Flow Control sent */
+    mHcitHfcEnabled_c
+}hcitHfcState_tag;
+
+typedef struct hcitHfcLink_tag
+{
+    uint16_t    handle;         /* mHcitAclInvalidHandle_c if the slot is free */
+    uint16_t    inUse;          /* Packets received and not yet released */
+    uint16_t    completed;      /* Packets released and not yet reported to the Controller */
+}hcitHfcLink_t;
+#endif /* gHcitHostFlowControl_d */
+
+#if gHcitStatistics_d
+typedef struct hcitPendingCmd_tag
+{
+    uint64_t    timestamp;      /* Time the command went through the transport */
+    uint16_t    opcode;         /* 0 if the entry is free */
+}hcitPendingCmd_t;
+#endif /* gHcitStatistics_d */
+
 /************************************************************************************
 *************************************************************************************
 * Private memory declarations
 *************************************************************************************
 ************************************************************************************/
 static bool_t   mHcitInit = FALSE;
+#if gHcitSerialManagerSupport_d
 static uint8_t  gHcitSerMgrIf;
+#else
+static hcitWriteInterface_t mWriteInterface = NULL;
+#endif
 
 static hcitComm_t mHcitData;
 static hciTransportInterface_t  mTransportInterface;
 
 static detectState_t  mPacketDetectStep;
 
-static hcitPacket_t mHcitPacketRaw;
+/* Receive buffer pools. A buffer is taken when a valid header is received and is
+   given back after the transport interface is done with the packet. */
+static uint8_t mHcitRxEventBuffers[gHcitRxEventBufferCount_c][mHcitRxEventBufferSize_c];
+static uint8_t mHcitRxAclBuffers[gHcitRxAclBufferCount_c][mHcitRxAclBufferSize_c];
+#if gHcitIsoSupport_d
+static uint8_t mHcitRxIsoBuffers[gHcitRxIsoBufferCount_c][mHcitRxIsoBufferSize_c];
+#endif
+
+static hcitRxPool_t mHcitRxPools[mHcitRxPoolCount_c] =
+{
+    { &mHcitRxEventBuffers[0][0], mHcitRxEventBufferSize_c, gHcitRxEventBufferCount_c, 0U },
+    { &mHcitRxAclBuffers[0][0],   mHcitRxAclBufferSize_c,   gHcitRxAclBufferCount_c,   0U },
+#if gHcitIsoSupport_d
+    { &mHcitRxIsoBuffers[0][0],   mHcitRxIsoBufferSize_c,   gHcitRxIsoBufferCount_c,   0U },
+#endif
+};
+
+static uint8_t mHcitRxDiscardBuffer[mHcitRxDiscardChunkSize_c];
+
+#if gHcitIsoSupport_d
+static hcitIsoDataCallback_t mpfHcitIsoDataCallback = NULL;
+#endif
+
+/* Packets waiting to be written. They are queued with interrupts disabled and
+   written by one context at a time, the TX writer, with interrupts enabled. */
+static hcitTxPacket_t*  mpHcitTxHead = NULL;
+static hcitTxPacket_t*  mpHcitTxTail = NULL;
+static bool_t           mHcitTxRunning = FALSE;
+
+#if gHcitTxCoalescing_d
+/* Double buffer: one is filled while the other one is being written.
+   The buffer being filled is owned by the TX writer. */
+static hcitTxBuffer_t           mHcitTxBuffers[2];
+static hcitTxBuffer_t*          mpHcitTxFilling = NULL;
+static bool_t                   mHcitTxFlushRequest = FALSE;
+static tmrTimerID_t             mHcitTxTimerId = gTmrInvalidTimerID_c;
+static hcitTxCoalesceStats_t    mHcitTxStats;
+#endif
+
+#if gHcitAclScheduler_d
+static hcitAclLink_t    mHcitAclLinks[gHcitAclMaxLinks_c];
+static uint16_t         mHcitAclTotalCredits = 0U;  /* 0 until the Controller buffers are known */
+static uint16_t         mHcitAclFreeCredits = 0U;
+static bool_t           mHcitAclLeBuffers = FALSE;
+static uint8_t          mHcitAclRrIndex = 0U;
+#endif
+
+#if gHcitCmdPipelining_d
+static hcitCmdTxEntry_t mHcitCmdQueue[gHcitCmdQueueDepth_c];
+static uint8_t          mHcitCmdHead = 0U;
+static uint8_t          mHcitCmdCount = 0U;
+static uint8_t          mHcitCmdCredits = 1U;       /* Commands the Controller accepts now */
+#endif
+
+#if gHcitHostFlowControl_d
+static hcitHfcState_t   mHcitHfcState = mHcitHfcDisabled_c;
+static hcitHfcLink_t    mHcitHfcLinks[gHcitAclMaxLinks_c];
+static uint16_t         mHcitHfcCompleted = 0U;     /* Sum of the completed counters */
+static tmrTimerID_t     mHcitHfcTimerId = gTmrInvalidTimerID_c;
+#endif
+
+#if gHcitHostFlowControl_d || gHcitAclRxDemux_d
+static hcitHostAclPending_t mpfHcitHostAclPending = NULL;
+#endif
+
+#if gHcitAclRxDemux_d
+/* Packets are given to the Host by one context at a time, the deliverer. The other
+   contexts leave a copy of their packets in the deferred queue. */
+static hcitAclRxLink_t      mHcitAclRxLinks[gHcitAclMaxLinks_c];
+static hcitAclRxPacket_t*   mpHcitAclRxDeferredHead = NULL;
+static hcitAclRxPacket_t*   mpHcitAclRxDeferredTail = NULL;
+static bool_t               mHcitAclRxRunning = FALSE;
+static bool_t               mHcitAclRxResetPending = FALSE;
+static uint16_t             mHcitAclRxHeld = 0U;        /* Sum of the held packets */
+static uint8_t              mHcitAclRxRrIndex = 0U;
+static tmrTimerID_t         mHcitAclRxTimerId = gTmrInvalidTimerID_c;
+#endif
+
+#if mHcitResetSetup_d
+static hcitSetupStep_t  mHcitSetupStep = mHcitSetupIdle_c;
+static hcitPacket_t*    mpHcitResetEvent = NULL;    /* Held until the setup is done */
+static uint16_t         mHcitResetEventLength;
+static uint8_t          mHcitSetupCmdCredits;       /* Reported by the last Command Complete */
+#endif
+
+#if gHcitBaudRateUpgrade_d
+static hcitBaudState_t          mHcitBaudState = mHcitBaudIdle_c;
+static uint32_t                 mHcitBaudRate;
+static uint32_t                 mHcitBaudFallbackRate;
+static uint32_t                 mHcitBaudTarget = gHcitUpgradeSpeed_d;
+static hcitBaudRateCallback_t   mpfHcitBaudCallback = NULL;
+static tmrTimerID_t             mHcitBaudTimerId = gTmrInvalidTimerID_c;
+static bool_t                   mHcitBaudVendorPending = FALSE; /* Vendor command not answered yet */
+#endif
+
+#if gHcitStatistics_d
+static hcitStats_t      mHcitStats;
+static hcitCmdLatency_t mHcitCmdLatency[gHcitStatsMaxOpcodes_c];
+static hcitPendingCmd_t mHcitPendingCmds[gHcitStatsMaxPendingCmds_c];
+static const uint32_t   mHcitLatencyBucketBounds[gHcitLatencyBucketCount_c - 1U] = mHcitLatencyBucketBoundsUs_c;
+static bool_t           mHcitRxOutOfSync = FALSE;   /* Set from the first skipped byte to the next marker */
+#endif
 /************************************************************************************
 *************************************************************************************
 * Private functions prototypes
 *************************************************************************************
 ************************************************************************************/
+#if gHcitSerialManagerSupport_d
 static void Hcit_RxCallBack(void *pData);
+#endif
+static bleResult_t Hcit_Write(uint8_t* pBuffer, uint16_t length, pSerialCallBack_t pfWriteComplete, void* pParam);
+static bleResult_t Hcit_WritePacket(hciPacketType_t packetType, void* pPacket, uint16_t packetSize);
+static void Hcit_TxQueue(hciPacketType_t packetType, void* pPacket, uint16_t packetSize);
+static void Hcit_TxRun(void);
+static void Hcit_TxWrite(hcitTxPacket_t* pTxPacket);
 static void Hcit_SendMessage(void);
+static void Hcit_GetRxWindow(uint8_t** ppWindow, uint16_t* pWindowLength);
+static void Hcit_RxWindowFilled(uint16_t length);
+static uint16_t Hcit_GetHeaderLength(hciPacketType_t packetType);
+static void Hcit_HeaderReceived(void);
+static hcitPacket_t* Hcit_RxBufferAlloc(hciPacketType_t packetType);
+#if gHcitIsoSupport_d
+static bleResult_t Hcit_CheckDataPacket(hciPacketType_t packetType, const uint8_t* pPacket, uint16_t packetSize);
+static void Hcit_IsoDataReceived(const uint8_t* pPacket, uint16_t packetSize);
+#endif
+#if gHcitTxCoalescing_d
+static bool_t Hcit_TxCoalesce(hciPacketType_t packetType, const uint8_t* pData, uint16_t length);
+static void Hcit_TxFlush(void);
+static void Hcit_TxWriteComplete(void* pParam);
+static void Hcit_TxTimeout(void* pParam);
+#endif
+#if gHcitAclScheduler_d
+static bleResult_t Hcit_AclEnqueue(void* pPacket, uint16_t packetSize);
+static hcitAclLink_t* Hcit_AclGetLink(uint16_t handle, bool_t allocate);
+static void Hcit_AclReleaseLink(hcitAclLink_t* pLink);
+static void Hcit_AclProcessEvent(const uint8_t* pEvent, uint16_t length);
+static void Hcit_AclSchedule(void);
+#endif
+#if gHcitCmdPipelining_d
+static bleResult_t Hcit_CmdEnqueue(void* pPacket, uint16_t packetSize);
+static void Hcit_CmdProcessEvent(uint8_t* pEvent, uint16_t length);
+static void Hcit_CmdSchedule(void);
+#endif
+#if mHcitResetSetup_d
+static bool_t Hcit_SetupProcessEvent(hcitPacket_t* pPacket, uint16_t length);
+static void Hcit_SetupContinue(void);
+static bleResult_t Hcit_SendTransportCommand(uint16_t opcode, const uint8_t* pParams, uint8_t paramsLength);
+#endif
+#if gHcitBaudRateUpgrade_d
+static bool_t Hcit_BaudStart(void);
+static bool_t Hcit_BaudCommandComplete(uint16_t opcode, bool_t success);
+static void Hcit_BaudTimeout(void* pParam);
+static void Hcit_BaudDone(void);
+#endif
+#if gHcitHostFlowControl_d
+static bool_t Hcit_HfcStart(void);
+static bool_t Hcit_HfcCommandComplete(uint16_t opcode, bool_t success);
+static bool_t Hcit_HfcProcessEvent(hcitPacket_t* pPacket, uint16_t length);
+static void Hcit_HfcPacketReceived(const uint8_t* pPacket);
+static void Hcit_HfcPacketReleased(uint16_t handle, bool_t poolFree);
+static void Hcit_HfcReport(bool_t poolFree);
+static void Hcit_HfcTimeout(void* pParam);
+static hcitHfcLink_t* Hcit_HfcGetLink(uint16_t handle, bool_t allocate);
+static void Hcit_HfcResetLinks(void);
+#endif
+#if gHcitHostFlowControl_d
+static uint32_t Hcit_HostAclPending(void);
+#endif
+#if gHcitAclRxDemux_d
+static void Hcit_AclRxReceive(hciPacketType_t packetType, void* pPacket, uint16_t packetSize);
+static void Hcit_AclRxProcessEvent(const uint8_t* pEvent, uint16_t length);
+static void Hcit_AclRxRun(bool_t running);
+static void Hcit_AclRxDispatch(hciPacketType_t packetType, void* pPacket, uint16_t packetSize, hcitAclRxPacket_t* pCopy);
+static void Hcit_AclRxHold(hcitAclRxLink_t* pLink, hcitAclRxPacket_t* pCopy);
+static void Hcit_AclRxDeliver(hcitAclRxLink_t* pLink);
+static void Hcit_AclRxFlushLink(hcitAclRxLink_t* pLink);
+static void Hcit_AclRxDrain(void);
+static void Hcit_AclRxDiscard(void);
+static void Hcit_AclRxTimeout(void* pParam);
+static bool_t Hcit_AclRxHostBusy(void);
+static hcitAclRxPacket_t* Hcit_AclRxCopy(hciPacketType_t packetType, const void* pPacket, uint16_t packetSize);
+static hcitAclRxLink_t* Hcit_AclRxGetLink(uint16_t handle, bool_t allocate);
+static void Hcit_AclRxFreeLink(hcitAclRxLink_t* pLink);
+#endif
+#if gHcitStatistics_d
+static void Hcit_StatsCount(uint32_t* pCounter);
+static void Hcit_StatsPacket(hciPacketType_t packetType, const uint8_t* pPacket, uint16_t packetSize, bool_t received);
+static void Hcit_StatsCommandSent(uint16_t opcode);
+static void Hcit_StatsCommandCompleted(uint16_t opcode);
+static void Hcit_StatsTxQueue(bool_t started);
+static void Hcit_TxBufferWritten(void* pParam);
+#endif
 
 /************************************************************************************
 *************************************************************************************
@@ -154,6 +592,9 @@ bleResult_t Hcit_Init( hcitConfigStruct_t* hcitConfigStruct )
     bleResult_t result = gHciSuccess_c;
 #if gHcitSerialManagerSupport_d
     serialStatus_t serialStatus = gSerial_Success_c;
+#endif
+#if gHcitAclScheduler_d || gHcitAclRxDemux_d
+    uint32_t i;
 #endif
     if( mHcitInit == FALSE )
     {
@@ -187,6 +628,67 @@ bleResult_t Hcit_Init( hcitConfigStruct_t* hcitConfigStruct )
 
         /* Install Controller Events Callback handler */
         Serial_SetRxCallBack(gHcitSerMgrIf, Hcit_RxCallBack, NULL);
+#else
+        /* Received bytes are given through Hcit_InterfaceDataReceived() */
+        mWriteInterface = hcitConfigStruct->writeInterface;
+
+        if (mWriteInterface == NULL)
+        {
+            return gBleInvalidParameter_c;
+        }
+#endif
+#if gHcitH5Transport_d
+        if (Hcit_H5Init() != gBleSuccess_c)
+        {
+            return gHciTransportError_c;
+        }
+#endif
+#if gHcitTxCoalescing_d
+        mHcitTxTimerId = TMR_AllocateTimer();
+
+        if (mHcitTxTimerId == gTmrInvalidTimerID_c)
+        {
+            return gHciTransportError_c;
+        }
+#endif
+#if gHcitAclScheduler_d
+        for( i = 0U; i < gHcitAclMaxLinks_c; i++ )
+        {
+            Hcit_AclReleaseLink(&mHcitAclLinks[i]);
+        }
+#endif
+#if gHcitHostFlowControl_d || gHcitAclRxDemux_d
+        mpfHcitHostAclPending = hcitConfigStruct->pfHostAclPending;
+#endif
+#if gHcitAclRxDemux_d
+        for( i = 0U; i < gHcitAclMaxLinks_c; i++ )
+        {
+            Hcit_AclRxFreeLink(&mHcitAclRxLinks[i]);
+        }
+        mHcitAclRxTimerId = TMR_AllocateTimer();
+
+        if (mHcitAclRxTimerId == gTmrInvalidTimerID_c)
+        {
+            return gHciTransportError_c;
+        }
+#endif
+#if gHcitHostFlowControl_d
+        Hcit_HfcResetLinks();
+        mHcitHfcTimerId = TMR_AllocateTimer();
+
+        if (mHcitHfcTimerId == gTmrInvalidTimerID_c)
+        {
+            return gHciTransportError_c;
+        }
+#endif
+#if gHcitBaudRateUpgrade_d
+        mHcitBaudRate = hcitConfigStruct->interfaceBaudrate;
+        mHcitBaudTimerId = TMR_AllocateTimer();
+
+        if (mHcitBaudTimerId == gTmrInvalidTimerID_c)
+        {
+            return gHciTransportError_c;
+        }
 #endif
         /* Flag initialization on module */
         mHcitInit = TRUE;
@@ -223,18 +725,18 @@ bleResult_t Hcit_SendPacket
 {
     uint8_t*        pSerialPacket = NULL;
     bleResult_t     result = gBleSuccess_c;
-    serialStatus_t  status = gSerial_Success_c;
-    
-    pSerialPacket = MEM_BufferAlloc(1+packetSize);
+
+    /* The caller keeps its buffer, so the packet is copied once behind the headroom */
+    pSerialPacket = Hcit_AllocPacket(packetSize);
     if( NULL != pSerialPacket )
     {
-        pSerialPacket[0] = packetType;
-        FLib_MemCpy(pSerialPacket+1, (uint8_t*)pPacket, packetSize);
-        status = Serial_AsyncWrite(gHcitSerMgrIf, pSerialPacket, 1+packetSize, (pSerialCallBack_t)MEM_BufferFree, pSerialPacket);
-        if( gSerial_Success_c != status )
+        FLib_MemCpy(pSerialPacket, (uint8_t*)pPacket, packetSize);
+        result = Hcit_SendAllocatedPacket(packetType, pSerialPacket, packetSize);
+
+        if( result == gBleOverflow_c )
         {
-            MEM_BufferFree(pSerialPacket);
-            result = gHciTransportError_c;
+            /* The queue is full: the Host gets the error and keeps its packet */
+            Hcit_FreePacket(pSerialPacket);
         }
     }
     else
@@ -246,185 +748,3039 @@ bleResult_t Hcit_SendPacket
 }
 
 /*! *********************************************************************************
-* \brief  
+* \brief  Allocates a packet buffer with room for the HCI transport header.
 *
-* \param[in]    
+* \param[in]    packetSize  Size of the HCI packet, without the transport header
 *
-* \param[out]   
+* \return  Pointer to the packet payload, or NULL if there is not enough memory.
 *
-* \return  
+********************************************************************************** */
+void* Hcit_AllocPacket(uint16_t packetSize)
+{
+    uint8_t* pBuffer = MEM_BufferAlloc(mHcitTxPacketOffset_c + (uint32_t)packetSize);
+
+    if( NULL != pBuffer )
+    {
+        mHcitStatsCount(txAllocations);
+        pBuffer += mHcitTxPacketOffset_c;
+    }
+    else
+    {
+        mHcitStatsCount(txAllocFailures);
+    }
+
+    return pBuffer;
+}
+
+/*! *********************************************************************************
+* \brief  Frees a packet allocated with Hcit_AllocPacket() that was not sent.
 *
-* \pre 
+* \param[in]    pPacket     Pointer returned by Hcit_AllocPacket()
 *
-* \remarks 
+********************************************************************************** */
+void Hcit_FreePacket(void* pPacket)
+{
+    if( NULL != pPacket )
+    {
+        (void)MEM_BufferFree((uint8_t*)pPacket - mHcitTxPacketOffset_c);
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Sends a packet allocated with Hcit_AllocPacket() without copying it.
+*
+* \param[in]    packetType  HCI packet type
+* \param[in]    pPacket     Pointer returned by Hcit_AllocPacket()
+* \param[in]    packetSize  Size of the HCI packet, without the transport header
+*
+* \return  gBleSuccess_c or error.
+*
+* \remarks The transport takes ownership of the packet, except on gBleOverflow_c.
+*          ACL packets go through the ACL scheduler and commands through the command
+*          queue, when enabled.
 *
 ********************************************************************************** */
-bleResult_t Hcit_RecvPacket
+bleResult_t Hcit_SendAllocatedPacket
     (
+        hciPacketType_t packetType,
         void*           pPacket,
         uint16_t        packetSize
     )
 {
-    bleResult_t result = gHciSuccess_c;
+    bleResult_t result = gBleSuccess_c;
 
-    uint8_t* aData = (uint8_t*) pPacket;
-    uint8_t type = aData[0];
-    
-    if (type != 0x01 && type != 0x02 && type != 0x04)
+#if gHcitIsoSupport_d
+    if( gBleSuccess_c != Hcit_CheckDataPacket(packetType, (const uint8_t*)pPacket, packetSize) )
     {
-        result = /* Something more meaningful? */ gHciTransportError_c;
+        Hcit_FreePacket(pPacket);
+        return gBleInvalidParameter_c;
+    }
+#endif
+
+#if gHcitAclScheduler_d
+    if( packetType == gHciDataPacket_c )
+    {
+        result = Hcit_AclEnqueue(pPacket, packetSize);
     }
     else
+#endif
+#if gHcitCmdPipelining_d
+    if( packetType == gHciCommandPacket_c )
     {
-        hciPacketType_t packetType = (hciPacketType_t) type;    
-        result = Ble_HciRecv
-        (
-            packetType,
-            aData + 1,
-            packetSize - 1
-        );
-
-        MEM_BufferFree( pPacket );  ///TODO: Verify here in FSCI
+        result = Hcit_CmdEnqueue(pPacket, packetSize);
+    }
+    else
+#endif
+    {
+        result = Hcit_WritePacket(packetType, pPacket, packetSize);
     }
 
     return result;
 }
 
-void hci_processReceivedChar(uint8_t recvChar)
+#if gHcitH5Transport_d
+/*! *********************************************************************************
+* \brief  Writes an encoded H5 frame to the serial interface.
+*
+* \param[in]    pBuffer     Frame allocated with MEM_BufferAlloc()
+* \param[in]    length      Length of the frame
+*
+* \return  gBleSuccess_c or gHciTransportError_c.
+*
+* \remarks The buffer is freed when the write completes or fails.
+*
+********************************************************************************** */
+bleResult_t Hcit_SerialWrite(uint8_t* pBuffer, uint16_t length)
 {
-    switch( mPacketDetectStep )
-    {
-        case mDetectMarker_c:
-            if( (recvChar == gHciDataPacket_c) || (recvChar == gHciEventPacket_c) ||
-                (recvChar == gHciCommandPacket_c) )
-            {
-                mHcitData.pPacket = (hcitPacket_t*)&mHcitData.pktHeader;
-
-                mHcitData.pktHeader.packetTypeMarker = (hciPacketType_t)recvChar;
-                mHcitData.bytesReceived = 1;
-
-                mPacketDetectStep = mDetectHeader_c;
-            }
-            break;
-
-        case mDetectHeader_c:
-            mHcitData.pPacket->raw[mHcitData.bytesReceived++] = recvChar;
-            switch( mHcitData.pktHeader.packetTypeMarker ) 
-            {
-                case gHciDataPacket_c:
-                    /* ACL Data Packet */
-                    if( mHcitData.bytesReceived == (gHciAclDataPacketHeaderLength_c + 1) )
-                    {
-                        /* Validate ACL Data packet length */
-                        if( mHcitData.pktHeader.aclDataPacket.dataTotalLength > gHcLeAclDataPacketLengthDefault_c )
-                        {
-                            mHcitData.pPacket = NULL;
-                            mPacketDetectStep = mDetectMarker_c;
-                            break;
-                        }
-                        mHcitData.expectedLength = gHciAclDataPacketHeaderLength_c +
-                                                    mHcitData.pktHeader.aclDataPacket.dataTotalLength;
-                        
-                        mPacketDetectStep = mPacketInProgress_c;
-                    }
-                    break;
-
-                case gHciEventPacket_c:
-                    /* HCI Event Packet */
-                    if( mHcitData.bytesReceived == (gHciEventPacketHeaderLength_c + 1) )
-                    {
-                        /* Validate HCI Event packet length
-                        if( mHcitData.pktHeader.eventPacket.dataTotalLength > gHcEventPacketLengthDefault_c )
-                        {
-                            mHcitData.pPacket = NULL;
-                            mPacketDetectStep = mDetectMarker_c;
-                            break;
-                        } */
-                        mHcitData.expectedLength = gHciEventPacketHeaderLength_c +
-                                                    mHcitData.pktHeader.eventPacket.dataTotalLength;
-                        mPacketDetectStep = mPacketInProgress_c;
-                    }
-                    break;
-
-                case gHciCommandPacket_c:           
-                    /* HCI Command Packet */
-                    if( mHcitData.bytesReceived == (gHciCommandPacketHeaderLength_c + 1) )
-                    {
-
-                        mHcitData.expectedLength = gHciCommandPacketHeaderLength_c +
-                                                    mHcitData.pktHeader.commandPacket.parameterTotalLength;
-                        mPacketDetectStep = mPacketInProgress_c;
-                    }
-                    break;
-                case gHciSynchronousDataPacket_c:   
-                default:
-                    /* Not Supported */
-                    break;
-            }
-
-            if( mPacketDetectStep == mPacketInProgress_c )
-            {
-                mHcitData.pPacket = &mHcitPacketRaw;
-                FLib_MemCpy(mHcitData.pPacket, (uint8_t*)&mHcitData.pktHeader + 1, sizeof(hcitPacketHdr_t) - 1);
-                mHcitData.bytesReceived -= 1;
-                
-                if( mHcitData.bytesReceived == mHcitData.expectedLength )
-                {
-                    Hcit_SendMessage();
-                }                    
-            }
-            break;
+    bleResult_t result = gBleSuccess_c;
 
-        case mPacketInProgress_c:
-            mHcitData.pPacket->raw[mHcitData.bytesReceived++] = recvChar;
-
-            if( mHcitData.bytesReceived == mHcitData.expectedLength )
-            {
-                Hcit_SendMessage();
-            }
-            break;
+    mHcitStatsTxWriteStarted();
+    result = Hcit_Write(pBuffer, length, mHcitTxBufferWrittenCb, pBuffer);
 
-        default:
-            break;
+    if( gBleSuccess_c != result )
+    {
+        mHcitStatsTxWriteDone();
+        mHcitStatsCount(txWriteErrors);
+        (void)MEM_BufferFree(pBuffer);
     }
-}
-
-/************************************************************************************
-*************************************************************************************
-* Private functions
-*************************************************************************************
-************************************************************************************/
-
-static void Hcit_SendMessage(void)
-{
-    /* Send the message to HCI */
-    mTransportInterface( mHcitData.pktHeader.packetTypeMarker,
-                                mHcitData.pPacket,
-                                mHcitData.bytesReceived);
 
-    mHcitData.pPacket = NULL;
-    mPacketDetectStep = mDetectMarker_c;  
+    return result;
 }
+#endif /* gHcitH5Transport_d */
 
-static void Hcit_RxCallBack(void *pData) 
+#if gHcitTxCoalescing_d
+/*! *********************************************************************************
+* \brief  Reads the TX coalescing counters.
+*
+* \param[out]   pStats      Copy of the counters
+* \param[in]    reset       If TRUE, the counters are cleared after being read
+*
+* \remarks The batching ratio is packets / serialWrites.
+*
+********************************************************************************** */
+void Hcit_GetTxCoalesceStats(hcitTxCoalesceStats_t* pStats, bool_t reset)
 {
-    uint8_t         recvChar;
-    uint16_t        count;
-    if( Serial_GetByteFromRxBuffer( gHcitSerMgrIf, &recvChar, &count) != gSerial_Success_c )
+    OSA_InterruptDisable();
+    FLib_MemCpy(pStats, &mHcitTxStats, sizeof(hcitTxCoalesceStats_t));
+    if( reset )
     {
-        return;
+        FLib_MemSet(&mHcitTxStats, 0, sizeof(hcitTxCoalesceStats_t));
     }
+    OSA_InterruptEnable();
+}
+#endif /* gHcitTxCoalescing_d */
 
-    while( count )
-    {
+#if gHcitAclScheduler_d
+/*! *********************************************************************************
+* \brief  Sets the scheduling weight of a connection.
+*
+* \param[in]    connectionHandle    HCI connection handle
+* \param[in]    weight              ACL packets sent for this connection in each
+*                                   round-robin round, while credits are available
+*
+* \return  gBleSuccess_c, gBleInvalidParameter_c or gBleOverflow_c if all link slots
+*          are used.
+*
+********************************************************************************** */
+bleResult_t Hcit_AclSetLinkWeight(uint16_t connectionHandle, uint8_t weight)
+{
+    hcitAclLink_t*  pLink;
+    bleResult_t     result = gBleSuccess_c;
+
+    if( (weight == 0U) || (connectionHandle > mHcitAclHandleMask_c) )
+    {
+        return gBleInvalidParameter_c;
+    }
+
+    OSA_InterruptDisable();
+    pLink = Hcit_AclGetLink(connectionHandle, TRUE);
+    if( NULL != pLink )
+    {
+        pLink->weight = weight;
+        pLink->quantum = weight;
+    }
+    else
+    {
+        result = gBleOverflow_c;
+    }
+    OSA_InterruptEnable();
+
+    return result;
+}
+#endif /* gHcitAclScheduler_d */
+
+#if gHcitAclRxDemux_d
+/*! *********************************************************************************
+* \brief  Reads the received ACL data counters of a connection.
+*
+* \param[in]    connectionHandle    HCI connection handle
+* \param[out]   pStats              Copy of the counters
+*
+* \return  gBleSuccess_c or gBleInvalidParameter_c.
+*
+********************************************************************************** */
+bleResult_t Hcit_AclRxGetStats(uint16_t connectionHandle, hcitAclRxStats_t* pStats)
+{
+    hcitAclRxLink_t*    pLink;
+    bleResult_t         result = gBleSuccess_c;
+
+    OSA_InterruptDisable();
+    pLink = Hcit_AclRxGetLink(connectionHandle, FALSE);
+
+    if( NULL == pLink )
+    {
+        result = gBleInvalidParameter_c;
+    }
+    else
+    {
+        *pStats = pLink->stats;
+    }
+    OSA_InterruptEnable();
+
+    return result;
+}
+#endif /* gHcitAclRxDemux_d */
+
+#if gHcitStatistics_d
+/*! *********************************************************************************
+* \brief  Reads the HCI transport counters.
+*
+* \param[out]   pStats      Copy of the counters
+*
+********************************************************************************** */
+void Hcit_GetStatistics(hcitStats_t* pStats)
+{
+    OSA_InterruptDisable();
+    FLib_MemCpy(pStats, &mHcitStats, sizeof(hcitStats_t));
+    OSA_InterruptEnable();
+}
+
+/*! *********************************************************************************
+* \brief  Reads the latency histogram of one command opcode.
+*
+* \param[in]    index       Histogram index, from 0 to gHcitStatsMaxOpcodes_c - 1
+* \param[out]   pLatency    Copy of the histogram. The opcode is 0 if unused.
+*
+* \return  gBleSuccess_c or gBleInvalidParameter_c.
+*
+********************************************************************************** */
+bleResult_t Hcit_GetCommandLatency(uint8_t index, hcitCmdLatency_t* pLatency)
+{
+    if( index >= gHcitStatsMaxOpcodes_c )
+    {
+        return gBleInvalidParameter_c;
+    }
+
+    OSA_InterruptDisable();
+    FLib_MemCpy(pLatency, &mHcitCmdLatency[index], sizeof(hcitCmdLatency_t));
+    OSA_InterruptEnable();
+
+    return gBleSuccess_c;
+}
+
+/*! *********************************************************************************
+* \brief  Clears the HCI transport counters and latency histograms.
+*
+* \remarks The current TX queue depth is kept.
+*
+********************************************************************************** */
+void Hcit_ResetStatistics(void)
+{
+    uint16_t txQueueDepth;
+
+    OSA_InterruptDisable();
+    txQueueDepth = mHcitStats.txQueueDepth;
+    FLib_MemSet(&mHcitStats, 0, sizeof(mHcitStats));
+    FLib_MemSet(mHcitCmdLatency, 0, sizeof(mHcitCmdLatency));
+    mHcitStats.txQueueDepth = txQueueDepth;
+    mHcitStats.txQueueDepthMax = txQueueDepth;
+    OSA_InterruptEnable();
+}
+#endif /* gHcitStatistics_d */
+
+#if gHcitBaudRateUpgrade_d
+/*! *********************************************************************************
+* \brief  Sets the baud rate requested after each HCI Reset.
+*
+* \param[in]    baudrate    Upgrade baud rate, or 0 to keep the current baud rate
+* \param[in]    pfCallback  Called with the baud rate in use after each attempt
+*
+********************************************************************************** */
+void Hcit_SetBaudRateUpgrade(uint32_t baudrate, hcitBaudRateCallback_t pfCallback)
+{
+    OSA_InterruptDisable();
+    mHcitBaudTarget = baudrate;
+    mpfHcitBaudCallback = pfCallback;
+    OSA_InterruptEnable();
+}
+
+/*! *********************************************************************************
+* \brief  Returns the baud rate of the interface.
+*
+* \return  Baud rate in use, or 0 if the last upgrade lost the Controller.
+*
+********************************************************************************** */
+uint32_t Hcit_GetBaudRate(void)
+{
+    return mHcitBaudRate;
+}
+#endif /* gHcitBaudRateUpgrade_d */
+
+/*! *********************************************************************************
+* \brief  
+*
+* \param[in]    
+*
+* \param[out]   
+*
+* \return  
+*
+* \pre 
+*
+* \remarks 
+*
+********************************************************************************** */
+bleResult_t Hcit_RecvPacket
+    (
+        void*           pPacket,
+        uint16_t        packetSize
+    )
+{
+    bleResult_t result = gHciSuccess_c;
+
+    uint8_t* aData = (uint8_t*) pPacket;
+    uint8_t type = aData[0];
+    
+    if (type != 0x01 && type != 0x02 && type != 0x04)
+    {
+        result = /* Something more meaningful? */ gHciTransportError_c;
+    }
+    else
+    {
+        hciPacketType_t packetType = (hciPacketType_t) type;    
+        result = Ble_HciRecv
+        (
+            packetType,
+            aData + 1,
+            packetSize - 1
+        );
+
+        MEM_BufferFree( pPacket );  ///TODO: Verify here in FSCI
+    }
+
+    return result;
+}
+
+#if gHcitIsoSupport_d
+/*! *********************************************************************************
+* \brief  Sets the callback receiving the ISO data packets.
+*
+* \param[in]    pfCallback  ISO data callback, or NULL to drop the ISO data packets
+*
+********************************************************************************** */
+void Hcit_SetIsoDataCallback(hcitIsoDataCallback_t pfCallback)
+{
+    mpfHcitIsoDataCallback = pfCallback;
+}
+#endif /* gHcitIsoSupport_d */
+
+/*! *********************************************************************************
+* \brief  Gives a receive buffer back to the HCI transport.
+*
+* \param[in]    pPacket     Packet previously delivered to the transport interface
+*
+* \remarks Only needed when gHcitRxZeroCopy_d is enabled. Otherwise, the buffer is
+*          reclaimed as soon as the transport interface returns.
+*
+********************************************************************************** */
+void Hcit_RxBufferRelease(void* pPacket)
+{
+    uint8_t*    pBuffer = (uint8_t*)pPacket;
+    uint32_t    i;
+
+    for( i = 0U; i < (uint32_t)mHcitRxPoolCount_c; i++ )
+    {
+        hcitRxPool_t* pPool = &mHcitRxPools[i];
+
+        if( (pBuffer >= pPool->pBuffers) &&
+            (pBuffer < (pPool->pBuffers + ((uint32_t)pPool->bufferSize * pPool->bufferCount))) )
+        {
+            uint32_t index = (uint32_t)(pBuffer - pPool->pBuffers) / pPool->bufferSize;
+#if gHcitHostFlowControl_d
+            /* Read before the buffer is freed: the parser can reuse it at once */
+            uint16_t handle = Utils_ExtractTwoByteValue(pBuffer) & mHcitAclHandleMask_c;
+            bool_t   poolFree;
+#endif
+
+            OSA_InterruptDisable();
+            pPool->inUseMask &= ~(1UL << index);
+#if gHcitHostFlowControl_d
+            poolFree = (pPool->inUseMask == 0U);
+#endif
+            OSA_InterruptEnable();
+#if gHcitHostFlowControl_d
+            if( i == (uint32_t)mHcitRxAclPool_c )
+            {
+                Hcit_HfcPacketReleased(handle, poolFree);
+            }
+#endif
+            return;
+        }
+    }
+
+}
+
+/*! *********************************************************************************
+* \brief  Feeds bytes received from the interface to the HCI transport.
+*
+* \param[in]    pData       Pointer to the received bytes
+* \param[in]    dataLength  Number of received bytes
+*
+* \remarks Used when the interface is not handled by the Serial Manager. The bytes
+*          go to the H5 decoder or straight to the H4 packet parser.
+*
+********************************************************************************** */
+void Hcit_InterfaceDataReceived(const uint8_t* pData, uint16_t dataLength)
+{
+#if gHcitH5Transport_d
+    Hcit_H5ReceiveData(pData, dataLength);
+#else
+    hci_processReceivedData(pData, dataLength);
+#endif
+}
+
+/*! *********************************************************************************
+* \brief  Feeds a span of received bytes to the HCI packet parser.
+*
+* \param[in]    pData       Pointer to the received bytes
+* \param[in]    dataLength  Number of received bytes
+*
+* \remarks The span may contain any number of complete or partial packets. Header
+*          and payload runs are copied in bulk into the packet buffer.
+*
+********************************************************************************** */
+void hci_processReceivedData(const uint8_t* pData, uint16_t dataLength)
+{
+    uint8_t*    pWindow;
+    uint16_t    windowLength;
+    uint16_t    index = 0U;
+
+    while( index < dataLength )
+    {
+        Hcit_GetRxWindow(&pWindow, &windowLength);
+
+        if( windowLength > (dataLength - index) )
+        {
+            windowLength = dataLength - index;
+        }
+
+        FLib_MemCpy(pWindow, &pData[index], windowLength);
+        index += windowLength;
+
+        Hcit_RxWindowFilled(windowLength);
+    }
+
+}
+
+/*! *********************************************************************************
+* \brief  Feeds one received byte to the HCI packet parser.
+*
+* \param[in]    recvChar    The received byte
+*
+********************************************************************************** */
+void hci_processReceivedChar(uint8_t recvChar)
+{
+    if( (mPacketDetectStep == mPacketInProgress_c) &&
+        ((mHcitData.bytesReceived + 1U) < mHcitData.expectedLength) )
+    {
+        /* Payload byte that does not complete the packet */
+        mHcitData.pPacket->raw[mHcitData.bytesReceived] = recvChar;
+        mHcitData.bytesReceived++;
+    }
+    else
+    {
+        hci_processReceivedData(&recvChar, 1U);
+    }
+}
+
+/************************************************************************************
+*************************************************************************************
+* Private functions
+*************************************************************************************
+************************************************************************************/
+
+static void Hcit_SendMessage(void)
+{
+    mHcitStatsPacket(mHcitData.pktHeader.packetTypeMarker, mHcitData.pPacket, mHcitData.bytesReceived, TRUE);
+    mHcitSnoopPacket(mHcitData.pktHeader.packetTypeMarker, mHcitData.pPacket, mHcitData.bytesReceived, TRUE);
+
+#if gHcitAclScheduler_d
+    if( mHcitData.pktHeader.packetTypeMarker == gHciEventPacket_c )
+    {
+        Hcit_AclProcessEvent(mHcitData.pPacket->raw, mHcitData.bytesReceived);
+    }
+#endif
+
+#if gHcitCmdPipelining_d
+    if( mHcitData.pktHeader.packetTypeMarker == gHciEventPacket_c )
+    {
+        Hcit_CmdProcessEvent(mHcitData.pPacket->raw, mHcitData.bytesReceived);
+    }
+#endif
+
+#if gHcitAclRxDemux_d
+    if( mHcitData.pktHeader.packetTypeMarker == gHciEventPacket_c )
+    {
+        Hcit_AclRxProcessEvent(mHcitData.pPacket->raw, mHcitData.bytesReceived);
+    }
+#endif
+
+#if mHcitResetSetup_d
+    if( (mHcitData.pktHeader.packetTypeMarker == gHciEventPacket_c) &&
+        Hcit_SetupProcessEvent(mHcitData.pPacket, mHcitData.bytesReceived) )
+    {
+        /* Held, or answers a command sent by the transport */
+        mHcitData.pPacket = NULL;
+        mPacketDetectStep = mDetectMarker_c;
+        return;
+    }
+#endif
+
+#if gHcitHostFlowControl_d
+    if( mHcitData.pktHeader.packetTypeMarker == gHciEventPacket_c )
+    {
+        if( Hcit_HfcProcessEvent(mHcitData.pPacket, mHcitData.bytesReceived) )
+        {
+            /* The event answers a command sent by the transport */
+            mHcitData.pPacket = NULL;
+            mPacketDetectStep = mDetectMarker_c;
+            return;
+        }
+    }
+    else if( mHcitData.pktHeader.packetTypeMarker == gHciDataPacket_c )
+    {
+        Hcit_HfcPacketReceived(mHcitData.pPacket->raw);
+    }
+    else
+    {
+        /* Not subject to flow control */
+    }
+#endif
+
+#if gHcitIsoSupport_d
+    if( (uint8_t)mHcitData.pktHeader.packetTypeMarker == gHcitIsoDataPacket_c )
+    {
+        /* The Host does not handle ISO data */
+        Hcit_IsoDataReceived(mHcitData.pPacket->raw, mHcitData.bytesReceived);
+        Hcit_RxBufferRelease(mHcitData.pPacket);
+        mHcitData.pPacket = NULL;
+        mPacketDetectStep = mDetectMarker_c;
+        return;
+    }
+#endif
+
+#if gHcitAclRxDemux_d
+    /* Given to the Host, or copied if it is ACL data for a busy Host */
+    Hcit_AclRxReceive(mHcitData.pktHeader.packetTypeMarker, mHcitData.pPacket, mHcitData.bytesReceived);
+    Hcit_RxBufferRelease(mHcitData.pPacket);
+#else
+    /* Send the message to HCI */
+    mTransportInterface( mHcitData.pktHeader.packetTypeMarker,
+                                mHcitData.pPacket,
+                                mHcitData.bytesReceived);
+
+#if !gHcitRxZeroCopy_d
+    /* The transport interface copies the packet before returning */
+    Hcit_RxBufferRelease(mHcitData.pPacket);
+#endif
+#endif /* gHcitAclRxDemux_d */
+
+    mHcitData.pPacket = NULL;
+    mPacketDetectStep = mDetectMarker_c;  
+}
+
+/*! *********************************************************************************
+* \brief  Returns the location where the next received bytes must be stored and the
+*         number of bytes the parser expects in its current state.
+*
+* \param[out]   ppWindow        Location of the next received bytes
+* \param[out]   pWindowLength   Number of bytes expected in the current state
+*
+********************************************************************************** */
+static void Hcit_GetRxWindow(uint8_t** ppWindow, uint16_t* pWindowLength)
+{
+    switch( mPacketDetectStep )
+    {
+        case mDetectHeader_c:
+            *ppWindow = &((uint8_t*)&mHcitData.pktHeader)[mHcitData.bytesReceived];
+            *pWindowLength = Hcit_GetHeaderLength(mHcitData.pktHeader.packetTypeMarker) + 1U - mHcitData.bytesReceived;
+            break;
+
+        case mPacketInProgress_c:
+            *ppWindow = &mHcitData.pPacket->raw[mHcitData.bytesReceived];
+            *pWindowLength = mHcitData.expectedLength - mHcitData.bytesReceived;
+            break;
+
+        case mPacketDiscard_c:
+            *ppWindow = mHcitRxDiscardBuffer;
+            *pWindowLength = mHcitData.expectedLength - mHcitData.bytesReceived;
+            if( *pWindowLength > mHcitRxDiscardChunkSize_c )
+            {
+                *pWindowLength = mHcitRxDiscardChunkSize_c;
+            }
+            break;
+
+        case mDetectMarker_c:
+        default:
+            /* The packet type marker is searched one byte at a time */
+            *ppWindow = (uint8_t*)&mHcitData.pktHeader.packetTypeMarker;
+            *pWindowLength = 1U;
+            break;
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Advances the parser after bytes were stored in the current window.
+*
+* \param[in]    length      Number of bytes stored in the window returned by
+*                           Hcit_GetRxWindow()
+*
+********************************************************************************** */
+static void Hcit_RxWindowFilled(uint16_t length)
+{
+    switch( mPacketDetectStep )
+    {
+        case mDetectMarker_c:
+            if( Hcit_GetHeaderLength(mHcitData.pktHeader.packetTypeMarker) != 0U )
+            {
+                mHcitData.bytesReceived = 1;
+                mPacketDetectStep = mDetectHeader_c;
+#if gHcitStatistics_d
+                mHcitRxOutOfSync = FALSE;
+#endif
+            }
+            else
+            {
+                /* Not a packet type marker: the parser is out of sync */
+#if gHcitStatistics_d
+                if( !mHcitRxOutOfSync )
+                {
+                    mHcitRxOutOfSync = TRUE;
+                    mHcitStatsCount(rxResyncs);
+                }
+#endif
+                mHcitStatsCount(rxSkippedBytes);
+            }
+            break;
+
+        case mDetectHeader_c:
+            mHcitData.bytesReceived += length;
+
+            if( mHcitData.bytesReceived == (Hcit_GetHeaderLength(mHcitData.pktHeader.packetTypeMarker) + 1U) )
+            {
+                Hcit_HeaderReceived();
+            }
+            break;
+
+        case mPacketInProgress_c:
+            mHcitData.bytesReceived += length;
+
+            if( mHcitData.bytesReceived == mHcitData.expectedLength )
+            {
+                Hcit_SendMessage();
+            }
+            break;
+
+        case mPacketDiscard_c:
+            mHcitData.bytesReceived += length;
+
+            if( mHcitData.bytesReceived == mHcitData.expectedLength )
+            {
+                mPacketDetectStep = mDetectMarker_c;
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Returns the header length of a packet type, or 0 if the value is not
+*         a supported packet type marker.
+*
+********************************************************************************** */
+static uint16_t Hcit_GetHeaderLength(hciPacketType_t packetType)
+{
+    uint16_t headerLength;
+
+    switch( (uint8_t)packetType )
+    {
+        case gHciDataPacket_c:
+            headerLength = gHciAclDataPacketHeaderLength_c;
+            break;
+
+        case gHciEventPacket_c:
+            headerLength = gHciEventPacketHeaderLength_c;
+            break;
+
+        case gHciCommandPacket_c:
+            headerLength = gHciCommandPacketHeaderLength_c;
+            break;
+
+#if gHcitIsoSupport_d
+        case gHciSynchronousDataPacket_c:
+            headerLength = mHcitSyncHeaderLength_c;
+            break;
+
+        case gHcitIsoDataPacket_c:
+            headerLength = mHcitIsoHeaderLength_c;
+            break;
+#endif
+
+        default:
+            /* Not Supported */
+            headerLength = 0U;
+            break;
+    }
+
+    return headerLength;
+}
+
+/*! *********************************************************************************
+* \brief  Validates a complete packet header and prepares the reception of the
+*         packet payload.
+*
+********************************************************************************** */
+static void Hcit_HeaderReceived(void)
+{
+    switch( (uint8_t)mHcitData.pktHeader.packetTypeMarker )
+    {
+        case gHciDataPacket_c:
+            /* Validate ACL Data packet length */
+            if( mHcitData.pktHeader.aclDataPacket.dataTotalLength > gHcLeAclDataPacketLengthDefault_c )
+            {
+                mHcitStatsCount(rxOversizeAclDrops);
+                mHcitData.pPacket = NULL;
+                mPacketDetectStep = mDetectMarker_c;
+                return;
+            }
+            mHcitData.expectedLength = gHciAclDataPacketHeaderLength_c +
+                                        mHcitData.pktHeader.aclDataPacket.dataTotalLength;
+            break;
+
+        case gHciEventPacket_c:
+            /* Validate HCI Event packet length
+            if( mHcitData.pktHeader.eventPacket.dataTotalLength > gHcEventPacketLengthDefault_c )
+            {
+                mHcitData.pPacket = NULL;
+                mPacketDetectStep = mDetectMarker_c;
+                return;
+            } */
+            mHcitData.expectedLength = gHciEventPacketHeaderLength_c +
+                                        mHcitData.pktHeader.eventPacket.dataTotalLength;
+            break;
+
+        case gHciCommandPacket_c:
+            /* HCI Command Packet */
+            mHcitData.expectedLength = gHciCommandPacketHeaderLength_c +
+                                        mHcitData.pktHeader.commandPacket.parameterTotalLength;
+            break;
+
+#if gHcitIsoSupport_d
+        case gHciSynchronousDataPacket_c:
+            mHcitData.expectedLength = mHcitSyncHeaderLength_c +
+                                        mHcitData.pktHeader.syncDataPacket.dataTotalLength;
+            break;
+
+        case gHcitIsoDataPacket_c:
+            mHcitData.expectedLength = mHcitIsoHeaderLength_c +
+                                        mHcitData.pktHeader.isoDataPacket.dataTotalLength;
+
+            /* Validate ISO Data packet length. The payload is skipped to stay in sync. */
+            if( mHcitData.pktHeader.isoDataPacket.dataTotalLength > gHcitIsoMaxDataLength_c )
+            {
+                mHcitStatsCount(rxOversizeIsoDrops);
+                mHcitData.bytesReceived -= 1U;
+                mHcitData.pPacket = NULL;
+                mPacketDetectStep = mPacketDiscard_c;
+                return;
+            }
+            break;
+#endif
+
+        default:
+            /* Not Supported */
+            mPacketDetectStep = mDetectMarker_c;
+            return;
+    }
+
+    mHcitData.bytesReceived -= 1U;
+    mHcitData.pPacket = Hcit_RxBufferAlloc(mHcitData.pktHeader.packetTypeMarker);
+
+    if( NULL == mHcitData.pPacket )
+    {
+        /* No free buffer: skip the payload of this packet and stay in sync */
+        mHcitStatsCount(rxNoBufferDrops);
+        mPacketDetectStep = (mHcitData.bytesReceived == mHcitData.expectedLength) ?
+                                mDetectMarker_c : mPacketDiscard_c;
+        return;
+    }
+
+    mPacketDetectStep = mPacketInProgress_c;
+
+    FLib_MemCpy(mHcitData.pPacket, (uint8_t*)&mHcitData.pktHeader + 1, sizeof(hcitPacketHdr_t) - 1U);
+
+    if( mHcitData.bytesReceived == mHcitData.expectedLength )
+    {
+        Hcit_SendMessage();
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Takes a free buffer from the receive pool of a packet type.
+*
+* \param[in]    packetType  Type of the packet to be received
+*
+* \return  Pointer to the buffer, or NULL if the pool is exhausted.
+*
+********************************************************************************** */
+static hcitPacket_t* Hcit_RxBufferAlloc(hciPacketType_t packetType)
+{
+    hcitRxPool_t*   pPool;
+    hcitPacket_t*   pPacket = NULL;
+    uint32_t        i;
+
+    pPool = (packetType == gHciDataPacket_c) ? &mHcitRxPools[mHcitRxAclPool_c] :
+                                               &mHcitRxPools[mHcitRxEventPool_c];
+#if gHcitIsoSupport_d
+    if( (packetType == gHciSynchronousDataPacket_c) || ((uint8_t)packetType == gHcitIsoDataPacket_c) )
+    {
+        pPool = &mHcitRxPools[mHcitRxIsoPool_c];
+    }
+#endif
+
+    OSA_InterruptDisable();
+    for( i = 0U; i < pPool->bufferCount; i++ )
+    {
+        if( (pPool->inUseMask & (1UL << i)) == 0U )
+        {
+            pPool->inUseMask |= (1UL << i);
+            pPacket = (hcitPacket_t*)&pPool->pBuffers[i * pPool->bufferSize];
+#if gHcitStatistics_d
+            mHcitStats.rxAllocations++;
+#endif
+            break;
+        }
+    }
+    OSA_InterruptEnable();
+
+    return pPacket;
+}
+
+#if gHcitSerialManagerSupport_d
+static void Hcit_RxCallBack(void *pData)
+{
+#if gHcitH5Transport_d
+    uint8_t         chunk[mHcitH5RxChunkSize_c];
+    uint16_t        bytesRead = 0U;
+
+    /* SLIP frames are decoded before reaching the HCI packet parser */
+    do
+    {
+        if( Serial_Read(gHcitSerMgrIf, chunk, mHcitH5RxChunkSize_c, &bytesRead) != gSerial_Success_c )
+        {
+            return;
+        }
+
+        Hcit_H5ReceiveData(chunk, bytesRead);
+    } while( bytesRead == mHcitH5RxChunkSize_c );
+#else
+    uint8_t*        pWindow;
+    uint16_t        windowLength;
+    uint16_t        bytesRead = 0U;
+
+    /* Read the marker, the header and the payload of each packet straight into
+       their final location, as many bytes at once as the parser state allows */
+    do
+    {
+        Hcit_GetRxWindow(&pWindow, &windowLength);
+
+        if( Serial_Read(gHcitSerMgrIf, pWindow, windowLength, &bytesRead) != gSerial_Success_c )
+        {
+            return;
+        }
+
+        if( bytesRead != 0U )
+        {
+            Hcit_RxWindowFilled(bytesRead);
+        }
+    } while( bytesRead == windowLength );
+
+#endif /* gHcitH5Transport_d */
+}
+#endif /* gHcitSerialManagerSupport_d */
+
+/*! *********************************************************************************
+* \brief  Writes a packet allocated with Hcit_AllocPacket() to the interface.
+*
+* \param[in]    packetType  HCI packet type
+* \param[in]    pPacket     Pointer returned by Hcit_AllocPacket()
+* \param[in]    packetSize  Size of the HCI packet, without the transport header
+*
+* \return  gBleSuccess_c. Write errors are counted in the statistics.
+*
+* \remarks Takes ownership of the packet. Used for the packets that go through
+*          neither the ACL scheduler nor the command queue. Must not be called with
+*          interrupts disabled.
+*
+********************************************************************************** */
+static bleResult_t Hcit_WritePacket
+    (
+        hciPacketType_t packetType,
+        void*           pPacket,
+        uint16_t        packetSize
+    )
+{
+    OSA_InterruptDisable();
+    Hcit_TxQueue(packetType, pPacket, packetSize);
+    OSA_InterruptEnable();
+
+    Hcit_TxRun();
+
+    return gBleSuccess_c;
+}
+
+/*! *********************************************************************************
+* \brief  Adds a packet allocated with Hcit_AllocPacket() to the TX queue.
+*
+* \param[in]    packetType  HCI packet type
+* \param[in]    pPacket     Pointer returned by Hcit_AllocPacket()
+* \param[in]    packetSize  Size of the HCI packet, without the transport header
+*
+* \pre Called with interrupts disabled. Hcit_TxRun() must be called afterwards, once
+*      interrupts are enabled again.
+*
+********************************************************************************** */
+static void Hcit_TxQueue(hciPacketType_t packetType, void* pPacket, uint16_t packetSize)
+{
+    hcitTxPacket_t* pTxPacket = (hcitTxPacket_t*)((uint8_t*)pPacket - mHcitTxPacketOffset_c);
+
+    pTxPacket->pNext = NULL;
+    pTxPacket->packetSize = packetSize;
+    pTxPacket->packetType = packetType;
+
+    if( NULL == mpHcitTxTail )
+    {
+        mpHcitTxHead = pTxPacket;
+    }
+    else
+    {
+        mpHcitTxTail->pNext = pTxPacket;
+    }
+    mpHcitTxTail = pTxPacket;
+}
+
+/*! *********************************************************************************
+* \brief  Writes the queued packets to the interface, in queue order.
+*
+* \remarks Only one context is the TX writer at a time. A context finding the writer
+*          busy leaves its packets in the queue: the writer takes them before it
+*          stops, as the queue is checked and the writer released under the same
+*          lock. Packets are taken with interrupts disabled and written with
+*          interrupts enabled.
+*
+********************************************************************************** */
+static void Hcit_TxRun(void)
+{
+    hcitTxPacket_t* pTxPacket;
+    bool_t          flush = FALSE;
+    bool_t          run;
+
+    OSA_InterruptDisable();
+    run = !mHcitTxRunning;
+    mHcitTxRunning = TRUE;
+
+    while( run )
+    {
+        pTxPacket = mpHcitTxHead;
+        if( NULL != pTxPacket )
+        {
+            mpHcitTxHead = pTxPacket->pNext;
+            if( NULL == mpHcitTxHead )
+            {
+                mpHcitTxTail = NULL;
+            }
+        }
+#if gHcitTxCoalescing_d
+        flush = mHcitTxFlushRequest;
+        mHcitTxFlushRequest = FALSE;
+#endif
+
+        if( (NULL == pTxPacket) && !flush )
+        {
+            mHcitTxRunning = FALSE;
+            run = FALSE;
+        }
+        else
+        {
+            OSA_InterruptEnable();
+#if gHcitTxCoalescing_d
+            if( flush && (NULL != mpHcitTxFilling) && (mpHcitTxFilling->length > 0U) )
+            {
+                mHcitTxStats.timeoutFlushes++;
+                Hcit_TxFlush();
+            }
+#endif
+            if( NULL != pTxPacket )
+            {
+                Hcit_TxWrite(pTxPacket);
+            }
+            OSA_InterruptDisable();
+        }
+    }
+
+    OSA_InterruptEnable();
+}
+
+/*! *********************************************************************************
+* \brief  Writes one packet taken from the TX queue.
+*
+* \param[in]    pTxPacket   Queued packet. Freed once written.
+*
+* \pre Called by the TX writer.
+*
+********************************************************************************** */
+static void Hcit_TxWrite(hcitTxPacket_t* pTxPacket)
+{
+    /* The H4 packet type marker goes in the last byte of the headroom */
+    uint8_t*        pH4Packet = (uint8_t*)pTxPacket + mHcitTxPacketOffset_c - 1U;
+    uint8_t*        pPacket = &pH4Packet[1];
+    hciPacketType_t packetType = pTxPacket->packetType;
+    uint16_t        packetSize = pTxPacket->packetSize;
+
+    mHcitStatsPacket(packetType, pPacket, packetSize, FALSE);
+    mHcitSnoopPacket(packetType, pPacket, packetSize, FALSE);
+
+#if gHcitH5Transport_d
+    /* The H5 link keeps its own copy until the packet is acknowledged */
+    if( gBleSuccess_c != Hcit_H5SendPacket(packetType, pPacket, packetSize) )
+    {
+        mHcitStatsCount(txWriteErrors);
+    }
+    (void)MEM_BufferFree(pTxPacket);
+    (void)pH4Packet;
+#else
+    (void)pPacket;
+    pH4Packet[0] = packetType;
+
+#if gHcitTxCoalescing_d
+    if( Hcit_TxCoalesce(packetType, pH4Packet, 1U + packetSize) )
+    {
+        (void)MEM_BufferFree(pTxPacket);
+        return;
+    }
+#endif
+
+    mHcitStatsTxWriteStarted();
+    if( gBleSuccess_c != Hcit_Write(pH4Packet, 1U + packetSize, mHcitTxBufferWrittenCb, pTxPacket) )
+    {
+        mHcitStatsTxWriteDone();
+        mHcitStatsCount(txWriteErrors);
+        (void)MEM_BufferFree(pTxPacket);
+    }
+#endif /* gHcitH5Transport_d */
+}
+
+/*! *********************************************************************************
+* \brief  Writes a buffer to the interface.
+*
+* \param[in]    pBuffer         Data to write
+* \param[in]    length          Number of bytes to write
+* \param[in]    pfWriteComplete Called with pParam once the buffer is no longer used
+* \param[in]    pParam          Parameter of pfWriteComplete
+*
+* \return  gBleSuccess_c or gHciTransportError_c. pfWriteComplete is not called on error.
+*
+********************************************************************************** */
+static bleResult_t Hcit_Write(uint8_t* pBuffer, uint16_t length, pSerialCallBack_t pfWriteComplete, void* pParam)
+{
+    bleResult_t result = gBleSuccess_c;
+
+#if gHcitSerialManagerSupport_d
+    if( gSerial_Success_c != Serial_AsyncWrite(gHcitSerMgrIf, pBuffer, length, pfWriteComplete, pParam) )
+    {
+        result = gHciTransportError_c;
+    }
+#else
+    if( gBleSuccess_c != mWriteInterface(pBuffer, length, pfWriteComplete, pParam) )
+    {
+        result = gHciTransportError_c;
+    }
+#endif
+
+    return result;
+}
+
+#if gHcitTxCoalescing_d
+/*! *********************************************************************************
+* \brief  Copies a packet into the TX coalescing buffer, if possible.
+*
+* \param[in]    packetType  HCI packet type
+* \param[in]    pData       H4 packet, starting with the packet type marker
+* \param[in]    length      Length of the H4 packet
+*
+* \return  TRUE if the packet was coalesced, FALSE if it must be written directly.
+*
+* \pre Called by the TX writer.
+*
+********************************************************************************** */
+static bool_t Hcit_TxCoalesce(hciPacketType_t packetType, const uint8_t* pData, uint16_t length)
+{
+    bool_t      startTimer = FALSE;
+    uint32_t    i;
+
+    /* Make room by writing out the pending data */
+    if( (NULL != mpHcitTxFilling) &&
+        ((uint32_t)mpHcitTxFilling->length + length > gHcitTxCoalesceBufferSize_c) )
+    {
+        mHcitTxStats.sizeFlushes++;
+        Hcit_TxFlush();
+    }
+
+    if( NULL == mpHcitTxFilling )
+    {
+        for( i = 0U; i < NumberOfElements(mHcitTxBuffers); i++ )
+        {
+            if( mHcitTxBuffers[i].state == mHcitTxBufferFree_c )
+            {
+                mpHcitTxFilling = &mHcitTxBuffers[i];
+                mpHcitTxFilling->state = mHcitTxBufferFilling_c;
+                mpHcitTxFilling->length = 0U;
+                startTimer = TRUE;
+                break;
+            }
+        }
+    }
+
+    /* Nothing pending at this point, so a direct write keeps the packet order */
+    if( (NULL == mpHcitTxFilling) || (length > gHcitTxCoalesceBufferSize_c) )
+    {
+        mHcitTxStats.bypassed++;
+        return FALSE;
+    }
+
+    FLib_MemCpy(&mpHcitTxFilling->data[mpHcitTxFilling->length], pData, length);
+    mpHcitTxFilling->length += length;
+    mHcitTxStats.packets++;
+
+    /* The Host waits for the answer to a command, so do not hold it back */
+    if( packetType == gHciCommandPacket_c )
+    {
+        Hcit_TxFlush();
+    }
+    else if( startTimer )
+    {
+        (void)TMR_StartSingleShotTimer(mHcitTxTimerId, gHcitTxCoalesceTimeoutMs_c, Hcit_TxTimeout, NULL);
+    }
+    else
+    {
+        /* The timer runs since the first packet of the buffer */
+    }
+
+    return TRUE;
+}
+
+/*! *********************************************************************************
+* \brief  Writes the buffer being filled to the serial interface.
+*
+* \pre Called by the TX writer.
+*
+********************************************************************************** */
+static void Hcit_TxFlush(void)
+{
+    hcitTxBuffer_t* pBuffer = mpHcitTxFilling;
+
+    if( (NULL != pBuffer) && (pBuffer->length > 0U) )
+    {
+        mpHcitTxFilling = NULL;
+        pBuffer->state = mHcitTxBufferQueued_c;
+        mHcitTxStats.serialWrites++;
+
+        mHcitStatsTxWriteStarted();
+        if( gBleSuccess_c != Hcit_Write(pBuffer->data, pBuffer->length, Hcit_TxWriteComplete, pBuffer) )
+        {
+            mHcitStatsTxWriteDone();
+            mHcitTxStats.writeErrors++;
+            pBuffer->state = mHcitTxBufferFree_c;
+        }
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Serial write completion callback. Releases the coalescing buffer.
+*
+* \param[in]    pParam      The buffer that was written
+*
+********************************************************************************** */
+static void Hcit_TxWriteComplete(void* pParam)
+{
+    mHcitStatsTxWriteDone();
+    ((hcitTxBuffer_t*)pParam)->state = mHcitTxBufferFree_c;
+}
+
+/*! *********************************************************************************
+* \brief  Flush timer callback. Bounds the time a packet waits for coalescing.
+*
+* \param[in]    pParam      Not used
+*
+* \remarks The buffer being filled belongs to the TX writer, which does the flush.
+*
+********************************************************************************** */
+static void Hcit_TxTimeout(void* pParam)
+{
+    (void)pParam;
+
+    OSA_InterruptDisable();
+    mHcitTxFlushRequest = TRUE;
+    OSA_InterruptEnable();
+
+    Hcit_TxRun();
+}
+#endif /* gHcitTxCoalescing_d */
+
+#if gHcitAclScheduler_d
+/*! *********************************************************************************
+* \brief  Queues an ACL packet on its connection and runs the scheduler.
+*
+* \param[in]    pPacket     Packet allocated with Hcit_AllocPacket()
+* \param[in]    packetSize  Size of the HCI ACL packet
+*
+* \return  gBleSuccess_c or gBleOverflow_c if the connection queue is full.
+*
+* \remarks On gBleOverflow_c the packet is not taken and the caller keeps it.
+*
+********************************************************************************** */
+static bleResult_t Hcit_AclEnqueue(void* pPacket, uint16_t packetSize)
+{
+    uint16_t            handle = Utils_ExtractTwoByteValue((uint8_t*)pPacket) & mHcitAclHandleMask_c;
+    hcitAclLink_t*      pLink;
+    hcitAclTxEntry_t*   pEntry;
+    bleResult_t         result = gBleSuccess_c;
+
+    OSA_InterruptDisable();
+
+    pLink = Hcit_AclGetLink(handle, TRUE);
+
+    if( (NULL == pLink) || (pLink->count == gHcitAclQueueDepth_c) )
+    {
+        /* Not taken: the caller keeps the packet */
+        result = gBleOverflow_c;
+    }
+    else if( mHcitAclTotalCredits == 0U )
+    {
+        /* Controller buffers not known yet: no scheduling possible. The packet is
+           counted, so that its buffer is not offered again once the size is known. */
+        Hcit_TxQueue(gHciDataPacket_c, pPacket, packetSize);
+        pLink->inFlight++;
+    }
+    else
+    {
+        pEntry = &pLink->queue[(pLink->head + pLink->count) % gHcitAclQueueDepth_c];
+        pEntry->pPacket = pPacket;
+        pEntry->packetSize = packetSize;
+        pLink->count++;
+
+        Hcit_AclSchedule();
+    }
+
+    OSA_InterruptEnable();
+
+    Hcit_TxRun();
+
+    return result;
+}
+
+/*! *********************************************************************************
+* \brief  Finds the link slot of a connection handle.
+*
+* \param[in]    handle      HCI connection handle
+* \param[in]    allocate    If TRUE, a free slot is taken when none is found
+*
+* \return  Pointer to the link slot or NULL.
+*
+********************************************************************************** */
+static hcitAclLink_t* Hcit_AclGetLink(uint16_t handle, bool_t allocate)
+{
+    hcitAclLink_t*  pFree = NULL;
+    uint32_t        i;
+
+    for( i = 0U; i < gHcitAclMaxLinks_c; i++ )
+    {
+        if( mHcitAclLinks[i].handle == handle )
+        {
+            return &mHcitAclLinks[i];
+        }
+
+        if( (NULL == pFree) && (mHcitAclLinks[i].handle == mHcitAclInvalidHandle_c) )
+        {
+            pFree = &mHcitAclLinks[i];
+        }
+    }
+
+    if( allocate && (NULL != pFree) )
+    {
+        pFree->handle = handle;
+    }
+    else
+    {
+        pFree = NULL;
+    }
+
+    return pFree;
+}
+
+/*! *********************************************************************************
+* \brief  Frees a link slot, dropping the packets still queued on it.
+*
+* \param[in]    pLink       Link slot
+*
+********************************************************************************** */
+static void Hcit_AclReleaseLink(hcitAclLink_t* pLink)
+{
+    while( pLink->count > 0U )
+    {
+        Hcit_FreePacket(pLink->queue[pLink->head].pPacket);
+        pLink->head = (uint8_t)((pLink->head + 1U) % gHcitAclQueueDepth_c);
+        pLink->count--;
+    }
+
+    pLink->handle = mHcitAclInvalidHandle_c;
+    pLink->inFlight = 0U;
+    pLink->weight = gHcitAclDefaultWeight_c;
+    pLink->quantum = gHcitAclDefaultWeight_c;
+    pLink->head = 0U;
+}
+
+/*! *********************************************************************************
+* \brief  Updates the ACL credits from the events received from the Controller.
+*
+* \param[in]    pEvent      HCI event packet
+* \param[in]    length      Length of the HCI event packet
+*
+********************************************************************************** */
+static void Hcit_AclProcessEvent(const uint8_t* pEvent, uint16_t length)
+{
+    hcitAclLink_t*  pLink;
+    uint16_t        opcode;
+    uint16_t        count;
+    uint32_t        inFlight;
+    uint32_t        i;
+
+    OSA_InterruptDisable();
+
+    switch( pEvent[0] )
+    {
+        case gHciCommandCompleteEvent_c:
+            /* Event code, length, number of commands, opcode, status, parameters */
+            if( (length < 6U) || (pEvent[5] != (uint8_t)gHciSuccess_c) )
+            {
+                break;
+            }
+
+            opcode = Utils_ExtractTwoByteValue(&pEvent[3]);
+
+            if( opcode == HciControllerCmdOpcode(gHciReset_c) )
+            {
+                /* The Controller dropped the connections and their buffers: the size is
+                   read again by the Host before any data is sent */
+                for( i = 0U; i < gHcitAclMaxLinks_c; i++ )
+                {
+                    Hcit_AclReleaseLink(&mHcitAclLinks[i]);
+                }
+                mHcitAclTotalCredits = 0U;
+                mHcitAclFreeCredits = 0U;
+                mHcitAclLeBuffers = FALSE;
+                break;
+            }
+
+            if( (opcode == HciLeCmdOpcode(gHciLeReadBufferSize_c)) && (length >= 9U) && (pEvent[8] != 0U) )
+            {
+                mHcitAclLeBuffers = TRUE;
+                mHcitAclTotalCredits = pEvent[8];
+            }
+            /* The shared buffers are used only if the Controller has no LE buffers */
+            else if( (opcode == HciInfoCmdOpcode(gHciReadBufferSize_c)) && (length >= 13U) && !mHcitAclLeBuffers )
+            {
+                mHcitAclTotalCredits = Utils_ExtractTwoByteValue(&pEvent[9]);
+            }
+            else
+            {
+                /* Not a buffer size command */
+                break;
+            }
+
+            /* Packets sent before the size was known still hold Controller buffers */
+            inFlight = 0U;
+            for( i = 0U; i < gHcitAclMaxLinks_c; i++ )
+            {
+                inFlight += mHcitAclLinks[i].inFlight;
+            }
+            mHcitAclFreeCredits = (inFlight < mHcitAclTotalCredits) ? (uint16_t)(mHcitAclTotalCredits - inFlight) : 0U;
+            break;
+
+        case gHciNumberOfCompletedPacketsEvent_c:
+            for( i = 0U; (i < pEvent[2]) && ((3U + 4U * i + 4U) <= length); i++ )
+            {
+                pLink = Hcit_AclGetLink(Utils_ExtractTwoByteValue(&pEvent[3U + 4U * i]) & mHcitAclHandleMask_c, FALSE);
+                count = Utils_ExtractTwoByteValue(&pEvent[5U + 4U * i]);
+
+                if( NULL != pLink )
+                {
+                    count = (count > pLink->inFlight) ? pLink->inFlight : count;
+                    pLink->inFlight -= count;
+                    mHcitAclFreeCredits += count;
+                }
+            }
+            break;
+
+        case gHciDisconnectionCompleteEvent_c:
+            if( (length >= 5U) && (pEvent[2] == (uint8_t)gHciSuccess_c) )
+            {
+                pLink = Hcit_AclGetLink(Utils_ExtractTwoByteValue(&pEvent[3]) & mHcitAclHandleMask_c, FALSE);
+
+                if( NULL != pLink )
+                {
+                    /* The Controller flushed the packets of the link: their credits are back */
+                    mHcitAclFreeCredits += pLink->inFlight;
+                    Hcit_AclReleaseLink(pLink);
+                }
+            }
+            break;
+
+        default:
+            /* Not relevant for ACL credits */
+            break;
+    }
+
+    Hcit_AclSchedule();
+
+    OSA_InterruptEnable();
+
+    Hcit_TxRun();
+}
+
+/*! *********************************************************************************
+* \brief  Moves queued ACL packets to the TX queue while credits are available,
+*         visiting the connections in weighted round-robin order.
+*
+* \pre Called with interrupts disabled. Hcit_TxRun() must be called afterwards.
+*
+********************************************************************************** */
+static void Hcit_AclSchedule(void)
+{
+    hcitAclLink_t*      pLink;
+    hcitAclTxEntry_t    entry;
+    uint32_t            idleLinks = 0U;
+
+    while( (mHcitAclFreeCredits > 0U) && (idleLinks < gHcitAclMaxLinks_c) )
+    {
+        pLink = &mHcitAclLinks[mHcitAclRrIndex];
+
+        if( (pLink->count > 0U) && (pLink->quantum > 0U) )
+        {
+            entry = pLink->queue[pLink->head];
+            pLink->head = (uint8_t)((pLink->head + 1U) % gHcitAclQueueDepth_c);
+            pLink->count--;
+            pLink->quantum--;
+
+            Hcit_TxQueue(gHciDataPacket_c, entry.pPacket, entry.packetSize);
+            pLink->inFlight++;
+            mHcitAclFreeCredits--;
+            idleLinks = 0U;
+        }
+        else
+        {
+            /* End of the round for this link */
+            idleLinks = (pLink->count > 0U) ? 0U : (idleLinks + 1U);
+            pLink->quantum = pLink->weight;
+            mHcitAclRrIndex = (uint8_t)((mHcitAclRrIndex + 1U) % gHcitAclMaxLinks_c);
+        }
+    }
+}
+#endif /* gHcitAclScheduler_d */
+
+#if gHcitCmdPipelining_d
+/*! *********************************************************************************
+* \brief  Queues a command until the Controller has a command credit for it.
+*
+* \param[in]    pPacket     Command allocated with Hcit_AllocPacket()
+* \param[in]    packetSize  Size of the command
+*
+* \return  gBleSuccess_c, or gBleOverflow_c if the queue is full.
+*
+* \remarks On gBleOverflow_c the packet is not taken and the caller keeps it.
+*
+********************************************************************************** */
+static bleResult_t Hcit_CmdEnqueue(void* pPacket, uint16_t packetSize)
+{
+    hcitCmdTxEntry_t*   pEntry;
+    bleResult_t         result = gBleSuccess_c;
+
+    OSA_InterruptDisable();
+
+    if( Utils_ExtractTwoByteValue((uint8_t*)pPacket) == HciControllerCmdOpcode(gHciHostNumberOfCompletedPackets_c) )
+    {
+        /* Host Number Of Completed Packets is sent without command credit */
+        Hcit_TxQueue(gHciCommandPacket_c, pPacket, packetSize);
+    }
+    else if( mHcitCmdCount == gHcitCmdQueueDepth_c )
+    {
+        /* Not taken: the caller keeps the packet */
+        result = gBleOverflow_c;
+    }
+    else
+    {
+        /* Commands leave in submission order */
+        pEntry = &mHcitCmdQueue[(mHcitCmdHead + mHcitCmdCount) % gHcitCmdQueueDepth_c];
+        pEntry->pPacket = pPacket;
+        pEntry->packetSize = packetSize;
+        mHcitCmdCount++;
+
+        Hcit_CmdSchedule();
+    }
+
+    OSA_InterruptEnable();
+
+    Hcit_TxRun();
+
+    return result;
+}
+
+/*! *********************************************************************************
+* \brief  Updates the command credits from a Command Complete or Command Status event
+*         and reports the credits of the transport to the Host in the event.
+*
+* \param[in]    pEvent      HCI event packet, modified in place
+* \param[in]    length      Length of the HCI event packet
+*
+********************************************************************************** */
+static void Hcit_CmdProcessEvent(uint8_t* pEvent, uint16_t length)
+{
+    uint8_t*    pNumCommands;
+    uint32_t    hostCredits;
+
+    /* Event code, length, number of commands for Command Complete,
+       event code, length, status, number of commands for Command Status */
+    if( (pEvent[0] == (uint8_t)gHciCommandCompleteEvent_c) && (length >= 3U) )
+    {
+        pNumCommands = &pEvent[2];
+    }
+    else if( (pEvent[0] == (uint8_t)gHciCommandStatusEvent_c) && (length >= 4U) )
+    {
+        pNumCommands = &pEvent[3];
+    }
+    else
+    {
+        return;
+    }
+
+    OSA_InterruptDisable();
+
+    mHcitCmdCredits = *pNumCommands;
+    Hcit_CmdSchedule();
+
+    hostCredits = (uint32_t)mHcitCmdCredits + gHcitCmdQueueDepth_c - mHcitCmdCount;
+    *pNumCommands = (hostCredits > 0xFFU) ? 0xFFU : (uint8_t)hostCredits;
+
+    OSA_InterruptEnable();
+
+    Hcit_TxRun();
+}
+
+/*! *********************************************************************************
+* \brief  Moves queued commands to the TX queue while the Controller has command
+*         credits.
+*
+* \pre Called with interrupts disabled. Hcit_TxRun() must be called afterwards.
+*
+********************************************************************************** */
+static void Hcit_CmdSchedule(void)
+{
+    hcitCmdTxEntry_t entry;
+
+    while( (mHcitCmdCredits > 0U) && (mHcitCmdCount > 0U) )
+    {
+        entry = mHcitCmdQueue[mHcitCmdHead];
+        mHcitCmdHead = (uint8_t)((mHcitCmdHead + 1U) % gHcitCmdQueueDepth_c);
+        mHcitCmdCount--;
+
+        mHcitCmdCredits--;
+        Hcit_TxQueue(gHciCommandPacket_c, entry.pPacket, entry.packetSize);
+    }
+}
+#endif /* gHcitCmdPipelining_d */
+
+#if mHcitResetSetup_d
+/*! *********************************************************************************
+* \brief  Holds the Reset Command Complete while the transport configures the
+*         Controller, and handles the events answering the setup commands.
+*
+* \param[in]    pPacket     HCI event packet
+* \param[in]    length      Length of the HCI event packet
+*
+* \return  TRUE if the event must not be given to the Host.
+*
+* \remarks The Host sends no command until it gets the Reset Command Complete, so the
+*          setup commands do not interfere with the Host commands.
+*
+********************************************************************************** */
+static bool_t Hcit_SetupProcessEvent(hcitPacket_t* pPacket, uint16_t length)
+{
+    const uint8_t*  pEvent = pPacket->raw;
+    uint16_t        opcode;
+    uint8_t         credits;
+    bool_t          success;
+    bool_t          consumed = FALSE;
+
+    if( (pEvent[0] != (uint8_t)gHciCommandCompleteEvent_c) || (length < 6U) )
+    {
+        return FALSE;
+    }
+
+    /* Event code, length, number of commands, opcode, status */
+    opcode = Utils_ExtractTwoByteValue(&pEvent[3]);
+    success = (pEvent[5] == (uint8_t)gHciSuccess_c);
+
+    if( opcode == HciControllerCmdOpcode(gHciReset_c) )
+    {
+#if gHcitBaudRateUpgrade_d
+        /* The Controller forgets the commands sent before the reset */
+        mHcitBaudVendorPending = FALSE;
+#endif
+#if gHcitHostFlowControl_d
+        OSA_InterruptDisable();
+        Hcit_HfcResetLinks();
+        OSA_InterruptEnable();
+#endif
+        if( success && (mHcitSetupStep == mHcitSetupIdle_c) )
+        {
+            mpHcitResetEvent = pPacket;
+            mHcitResetEventLength = length;
+            mHcitSetupCmdCredits = pEvent[2];
+            Hcit_SetupContinue();
+            consumed = TRUE;
+        }
+
+        return consumed;
+    }
+
+    /* The Host gets the command credits of the last setup command */
+    credits = mHcitSetupCmdCredits;
+    mHcitSetupCmdCredits = pEvent[2];
+
+#if gHcitBaudRateUpgrade_d
+    /* Also consumes a late answer to the vendor command, in any setup step */
+    consumed = Hcit_BaudCommandComplete(opcode, success);
+#endif
+#if gHcitHostFlowControl_d
+    if( !consumed && (mHcitSetupStep == mHcitSetupFlowControl_c) )
+    {
+        consumed = Hcit_HfcCommandComplete(opcode, success);
+    }
+#endif
+
+    if( consumed )
+    {
+        Hcit_RxBufferRelease(pPacket);
+    }
+    else
+    {
+        mHcitSetupCmdCredits = credits;
+    }
+
+    return consumed;
+}
+
+/*! *********************************************************************************
+* \brief  Starts the next setup step. Gives the Reset Command Complete to the Host
+*         once all steps are done or skipped.
+*
+********************************************************************************** */
+static void Hcit_SetupContinue(void)
+{
+    hcitPacket_t*   pEvent;
+    bool_t          started = FALSE;
+
+    while( !started )
+    {
+        mHcitSetupStep++;
+
+        switch( mHcitSetupStep )
+        {
+#if gHcitBaudRateUpgrade_d
+            case mHcitSetupBaudRate_c:
+                started = Hcit_BaudStart();
+                break;
+#endif
+#if gHcitHostFlowControl_d
+            case mHcitSetupFlowControl_c:
+                started = mHcitSetupLinkLost() ? FALSE : Hcit_HfcStart();
+                break;
+#endif
+            case mHcitSetupDone_c:
+                pEvent = mpHcitResetEvent;
+                mpHcitResetEvent = NULL;
+                mHcitSetupStep = mHcitSetupIdle_c;
+
+                pEvent->raw[2] = mHcitSetupCmdCredits;
+                if( mHcitSetupLinkLost() )
+                {
+                    /* Event code, length, number of commands, opcode, status */
+                    pEvent->raw[5] = (uint8_t)gHciHardwareFailure_c;
+                }
+                mTransportInterface(gHciEventPacket_c, pEvent, mHcitResetEventLength);
+#if !gHcitRxZeroCopy_d
+                Hcit_RxBufferRelease(pEvent);
+#endif
+                started = TRUE;
+                break;
+
+            default:
+                /* Step not enabled */
+                break;
+        }
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Sends a command on behalf of the transport.
+*
+* \param[in]    opcode          Command opcode
+* \param[in]    pParams         Command parameters
+* \param[in]    paramsLength    Length of the command parameters
+*
+* \return  gBleSuccess_c or error.
+*
+********************************************************************************** */
+static bleResult_t Hcit_SendTransportCommand(uint16_t opcode, const uint8_t* pParams, uint8_t paramsLength)
+{
+    uint8_t*    pCommand = Hcit_AllocPacket(gHciCommandPacketHeaderLength_c + (uint16_t)paramsLength);
+    bleResult_t result;
+
+    if( NULL == pCommand )
+    {
+        return gBleOutOfMemory_c;
+    }
+
+    Utils_PackTwoByteValue(opcode, &pCommand[0]);
+    pCommand[2] = paramsLength;
+    FLib_MemCpy(&pCommand[gHciCommandPacketHeaderLength_c], pParams, paramsLength);
+
+    /* Goes through the command queue like the commands of the Host */
+    result = Hcit_SendAllocatedPacket(gHciCommandPacket_c, pCommand,
+                                      gHciCommandPacketHeaderLength_c + (uint16_t)paramsLength);
+    if( result == gBleOverflow_c )
+    {
+        Hcit_FreePacket(pCommand);
+    }
+
+    return result;
+}
+#endif /* mHcitResetSetup_d */
+
+#if gHcitBaudRateUpgrade_d
+/*! *********************************************************************************
+* \brief  Asks the Controller to switch to the upgrade baud rate.
+*
+* \return  TRUE if the vendor command was sent.
+*
+********************************************************************************** */
+static bool_t Hcit_BaudStart(void)
+{
+    uint8_t params[4];
+
+    if( (mHcitBaudTarget == 0U) || (mHcitBaudTarget == mHcitBaudRate) )
+    {
+        return FALSE;
+    }
+
+    Utils_PackFourByteValue(mHcitBaudTarget, params);
+
+    mHcitBaudState = mHcitBaudSwitching_c;
+    mHcitBaudVendorPending = TRUE;
+    (void)TMR_StartSingleShotTimer(mHcitBaudTimerId, gHcitBaudVerifyTimeoutMs_c, Hcit_BaudTimeout, NULL);
+
+    if( gBleSuccess_c != Hcit_SendTransportCommand(gHcitBaudVendorOpcode_c, params, sizeof(params)) )
+    {
+        (void)TMR_StopTimer(mHcitBaudTimerId);
+        mHcitBaudState = mHcitBaudIdle_c;
+        mHcitBaudVendorPending = FALSE;
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*! *********************************************************************************
+* \brief  Handles the Command Complete of a baud rate upgrade command.
+*
+* \param[in]    opcode      Command opcode
+* \param[in]    success     TRUE if the command succeeded
+*
+* \return  TRUE if the event answers a baud rate upgrade command.
+*
+* \remarks Called for every Command Complete received during or after the setup, so
+*          that the answer to the vendor command is consumed even after its timeout.
+*
+********************************************************************************** */
+static bool_t Hcit_BaudCommandComplete(uint16_t opcode, bool_t success)
+{
+    hcitBaudState_t state;
+
+    OSA_InterruptDisable();
+    state = mHcitBaudState;
+
+    if( (opcode == gHcitBaudVendorOpcode_c) && mHcitBaudVendorPending )
+    {
+        mHcitBaudVendorPending = FALSE;
+
+        if( state != mHcitBaudSwitching_c )
+        {
+            /* Late answer: the Host did not send this command */
+            OSA_InterruptEnable();
+            return TRUE;
+        }
+    }
+
+    if( (state == mHcitBaudSwitching_c) && (opcode == gHcitBaudVendorOpcode_c) )
+    {
+        /* The Controller switches after sending the Command Complete */
+        mHcitBaudState = success ? mHcitBaudSettling_c : mHcitBaudIdle_c;
+    }
+    else if( ((state == mHcitBaudVerifying_c) || (state == mHcitBaudFallback_c)) &&
+             (opcode == HciInfoCmdOpcode(gHciReadLocalVersionInformation_c)) )
+    {
+        /* The link works at the current baud rate */
+        mHcitBaudState = mHcitBaudIdle_c;
+    }
+    else
+    {
+        state = mHcitBaudIdle_c;
+    }
+    OSA_InterruptEnable();
+
+    if( state == mHcitBaudIdle_c )
+    {
+        return FALSE;
+    }
+
+    (void)TMR_StopTimer(mHcitBaudTimerId);
+
+    if( mHcitBaudState == mHcitBaudSettling_c )
+    {
+        mHcitBaudFallbackRate = mHcitBaudRate;
+        mHcitBaudRate = mHcitBaudTarget;
+        (void)Serial_SetBaudRate(gHcitSerMgrIf, mHcitBaudRate);
+        (void)TMR_StartSingleShotTimer(mHcitBaudTimerId, gHcitBaudSettleTimeMs_c, Hcit_BaudTimeout, NULL);
+    }
+    else
+    {
+        Hcit_BaudDone();
+    }
+
+    return TRUE;
+}
+
+/*! *********************************************************************************
+* \brief  Sends the verification ping after the switch, or falls back to the
+*         previous baud rate when the Controller does not answer.
+*
+* \param[in]    pParam      Not used
+*
+********************************************************************************** */
+static void Hcit_BaudTimeout(void* pParam)
+{
+    hcitBaudState_t state;
+
+    (void)pParam;
+
+    OSA_InterruptDisable();
+    state = mHcitBaudState;
+
+    switch( state )
+    {
+        case mHcitBaudSettling_c:
+            mHcitBaudState = mHcitBaudVerifying_c;
+            break;
+
+        case mHcitBaudVerifying_c:
+            mHcitBaudState = mHcitBaudFallback_c;
+            break;
+
+        default:
+            /* No answer to the vendor command or to the fallback ping */
+            mHcitBaudState = mHcitBaudIdle_c;
+            break;
+    }
+    OSA_InterruptEnable();
+
+    switch( state )
+    {
+        case mHcitBaudSettling_c:
+            break;
+
+        case mHcitBaudVerifying_c:
+            mHcitBaudRate = mHcitBaudFallbackRate;
+            (void)Serial_SetBaudRate(gHcitSerMgrIf, mHcitBaudRate);
+            break;
+
+        case mHcitBaudFallback_c:
+            /* The Controller answers at none of the baud rates */
+            mHcitBaudRate = 0U;
+            Hcit_BaudDone();
+            return;
+
+        case mHcitBaudSwitching_c:
+            Hcit_BaudDone();
+            return;
+
+        default:
+            /* Already completed */
+            return;
+    }
+
+    /* Read Local Version Information is used as ping */
+    (void)TMR_StartSingleShotTimer(mHcitBaudTimerId, gHcitBaudVerifyTimeoutMs_c, Hcit_BaudTimeout, NULL);
+    (void)Hcit_SendTransportCommand(HciInfoCmdOpcode(gHciReadLocalVersionInformation_c), NULL, 0U);
+}
+
+/*! *********************************************************************************
+* \brief  Reports the effective baud rate and resumes the setup.
+*
+********************************************************************************** */
+static void Hcit_BaudDone(void)
+{
+    if( NULL != mpfHcitBaudCallback )
+    {
+        mpfHcitBaudCallback(mHcitBaudRate);
+    }
+
+    Hcit_SetupContinue();
+}
+#endif /* gHcitBaudRateUpgrade_d */
+
+#if gHcitHostFlowControl_d
+/*! *********************************************************************************
+* \brief  Declares the ACL packets the Host can hold to the Controller.
+*
+* \return  TRUE if the command was sent.
+*
+********************************************************************************** */
+static bool_t Hcit_HfcStart(void)
+{
+    uint8_t params[7];
+
+    /* ACL data packet length, synchronous data packet length,
+       total number of ACL and synchronous data packets */
+    Utils_PackTwoByteValue(gHcLeAclDataPacketLengthDefault_c, &params[0]);
+    params[2] = 0U;
+    Utils_PackTwoByteValue(gHcitHostFlowAclPackets_c, &params[3]);
+    Utils_PackTwoByteValue(0U, &params[5]);
+
+    if( gBleSuccess_c != Hcit_SendTransportCommand(HciControllerCmdOpcode(gHciHostBufferSize_c), params, sizeof(params)) )
+    {
+        return FALSE;
+    }
+
+    mHcitHfcState = mHcitHfcBufferSize_c;
+    return TRUE;
+}
+
+/*! *********************************************************************************
+* \brief  Handles the Command Complete of a flow control setup command.
+*
+* \param[in]    opcode      Command opcode
+* \param[in]    success     TRUE if the command succeeded
+*
+* \return  TRUE if the event answers a flow control setup command.
+*
+********************************************************************************** */
+static bool_t Hcit_HfcCommandComplete(uint16_t opcode, bool_t success)
+{
+    uint8_t flowControl = (uint8_t)gHciFlowControlOnAclPacketsOffHciSyncPackets_c;
+
+    if( (mHcitHfcState == mHcitHfcBufferSize_c) && (opcode == HciControllerCmdOpcode(gHciHostBufferSize_c)) )
+    {
+        if( success &&
+            (gBleSuccess_c == Hcit_SendTransportCommand(HciControllerCmdOpcode(gHciSetControllerToHostFlowControl_c),
+                                                        &flowControl, 1U)) )
+        {
+            mHcitHfcState = mHcitHfcEnabling_c;
+        }
+        else
+        {
+            mHcitHfcState = mHcitHfcDisabled_c;
+            Hcit_SetupContinue();
+        }
+    }
+    else if( (mHcitHfcState == mHcitHfcEnabling_c) &&
+             (opcode == HciControllerCmdOpcode(gHciSetControllerToHostFlowControl_c)) )
+    {
+        mHcitHfcState = success ? mHcitHfcEnabled_c : mHcitHfcDisabled_c;
+        Hcit_SetupContinue();
+    }
+    else
+    {
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*! *********************************************************************************
+* \brief  Tracks the disconnections and consumes the answers to the completed
+*         packets reports.
+*
+* \param[in]    pPacket     HCI event packet
+* \param[in]    length      Length of the HCI event packet
+*
+* \return  TRUE if the event must not be given to the Host.
+*
+********************************************************************************** */
+static bool_t Hcit_HfcProcessEvent(hcitPacket_t* pPacket, uint16_t length)
+{
+    const uint8_t*  pEvent = pPacket->raw;
+    hcitHfcLink_t*  pLink;
+
+    if( (pEvent[0] == (uint8_t)gHciDisconnectionCompleteEvent_c) && (length >= 5U) &&
+        (pEvent[2] == (uint8_t)gHciSuccess_c) )
+    {
+        OSA_InterruptDisable();
+        pLink = Hcit_HfcGetLink(Utils_ExtractTwoByteValue(&pEvent[3]) & mHcitAclHandleMask_c, FALSE);
+
+        if( NULL != pLink )
+        {
+            /* The Controller takes back the buffers of the link */
+            mHcitHfcCompleted -= pLink->completed;
+            pLink->handle = mHcitAclInvalidHandle_c;
+            pLink->inUse = 0U;
+            pLink->completed = 0U;
+        }
+        OSA_InterruptEnable();
+    }
+    else if( (pEvent[0] == (uint8_t)gHciCommandCompleteEvent_c) && (length >= 6U) &&
+             (Utils_ExtractTwoByteValue(&pEvent[3]) == HciControllerCmdOpcode(gHciHostNumberOfCompletedPackets_c)) &&
+             (mHcitHfcState == mHcitHfcEnabled_c) )
+    {
+        /* Only sent by the transport, answered only on error */
+        Hcit_RxBufferRelease(pPacket);
+        return TRUE;
+    }
+    else
+    {
+        /* Not relevant for flow control */
+    }
+
+    return FALSE;
+}
+
+/*! *********************************************************************************
+* \brief  Counts a received ACL packet as using one Host buffer.
+*
+* \param[in]    pPacket     HCI ACL data packet
+*
+********************************************************************************** */
+static void Hcit_HfcPacketReceived(const uint8_t* pPacket)
+{
+    hcitHfcLink_t* pLink;
+
+    OSA_InterruptDisable();
+    if( mHcitHfcState == mHcitHfcEnabled_c )
+    {
+        pLink = Hcit_HfcGetLink(Utils_ExtractTwoByteValue(pPacket) & mHcitAclHandleMask_c, TRUE);
+
+        if( NULL != pLink )
+        {
+            pLink->inUse++;
+        }
+    }
+    OSA_InterruptEnable();
+}
+
+/*! *********************************************************************************
+* \brief  Counts a released ACL buffer and reports it to the Controller.
+*
+* \param[in]    handle      Connection handle of the released HCI ACL data packet
+* \param[in]    poolFree    TRUE if no ACL receive buffer is in use
+*
+********************************************************************************** */
+static void Hcit_HfcPacketReleased(uint16_t handle, bool_t poolFree)
+{
+    hcitHfcLink_t* pLink;
+
+    OSA_InterruptDisable();
+    pLink = Hcit_HfcGetLink(handle, FALSE);
+
+    /* Packets received before the flow control was enabled are not counted */
+    if( (NULL != pLink) && (pLink->inUse > 0U) )
+    {
+        pLink->inUse--;
+        pLink->completed++;
+        mHcitHfcCompleted++;
+    }
+    OSA_InterruptEnable();
+
+    Hcit_HfcReport(poolFree);
+}
+
+/*! *********************************************************************************
+* \brief  Reports the released ACL buffers to the Controller with Host Number Of
+*         Completed Packets, once the Host has processed its pending packets.
+*
+* \param[in]    poolFree    TRUE to report the packets even below the batch size
+*
+* \remarks The Host copies the received packets in its queue, so a released buffer
+*          does not mean that the Host is done with the packet. The report is held,
+*          and retried every gHcitHostFlowPollMs_c, while more than
+*          gHcitHostFlowQueueLimit_c ACL packets wait for the Host (pfHostAclPending)
+*          or are held by the ACL receive demultiplexing. Events waiting for the Host
+*          do not hold the reports.
+*
+********************************************************************************** */
+static void Hcit_HfcReport(bool_t poolFree)
+{
+    uint8_t     params[mHcitHfcMaxParamsLength_c];
+    uint8_t     length = 1U;
+    uint32_t    i;
+
+    OSA_InterruptDisable();
+
+    if( (mHcitHfcCompleted == 0U) || ((mHcitHfcCompleted < gHcitHostFlowCreditBatch_c) && !poolFree) )
+    {
+        OSA_InterruptEnable();
+        return;
+    }
+
+    if( Hcit_HostAclPending() > gHcitHostFlowQueueLimit_c )
+    {
+        OSA_InterruptEnable();
+
+        if( !TMR_IsTimerActive(mHcitHfcTimerId) )
+        {
+            (void)TMR_StartSingleShotTimer(mHcitHfcTimerId, gHcitHostFlowPollMs_c, Hcit_HfcTimeout, NULL);
+        }
+        return;
+    }
+
+    /* Number of handles, then handle and number of completed packets */
+    params[0] = 0U;
+    for( i = 0U; i < gHcitAclMaxLinks_c; i++ )
+    {
+        if( mHcitHfcLinks[i].completed > 0U )
+        {
+            Utils_PackTwoByteValue(mHcitHfcLinks[i].handle, &params[length]);
+            Utils_PackTwoByteValue(mHcitHfcLinks[i].completed, &params[length + 2U]);
+            length += 4U;
+            params[0]++;
+            mHcitHfcLinks[i].completed = 0U;
+        }
+    }
+    mHcitHfcCompleted = 0U;
+    OSA_InterruptEnable();
+
+    (void)Hcit_SendTransportCommand(HciControllerCmdOpcode(gHciHostNumberOfCompletedPackets_c), params, length);
+}
+
+/*! *********************************************************************************
+* \brief  Retries a completed packets report held by a busy Host.
+*
+* \param[in]    pParam      Not used
+*
+********************************************************************************** */
+static void Hcit_HfcTimeout(void* pParam)
+{
+    (void)pParam;
+    Hcit_HfcReport(TRUE);
+}
+
+/*! *********************************************************************************
+* \brief  Returns the flow control slot of a connection.
+*
+* \param[in]    handle      Connection handle
+* \param[in]    allocate    TRUE to take a free slot if the connection has none
+*
+* \return  Pointer to the link slot or NULL.
+*
+* \pre Called with interrupts disabled.
+*
+********************************************************************************** */
+static hcitHfcLink_t* Hcit_HfcGetLink(uint16_t handle, bool_t allocate)
+{
+    hcitHfcLink_t*  pFree = NULL;
+    uint32_t        i;
+
+    for( i = 0U; i < gHcitAclMaxLinks_c; i++ )
+    {
+        if( mHcitHfcLinks[i].handle == handle )
+        {
+            return &mHcitHfcLinks[i];
+        }
+
+        if( (NULL == pFree) && (mHcitHfcLinks[i].handle == mHcitAclInvalidHandle_c) )
+        {
+            pFree = &mHcitHfcLinks[i];
+        }
+    }
+
+    if( allocate && (NULL != pFree) )
+    {
+        pFree->handle = handle;
+    }
+    else
+    {
+        pFree = NULL;
+    }
+
+    return pFree;
+}
+
+/*! *********************************************************************************
+* \brief  Forgets all connections. The Controller resets its buffer accounting.
+*
+********************************************************************************** */
+static void Hcit_HfcResetLinks(void)
+{
+    uint32_t i;
+
+    for( i = 0U; i < gHcitAclMaxLinks_c; i++ )
+    {
+        mHcitHfcLinks[i].handle = mHcitAclInvalidHandle_c;
+        mHcitHfcLinks[i].inUse = 0U;
+        mHcitHfcLinks[i].completed = 0U;
+    }
+
+    mHcitHfcCompleted = 0U;
+    mHcitHfcState = mHcitHfcDisabled_c;
+}
+
+/*! *********************************************************************************
+* \brief  Returns the number of received ACL packets the Host has not taken yet: the
+*         ones in its queue (pfHostAclPending) and the ones held by the transport.
+*
+********************************************************************************** */
+static uint32_t Hcit_HostAclPending(void)
+{
+    uint32_t pending = mHcitAclRxHeld();
+
+    if( NULL != mpfHcitHostAclPending )
+    {
+        pending += mpfHcitHostAclPending();
+    }
+
+    return pending;
+}
+#endif /* gHcitHostFlowControl_d */
+
+#if gHcitAclRxDemux_d
+/*! *********************************************************************************
+* \brief  Gives a received packet to the Host, or holds it if it is ACL data and the
+*         Host is busy.
+*
+* \param[in]    packetType  HCI packet type
+* \param[in]    pPacket     HCI packet, kept by the caller
+* \param[in]    packetSize  Size of the HCI packet
+*
+* \remarks Only one context is the deliverer at a time, as for the TX writer. A
+*          context finding the deliverer busy, such as the receive interrupt
+*          preempting the poll timer, leaves a copy of its packet in the deferred
+*          queue: the deliverer takes it before it stops. Without memory for the copy,
+*          the packet is given to the Host at once, possibly out of order.
+*
+********************************************************************************** */
+static void Hcit_AclRxReceive(hciPacketType_t packetType, void* pPacket, uint16_t packetSize)
+{
+    hcitAclRxPacket_t*  pCopy;
+    bool_t              run;
+
+    OSA_InterruptDisable();
+    run = !mHcitAclRxRunning;
+    mHcitAclRxRunning = TRUE;
+    OSA_InterruptEnable();
+
+    if( run )
+    {
+        Hcit_AclRxDispatch(packetType, pPacket, packetSize, NULL);
+    }
+    else
+    {
+        pCopy = Hcit_AclRxCopy(packetType, pPacket, packetSize);
+
+        if( NULL == pCopy )
+        {
+            mTransportInterface(packetType, pPacket, packetSize);
+            return;
+        }
+
+        OSA_InterruptDisable();
+        if( NULL == mpHcitAclRxDeferredTail )
+        {
+            mpHcitAclRxDeferredHead = pCopy;
+        }
+        else
+        {
+            mpHcitAclRxDeferredTail->pNext = pCopy;
+        }
+        mpHcitAclRxDeferredTail = pCopy;
+        OSA_InterruptEnable();
+    }
+
+    Hcit_AclRxRun(run);
+}
+
+/*! *********************************************************************************
+* \brief  Drops the held ACL packets on HCI Reset.
+*
+* \param[in]    pEvent      HCI event packet
+* \param[in]    length      Length of the HCI event packet
+*
+* \remarks The Controller forgets all connections on HCI Reset. The deliverer drops
+*          the held packets before it gives the next packet to the Host.
+*
+********************************************************************************** */
+static void Hcit_AclRxProcessEvent(const uint8_t* pEvent, uint16_t length)
+{
+    if( (pEvent[0] == (uint8_t)gHciCommandCompleteEvent_c) && (length >= 6U) &&
+        (pEvent[5] == (uint8_t)gHciSuccess_c) &&
+        (Utils_ExtractTwoByteValue(&pEvent[3]) == HciControllerCmdOpcode(gHciReset_c)) )
+    {
+        OSA_InterruptDisable();
+        mHcitAclRxResetPending = TRUE;
+        OSA_InterruptEnable();
+
+        Hcit_AclRxRun(FALSE);
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Gives the deferred packets to the Host, then the held ACL packets while the
+*         Host is not busy, and releases the deliverer.
+*
+* \param[in]    running     TRUE if the caller is the deliverer
+*
+* \remarks The deferred queue is checked and the deliverer released under the same
+*          lock. The poll timer runs while ACL packets are held.
+*
+********************************************************************************** */
+static void Hcit_AclRxRun(bool_t running)
+{
+    hcitAclRxPacket_t*  pDeferred;
+    bool_t              run = running;
+    bool_t              reset;
+
+    OSA_InterruptDisable();
+    if( !run )
+    {
+        run = !mHcitAclRxRunning;
+        mHcitAclRxRunning = TRUE;
+    }
+
+    while( run )
+    {
+        pDeferred = mpHcitAclRxDeferredHead;
+        if( NULL != pDeferred )
+        {
+            mpHcitAclRxDeferredHead = pDeferred->pNext;
+            if( NULL == mpHcitAclRxDeferredHead )
+            {
+                mpHcitAclRxDeferredTail = NULL;
+            }
+        }
+        reset = mHcitAclRxResetPending;
+        mHcitAclRxResetPending = FALSE;
+        OSA_InterruptEnable();
+
+        if( reset )
+        {
+            Hcit_AclRxDiscard();
+        }
+
+        if( NULL != pDeferred )
+        {
+            Hcit_AclRxDispatch(pDeferred->packetType, mHcitAclRxPacketData(pDeferred), pDeferred->packetSize, pDeferred);
+            OSA_InterruptDisable();
+        }
+        else
+        {
+            Hcit_AclRxDrain();
+            OSA_InterruptDisable();
+
+            if( (NULL == mpHcitAclRxDeferredHead) && !mHcitAclRxResetPending )
+            {
+                mHcitAclRxRunning = FALSE;
+                run = FALSE;
+            }
+        }
+    }
+
+    OSA_InterruptEnable();
+
+    if( (mHcitAclRxHeld > 0U) && !TMR_IsTimerActive(mHcitAclRxTimerId) )
+    {
+        (void)TMR_StartSingleShotTimer(mHcitAclRxTimerId, gHcitAclRxPollMs_c, Hcit_AclRxTimeout, NULL);
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Gives a packet to the Host or holds it.
+*
+* \param[in]    packetType  HCI packet type
+* \param[in]    pPacket     HCI packet
+* \param[in]    packetSize  Size of the HCI packet
+* \param[in]    pCopy       Copy holding the packet, freed or held, or NULL if the
+*                           packet is kept by the caller
+*
+* \remarks ACL data is held while the Host is busy or older data of the connection is
+*          held. The held data of a connection is given to the Host before the events
+*          that change the state of the connection. Other events go ahead of it.
+*
+* \pre Called by the deliverer.
+*
+********************************************************************************** */
+static void Hcit_AclRxDispatch
+    (
+        hciPacketType_t     packetType,
+        void*               pPacket,
+        uint16_t            packetSize,
+        hcitAclRxPacket_t*  pCopy
+    )
+{
+    const uint8_t*      pRaw = (const uint8_t*)pPacket;
+    hcitAclRxLink_t*    pLink = NULL;
+    bool_t              hold = FALSE;
+    bool_t              closed = FALSE;
+
+    if( packetType == gHciDataPacket_c )
+    {
+        pLink = Hcit_AclRxGetLink(Utils_ExtractTwoByteValue(pRaw) & mHcitAclHandleMask_c, TRUE);
+
+        /* Given to the Host at once if there are more connections than slots */
+        if( NULL != pLink )
+        {
+            pLink->stats.packets++;
+            pLink->stats.bytes += packetSize;
+            hold = (pLink->stats.queued > 0U) || Hcit_AclRxHostBusy();
+        }
+    }
+    else if( (packetType == gHciEventPacket_c) && (packetSize >= 5U) &&
+             ((pRaw[0] == (uint8_t)gHciDisconnectionCompleteEvent_c) ||
+              (pRaw[0] == (uint8_t)gHciEncryptionChangeEvent_c) ||
+              (pRaw[0] == (uint8_t)gHciEncryptionKeyRefreshCompleteEvent_c)) )
+    {
+        /* Event code, length, status, connection handle */
+        pLink = Hcit_AclRxGetLink(Utils_ExtractTwoByteValue(&pRaw[3]) & mHcitAclHandleMask_c, FALSE);
+
+        if( NULL != pLink )
+        {
+            Hcit_AclRxFlushLink(pLink);
+            closed = (pRaw[0] == (uint8_t)gHciDisconnectionCompleteEvent_c) && (pRaw[2] == (uint8_t)gHciSuccess_c);
+        }
+    }
+    else
+    {
+        /* Goes ahead of the held ACL data */
+    }
+
+    if( hold )
+    {
+        if( NULL == pCopy )
+        {
+            pCopy = Hcit_AclRxCopy(packetType, pPacket, packetSize);
+        }
+
+        if( NULL != pCopy )
+        {
+            Hcit_AclRxHold(pLink, pCopy);
+            return;
+        }
+
+        /* No memory left: the held packets of the connection go first */
+        pLink->stats.bypassed++;
+        Hcit_AclRxFlushLink(pLink);
+    }
+
+    mTransportInterface(packetType, pPacket, packetSize);
+
+    if( NULL != pCopy )
+    {
+        /* The transport interface copies the packet before returning */
+        (void)MEM_BufferFree(pCopy);
+    }
+
+    if( closed )
+    {
+        Hcit_AclRxFreeLink(pLink);
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Adds a copied ACL packet to the queue of its connection. When the queue is
+*         full, its oldest packet is given to the Host first.
+*
+* \param[in]    pLink       Connection slot
+* \param[in]    pCopy       Copy of the HCI ACL data packet
+*
+* \pre Called by the deliverer.
+*
+********************************************************************************** */
+static void Hcit_AclRxHold(hcitAclRxLink_t* pLink, hcitAclRxPacket_t* pCopy)
+{
+    if( pLink->stats.queued == gHcitAclRxQueueDepth_c )
+    {
+        pLink->stats.overflows++;
+        Hcit_AclRxDeliver(pLink);
+    }
+
+    pCopy->pNext = NULL;
+
+    OSA_InterruptDisable();
+    if( NULL == pLink->pTail )
+    {
+        pLink->pHead = pCopy;
+    }
+    else
+    {
+        pLink->pTail->pNext = pCopy;
+    }
+    pLink->pTail = pCopy;
+    pLink->stats.held++;
+    pLink->stats.queued++;
+    mHcitAclRxHeld++;
+
+    if( pLink->stats.queued > pLink->stats.maxQueued )
+    {
+        pLink->stats.maxQueued = pLink->stats.queued;
+    }
+    OSA_InterruptEnable();
+}
+
+/*! *********************************************************************************
+* \brief  Gives the oldest held ACL packet of a connection to the Host.
+*
+* \param[in]    pLink       Connection slot with at least one held packet
+*
+* \pre Called by the deliverer.
+*
+********************************************************************************** */
+static void Hcit_AclRxDeliver(hcitAclRxLink_t* pLink)
+{
+    hcitAclRxPacket_t* pCopy;
+
+    OSA_InterruptDisable();
+    pCopy = pLink->pHead;
+    pLink->pHead = pCopy->pNext;
+    if( NULL == pLink->pHead )
+    {
+        pLink->pTail = NULL;
+    }
+    pLink->stats.queued--;
+    mHcitAclRxHeld--;
+    OSA_InterruptEnable();
+
+    mTransportInterface(pCopy->packetType, mHcitAclRxPacketData(pCopy), pCopy->packetSize);
+
+    /* The transport interface copies the packet before returning */
+    (void)MEM_BufferFree(pCopy);
+}
+
+/*! *********************************************************************************
+* \brief  Gives all the held ACL packets of a connection to the Host.
+*
+* \param[in]    pLink       Connection slot
+*
+* \pre Called by the deliverer.
+*
+********************************************************************************** */
+static void Hcit_AclRxFlushLink(hcitAclRxLink_t* pLink)
+{
+    while( pLink->stats.queued > 0U )
+    {
+        Hcit_AclRxDeliver(pLink);
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Gives the held ACL packets to the Host while it is not busy, one packet per
+*         connection in each round.
+*
+* \pre Called by the deliverer.
+*
+********************************************************************************** */
+static void Hcit_AclRxDrain(void)
+{
+    hcitAclRxLink_t* pLink;
+
+    while( (mHcitAclRxHeld > 0U) && !Hcit_AclRxHostBusy() )
+    {
+        pLink = &mHcitAclRxLinks[mHcitAclRxRrIndex];
+        mHcitAclRxRrIndex = (uint8_t)((mHcitAclRxRrIndex + 1U) % gHcitAclMaxLinks_c);
+
+        if( pLink->stats.queued > 0U )
+        {
+            Hcit_AclRxDeliver(pLink);
+        }
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Drops the held ACL packets and forgets all connections.
+*
+* \pre Called by the deliverer.
+*
+********************************************************************************** */
+static void Hcit_AclRxDiscard(void)
+{
+    hcitAclRxPacket_t*  pCopy;
+    uint32_t            i;
+
+    for( i = 0U; i < gHcitAclMaxLinks_c; i++ )
+    {
+        while( NULL != mHcitAclRxLinks[i].pHead )
+        {
+            pCopy = mHcitAclRxLinks[i].pHead;
+            mHcitAclRxLinks[i].pHead = pCopy->pNext;
+            (void)MEM_BufferFree(pCopy);
+        }
+
+        Hcit_AclRxFreeLink(&mHcitAclRxLinks[i]);
+    }
+
+    OSA_InterruptDisable();
+    mHcitAclRxHeld = 0U;
+    OSA_InterruptEnable();
+}
+
+/*! *********************************************************************************
+* \brief  Gives the held ACL packets to the Host once it has taken its packets.
+*
+* \param[in]    pParam      Not used
+*
+********************************************************************************** */
+static void Hcit_AclRxTimeout(void* pParam)
+{
+    (void)pParam;
+    Hcit_AclRxRun(FALSE);
+}
+
+/*! *********************************************************************************
+* \brief  Returns TRUE if gHcitAclRxHostDepth_c or more ACL packets wait for the Host.
+*
+********************************************************************************** */
+static bool_t Hcit_AclRxHostBusy(void)
+{
+    return (NULL != mpfHcitHostAclPending) && (mpfHcitHostAclPending() >= gHcitAclRxHostDepth_c);
+}
+
+/*! *********************************************************************************
+* \brief  Copies a received packet, to give it to the Host later.
+*
+* \param[in]    packetType  HCI packet type
+* \param[in]    pPacket     HCI packet
+* \param[in]    packetSize  Size of the HCI packet
+*
+* \return  Pointer to the copy, allocated with MEM_BufferAlloc(), or NULL.
+*
+********************************************************************************** */
+static hcitAclRxPacket_t* Hcit_AclRxCopy(hciPacketType_t packetType, const void* pPacket, uint16_t packetSize)
+{
+    hcitAclRxPacket_t* pCopy = MEM_BufferAlloc(sizeof(hcitAclRxPacket_t) + (uint32_t)packetSize);
+
+    if( NULL != pCopy )
+    {
+        pCopy->pNext = NULL;
+        pCopy->packetSize = packetSize;
+        pCopy->packetType = packetType;
+        FLib_MemCpy(mHcitAclRxPacketData(pCopy), (void*)pPacket, packetSize);
+    }
+
+    return pCopy;
+}
+
+/*! *********************************************************************************
+* \brief  Returns the receive slot of a connection.
+*
+* \param[in]    handle      HCI connection handle
+* \param[in]    allocate    TRUE to take a free slot if the connection has none
+*
+* \return  Pointer to the connection slot or NULL.
+*
+* \remarks Slots are taken and freed only by the deliverer.
+*
+********************************************************************************** */
+static hcitAclRxLink_t* Hcit_AclRxGetLink(uint16_t handle, bool_t allocate)
+{
+    hcitAclRxLink_t*    pFree = NULL;
+    uint32_t            i;
+
+    for( i = 0U; i < gHcitAclMaxLinks_c; i++ )
+    {
+        if( mHcitAclRxLinks[i].handle == handle )
+        {
+            return &mHcitAclRxLinks[i];
+        }
+
+        if( (NULL == pFree) && (mHcitAclRxLinks[i].handle == mHcitAclInvalidHandle_c) )
+        {
+            pFree = &mHcitAclRxLinks[i];
+        }
+    }
+
+    if( allocate && (NULL != pFree) )
+    {
+        pFree->handle = handle;
+    }
+    else
+    {
+        pFree = NULL;
+    }
+
+    return pFree;
+}
+
+/*! *********************************************************************************
+* \brief  Frees the receive slot of a connection and clears its counters.
+*
+* \param[in]    pLink       Connection slot without held packets
+*
+********************************************************************************** */
+static void Hcit_AclRxFreeLink(hcitAclRxLink_t* pLink)
+{
+    OSA_InterruptDisable();
+    FLib_MemSet(pLink, 0U, sizeof(hcitAclRxLink_t));
+    pLink->handle = mHcitAclInvalidHandle_c;
+    OSA_InterruptEnable();
+}
+#endif /* gHcitAclRxDemux_d */
+
+#if gHcitStatistics_d
+/*! *********************************************************************************
+* \brief  Increments a counter.
+*
+* \param[in]    pCounter    Counter in mHcitStats
+*
+********************************************************************************** */
+static void Hcit_StatsCount(uint32_t* pCounter)
+{
+    OSA_InterruptDisable();
+    (*pCounter)++;
+    OSA_InterruptEnable();
+}
+
+/*! *********************************************************************************
+* \brief  Accounts a packet going through the transport and tracks the commands
+*         until their Command Complete or Command Status event.
+*
+* \param[in]    packetType  HCI packet type
+* \param[in]    pPacket     HCI packet
+* \param[in]    packetSize  Size of the HCI packet
+* \param[in]    received    TRUE for a packet received from the serial interface
+*
+********************************************************************************** */
+static void Hcit_StatsPacket(hciPacketType_t packetType, const uint8_t* pPacket, uint16_t packetSize, bool_t received)
+{
+    uint32_t index = ((uint32_t)packetType < gHcitStatsPacketTypes_c) ? (uint32_t)packetType : 0U;
+
+    OSA_InterruptDisable();
+
+    if( received )
+    {
+        mHcitStats.rxPackets[index]++;
+        mHcitStats.rxBytes[index] += 1U + (uint32_t)packetSize;
+    }
+    else
+    {
+        mHcitStats.txPackets[index]++;
+        mHcitStats.txBytes[index] += 1U + (uint32_t)packetSize;
+    }
+
+    /* Host Number Of Completed Packets has no Command Complete */
+    if( (packetType == gHciCommandPacket_c) && (packetSize >= gHciCommandPacketHeaderLength_c) &&
+        (Utils_ExtractTwoByteValue(pPacket) != HciControllerCmdOpcode(gHciHostNumberOfCompletedPackets_c)) )
+    {
+        Hcit_StatsCommandSent(Utils_ExtractTwoByteValue(pPacket));
+    }
+    else if( (packetType == gHciEventPacket_c) &&
+             (pPacket[0] == (uint8_t)gHciCommandCompleteEvent_c) && (packetSize >= 5U) )
+    {
+        /* Event code, length, number of commands, opcode */
+        Hcit_StatsCommandCompleted(Utils_ExtractTwoByteValue(&pPacket[3]));
+    }
+    else if( (packetType == gHciEventPacket_c) &&
+             (pPacket[0] == (uint8_t)gHciCommandStatusEvent_c) && (packetSize >= 6U) )
+    {
+        /* Event code, length, status, number of commands, opcode */
+        Hcit_StatsCommandCompleted(Utils_ExtractTwoByteValue(&pPacket[4]));
+    }
+    else
+    {
+        /* No latency tracking */
+    }
+
+    OSA_InterruptEnable();
+}
+
+/*! *********************************************************************************
+* \brief  Records the time a command went through the transport.
+*
+* \param[in]    opcode      HCI command opcode
+*
+* \pre Called with interrupts disabled.
+*
+********************************************************************************** */
+static void Hcit_StatsCommandSent(uint16_t opcode)
+{
+    uint32_t i;
 
-        hci_processReceivedChar(recvChar);
-        if( Serial_GetByteFromRxBuffer( gHcitSerMgrIf, &recvChar, &count) != gSerial_Success_c )
+    for( i = 0U; i < gHcitStatsMaxPendingCmds_c; i++ )
+    {
+        if( mHcitPendingCmds[i].opcode == 0U )
         {
+            mHcitPendingCmds[i].opcode = opcode;
+            mHcitPendingCmds[i].timestamp = TMR_GetTimestamp();
             return;
         }
     }
+
+    mHcitStats.latencyOverflows++;
+}
+
+/*! *********************************************************************************
+* \brief  Adds the latency of a completed command to the histogram of its opcode.
+*
+* \param[in]    opcode      HCI command opcode
+*
+* \pre Called with interrupts disabled.
+*
+********************************************************************************** */
+static void Hcit_StatsCommandCompleted(uint16_t opcode)
+{
+    hcitCmdLatency_t*   pHistogram = NULL;
+    uint32_t            latency = 0U;
+    uint32_t            i;
+    bool_t              found = FALSE;
+
+    for( i = 0U; i < gHcitStatsMaxPendingCmds_c; i++ )
+    {
+        if( (mHcitPendingCmds[i].opcode == opcode) && (opcode != 0U) )
+        {
+            latency = (uint32_t)(TMR_GetTimestamp() - mHcitPendingCmds[i].timestamp);
+            mHcitPendingCmds[i].opcode = 0U;
+            found = TRUE;
+            break;
+        }
+    }
+
+    if( !found )
+    {
+        /* NOP Command Complete, or a command that was not tracked */
+        return;
+    }
+
+    for( i = 0U; i < gHcitStatsMaxOpcodes_c; i++ )
+    {
+        if( (mHcitCmdLatency[i].opcode == opcode) || (mHcitCmdLatency[i].opcode == 0U) )
+        {
+            pHistogram = &mHcitCmdLatency[i];
+            pHistogram->opcode = opcode;
+            break;
+        }
+    }
+
+    if( NULL == pHistogram )
+    {
+        mHcitStats.latencyOverflows++;
+        return;
+    }
+
+    for( i = 0U; i < (gHcitLatencyBucketCount_c - 1U); i++ )
+    {
+        if( latency < mHcitLatencyBucketBounds[i] )
+        {
+            break;
+        }
+    }
+
+    pHistogram->buckets[i]++;
+    pHistogram->count++;
+    if( latency > pHistogram->maxUs )
+    {
+        pHistogram->maxUs = latency;
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Tracks the number of serial writes in progress.
+*
+* \param[in]    started     TRUE when a write starts, FALSE when it ends
+*
+********************************************************************************** */
+static void Hcit_StatsTxQueue(bool_t started)
+{
+    OSA_InterruptDisable();
+    if( started )
+    {
+        mHcitStats.txQueueDepth++;
+        if( mHcitStats.txQueueDepth > mHcitStats.txQueueDepthMax )
+        {
+            mHcitStats.txQueueDepthMax = mHcitStats.txQueueDepth;
+        }
+    }
+    else if( mHcitStats.txQueueDepth > 0U )
+    {
+        mHcitStats.txQueueDepth--;
+    }
+    else
+    {
+        /* Counters were reset while the write was in progress */
+    }
+    OSA_InterruptEnable();
+}
+
+/*! *********************************************************************************
+* \brief  Serial write completion callback. Frees the written buffer.
+*
+* \param[in]    pParam      The buffer that was written
+*
+********************************************************************************** */
+static void Hcit_TxBufferWritten(void* pParam)
+{
+    mHcitStatsTxWriteDone();
+    (void)MEM_BufferFree(pParam);
+}
+#endif /* gHcitStatistics_d */
+
+#if gHcitIsoSupport_d
+/*! *********************************************************************************
+* \brief  Checks the length field of an outgoing ISO or synchronous data packet.
+*
+* \param[in]    packetType  HCI packet type
+* \param[in]    pPacket     HCI packet, without the packet type marker
+* \param[in]    packetSize  Size of the HCI packet
+*
+* \return  gBleSuccess_c or gBleInvalidParameter_c.
+*
+********************************************************************************** */
+static bleResult_t Hcit_CheckDataPacket(hciPacketType_t packetType, const uint8_t* pPacket, uint16_t packetSize)
+{
+    bleResult_t result = gBleSuccess_c;
+
+    switch( (uint8_t)packetType )
+    {
+        case gHciSynchronousDataPacket_c:
+            if( (packetSize < mHcitSyncHeaderLength_c) ||
+                (pPacket[2] != (packetSize - mHcitSyncHeaderLength_c)) )
+            {
+                result = gBleInvalidParameter_c;
+            }
+            break;
+
+        case gHcitIsoDataPacket_c:
+            if( (packetSize < mHcitIsoHeaderLength_c) ||
+                ((Utils_ExtractTwoByteValue(&pPacket[2]) & mHcitIsoDataLengthMask_c) != (packetSize - mHcitIsoHeaderLength_c)) )
+            {
+                result = gBleInvalidParameter_c;
+            }
+            break;
+
+        default:
+            ; /* For MISRA compliance */
+            break;
+    }
+
+    return result;
+}
+
+/*! *********************************************************************************
+* \brief  Parses a received ISO data packet and gives it to the application.
+*
+* \param[in]    pPacket     HCI ISO data packet
+* \param[in]    packetSize  Size of the HCI ISO data packet
+*
+* \remarks The packet buffer is released when the callback returns.
+*
+********************************************************************************** */
+static void Hcit_IsoDataReceived(const uint8_t* pPacket, uint16_t packetSize)
+{
+    hcitIsoPacket_t isoPacket;
+    uint16_t        handleAndFlags;
+    uint16_t        offset = mHcitIsoHeaderLength_c;
+    uint16_t        sduField;
+
+    if( NULL == mpfHcitIsoDataCallback )
+    {
+        return;
+    }
+
+    handleAndFlags = Utils_ExtractTwoByteValue(pPacket);
+
+    isoPacket.connectionHandle = handleAndFlags & mHcitAclHandleMask_c;
+    isoPacket.pbFlag = (uint8_t)((handleAndFlags >> 12U) & 0x03U);
+    isoPacket.timestampPresent = FALSE;
+    isoPacket.timestamp = 0U;
+    isoPacket.sduHeaderPresent = FALSE;
+    isoPacket.packetSequenceNumber = 0U;
+    isoPacket.isoSduLength = 0U;
+    isoPacket.packetStatusFlag = 0U;
+
+    /* The timestamp and the SDU header are only present in the first fragment */
+    if( (isoPacket.pbFlag == mHcitIsoPbFirstFragment_c) || (isoPacket.pbFlag == mHcitIsoPbComplete_c) )
+    {
+        if( ((handleAndFlags & mHcitIsoTsFlag_c) != 0U) && (packetSize >= (offset + 4U)) )
+        {
+            isoPacket.timestampPresent = TRUE;
+            isoPacket.timestamp = Utils_ExtractFourByteValue(&pPacket[offset]);
+            offset += 4U;
+        }
+
+        if( packetSize >= (offset + 4U) )
+        {
+            isoPacket.sduHeaderPresent = TRUE;
+            isoPacket.packetSequenceNumber = Utils_ExtractTwoByteValue(&pPacket[offset]);
+            sduField = Utils_ExtractTwoByteValue(&pPacket[offset + 2U]);
+            isoPacket.isoSduLength = sduField & 0x0FFFU;
+            isoPacket.packetStatusFlag = (uint8_t)(sduField >> 14U);
+            offset += 4U;
+        }
+    }
+
+    isoPacket.pData = (offset < packetSize) ? &pPacket[offset] : NULL;
+    isoPacket.dataLength = packetSize - offset;
+
+    mpfHcitIsoDataCallback(&isoPacket);
 }
+#endif /* gHcitIsoSupport_d */
+
+#endif /* !gHcitSharedMemory_d */
 
 /*! *********************************************************************************
 * @}
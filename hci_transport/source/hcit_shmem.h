@@ -0,0 +1,104 @@
+/*! *********************************************************************************
+* \addtogroup HCI
+* @{
+********************************************************************************** */
+/*! *********************************************************************************
+* Copyright 2026 NXP
+* All rights reserved.
+*
+* \file
+*
+* This is the private interface of the shared memory rings of the HCI transport.
+* The ring functions keep no state of their own, so that both sides of a ring can
+* be driven from the same image, for example by two threads on a host machine.
+*
+* SPDX-License-Identifier: BSD-3-Clause
+********************************************************************************** */
+
+#ifndef HCIT_SHMEM_H
+#define HCIT_SHMEM_H
+
+/************************************************************************************
+*************************************************************************************
+* Include
+*************************************************************************************
+************************************************************************************/
+#include "hci_transport.h"
+
+/************************************************************************************
+*************************************************************************************
+* Public prototypes
+*************************************************************************************
+************************************************************************************/
+#if gHcitSharedMemory_d
+
+/*! *********************************************************************************
+* \brief        Empties a ring. Must be called before any of the cores uses it.
+*
+* \param[in]    pRing       Shared memory ring
+*
+********************************************************************************** */
+void Hcit_ShmemRingInit(hcitShmemRing_t* pRing);
+
+/*! *********************************************************************************
+* \brief        Reserves the next slot of a ring (producer side).
+*
+* \param[in]    pRing       Shared memory ring
+* \param[in]    length      Size of the packet, without the packet type marker
+*
+* \return       Pointer to the packet in the slot, or NULL if the ring is full or
+*               the packet is too big.
+*
+********************************************************************************** */
+void* Hcit_ShmemRingAlloc(hcitShmemRing_t* pRing, uint16_t length);
+
+/*! *********************************************************************************
+* \brief        Hands a reserved slot over to the consumer (producer side).
+*
+* \param[in]    pRing       Shared memory ring
+* \param[in]    pPacket     Pointer returned by Hcit_ShmemRingAlloc()
+* \param[in]    packetType  HCI packet type, or 0 to cancel the reservation
+* \param[in]    length      Size of the packet, without the packet type marker
+*
+* \return       TRUE if packets were made visible to the consumer.
+*
+* \remarks      Slots are handed over in allocation order. A slot sent before an
+*               older reservation becomes visible with it.
+*
+********************************************************************************** */
+bool_t Hcit_ShmemRingSend(hcitShmemRing_t* pRing, void* pPacket, uint8_t packetType, uint16_t length);
+
+/*! *********************************************************************************
+* \brief        Takes the next packet of a ring (consumer side).
+*
+* \param[in]    pRing           Shared memory ring
+* \param[out]   pPacketType     HCI packet type
+* \param[out]   pLength         Size of the packet, without the packet type marker
+*
+* \return       Pointer to the packet in the slot, or NULL if the ring is empty.
+*
+* \remarks      The slot stays in use until Hcit_ShmemRingRelease() is called.
+*
+********************************************************************************** */
+void* Hcit_ShmemRingReceive(hcitShmemRing_t* pRing, uint8_t* pPacketType, uint16_t* pLength);
+
+/*! *********************************************************************************
+* \brief        Gives a received slot back to the producer (consumer side).
+*
+* \param[in]    pRing       Shared memory ring
+* \param[in]    pPacket     Pointer returned by Hcit_ShmemRingReceive()
+*
+* \return       FALSE if the packet does not belong to the ring.
+*
+* \remarks      Slots can be released in any order.
+*
+********************************************************************************** */
+bool_t Hcit_ShmemRingRelease(hcitShmemRing_t* pRing, void* pPacket);
+
+#endif /* gHcitSharedMemory_d */
+
+#endif /* HCIT_SHMEM_H */
+
+/*! *********************************************************************************
+* @}
+********************************************************************************** */
@@ -0,0 +1,565 @@
+/*! *********************************************************************************
+* \addtogroup HCI
+* @{
+********************************************************************************** */
+/*! *********************************************************************************
+* Copyright 2026 NXP
+* All rights reserved.
+*
+* \file
+*
+* This file implements the HCI transport over a shared memory region, for dual-core
+* parts. Each direction is a lock-free single-producer single-consumer ring: the
+* producer only writes the head and the consumer only writes the tail, so the cores
+* never wait for each other. Packets are written and read in place in the ring slots.
+*
+* SPDX-License-Identifier: BSD-3-Clause
+********************************************************************************** */
+
+/************************************************************************************
+*************************************************************************************
+* Include
+*************************************************************************************
+************************************************************************************/
+#include "hci_transport.h"
+
+#if gHcitSharedMemory_d
+
+#include "MemManager.h"
+#include "FunctionLib.h"
+#include "fsl_os_abstraction.h"
+#if gHcitSnoop_d
+#include "hcit_btsnoop.h"
+#endif
+
+#include "ble_general.h"
+#include "hcit_shmem.h"
+
+#if !defined(__GNUC__)
+#include "fsl_device_registers.h"
+#endif
+
+/************************************************************************************
+*************************************************************************************
+* Private macros
+*************************************************************************************
+************************************************************************************/
+#define mHcitShmemIndexMask_c       (gHcitShmemSlotCount_c - 1U)
+
+/* Orders the accesses to the shared memory as seen by the other core */
+#if defined(__GNUC__)
+    #define mHcitShmemBarrier()     __sync_synchronize()
+#else
+    #define mHcitShmemBarrier()     __DMB()
+#endif
+
+/* Capture hook */
+#if gHcitSnoop_d
+    #define mHcitSnoopPacket(type, pPacket, size, received) \
+                                            Hcit_SnoopPacket((type), (const uint8_t*)(pPacket), (size), (received))
+#else
+    #define mHcitSnoopPacket(type, pPacket, size, received)
+#endif
+
+/************************************************************************************
+*************************************************************************************
+* Private type definitions
+*************************************************************************************
+************************************************************************************/
+/* Slot states. Reserved and ready are written by the producer, the others by the
+   consumer, each only while it owns the slot. */
+typedef enum
+{
+    mHcitShmemSlotFree_c = 0,
+    mHcitShmemSlotReserved_c,
+    mHcitShmemSlotReady_c,
+    mHcitShmemSlotPublished_c,
+    mHcitShmemSlotReleased_c
+}hcitShmemSlotState_t;
+
+/************************************************************************************
+*************************************************************************************
+* Private memory declarations
+*************************************************************************************
+************************************************************************************/
+static bool_t                   mHcitInit = FALSE;
+static hciTransportInterface_t  mTransportInterface;
+static hcitDoorbell_t           mpfHcitDoorbell;
+
+/* Rings used by this core */
+static hcitShmemRing_t*         mpHcitTxRing;
+static hcitShmemRing_t*         mpHcitRxRing;
+
+/************************************************************************************
+*************************************************************************************
+* Private functions prototypes
+*************************************************************************************
+************************************************************************************/
+static hcitShmemSlot_t* Hcit_ShmemGetSlot(hcitShmemRing_t* pRing, const void* pPacket);
+
+/************************************************************************************
+*************************************************************************************
+* Public memory declarations
+*************************************************************************************
+************************************************************************************/
+#if gUseHciTransportDownward_d
+    osaSemaphoreId_t gHciDataBufferingSem;
+#endif /* gUseHciTransportDownward_d */
+
+/************************************************************************************
+*************************************************************************************
+* Public functions
+*************************************************************************************
+************************************************************************************/
+extern WEAK bleResult_t Ble_HciRecv
+    (
+        hciPacketType_t packetType,
+        void* pHciPacket,
+        uint16_t hciPacketLength
+    );
+
+/*! *********************************************************************************
+* \brief  Initializes the shared memory HCI transport.
+*
+* \param[in]    hcitConfigStruct    Configuration. pSharedMemory and pfDoorbell are
+*                                   required, the serial interface fields are ignored.
+*
+* \return  gBleSuccess_c or error.
+*
+* \remarks The Host side (Downward HCI Transport) empties the rings, so it must be
+*          initialized before the Controller core is started. The region must be
+*          mapped non-cacheable on both cores.
+*
+********************************************************************************** */
+bleResult_t Hcit_Init( hcitConfigStruct_t* hcitConfigStruct )
+{
+    bleResult_t result = gHciSuccess_c;
+
+    if( mHcitInit == FALSE )
+    {
+        if( (NULL == hcitConfigStruct->pSharedMemory) || (NULL == hcitConfigStruct->pfDoorbell) )
+        {
+            return gBleInvalidParameter_c;
+        }
+
+#if gUseHciTransportDownward_d
+        gHciDataBufferingSem = OSA_SemaphoreCreate(0);
+
+        if (gHciDataBufferingSem == NULL)
+        {
+            return gHciTransportError_c;
+        }
+
+        mpHcitTxRing = &hcitConfigStruct->pSharedMemory->hostToController;
+        mpHcitRxRing = &hcitConfigStruct->pSharedMemory->controllerToHost;
+
+        Hcit_ShmemRingInit(mpHcitTxRing);
+        Hcit_ShmemRingInit(mpHcitRxRing);
+#else
+        mpHcitTxRing = &hcitConfigStruct->pSharedMemory->controllerToHost;
+        mpHcitRxRing = &hcitConfigStruct->pSharedMemory->hostToController;
+#endif /* gUseHciTransportDownward_d */
+
+        mTransportInterface = hcitConfigStruct->transportInterface;
+        mpfHcitDoorbell = hcitConfigStruct->pfDoorbell;
+
+        /* Flag initialization on module */
+        mHcitInit = TRUE;
+    }
+    else
+    {
+        /* Module has already been initialized */
+        result = gHciAlreadyInit_c;
+    }
+
+    return result;
+}
+
+/*! *********************************************************************************
+* \brief  Copies a packet into the transmit ring and signals the other core.
+*
+* \param[in]    packetType  HCI packet type
+* \param[in]    pPacket     HCI packet, without the packet type marker
+* \param[in]    packetSize  Size of the HCI packet
+*
+* \return  gBleSuccess_c, or gBleOutOfMemory_c if the ring is full.
+*
+********************************************************************************** */
+bleResult_t Hcit_SendPacket
+    (
+        hciPacketType_t packetType,
+        void*           pPacket,
+        uint16_t        packetSize
+    )
+{
+    void* pSlotPacket = Hcit_AllocPacket(packetSize);
+
+    if( NULL == pSlotPacket )
+    {
+        return gBleOutOfMemory_c;
+    }
+
+    FLib_MemCpy(pSlotPacket, pPacket, packetSize);
+
+    return Hcit_SendAllocatedPacket(packetType, pSlotPacket, packetSize);
+}
+
+/*! *********************************************************************************
+* \brief  Reserves a slot of the transmit ring, so that the packet is built in place.
+*
+* \param[in]    packetSize  Size of the HCI packet, without the packet type marker
+*
+* \return  Pointer to the packet payload, or NULL if the ring is full.
+*
+********************************************************************************** */
+void* Hcit_AllocPacket(uint16_t packetSize)
+{
+    return Hcit_ShmemRingAlloc(mpHcitTxRing, packetSize);
+}
+
+/*! *********************************************************************************
+* \brief  Cancels a slot reserved with Hcit_AllocPacket() that was not sent.
+*
+* \param[in]    pPacket     Pointer returned by Hcit_AllocPacket()
+*
+********************************************************************************** */
+void Hcit_FreePacket(void* pPacket)
+{
+    /* The consumer skips cancelled slots */
+    if( (NULL != pPacket) && Hcit_ShmemRingSend(mpHcitTxRing, pPacket, 0U, 0U) )
+    {
+        mpfHcitDoorbell();
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Hands a packet built with Hcit_AllocPacket() over to the other core.
+*
+* \param[in]    packetType  HCI packet type
+* \param[in]    pPacket     Pointer returned by Hcit_AllocPacket()
+* \param[in]    packetSize  Size of the HCI packet, without the packet type marker
+*
+* \return  gBleSuccess_c.
+*
+* \remarks The transport takes ownership of the packet in all cases.
+*
+********************************************************************************** */
+bleResult_t Hcit_SendAllocatedPacket
+    (
+        hciPacketType_t packetType,
+        void*           pPacket,
+        uint16_t        packetSize
+    )
+{
+    mHcitSnoopPacket(packetType, pPacket, packetSize, FALSE);
+
+    if( Hcit_ShmemRingSend(mpHcitTxRing, pPacket, (uint8_t)packetType, packetSize) )
+    {
+        mpfHcitDoorbell();
+    }
+
+    return gBleSuccess_c;
+}
+
+/*! *********************************************************************************
+* \brief  Gives a packet received with its H4 packet type marker to the Host.
+*
+* \param[in]    pPacket     Packet allocated with MEM_BufferAlloc(), starting with the
+*                           packet type marker
+* \param[in]    packetSize  Size of the packet, packet type marker included
+*
+* \return  gBleSuccess_c or error.
+*
+********************************************************************************** */
+bleResult_t Hcit_RecvPacket
+    (
+        void*           pPacket,
+        uint16_t        packetSize
+    )
+{
+    bleResult_t result = gHciSuccess_c;
+
+    uint8_t* aData = (uint8_t*) pPacket;
+    uint8_t type = aData[0];
+
+    if (type != 0x01 && type != 0x02 && type != 0x04)
+    {
+        result = gHciTransportError_c;
+    }
+    else
+    {
+        hciPacketType_t packetType = (hciPacketType_t) type;
+        result = Ble_HciRecv
+        (
+            packetType,
+            aData + 1,
+            packetSize - 1
+        );
+
+        (void)MEM_BufferFree( pPacket );
+    }
+
+    return result;
+}
+
+/*! *********************************************************************************
+* \brief  Gives a received packet back to the other core.
+*
+* \param[in]    pPacket     Packet previously delivered to the transport interface
+*
+* \remarks Zero-copy reception is not available with this transport: the slot is
+*          released as soon as the transport interface returns, so there is
+*          nothing to do.
+*
+********************************************************************************** */
+void Hcit_RxBufferRelease(void* pPacket)
+{
+    (void)pPacket;
+}
+
+/*! *********************************************************************************
+* \brief  Delivers the packets added by the other core to the receive ring.
+*
+********************************************************************************** */
+void Hcit_ShmemDoorbellHandler(void)
+{
+    void*       pPacket;
+    uint8_t     packetType;
+    uint16_t    length;
+
+    if( mHcitInit == FALSE )
+    {
+        return;
+    }
+
+    pPacket = Hcit_ShmemRingReceive(mpHcitRxRing, &packetType, &length);
+
+    while( NULL != pPacket )
+    {
+        mHcitSnoopPacket((hciPacketType_t)packetType, pPacket, length, TRUE);
+
+        (void)mTransportInterface((hciPacketType_t)packetType, pPacket, length);
+
+        /* The transport interface copies the packet before returning */
+        (void)Hcit_ShmemRingRelease(mpHcitRxRing, pPacket);
+
+        pPacket = Hcit_ShmemRingReceive(mpHcitRxRing, &packetType, &length);
+    }
+}
+
+/*! *********************************************************************************
+* \brief  Empties a ring.
+*
+* \param[in]    pRing       Shared memory ring
+*
+********************************************************************************** */
+void Hcit_ShmemRingInit(hcitShmemRing_t* pRing)
+{
+    FLib_MemSet(pRing, 0U, sizeof(hcitShmemRing_t));
+    mHcitShmemBarrier();
+}
+
+/*! *********************************************************************************
+* \brief  Reserves the next slot of a ring.
+*
+* \param[in]    pRing       Shared memory ring
+* \param[in]    length      Size of the packet, without the packet type marker
+*
+* \return  Pointer to the packet in the slot, or NULL.
+*
+* \remarks The local producers are serialized with interrupts disabled. The other
+*          core is never waited for.
+*
+********************************************************************************** */
+void* Hcit_ShmemRingAlloc(hcitShmemRing_t* pRing, uint16_t length)
+{
+    hcitShmemSlot_t* pSlot = NULL;
+
+    if( length > gHcitShmemSlotSize_c )
+    {
+        return NULL;
+    }
+
+    OSA_InterruptDisable();
+    if( (pRing->reserve - pRing->tail) < gHcitShmemSlotCount_c )
+    {
+        /* The consumer is done with the slot once the tail has moved past it */
+        mHcitShmemBarrier();
+
+        pSlot = &pRing->slots[pRing->reserve & mHcitShmemIndexMask_c];
+        pSlot->state = (uint8_t)mHcitShmemSlotReserved_c;
+        pRing->reserve++;
+    }
+    OSA_InterruptEnable();
+
+    return (NULL != pSlot) ? pSlot->data : NULL;
+}
+
+/*! *********************************************************************************
+* \brief  Hands a reserved slot over to the consumer.
+*
+* \param[in]    pRing       Shared memory ring
+* \param[in]    pPacket     Pointer returned by Hcit_ShmemRingAlloc()
+* \param[in]    packetType  HCI packet type, or 0 to cancel the reservation
+* \param[in]    length      Size of the packet, without the packet type marker
+*
+* \return  TRUE if the head moved.
+*
+********************************************************************************** */
+bool_t Hcit_ShmemRingSend(hcitShmemRing_t* pRing, void* pPacket, uint8_t packetType, uint16_t length)
+{
+    hcitShmemSlot_t*    pSlot = Hcit_ShmemGetSlot(pRing, pPacket);
+    bool_t              published = FALSE;
+    uint32_t            head;
+
+    if( NULL == pSlot )
+    {
+        return FALSE;
+    }
+
+    pSlot->packetType = packetType;
+    pSlot->length = length;
+
+    OSA_InterruptDisable();
+    pSlot->state = (uint8_t)mHcitShmemSlotReady_c;
+
+    /* Publish the ready slots in allocation order */
+    head = pRing->head;
+    while( (head != pRing->reserve) &&
+           (pRing->slots[head & mHcitShmemIndexMask_c].state == (uint8_t)mHcitShmemSlotReady_c) )
+    {
+        pRing->slots[head & mHcitShmemIndexMask_c].state = (uint8_t)mHcitShmemSlotPublished_c;
+        head++;
+    }
+
+    if( head != pRing->head )
+    {
+        /* The slots are complete before the consumer can see them */
+        mHcitShmemBarrier();
+        pRing->head = head;
+        published = TRUE;
+    }
+    OSA_InterruptEnable();
+
+    return published;
+}
+
+/*! *********************************************************************************
+* \brief  Takes the next packet of a ring.
+*
+* \param[in]    pRing           Shared memory ring
+* \param[out]   pPacketType     HCI packet type
+* \param[out]   pLength         Size of the packet
+*
+* \return  Pointer to the packet in the slot, or NULL if the ring is empty.
+*
+********************************************************************************** */
+void* Hcit_ShmemRingReceive(hcitShmemRing_t* pRing, uint8_t* pPacketType, uint16_t* pLength)
+{
+    hcitShmemSlot_t* pSlot;
+
+    while( pRing->read != pRing->head )
+    {
+        /* The slot is read only after the head that published it */
+        mHcitShmemBarrier();
+
+        pSlot = &pRing->slots[pRing->read & mHcitShmemIndexMask_c];
+        pRing->read++;
+
+        if( pSlot->packetType != 0U )
+        {
+            *pPacketType = pSlot->packetType;
+            *pLength = pSlot->length;
+            return pSlot->data;
+        }
+
+        /* Cancelled allocation */
+        (void)Hcit_ShmemRingRelease(pRing, pSlot->data);
+    }
+
+    return NULL;
+}
+
+/*! *********************************************************************************
+* \brief  Gives a received slot back to the producer.
+*
+* \param[in]    pRing       Shared memory ring
+* \param[in]    pPacket     Pointer returned by Hcit_ShmemRingReceive()
+*
+* \return  FALSE if the packet does not belong to the ring.
+*
+********************************************************************************** */
+bool_t Hcit_ShmemRingRelease(hcitShmemRing_t* pRing, void* pPacket)
+{
+    hcitShmemSlot_t*    pSlot = Hcit_ShmemGetSlot(pRing, pPacket);
+    uint32_t            tail;
+
+    if( NULL == pSlot )
+    {
+        return FALSE;
+    }
+
+    OSA_InterruptDisable();
+    pSlot->state = (uint8_t)mHcitShmemSlotReleased_c;
+
+    /* The tail only moves over consecutive released slots */
+    tail = pRing->tail;
+    while( (tail != pRing->read) &&
+           (pRing->slots[tail & mHcitShmemIndexMask_c].state == (uint8_t)mHcitShmemSlotReleased_c) )
+    {
+        pRing->slots[tail & mHcitShmemIndexMask_c].state = (uint8_t)mHcitShmemSlotFree_c;
+        tail++;
+    }
+
+    if( tail != pRing->tail )
+    {
+        /* The slots are no longer read when the producer can reuse them */
+        mHcitShmemBarrier();
+        pRing->tail = tail;
+    }
+    OSA_InterruptEnable();
+
+    return TRUE;
+}
+
+/************************************************************************************
+*************************************************************************************
+* Private functions
+*************************************************************************************
+************************************************************************************/
+
+/*! *********************************************************************************
+* \brief  Returns the slot holding a packet.
+*
+* \param[in]    pRing       Shared memory ring
+* \param[in]    pPacket     Packet in one of the slots of the ring
+*
+* \return  Pointer to the slot, or NULL if the packet is not a slot of the ring.
+*
+********************************************************************************** */
+static hcitShmemSlot_t* Hcit_ShmemGetSlot(hcitShmemRing_t* pRing, const void* pPacket)
+{
+    const uint8_t*  pFirst = pRing->slots[0].data;
+    const uint8_t*  pData = (const uint8_t*)pPacket;
+    uint32_t        offset;
+
+    if( (pData < pFirst) || (pData >= (pFirst + sizeof(pRing->slots))) )
+    {
+        return NULL;
+    }
+
+    offset = (uint32_t)(pData - pFirst);
+
+    if( (offset % sizeof(hcitShmemSlot_t)) != 0U )
+    {
+        return NULL;
+    }
+
+    return &pRing->slots[offset / sizeof(hcitShmemSlot_t)];
+}
+
+#endif /* gHcitSharedMemory_d */
+
+/*! *********************************************************************************
+* @}
+********************************************************************************** */